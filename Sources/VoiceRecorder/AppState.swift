@@ -36,18 +36,34 @@ final class AppState {
     /// Current audio input level (0.0 -- 1.0), polled during recording.
     var currentMeteringLevel: Float = 0
 
-    /// All persisted recording sessions, newest first.
+    /// Persisted recording sessions loaded so far, newest first. These are
+    /// summaries: `transcript` is nil, use `transcript(for:)` for the text.
     var sessions: [VRSession] = []
 
+    /// Whether older sessions remain beyond the loaded pages.
+    var hasMoreSessions = false
+
+    /// Sessions matching the current history search.
+    var searchResults: [VRSession] = []
+
     /// The most recent transcription result (used for auto-paste).
     var latestTranscript: String?
 
     /// Circular buffer of recent metering samples for the waveform view.
     var meteringSamples: [Float] = Array(repeating: 0, count: Config.meteringSampleCount)
 
+    /// Latest per-band levels (low to high), display-scaled like the waveform.
+    var meteringBands: [Float] = Array(repeating: 0, count: Int(VRMeterBandCount))
+
     /// Elapsed seconds in the current recording.
     var recordingElapsedSeconds: Int = 0
 
+    /// Live caption of the recording in progress: text that has settled,
+    /// and the tentative words after it (may still change). Empty when
+    /// captions are off or nothing has been said yet.
+    var liveCaptionStable = ""
+    var liveCaptionPartial = ""
+
     /// Whether the whisper model was successfully loaded.
     var isModelLoaded = false
 
@@ -76,8 +92,29 @@ final class AppState {
     /// Timer that auto-dismisses error messages.
     private var errorDismissTimer: Timer?
 
-    /// The active session id created when recording starts.
-    private var activeSessionId: String?
+    /// The active session id created when recording starts.  Background
+    /// refinement and crash recovery are held while a session is active, so
+    /// they never compete with a live recording or its draft transcription.
+    private var activeSessionId: String? {
+        didSet {
+            if oldValue == nil, activeSessionId != nil {
+                whisperBridge.pauseRefinement()
+                whisperBridge.pauseRecovery()
+            } else if oldValue != nil, activeSessionId == nil {
+                whisperBridge.resumeRefinement()
+                whisperBridge.resumeRecovery()
+            }
+        }
+    }
+
+    /// Whether the active recording is being transcribed incrementally
+    /// through WhisperBridge's stream API (set when the model was loaded at
+    /// record start).
+    private var isStreamingTranscription = false
+
+    /// Samples stored so far for the active recording (for the minimum
+    /// duration check at stop time without re-reading the database).
+    private var recordedSampleCount = 0
 
     /// Cancellable for the toggle-recording notification from menu bar.
     private var toggleCancellable: Any?
@@ -88,6 +125,8 @@ final class AppState {
     // MARK: - Init
 
     init() {
+        // Before anything can transcribe (recovery starts from onAppear).
+        whisperBridge.attachTranscriptCache(toStorage: storageBridge)
         loadSessions()
         observeToggleNotification()
     }
@@ -175,11 +214,21 @@ final class AppState {
             return
         }
         activeSessionId = sessionId
+        recordedSampleCount = 0
+
+        // Transcribe chunks as they arrive so stop-to-text latency only
+        // depends on the final chunk. Without a model, stopRecording() falls
+        // back to transcribeActiveSession(), which surfaces the error.
+        isStreamingTranscription = whisperBridge.isModelLoaded()
+        if isStreamingTranscription {
+            whisperBridge.beginStream(withSampleRate: Int32(Config.transcriptionSampleRate))
+        }
 
         // Wire up the chunk callback so each 35-second PCM chunk is
-        // persisted immediately. Note: this fires asynchronously during recording
-        // for intermediate chunks. The final flush chunk is stored synchronously
-        // in stopRecording() to avoid race conditions.
+        // queued for storage immediately (committed by the core's write-behind
+        // queue). Note: this fires asynchronously during recording for
+        // intermediate chunks. The final flush chunk is queued in
+        // stopRecording(), followed by a flush barrier.
         audioManager.onChunkComplete = { [weak self] pcmData, chunkIndex in
             Task { @MainActor [weak self] in
                 guard let self, let sid = self.activeSessionId else {
@@ -188,7 +237,9 @@ final class AppState {
                 }
                 let ok = self.storageBridge.addChunk(pcmData, toSession: sid, at: chunkIndex)
                 if ok {
-                    log.info("Stored intermediate chunk \(chunkIndex): \(pcmData.count) bytes")
+                    log.info("Queued intermediate chunk \(chunkIndex): \(pcmData.count) bytes")
+                    self.recordedSampleCount += pcmData.count / MemoryLayout<Float>.size
+                    self.streamChunk(pcmData, index: chunkIndex, sessionId: sid)
                 } else {
                     log.error("FAILED to store chunk \(chunkIndex): \(pcmData.count) bytes for session \(sid)")
                     self.setError("Failed to save audio chunk — storage error")
@@ -198,6 +249,10 @@ final class AppState {
 
         guard audioManager.startRecording() else {
             setError("Failed to start audio engine — check microphone access")
+            if isStreamingTranscription {
+                whisperBridge.cancelStream()
+                isStreamingTranscription = false
+            }
             activeSessionId = nil
             return
         }
@@ -206,6 +261,7 @@ final class AppState {
         recordingElapsedSeconds = 0
         startMeteringPolling()
         startElapsedTimer()
+        startLiveCaptions()
 
         // Show the floating overlay when recording starts.
         showFloatingOverlay()
@@ -219,32 +275,69 @@ final class AppState {
         // CRITICAL: We must store this BEFORE calling transcribeActiveSession(),
         // otherwise the chunk callback's async Task hasn't run yet and the
         // database has zero chunks for short recordings.
-        let finalChunk = audioManager.stopRecording()
+        stopLiveCaptions()
+        let finalChunks = audioManager.stopRecording()
 
         isRecording = false
         stopMeteringPolling()
         stopElapsedTimer()
         currentMeteringLevel = 0
         meteringSamples = Array(repeating: 0, count: Config.meteringSampleCount)
+        meteringBands = Array(repeating: 0, count: Int(VRMeterBandCount))
 
-        // Store the final flush chunk synchronously.
-        if let (data, idx) = finalChunk, let sid = activeSessionId {
-            log.info("Storing final chunk \(idx): \(data.count) bytes for session \(sid)")
-            let stored = storageBridge.addChunk(data, toSession: sid, at: idx)
-            if !stored {
-                log.error("FAILED to store final chunk \(idx) for session \(sid)")
-                setError("Failed to save final audio chunk — recording may be lost")
-                activeSessionId = nil
-                loadSessions()
-                hideFloatingOverlayAfterDelay()
-                return
-            }
-        } else if finalChunk == nil {
+        // Queue the flushed chunks (normally just the final partial one).
+        if finalChunks.isEmpty {
             log.warning("No final chunk data — recording may have been too short or mic was silent")
+        } else if let sid = activeSessionId {
+            for (data, idx) in finalChunks {
+                log.info("Queueing final chunk \(idx): \(data.count) bytes for session \(sid)")
+                let stored = storageBridge.addChunk(data, toSession: sid, at: idx)
+                if !stored {
+                    log.error("FAILED to store final chunk \(idx) for session \(sid)")
+                    setError("Failed to save final audio chunk — recording may be lost")
+                    if isStreamingTranscription {
+                        whisperBridge.cancelStream()
+                        isStreamingTranscription = false
+                    }
+                    activeSessionId = nil
+                    loadSessions()
+                    hideFloatingOverlayAfterDelay()
+                    return
+                }
+                recordedSampleCount += data.count / MemoryLayout<Float>.size
+                streamChunk(data, index: idx, sessionId: sid)
+            }
         }
 
-        // Begin transcription — now all chunks are in the database.
-        transcribeActiveSession()
+        guard let sid = activeSessionId else {
+            if isStreamingTranscription {
+                finishStreamingTranscription()
+            } else {
+                transcribeActiveSession()
+            }
+            return
+        }
+
+        // The stream already holds every chunk in memory, so it can finish
+        // right away; the whole-session path reads audio back from the
+        // database and must wait for the flush barrier.
+        let streaming = isStreamingTranscription
+        if streaming {
+            finishStreamingTranscription()
+        }
+        storageBridge.flushSessionInBackground(sid) { [weak self] ok in
+            Task { @MainActor [weak self] in
+                guard let self else { return }
+                if !ok {
+                    log.error("FAILED to commit queued chunks for session \(sid)")
+                    self.setError("Failed to save audio chunk — recording may be incomplete")
+                }
+                if !streaming {
+                    // Now all chunks are in the database.
+                    self.transcribeActiveSession()
+                }
+            }
+        }
     }
 
     /// Cancel the current recording without transcribing.
@@ -252,6 +345,7 @@ final class AppState {
     func cancelRecording() {
         guard isRecording else { return }
 
+        stopLiveCaptions()
         _ = audioManager.stopRecording()
 
         isRecording = false
@@ -259,6 +353,12 @@ final class AppState {
         stopElapsedTimer()
         currentMeteringLevel = 0
         meteringSamples = Array(repeating: 0, count: Config.meteringSampleCount)
+        meteringBands = Array(repeating: 0, count: Int(VRMeterBandCount))
+
+        if isStreamingTranscription {
+            whisperBridge.cancelStream()
+            isStreamingTranscription = false
+        }
 
         if let sid = activeSessionId {
             log.info("Cancelling recording — deleting session \(sid)")
@@ -282,20 +382,44 @@ final class AppState {
 
     // MARK: - Transcription
 
-    /// Transcribe all chunks for the currently active session.
-    /// New flow: chunks are raw 16kHz mono PCM — concatenate them directly,
-    /// write as a WAV file, then feed to WhisperBridge.
-    private func transcribeActiveSession() {
+    /// Hand a stored chunk to the streaming transcriber and persist the
+    /// partial text it produces, so a crash mid-recording keeps the chunks
+    /// that were already transcribed.
+    private func streamChunk(_ pcmData: Data, index: Int, sessionId: String) {
+        guard isStreamingTranscription else { return }
+
+        whisperBridge.feedStreamPCMData(pcmData) { [weak self] text, error in
+            Task { @MainActor [weak self] in
+                guard let self else { return }
+                if let error {
+                    log.error("Stream transcription failed for chunk \(index) of session \(sessionId): \(error.localizedDescription)")
+                    return
+                }
+                guard let text, !text.isEmpty else { return }
+                self.storageBridge.updateTranscript(text, forChunk: index, ofSession: sessionId)
+                log.info("Stored partial transcript for chunk \(index): \(text.count) chars")
+            }
+        }
+    }
+
+    /// Finish the incremental stream started in startRecording(). Earlier
+    /// chunks were transcribed while recording, so this only waits on the
+    /// final (partial) chunk.
+    private func finishStreamingTranscription() {
+        isStreamingTranscription = false
+
         guard let sessionId = activeSessionId else {
+            whisperBridge.cancelStream()
             setError("No active session to transcribe")
             hideFloatingOverlayAfterDelay()
             return
         }
 
-        // Check if model is loaded before attempting transcription.
-        if !whisperBridge.isModelLoaded() {
-            setError("Whisper model not loaded — transcription unavailable")
-            isTranscribing = false
+        let durationSeconds = Float(recordedSampleCount) / Float(Config.transcriptionSampleRate)
+        if durationSeconds < Config.minimumTranscriptionDuration {
+            log.warning("Audio too short for transcription: \(String(format: "%.1f", durationSeconds))s (\(self.recordedSampleCount) samples) — skipping")
+            whisperBridge.cancelStream()
+            activeSessionId = nil
             loadSessions()
             hideFloatingOverlayAfterDelay()
             return
@@ -303,31 +427,64 @@ final class AppState {
 
         isTranscribing = true
         transcriptionProgress = 0
+        log.info("Finishing streamed transcription for session \(sessionId): ~\(String(format: "%.1f", durationSeconds))s of audio")
 
-        // Get raw PCM data (concatenated chunks) from the database.
-        guard let pcmData = storageBridge.getAudioForSession(sessionId) else {
-            setError("No audio data found for session — cannot transcribe")
+        whisperBridge.finishStream(
+            progress: { [weak self] progress in
+                Task { @MainActor [weak self] in
+                    self?.transcriptionProgress = progress
+                }
+            },
+            completion: { [weak self] transcript, segments, error in
+                Task { @MainActor [weak self] in
+                    self?.handleTranscriptionResult(transcript, segments: segments ?? [],
+                                                    error: error, sessionId: sessionId)
+                }
+            }
+        )
+    }
+
+    /// Transcribe all chunks for the currently active session.
+    /// Chunks are raw 16kHz mono PCM; WhisperBridge reads them from storage
+    /// one at a time, and chunks it has already transcribed with the same
+    /// model come from its transcript cache (so a retry redoes only what failed).
+    private func transcribeActiveSession(tier: VRModelTier = .automatic,
+                                         priority: VRTranscriptionPriority = .interactive) {
+        guard let sessionId = activeSessionId else {
+            setError("No active session to transcribe")
+            hideFloatingOverlayAfterDelay()
+            return
+        }
+
+        // Check if model is loaded before attempting transcription.
+        if !whisperBridge.isModelLoaded() {
+            setError("Whisper model not loaded — transcription unavailable")
             isTranscribing = false
             loadSessions()
             hideFloatingOverlayAfterDelay()
             return
         }
 
-        if pcmData.count == 0 {
-            setError("Audio data is empty — cannot transcribe")
+        isTranscribing = true
+        transcriptionProgress = 0
+
+        // Only the chunk spans are read here; the audio stays in storage.
+        let spans = storageBridge.getChunkSpans(forSession: sessionId)
+        let durationMs = spans.last?.endMs ?? 0
+        if durationMs <= 0 {
+            setError("No audio data found for session — cannot transcribe")
             isTranscribing = false
+            activeSessionId = nil
             loadSessions()
             hideFloatingOverlayAfterDelay()
             return
         }
 
-        // Validate PCM data: each sample is 4 bytes (Float32), at 16kHz.
-        let sampleCount = pcmData.count / MemoryLayout<Float>.size
-        let durationSeconds = Float(sampleCount) / Float(Config.transcriptionSampleRate)
-        log.info("Transcribing session \(sessionId): \(pcmData.count) bytes, \(sampleCount) samples, ~\(String(format: "%.1f", durationSeconds))s of audio")
+        let durationSeconds = Float(durationMs) / 1000
+        log.info("Transcribing session \(sessionId): \(spans.count) chunks, ~\(String(format: "%.1f", durationSeconds))s of audio")
 
         if durationSeconds < Config.minimumTranscriptionDuration {
-            log.warning("Audio too short for transcription: \(String(format: "%.1f", durationSeconds))s (\(sampleCount) samples) — skipping")
+            log.warning("Audio too short for transcription: \(String(format: "%.1f", durationSeconds))s — skipping")
             isTranscribing = false
             activeSessionId = nil
             loadSessions()
@@ -335,65 +492,217 @@ final class AppState {
             return
         }
 
-        // Feed raw PCM directly to WhisperBridge — no file I/O or conversion needed.
-        whisperBridge.transcribePCMData(
-            pcmData,
-            sampleRate: Int32(Config.transcriptionSampleRate),
+        whisperBridge.transcribeSession(
+            sessionId,
+            fromStorage: storageBridge,
+            tier: tier,
+            priority: priority,
             progress: { [weak self] progress in
                 Task { @MainActor [weak self] in
                     self?.transcriptionProgress = progress
                 }
             },
-            completion: { [weak self] transcript, error in
+            completion: { [weak self] transcript, segments, error in
+                Task { @MainActor [weak self] in
+                    self?.handleTranscriptionResult(transcript, segments: segments ?? [],
+                                                    error: error, sessionId: sessionId)
+                }
+            }
+        )
+    }
+
+    /// Persist, paste, and report a finished transcription. Shared by the
+    /// streaming and whole-session paths.
+    private func handleTranscriptionResult(_ transcript: String?, segments: [VRTranscriptSegment],
+                                           error: Error?, sessionId: String) {
+        // Superseded by a newer request for the session, or the session was
+        // deleted: whoever cancelled it owns the session state now.
+        if WhisperBridge.isCancellationError(error) {
+            log.info("Transcription of session \(sessionId) was cancelled")
+            return
+        }
+
+        isTranscribing = false
+        transcriptionProgress = 0
+
+        if let transcript, !transcript.isEmpty, error == nil {
+            storageBridge.updateTranscript(transcript, forSession: sessionId)
+            storageBridge.replaceSegments(segments, forSession: sessionId)
+            storageBridge.completeSession(sessionId, withDuration: recordingElapsedSeconds * 1000)
+            if Config.archiveSessionAudio {
+                storageBridge.archiveSessionInBackground(sessionId)
+            }
+            latestTranscript = transcript
+            log.debug("Pipeline stages: \(VRPipelineMetrics.summary(), privacy: .public)")
+
+            // Always auto-paste transcript to cursor position.
+            AutoPaste.pasteText(transcript)
+
+            // The paste used the draft; the refined text replaces it in history.
+            if Config.refineTranscriptsInBackground {
+                scheduleRefinement(sessionId: sessionId, draft: transcript)
+            }
+
+            // Hide the overlay after a short delay to show completion.
+            hideFloatingOverlayAfterDelay()
+        } else {
+            let msg = error?.localizedDescription ?? "Unknown transcription error"
+            setError("Transcription failed: \(msg)")
+            log.error("Transcription failed for session \(sessionId): \(msg)")
+            hideFloatingOverlayAfterDelay()
+        }
+
+        activeSessionId = nil
+        loadSessions()
+    }
+
+    /// Queue the background high-accuracy pass for a transcribed session.
+    /// It starts once no session is active and stores its result as the
+    /// refined version of the transcript.
+    private func scheduleRefinement(sessionId: String, draft: String) {
+        let storage = storageBridge
+        whisperBridge.refineSession(
+            sessionId,
+            audioLoader: { storage.getAudioForSession(sessionId) },
+            completion: { [weak self] refined, segments in
                 Task { @MainActor [weak self] in
                     guard let self else { return }
-                    self.isTranscribing = false
-                    self.transcriptionProgress = 0
-
-                    if let transcript, !transcript.isEmpty, error == nil {
-                        self.storageBridge.updateTranscript(transcript, forSession: sessionId)
-                        self.storageBridge.completeSession(sessionId, withDuration: self.recordingElapsedSeconds * 1000)
-                        self.latestTranscript = transcript
-
-                        // Always auto-paste transcript to cursor position.
-                        AutoPaste.pasteText(transcript)
-
-                        // Hide the overlay after a short delay to show completion.
-                        self.hideFloatingOverlayAfterDelay()
-                    } else {
-                        let msg = error?.localizedDescription ?? "Unknown transcription error"
-                        self.setError("Transcription failed: \(msg)")
-                        log.error("Transcription failed for session \(sessionId): \(msg)")
-                        self.hideFloatingOverlayAfterDelay()
+                    // Swap in every refined segment and the transcript together.
+                    guard storage.replaceSegments(segments, forSession: sessionId,
+                                                  fromMs: 0, toMs: Int.max,
+                                                  version: .refined) != nil else {
+                        log.error("Storing refined transcript for session \(sessionId) failed")
+                        return
+                    }
+                    log.info("Refined transcript for session \(sessionId): \(draft.count) -> \(refined.count) chars")
+                    if self.latestTranscript == draft {
+                        self.latestTranscript = refined
                     }
-
-                    self.activeSessionId = nil
                     self.loadSessions()
                 }
             }
         )
     }
 
+    /// Re-transcribe only the low-confidence spans of a stored session on the
+    /// accurate tier, splicing the new segments into its transcript. Much
+    /// cheaper than a full retry when a few passages came out garbled.
+    func retranscribeLowConfidenceSegments(sessionId: String) {
+        let storage = storageBridge
+        let spans = storage.getLowConfidenceSegments(forSession: sessionId,
+                                                     threshold: Config.lowConfidenceThreshold)
+        guard !spans.isEmpty, let pcmData = storage.getAudioForSession(sessionId) else { return }
+
+        // Merge neighbouring spans so each inference gets some context.
+        var ranges: [(start: Int, end: Int)] = []
+        for span in spans {
+            if let last = ranges.last, span.startMs - last.end <= Config.lowConfidenceMergeGapMs {
+                ranges[ranges.count - 1].end = max(last.end, span.endMs)
+            } else {
+                ranges.append((span.startMs, span.endMs))
+            }
+        }
+        log.info("Re-transcribing \(ranges.count) low-confidence range(s) of session \(sessionId)")
+
+        for range in ranges {
+            whisperBridge.transcribeSegments(
+                ofPCMData: pcmData,
+                sampleRate: Int32(Config.transcriptionSampleRate),
+                fromMs: range.start,
+                toMs: range.end,
+                tier: .accurate,
+                priority: .userInitiated,
+                sessionId: sessionId,
+                progress: nil,
+                completion: { [weak self] _, segments, error in
+                    Task { @MainActor [weak self] in
+                        guard let self, !WhisperBridge.isCancellationError(error) else { return }
+                        guard let segments, !segments.isEmpty, error == nil else {
+                            log.error("Range re-transcription failed for session \(sessionId): \(error?.localizedDescription ?? "no speech")")
+                            return
+                        }
+                        if storage.replaceSegments(segments, forSession: sessionId,
+                                                   fromMs: range.start, toMs: range.end,
+                                                   version: .refined) != nil {
+                            self.loadSessions()
+                        }
+                    }
+                }
+            )
+        }
+    }
+
     /// Retry transcription for a previously failed (or any) session.
     func retryTranscription(sessionId: String) {
         activeSessionId = sessionId
-        transcribeActiveSession()
+        // Retries favour accuracy over latency, and queue behind a fresh
+        // dictation's draft.
+        transcribeActiveSession(tier: .accurate, priority: .userInitiated)
     }
 
     // MARK: - Session Management
 
-    /// Reload all sessions from the database, sorted newest-first.
+    /// Reload the history list from the database, newest first. Reloads at
+    /// least one page, or as many rows as are already loaded so a refresh
+    /// doesn't truncate the list the user has scrolled through.
     func loadSessions() {
-        if let all = storageBridge.getAllSessions() as? [VRSession] {
-            sessions = all.sorted {
-                $0.createdAt > $1.createdAt
-            }
+        let limit = max(sessions.count, Config.historyPageSize)
+        let page = storageBridge.getSessionSummaries(fromOffset: 0, limit: limit)
+        sessions = page
+        hasMoreSessions = page.count == limit
+    }
+
+    /// Append the next page of older sessions to the history list.
+    func loadMoreSessions() {
+        guard hasMoreSessions else { return }
+        let page = storageBridge.getSessionSummaries(
+            fromOffset: sessions.count,
+            limit: Config.historyPageSize
+        )
+        sessions.append(contentsOf: page)
+        hasMoreSessions = page.count == Config.historyPageSize
+    }
+
+    /// Full transcript for a session, loaded on demand for the detail view.
+    func transcript(for sessionId: String) -> String? {
+        storageBridge.getTranscript(forSession: sessionId)
+    }
+
+    /// A session's waveform as `bars` peak levels (0.0 -- 1.0) for a history
+    /// thumbnail, from the stored overview pyramid; empty if none is stored.
+    func waveform(for sessionId: String, bars: Int) -> [Float] {
+        storageBridge.waveformOverview(forSession: sessionId, pixels: bars)
+            .map { max(abs($0.min), abs($0.max)) }
+    }
+
+    /// Look up a loaded session (history page or search result) by id.
+    func session(withId sessionId: String) -> VRSession? {
+        sessions.first(where: { $0.sessionId == sessionId })
+            ?? searchResults.first(where: { $0.sessionId == sessionId })
+    }
+
+    /// Run a full-text search over all transcripts, best match first.
+    func searchSessions(_ query: String) {
+        let trimmed = query.trimmingCharacters(in: .whitespaces)
+        guard !trimmed.isEmpty else {
+            searchResults = []
+            return
         }
+        searchResults = storageBridge.searchSessions(trimmed, limit: Config.searchResultLimit)
     }
 
     /// Delete a session and all its associated audio chunks.
     func deleteSession(sessionId: String) {
+        whisperBridge.cancelRefinement(forSession: sessionId)
+        whisperBridge.cancelRecovery(forSession: sessionId)
+        whisperBridge.cancelTranscriptions(forSession: sessionId)
+        if activeSessionId == sessionId {
+            activeSessionId = nil
+            isTranscribing = false
+            transcriptionProgress = 0
+        }
         storageBridge.deleteSession(sessionId)
+        searchResults.removeAll { $0.sessionId == sessionId }
         loadSessions()
     }
 
@@ -403,14 +712,17 @@ final class AppState {
         meteringTimer = Timer.scheduledTimer(withTimeInterval: Config.meteringPollInterval, repeats: true) { [weak self] _ in
             Task { @MainActor [weak self] in
                 guard let self, self.isRecording else { return }
-                let rawLevel = self.audioManager.getMeteringLevel()
+                let levels = self.audioManager.getMeteringLevels()
 
                 // Amplify the metering level for visual display.
                 // Raw RMS levels are typically 0.0-0.1 for normal speech.
                 // Moderate curve so bars show dynamic variation, not a solid block.
-                let amplified = min(pow(rawLevel, 0.5) * 2.0, 1.0)
+                func display(_ raw: Float) -> Float { min(pow(raw, 0.5) * 2.0, 1.0) }
+                let amplified = display(levels.rms)
 
                 self.currentMeteringLevel = amplified
+                let bands = levels.bands
+                self.meteringBands = [bands.0, bands.1, bands.2, bands.3].map(display)
 
                 // Shift samples left and append the new value.
                 self.meteringSamples.removeFirst()
@@ -424,6 +736,30 @@ final class AppState {
         meteringTimer = nil
     }
 
+    // MARK: - Live Captions
+
+    /// Caption the recording in the overlay as it is captured. Best effort:
+    /// the core backs off (or skips decodes) whenever transcription needs
+    /// the cores, so the final transcript is never delayed by it.
+    private func startLiveCaptions() {
+        liveCaptionStable = ""
+        liveCaptionPartial = ""
+        guard Config.liveCaptionsDuringRecording, whisperBridge.isModelLoaded() else { return }
+        whisperBridge.startLiveCaptions(fromCapture: audioManager.captureBuffer) { [weak self] stable, partial in
+            Task { @MainActor [weak self] in
+                guard let self, self.isRecording else { return }
+                self.liveCaptionStable = stable
+                self.liveCaptionPartial = partial
+            }
+        }
+    }
+
+    private func stopLiveCaptions() {
+        whisperBridge.stopLiveCaptions()
+        liveCaptionStable = ""
+        liveCaptionPartial = ""
+    }
+
     // MARK: - Elapsed Timer
 
     private func startElapsedTimer() {
@@ -9,82 +9,59 @@
 
 @preconcurrency import AVFoundation
 import Foundation
-
-/// Thread-safe buffer that accumulates PCM data from the audio render thread
-/// and delivers 35-second chunks back to the main thread.
+import VoiceRecorderBridge
+
+/// Hands PCM from the audio render thread to the C++ capture ring
+/// (VRCaptureBuffer), which slices it into 35-second chunks on its own
+/// consumer thread. Chunks are delivered back to the main thread.
+///
+/// The render thread only calls `append`, which goes straight to
+/// VRCaptureWrite: no lock, no allocation, no Obj-C message send.
 private final class AudioBuffer: @unchecked Sendable {
-    private let lock = NSLock()
-    private var buffer = Data()
-    private var _chunkIndex = 0
-    private var _currentLevel: Float = 0
+    let capture: VRCaptureBuffer
+    private let producer: VRCaptureProducerRef
 
-    let maxChunkBytes: Int
     var onChunkReady: ((Data, Int) -> Void)?
 
-    init(maxChunkBytes: Int) {
-        self.maxChunkBytes = maxChunkBytes
+    init(chunkSamples: Int) {
+        capture = VRCaptureBuffer(chunkSamples: chunkSamples)
+        producer = capture.producer
+        capture.onChunk = { [weak self] data, idx in
+            DispatchQueue.main.async {
+                self?.onChunkReady?(data, idx)
+            }
+        }
     }
 
     var currentLevel: Float {
-        lock.lock()
-        let level = _currentLevel
-        lock.unlock()
-        return level
+        currentLevels.rms
     }
 
-    var chunkIndex: Int {
-        lock.lock()
-        let idx = _chunkIndex
-        lock.unlock()
-        return idx
+    var currentLevels: VRMeterLevels {
+        capture.currentLevels
     }
 
-    func reset() {
-        lock.lock()
-        buffer = Data()
-        _chunkIndex = 0
-        _currentLevel = 0
-        lock.unlock()
+    var chunkIndex: Int {
+        capture.chunkIndex
     }
 
-    func setLevel(_ level: Float) {
-        lock.lock()
-        _currentLevel = level
-        lock.unlock()
+    /// Reset the chunk index and start the chunking thread. Called from main thread.
+    func start() {
+        capture.start()
     }
 
-    /// Append PCM data and check for chunk boundary. Called from audio thread.
-    func append(_ data: Data) {
-        lock.lock()
-        buffer.append(data)
-        let currentSize = buffer.count
-        lock.unlock()
-
-        if currentSize >= maxChunkBytes {
-            lock.lock()
-            let chunkData = Data(buffer.prefix(maxChunkBytes))
-            buffer = Data(buffer.dropFirst(maxChunkBytes))
-            let idx = _chunkIndex
-            _chunkIndex += 1
-            lock.unlock()
-
-            DispatchQueue.main.async { [weak self] in
-                self?.onChunkReady?(chunkData, idx)
-            }
-        }
+    /// Meter and enqueue samples. Called from audio thread.
+    func append(_ samples: UnsafePointer<Float>, count: Int) {
+        VRCaptureWrite(producer, samples, count)
     }
 
-    /// Flush remaining buffer as final chunk. Called from main thread.
-    func flush() -> (Data, Int)? {
-        lock.lock()
-        let remaining = buffer
-        buffer = Data()
-        let idx = _chunkIndex
-        _chunkIndex += 1
-        lock.unlock()
-
-        guard !remaining.isEmpty else { return nil }
-        return (remaining, idx)
+    /// Stop the chunking thread and return every chunk still buffered, in
+    /// order: full chunks not yet delivered, then the final partial one.
+    /// Called from main thread once the tap is removed.
+    func flush() -> [(Data, Int)] {
+        var first = 0
+        let remaining = capture.stop(withFirstChunkIndex: &first)
+        return remaining.enumerated().map { ($0.element, first + $0.offset) }
     }
 }
 
@@ -101,6 +78,11 @@ final class AudioManager {
         audioBuffer.currentLevel
     }
 
+    /// The capture ring, for readers of the live audio (live captions).
+    var captureBuffer: VRCaptureBuffer {
+        audioBuffer.capture
+    }
+
     // MARK: - Callbacks
 
     /// Called on main queue when a 35-second PCM chunk is ready.
@@ -115,7 +97,7 @@ final class AudioManager {
 
     /// Thread-safe accumulation buffer for PCM data.
     private let audioBuffer = AudioBuffer(
-        maxChunkBytes: Config.burstLengthSeconds * Config.transcriptionSampleRate * MemoryLayout<Float>.size
+        chunkSamples: Config.burstLengthSeconds * Config.transcriptionSampleRate
     )
 
     /// The 16kHz mono format we record into (non-interleaved for AVAudioPCMBuffer compat).
@@ -137,8 +119,6 @@ final class AudioManager {
     func startRecording() -> Bool {
         guard !isRecording else { return true }
 
-        audioBuffer.reset()
-
         let inputNode = engine.inputNode
         let nativeFormat = inputNode.outputFormat(forBus: 0)
 
@@ -157,11 +137,27 @@ final class AudioManager {
             return false
         }
 
+        // Conversion output buffer, allocated once here instead of per tap
+        // callback. Sized for taps well beyond the requested 4096 frames.
+        let ratio = recordingFormat.sampleRate / nativeFormat.sampleRate
+        guard let outputBuffer = AVAudioPCMBuffer(
+            pcmFormat: recordingFormat,
+            frameCapacity: AVAudioFrameCount(Double(Self.maxTapFrames) * ratio) + 16
+        ) else {
+            log.error("AudioManager: failed to allocate conversion buffer")
+            return false
+        }
+
         let audioBuffer = self.audioBuffer
         let recFormat = self.recordingFormat
 
+        audioBuffer.start()
+
         inputNode.installTap(onBus: 0, bufferSize: 4096, format: nativeFormat) { buffer, _ in
-            AudioManager.processTapBuffer(buffer, converter: converter, recordingFormat: recFormat, audioBuffer: audioBuffer)
+            AudioManager.processTapBuffer(
+                buffer, converter: converter, recordingFormat: recFormat,
+                outputBuffer: outputBuffer, audioBuffer: audioBuffer
+            )
         }
 
         do {
@@ -172,30 +168,32 @@ final class AudioManager {
         } catch {
             log.error("AudioManager: failed to start engine: \(error)")
             inputNode.removeTap(onBus: 0)
+            _ = audioBuffer.flush()
             return false
         }
     }
 
-    /// Stop recording and flush the final partial chunk.
-    /// Returns the final flush data and chunk index so the caller can store it
-    /// synchronously before starting transcription. Returns nil if no data remained.
-    func stopRecording() -> (Data, Int)? {
-        guard isRecording else { return nil }
+    /// Stop recording and flush everything still buffered.
+    /// Returns the remaining chunks (normally just the final partial one) in
+    /// index order so the caller can store them synchronously before starting
+    /// transcription. Empty if no data remained.
+    func stopRecording() -> [(Data, Int)] {
+        guard isRecording else { return [] }
 
         engine.inputNode.removeTap(onBus: 0)
         engine.stop()
         isRecording = false
 
-        let finalChunk = audioBuffer.flush()
+        let finalChunks = audioBuffer.flush()
         let totalChunks = audioBuffer.chunkIndex
 
-        if let (data, idx) = finalChunk {
-            log.info("AudioManager: recording stopped, final chunk \(idx) = \(data.count) bytes, \(totalChunks) chunk(s) total")
+        if let (data, idx) = finalChunks.last {
+            log.info("AudioManager: recording stopped, final chunk \(idx) = \(data.count) bytes, \(finalChunks.count) flushed, \(totalChunks) chunk(s) total")
         } else {
             log.warning("AudioManager: recording stopped, no data in final flush, \(totalChunks) chunk(s) total")
         }
 
-        return finalChunk
+        return finalChunks
     }
 
     /// Current metering level. Thread-safe.
@@ -203,22 +201,39 @@ final class AudioManager {
         audioBuffer.currentLevel
     }
 
+    /// Current RMS, peak, and band levels. Thread-safe.
+    func getMeteringLevels() -> VRMeterLevels {
+        audioBuffer.currentLevels
+    }
+
     // MARK: - Tap Processing (background audio thread)
 
-    /// Called on the audio render thread. Converts to 16kHz mono, computes RMS,
-    /// accumulates into chunk buffer, and fires chunk callback at 35s boundaries.
+    /// Largest native tap buffer the preallocated conversion buffer covers.
+    private nonisolated static let maxTapFrames = 16384
+
+    /// Called on the audio render thread. Converts to 16kHz mono into the
+    /// preallocated `outputBuffer`, then hands the samples to the capture
+    /// ring, which meters them and cuts 35s chunks on its own thread.
     private static nonisolated func processTapBuffer(
         _ buffer: AVAudioPCMBuffer,
         converter: AVAudioConverter,
         recordingFormat: AVAudioFormat,
+        outputBuffer preallocated: AVAudioPCMBuffer,
         audioBuffer: AudioBuffer
     ) {
         guard buffer.frameLength > 0 else { return }
 
-        // Calculate output capacity based on sample rate ratio.
+        // Reuse the preallocated buffer; only an unusually large tap
+        // buffer falls back to allocating.
         let ratio = recordingFormat.sampleRate / buffer.format.sampleRate
         let outputFrameCapacity = AVAudioFrameCount(Double(buffer.frameLength) * ratio) + 16
-        guard let outputBuffer = AVAudioPCMBuffer(pcmFormat: recordingFormat, frameCapacity: outputFrameCapacity) else { return }
+        let outputBuffer: AVAudioPCMBuffer
+        if outputFrameCapacity <= preallocated.frameCapacity {
+            outputBuffer = preallocated
+        } else {
+            guard let grown = AVAudioPCMBuffer(pcmFormat: recordingFormat, frameCapacity: outputFrameCapacity) else { return }
+            outputBuffer = grown
+        }
 
         // Convert: the input block provides our buffer exactly once.
         var error: NSError?
@@ -240,19 +255,8 @@ final class AudioManager {
         guard let channelData = outputBuffer.floatChannelData else { return }
         let frameCount = Int(outputBuffer.frameLength)
 
-        // Compute RMS for metering.
-        let samples = channelData[0]
-        var sum: Float = 0
-        for i in 0..<frameCount {
-            sum += samples[i] * samples[i]
-        }
-        let rms = sqrtf(sum / Float(frameCount))
-        audioBuffer.setLevel(rms)
-
-        // Copy PCM data and accumulate.
-        let byteCount = frameCount * MemoryLayout<Float>.size
-        let pcmData = Data(bytes: samples, count: byteCount)
-        audioBuffer.append(pcmData)
+        // Meter (RMS, peak, bands) and copy into the lock-free ring.
+        audioBuffer.append(channelData[0], count: frameCount)
     }
 
     // MARK: - PCM Utilities
@@ -31,12 +31,21 @@ enum Config {
         "\(whisperModelName).\(whisperModelExtension)"
     }
 
+    /// Optional fast-tier model (short dictations), used when present.
+    static let fastWhisperModelName = "ggml-tiny.en"
+
+    /// Optional accurate-tier model (retries, crash recovery), used when present.
+    static let accurateWhisperModelName = "ggml-small.en"
+
     /// Resolves the model path dynamically from bundle or project tree.
-    /// Returns nil if model cannot be found.
-    static func resolveModelPath() -> String? {
+    /// Returns nil if model cannot be found. Pass `required: false` for
+    /// optional models to skip the not-found error log.
+    static func resolveModelPath(named modelName: String = whisperModelName,
+                                 required: Bool = true) -> String? {
+        let whisperModelFilename = "\(modelName).\(whisperModelExtension)"
         var candidates: [String] = [
             // Bundled in .app/Contents/Resources/
-            Bundle.main.path(forResource: whisperModelName, ofType: whisperModelExtension),
+            Bundle.main.path(forResource: modelName, ofType: whisperModelExtension),
             // .app/Contents/Resources/models/
             Bundle.main.resourceURL?
                 .appendingPathComponent("models")
@@ -66,7 +75,7 @@ enum Config {
         let cwd = FileManager.default.currentDirectoryPath
         candidates.append(cwd + "/Resources/models/" + whisperModelFilename)
 
-        log.info("Searching \(candidates.count) candidate paths for whisper model...")
+        log.info("Searching \(candidates.count) candidate paths for \(whisperModelFilename)...")
         for (i, path) in candidates.enumerated() {
             let exists = FileManager.default.fileExists(atPath: path)
             if exists {
@@ -75,6 +84,10 @@ enum Config {
             }
         }
 
+        guard required else {
+            log.info("Optional model \(whisperModelFilename) not found")
+            return nil
+        }
         log.error("Whisper model not found after searching \(candidates.count) paths.")
         for (i, path) in candidates.enumerated() {
             log.error("  [\(i)] \(path)")
@@ -101,6 +114,25 @@ enum Config {
         applicationSupportDirectory.appendingPathComponent("database.db").path
     }
 
+    /// Move each completed session's audio out of the database into an
+    /// archive file (a float WAV under `archives/`), keeping the database
+    /// small; the database keeps only metadata and the file name.
+    static let archiveSessionAudio = true
+
+    /// File extension of exported / archived sessions.
+    static let sessionArchiveExtension = "vrsession"
+
+    /// Export archives as FLAC (about a quarter of the size of float PCM).
+    static let compressExportedArchives = true
+
+    /// Columns in a history row's waveform thumbnail.
+    static let waveformThumbnailBars = 48
+
+    /// Per-model inference thread counts picked by the engine's calibration.
+    static var threadCalibrationPath: String {
+        applicationSupportDirectory.appendingPathComponent("thread-calibration.txt").path
+    }
+
     // MARK: Audio
 
     /// Transcription sample rate (whisper.cpp requirement).
@@ -110,9 +142,31 @@ enum Config {
     /// Whisper produces 0 segments for very short audio (< ~1s), so skip those.
     static let minimumTranscriptionDuration: Float = 1.0
 
+    /// Re-transcribe each session in the background with the accurate model
+    /// and beam search, replacing the pasted draft in history.
+    static let refineTranscriptsInBackground = true
+
+    /// Segments whose mean token probability is below this are re-run by
+    /// AppState.retranscribeLowConfidenceSegments(sessionId:).
+    static let lowConfidenceThreshold: Float = 0.5
+
+    /// Low-confidence segments closer together than this (ms) are
+    /// re-transcribed as one range.
+    static let lowConfidenceMergeGapMs: Int = 2000
+
     /// Maximum burst length in seconds before flushing to disk.
     static let burstLengthSeconds: Int = 35
 
+    /// Audio (ms) each streamed chunk re-transcribes from the end of the
+    /// previous one, so words split by the chunk boundary come out whole.
+    /// One second costs under 3% extra inference per 35 s chunk.
+    static let streamOverlapMs: Int = 1000
+
+    /// Show live captions in the floating overlay while recording: the last
+    /// few seconds re-decoded on the fast model about twice a second,
+    /// backing off whenever the real transcription needs the cores.
+    static let liveCaptionsDuringRecording = true
+
     /// Metering poll interval in seconds.
     static let meteringPollInterval: TimeInterval = 0.05
 
@@ -120,4 +174,12 @@ enum Config {
 
     /// Number of metering samples to keep for waveform display.
     static let meteringSampleCount: Int = 100
+
+    // MARK: History
+
+    /// Sessions fetched per history page (summaries only, no transcripts).
+    static let historyPageSize: Int = 100
+
+    /// Maximum number of full-text search results shown.
+    static let searchResultLimit: Int = 50
 }
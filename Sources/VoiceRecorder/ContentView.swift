@@ -86,7 +86,7 @@ struct ContentView: View {
     @ViewBuilder
     private var detailContent: some View {
         if let sessionId = selectedSessionId,
-           let session = appState.sessions.first(where: { $0.sessionId == sessionId }) {
+           let session = appState.session(withId: sessionId) {
             SessionDetailView(session: session)
         } else {
             VStack(spacing: 16) {
@@ -173,8 +173,12 @@ struct ContentView: View {
                 .frame(width: 12, height: 12)
                 .modifier(OverlayPulse())
 
-            WaveformView.expanded(samples: appState.meteringSamples, color: .green)
-                .frame(width: 300, height: 80)
+            HStack(spacing: 8) {
+                WaveformView.expanded(samples: appState.meteringSamples, color: .green)
+                    .frame(width: 300, height: 80)
+                BandMeterView(levels: appState.meteringBands, barColor: .green)
+                    .frame(width: 28, height: 80)
+            }
 
             Text(formattedElapsed)
                 .font(.system(size: 28, weight: .light, design: .monospaced))
@@ -225,6 +229,9 @@ private struct SessionDetailView: View {
     let session: VRSession
     @Environment(AppState.self) private var appState
 
+    /// Full transcript, loaded lazily (history rows only carry a preview).
+    @State private var transcript: String?
+
     var body: some View {
         ScrollView {
             VStack(alignment: .leading, spacing: 16) {
@@ -253,7 +260,7 @@ private struct SessionDetailView: View {
                             .font(.body)
                             .foregroundStyle(.orange)
                     }
-                } else if let transcript = session.transcript, !transcript.isEmpty {
+                } else if let transcript, !transcript.isEmpty {
                     Text(transcript)
                         .font(.body)
                         .textSelection(.enabled)
@@ -274,6 +281,10 @@ private struct SessionDetailView: View {
             }
             .padding(20)
         }
+        // Reload when the selection changes or the session finishes transcribing.
+        .task(id: "\(session.sessionId)|\(session.status)") {
+            transcript = session.transcript ?? appState.transcript(for: session.sessionId)
+        }
     }
 
     private var formattedDate: String {
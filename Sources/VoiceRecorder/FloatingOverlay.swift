@@ -5,7 +5,8 @@
 //  NSPanel-based floating window that stays above all other windows.
 //
 //  Layout (overlay only appears during recording, fades after paste):
-//  - Recording:     Red dot + waveform + elapsed timer + stop button
+//  - Recording:     Red dot + waveform + elapsed timer + stop button,
+//                   with a one-line live caption underneath once speech is heard
 //  - Transcribing:  Progress bar + percentage
 //  - Done:          Checkmark + "Pasted" (shown briefly before fade-out)
 //  - Error:         Red banner shown briefly when something fails
@@ -247,6 +248,16 @@ struct FloatingOverlayContent: View {
     // MARK: - Recording
 
     private var recordingView: some View {
+        VStack(alignment: .leading, spacing: 4) {
+            recordingControls
+
+            if !appState.liveCaptionStable.isEmpty || !appState.liveCaptionPartial.isEmpty {
+                liveCaptionView
+            }
+        }
+    }
+
+    private var recordingControls: some View {
         HStack(spacing: 8) {
             // Pulsing red dot.
             Circle()
@@ -281,6 +292,20 @@ struct FloatingOverlayContent: View {
         }
     }
 
+    /// Settled caption text, then the tentative words dimmed. Truncated at
+    /// the head so the newest words stay visible.
+    private var liveCaptionView: some View {
+        let stable = appState.liveCaptionStable
+        let partial = appState.liveCaptionPartial
+        let separator = !stable.isEmpty && !partial.isEmpty ? " " : ""
+        return (Text(stable + separator) + Text(partial).foregroundColor(.secondary))
+            .font(.system(size: 11))
+            .foregroundStyle(.primary)
+            .lineLimit(1)
+            .truncationMode(.head)
+            .frame(width: 300, alignment: .leading)
+    }
+
     // MARK: - Transcribing
 
     private var transcribingView: some View {
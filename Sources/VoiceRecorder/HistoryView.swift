@@ -4,10 +4,10 @@
 //
 //  Recording history browser.
 //
-//  Displays all persisted sessions in a scrollable list, newest first.
-//  Each row shows timestamp, duration, status, and a one-line transcript
-//  preview.  Expanding a row reveals the full transcript along with
-//  playback, copy, retry, and delete controls.
+//  Displays persisted sessions in a scrollable list, newest first, one page
+//  of summaries at a time.  Each row shows timestamp, duration, status, and
+//  a one-line transcript preview.  Expanding a row loads the full transcript
+//  along with playback, copy, retry, and delete controls.
 //
 
 import SwiftUI
@@ -23,7 +23,7 @@ struct HistoryView: View {
     /// Binding to the parent's selected session id for the detail pane.
     @Binding var selectedSessionId: String?
 
-    /// Search query to filter sessions by transcript content.
+    /// Full-text search query over transcripts.
     @State private var searchText = ""
 
     /// The session whose detail is currently expanded (nil = all collapsed).
@@ -67,6 +67,13 @@ struct HistoryView: View {
                                 onRetry: { appState.retryTranscription(sessionId: session.sessionId) },
                                 onDelete: { appState.deleteSession(sessionId: session.sessionId) }
                             )
+                            .onAppear {
+                                // Fetch the next page as the last row scrolls in.
+                                if searchText.isEmpty,
+                                   session.sessionId == appState.sessions.last?.sessionId {
+                                    appState.loadMoreSessions()
+                                }
+                            }
                         }
                     }
                     .padding(.vertical, 4)
@@ -76,16 +83,15 @@ struct HistoryView: View {
         .onAppear {
             appState.loadSessions()
         }
+        .onChange(of: searchText) { _, query in
+            appState.searchSessions(query)
+        }
     }
 
     // MARK: - Filtered Sessions
 
     private var filteredSessions: [VRSession] {
-        guard !searchText.isEmpty else { return appState.sessions }
-        let query = searchText.lowercased()
-        return appState.sessions.filter { session in
-            session.transcript?.lowercased().contains(query) ?? false
-        }
+        searchText.isEmpty ? appState.sessions : appState.searchResults
     }
 
     // MARK: - Helpers
@@ -103,7 +109,8 @@ struct HistoryView: View {
     }
 
     private func copyTranscript(_ session: VRSession) {
-        guard let text = session.transcript, !text.isEmpty else { return }
+        guard let text = session.transcript ?? appState.transcript(for: session.sessionId),
+              !text.isEmpty else { return }
         NSPasteboard.general.clearContents()
         NSPasteboard.general.setString(text, forType: .string)
     }
@@ -148,6 +155,13 @@ private struct SessionRow: View {
     @State private var audioPlayer: AVAudioPlayer?
     @State private var isPlaying = false
 
+    /// Full transcript, loaded when the row is expanded.
+    @State private var fullTranscript: String?
+
+    /// Thumbnail peaks from the stored waveform overview (a few hundred
+    /// bytes per row, no audio).
+    @State private var waveform: [Float] = []
+
     @Environment(AppState.self) private var appState
 
     var body: some View {
@@ -159,6 +173,10 @@ private struct SessionRow: View {
             if isExpanded {
                 detailView
                     .transition(.opacity.combined(with: .move(edge: .top)))
+                    .task(id: session.status) {
+                        fullTranscript = session.transcript
+                            ?? appState.transcript(for: session.sessionId)
+                    }
             }
         }
         .background(isExpanded ? Color.accentColor.opacity(0.04) : Color.clear)
@@ -179,7 +197,13 @@ private struct SessionRow: View {
                         .font(.system(size: 13, weight: .medium))
                         .foregroundStyle(.primary)
 
-                    if let preview = transcriptPreview {
+                    if let snippet = session.snippet {
+                        Text(highlighted(snippet))
+                            .font(.system(size: 11))
+                            .foregroundStyle(.secondary)
+                            .lineLimit(2)
+                            .truncationMode(.tail)
+                    } else if let preview = transcriptPreview {
                         Text(preview)
                             .font(.system(size: 11))
                             .foregroundStyle(.secondary)
@@ -190,6 +214,11 @@ private struct SessionRow: View {
 
                 Spacer()
 
+                if !waveform.isEmpty {
+                    WaveformView.thumbnail(samples: waveform, color: .secondary)
+                        .frame(width: 72, height: 18)
+                }
+
                 Text(formattedDuration)
                     .font(.system(size: 12, weight: .regular, design: .monospaced))
                     .foregroundStyle(.tertiary)
@@ -204,6 +233,10 @@ private struct SessionRow: View {
             .contentShape(Rectangle())
         }
         .buttonStyle(.plain)
+        .task(id: session.durationMs) {
+            waveform = appState.waveform(for: session.sessionId,
+                                         bars: Config.waveformThumbnailBars)
+        }
     }
 
     // MARK: - Detail View
@@ -214,7 +247,7 @@ private struct SessionRow: View {
                 .padding(.horizontal, 10)
 
             // Full transcript.
-            if let transcript = session.transcript, !transcript.isEmpty {
+            if let transcript = fullTranscript, !transcript.isEmpty {
                 ScrollView {
                     Text(transcript)
                         .font(.system(size: 13))
@@ -250,7 +283,7 @@ private struct SessionRow: View {
                     Label("Copy", systemImage: "doc.on.doc")
                 }
                 .buttonStyle(.bordered)
-                .disabled(session.transcript?.isEmpty ?? true)
+                .disabled(fullTranscript?.isEmpty ?? true)
 
                 // Retry transcription.
                 Button {
@@ -317,7 +350,8 @@ private struct SessionRow: View {
     }
 
     private var transcriptPreview: String? {
-        guard let transcript = session.transcript, !transcript.isEmpty else { return nil }
+        guard let transcript = session.preview ?? session.transcript,
+              !transcript.isEmpty else { return nil }
         // Return the first line, trimmed.
         return transcript
             .components(separatedBy: .newlines)
@@ -325,6 +359,27 @@ private struct SessionRow: View {
             .trimmingCharacters(in: .whitespaces)
     }
 
+    /// Render a search snippet, bolding the terms FTS5 marked as matches.
+    private func highlighted(_ snippet: String) -> AttributedString {
+        var result = AttributedString()
+        var isMatch = false
+        var rest = Substring(snippet)
+        while !rest.isEmpty {
+            let marker = isMatch ? VRSnippetHighlightClose : VRSnippetHighlightOpen
+            let range = rest.range(of: marker)
+            var piece = AttributedString(rest[..<(range?.lowerBound ?? rest.endIndex)])
+            if isMatch {
+                piece.font = .system(size: 11, weight: .semibold)
+                piece.foregroundColor = .primary
+            }
+            result += piece
+            guard let range else { break }
+            rest = rest[range.upperBound...]
+            isMatch.toggle()
+        }
+        return result
+    }
+
     // MARK: - Playback
 
     private func togglePlayback() {
@@ -336,37 +391,46 @@ private struct SessionRow: View {
     }
 
     private func startPlayback() {
-        guard let pcmData = appState.storageBridge.getAudioForSession(session.sessionId) else {
-            appState.setError("No audio data found for playback")
-            return
-        }
+        do {
+            let player: AVAudioPlayer
+            let tempURL: URL?
+            if let archiveURL = appState.storageBridge.playableAudioURL(forSession: session.sessionId) {
+                // Archived sessions are WAV files already: play in place.
+                player = try AVAudioPlayer(contentsOf: archiveURL, fileTypeHint: AVFileType.wav.rawValue)
+                tempURL = nil
+            } else {
+                guard let pcmData = appState.storageBridge.getAudioForSession(session.sessionId) else {
+                    appState.setError("No audio data found for playback")
+                    return
+                }
 
-        if pcmData.count == 0 {
-            appState.setError("Audio data is empty — cannot play")
-            return
-        }
+                if pcmData.count == 0 {
+                    appState.setError("Audio data is empty — cannot play")
+                    return
+                }
 
-        do {
-            // Wrap raw PCM in a WAV header so AVAudioPlayer can play it.
-            let wavData = AudioManager.pcmToWAV(pcmData as Data)
-            let tempURL = FileManager.default.temporaryDirectory
-                .appendingPathComponent("\(session.sessionId)_playback.wav")
-            try wavData.write(to: tempURL, options: .atomic)
+                // Wrap raw PCM in a WAV header so AVAudioPlayer can play it.
+                let wavData = AudioManager.pcmToWAV(pcmData as Data)
+                let url = FileManager.default.temporaryDirectory
+                    .appendingPathComponent("\(session.sessionId)_playback.wav")
+                try wavData.write(to: url, options: .atomic)
+                tempURL = url
+                player = try AVAudioPlayer(contentsOf: url)
+            }
 
-            let player = try AVAudioPlayer(contentsOf: tempURL)
             player.delegate = PlaybackDelegate.shared
             PlaybackDelegate.shared.onFinish = {
                 DispatchQueue.main.async {
                     self.isPlaying = false
                     self.audioPlayer = nil
-                    try? FileManager.default.removeItem(at: tempURL)
+                    if let tempURL { try? FileManager.default.removeItem(at: tempURL) }
                 }
             }
             player.prepareToPlay()
             let started = player.play()
             if !started {
                 appState.setError("AVAudioPlayer.play() returned false")
-                try? FileManager.default.removeItem(at: tempURL)
+                if let tempURL { try? FileManager.default.removeItem(at: tempURL) }
                 return
             }
             audioPlayer = player
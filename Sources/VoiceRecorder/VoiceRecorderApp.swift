@@ -12,6 +12,7 @@
 import SwiftUI
 import AppKit
 import ApplicationServices
+import UniformTypeIdentifiers
 import VoiceRecorderBridge
 
 @main
@@ -29,6 +30,8 @@ struct VoiceRecorderApp: App {
                 .onAppear {
                     loadWhisperModel()
                     recoverOrphanedSessions()
+                    backfillWaveforms()
+                    archiveStoredSessions()
                 }
         }
         .defaultSize(width: 720, height: 520)
@@ -49,6 +52,16 @@ struct VoiceRecorderApp: App {
                 .keyboardShortcut("r", modifiers: .command)
             }
 
+            CommandGroup(after: .newItem) {
+                Divider()
+                Button("Import Recordings…") {
+                    importRecordings()
+                }
+                Button("Export All Recordings…") {
+                    exportAllRecordings()
+                }
+            }
+
             CommandGroup(replacing: .help) {
                 Button("BrainPhart Voice Help") {
                     // Placeholder — could open docs URL
@@ -72,13 +85,41 @@ struct VoiceRecorderApp: App {
             return
         }
 
-        let success = appState.whisperBridge.loadModel(path)
-        if success {
-            log.info("Whisper model loaded from: \(path)")
-            appState.isModelLoaded = true
-        } else {
-            appState.setError("Failed to load whisper model from: \(path)")
-            appState.isModelLoaded = false
+        // The warm-up also benchmarks a few thread counts once per model;
+        // cache the winner so later launches skip that.
+        WhisperBridge.setThreadCalibrationCachePath(Config.threadCalibrationPath)
+        appState.whisperBridge.streamOverlapMs = Config.streamOverlapMs
+
+        // Load and warm up off the main thread so launch isn't blocked on
+        // reading weights and compiling Metal kernels. Requests made before
+        // it finishes wait inside the engine, so the model counts as loaded
+        // from here on.
+        appState.isModelLoaded = true
+        appState.whisperBridge.preloadModel(path) { success in
+            if success {
+                log.info("Whisper model loaded from: \(path)")
+            } else {
+                appState.setError("Failed to load whisper model from: \(path)")
+                appState.isModelLoaded = false
+            }
+        }
+
+        // Extra tiers are optional: short dictations route to the fast
+        // model and retries/recovery to the accurate one when installed;
+        // otherwise everything uses the default model.
+        let extraModels: [(String, VRModelTier)] = [
+            (Config.fastWhisperModelName, .fast),
+            (Config.accurateWhisperModelName, .accurate),
+        ]
+        for (name, tier) in extraModels {
+            guard let extraPath = Config.resolveModelPath(named: name, required: false) else { continue }
+            appState.whisperBridge.registerModel(extraPath, identifier: name, tier: tier) { success in
+                if success {
+                    log.info("Registered \(name) for routing")
+                } else {
+                    log.warning("Failed to load optional model \(name) from: \(extraPath)")
+                }
+            }
         }
     }
 
@@ -86,29 +127,97 @@ struct VoiceRecorderApp: App {
 
     /// On launch, any session left in "recording" status is orphaned (the app
     /// crashed or was force-quit). Re-process them so no audio is lost.
-    /// Very short recordings (< 1s) are silently deleted — they can't produce
+    /// Only the orphan list is read here; the transcription runs chunk by
+    /// chunk on WhisperBridge's background recovery worker, which yields to
+    /// any new recording and resumes from its last checkpoint, so launch
+    /// time doesn't grow with the amount of leftover audio. Very short
+    /// recordings (< 1s) are silently deleted — they can't produce
     /// meaningful transcriptions and would otherwise show confusing empty results.
     private func recoverOrphanedSessions() {
         let appState = appDelegate.appState
         let orphaned = appState.storageBridge.getOrphanedSessions()
-        guard let sessions = orphaned as? [VRSession], !sessions.isEmpty else { return }
-
-        log.info("Recovering \(sessions.count) orphaned session(s)...")
-        for session in sessions {
-            let pcmData = appState.storageBridge.getAudioForSession(session.sessionId)
-            let byteCount = pcmData?.count ?? 0
-            let sampleCount = byteCount / MemoryLayout<Float>.size
-            let durationSeconds = Float(sampleCount) / Float(Config.transcriptionSampleRate)
-
-            if durationSeconds < Config.minimumTranscriptionDuration {
-                log.info("Orphaned session \(session.sessionId) too short (\(String(format: "%.1f", durationSeconds))s) — deleting")
-                appState.deleteSession(sessionId: session.sessionId)
-                continue
+        guard !orphaned.isEmpty else { return }
+
+        log.info("Recovering \(orphaned.count) orphaned session(s) in the background")
+        appState.whisperBridge.recoverSessions(
+            orphaned.map(\.sessionId),
+            fromStorage: appState.storageBridge,
+            minimumDurationMs: Int(Config.minimumTranscriptionDuration * 1000),
+            completion: { sessionId, outcome in
+                switch outcome {
+                case .recovered: log.info("Recovered orphaned session \(sessionId)")
+                case .discarded: log.info("Orphaned session \(sessionId) too short — deleted")
+                default:         log.error("Recovering orphaned session \(sessionId) failed")
+                }
+                Task { @MainActor in appState.loadSessions() }
+            }
+        )
+    }
+
+    // MARK: - Archives
+
+    /// Compute history thumbnails for sessions recorded before waveforms
+    /// were stored with each chunk, in the background.
+    private func backfillWaveforms() {
+        appDelegate.appState.storageBridge.backfillWaveforms { backfilled in
+            if backfilled > 0 {
+                log.info("Computed waveforms for \(backfilled) session(s)")
+            }
+        }
+    }
+
+    /// Move completed sessions still stored in the database (e.g. from
+    /// before archiving existed) into archive files, in the background.
+    private func archiveStoredSessions() {
+        guard Config.archiveSessionAudio else { return }
+        appDelegate.appState.storageBridge.archiveStoredSessions { archived in
+            if archived > 0 {
+                log.info("Archived \(archived) session(s) out of the database")
             }
+        }
+    }
 
-            log.info("Orphaned session \(session.sessionId): \(String(format: "%.1f", durationSeconds))s — attempting transcription")
-            appState.retryTranscription(sessionId: session.sessionId)
+    /// Import session archives exported on this or another machine.
+    private func importRecordings() {
+        let panel = NSOpenPanel()
+        panel.title = "Import Recordings"
+        panel.allowsMultipleSelection = true
+        panel.canChooseDirectories = false
+        if let type = UTType(filenameExtension: Config.sessionArchiveExtension) {
+            panel.allowedContentTypes = [type]
         }
+        guard panel.runModal() == .OK, !panel.urls.isEmpty else { return }
+
+        let appState = appDelegate.appState
+        let requested = panel.urls.count
+        appState.storageBridge.importSessions(from: panel.urls) { sessionIds in
+            log.info("Imported \(sessionIds.count) of \(requested) recording(s)")
+            Task { @MainActor in
+                if sessionIds.count < requested {
+                    appState.setError("\(requested - sessionIds.count) file(s) could not be imported")
+                }
+                appState.loadSessions()
+            }
+        }
+    }
+
+    /// Export every recording as a session archive into a chosen folder.
+    private func exportAllRecordings() {
+        let panel = NSOpenPanel()
+        panel.title = "Export All Recordings"
+        panel.prompt = "Export"
+        panel.canChooseFiles = false
+        panel.canChooseDirectories = true
+        panel.canCreateDirectories = true
+        guard panel.runModal() == .OK, let directory = panel.url else { return }
+
+        appDelegate.appState.storageBridge.exportAllSessions(
+            toDirectory: directory,
+            compressed: Config.compressExportedArchives,
+            completion: { exported in
+                log.info("Exported \(exported) recording(s) to \(directory.path)")
+            }
+        )
     }
 }
 
@@ -82,6 +82,38 @@ struct WaveformView: View {
     }
 }
 
+// MARK: - BandMeterView
+
+/// Live per-band level meter: one vertical bar per frequency band, low band
+/// on the left. Fed from the C++ metering kernel's band levels (0.0 -- 1.0).
+struct BandMeterView: View {
+    /// Band levels, low to high.
+    let levels: [Float]
+
+    /// Colour of the meter bars.
+    var barColor: Color = .green
+
+    /// Spacing between bars in points.
+    var barSpacing: CGFloat = 2.0
+
+    var body: some View {
+        Canvas { context, size in
+            guard !levels.isEmpty else { return }
+            let count = CGFloat(levels.count)
+            let barWidth = max(1, (size.width - barSpacing * (count - 1)) / count)
+
+            for (i, level) in levels.enumerated() {
+                let height = max(1, size.height * CGFloat(min(max(level, 0), 1)))
+                let x = CGFloat(i) * (barWidth + barSpacing)
+                let rect = CGRect(x: x, y: size.height - height, width: barWidth, height: height)
+                let path = RoundedRectangle(cornerRadius: min(2, barWidth / 2)).path(in: rect)
+                context.fill(path, with: .color(barColor.opacity(0.5 + 0.5 * Double(level))))
+            }
+        }
+        .animation(.easeOut(duration: 0.08), value: levels)
+    }
+}
+
 // MARK: - WaveformStyle (convenience presets)
 
 extension WaveformView {
@@ -97,6 +129,18 @@ extension WaveformView {
         )
     }
 
+    /// A static thumbnail of a whole recording for a history row, drawn
+    /// from its stored overview (one sample per bar).
+    static func thumbnail(samples: [Float], color: Color) -> WaveformView {
+        WaveformView(
+            samples: samples,
+            barColor: color,
+            barCount: max(1, samples.count),
+            barSpacing: 1.0,
+            minimumBarHeight: 0.05
+        )
+    }
+
     /// A larger waveform for the history detail view.
     /// Dense thin bars for detailed waveform visualization.
     static func expanded(samples: [Float], color: Color) -> WaveformView {
@@ -0,0 +1,571 @@
+// vr_bench — throughput benchmark and regression check for the C++ core.
+//
+// Times each stage of the transcription path on a fixed corpus:
+//
+//   decode      AudioConverter::m4a_to_pcm         (compressed fixtures)
+//   resample    AudioConverter::resample           (48 / 44.1 kHz → 16 kHz)
+//   transcribe  WhisperEngine::transcribe          (per model × thread count)
+//   database    DatabaseManager::add_chunk / get_chunks latency
+//   pipeline    decode → resample → transcribe → DB write, end to end
+//
+// and reports peak RSS.  Results go to stdout (or --out) as JSON.  Every
+// metric in "metrics" is lower-is-better (real-time factors, milliseconds,
+// megabytes), so two runs compare key by key; --baseline does that and
+// exits with status 2 if any metric got worse by more than --tolerance.
+//
+// The corpus is a directory of fixtures: anything FFmpeg can demux (.m4a,
+// .wav, .flac, ...) plus raw 16 kHz mono float32 files (.f32 / .pcm).
+// Without --corpus a synthetic 35 s clip stands in, which exercises every
+// stage except decode.
+//
+//   vr_bench --model Resources/models/ggml-base.en.bin --corpus corpus/
+//            --threads 0,4,8 --out base.json
+//   vr_bench --model ... --corpus ... --baseline base.json
+
+#include "AudioConverter.hpp"
+#include "CpuTopology.hpp"
+#include "DatabaseManager.hpp"
+#include "WhisperEngine.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <sys/resource.h>
+#include <unistd.h>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+constexpr int kRate = 16000;
+constexpr double kPi = 3.14159265358979323846;
+
+// ---------------------------------------------------------------------------
+// Options
+// ---------------------------------------------------------------------------
+
+struct Options {
+    std::string              corpus;
+    std::vector<std::string> models;
+    std::vector<int>         threads{0};     // 0 = the engine's automatic policy
+    int                      runs = 3;
+    int                      db_chunks = 20;
+    bool                     vad = true;
+    std::string              out;
+    std::string              baseline;
+    double                   tolerance = 0.10;
+};
+
+void usage() {
+    fprintf(stderr,
+        "usage: vr_bench [--model PATH]... [--corpus DIR] [--threads N,N,...]\n"
+        "                [--runs N] [--db-chunks N] [--no-vad] [--out FILE]\n"
+        "                [--baseline FILE] [--tolerance FRACTION]\n");
+}
+
+std::vector<int> parse_int_list(const std::string& s) {
+    std::vector<int> out;
+    std::stringstream in(s);
+    std::string item;
+    while (std::getline(in, item, ',')) {
+        if (!item.empty()) out.push_back(std::max(0, std::atoi(item.c_str())));
+    }
+    return out;
+}
+
+bool parse_options(int argc, char** argv, Options& opts) {
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        const auto value = [&]() -> const char* {
+            return i + 1 < argc ? argv[++i] : nullptr;
+        };
+        const bool takes_value = arg == "--model" || arg == "--corpus" ||
+                                 arg == "--threads" || arg == "--runs" ||
+                                 arg == "--db-chunks" || arg == "--out" ||
+                                 arg == "--baseline" || arg == "--tolerance";
+        const char* v = nullptr;
+        if (arg == "--no-vad") {
+            opts.vad = false;
+        } else if (arg == "--help" || arg == "-h") {
+            return false;
+        } else if (!takes_value) {
+            fprintf(stderr, "[vr_bench] unknown option %s\n", arg.c_str());
+            return false;
+        } else if (!(v = value())) {
+            fprintf(stderr, "[vr_bench] missing value for %s\n", arg.c_str());
+            return false;
+        } else if (arg == "--model") {
+            opts.models.emplace_back(v);
+        } else if (arg == "--corpus") {
+            opts.corpus = v;
+        } else if (arg == "--threads") {
+            opts.threads = parse_int_list(v);
+            if (opts.threads.empty()) opts.threads.push_back(0);
+        } else if (arg == "--runs") {
+            opts.runs = std::max(1, std::atoi(v));
+        } else if (arg == "--db-chunks") {
+            opts.db_chunks = std::max(1, std::atoi(v));
+        } else if (arg == "--out") {
+            opts.out = v;
+        } else if (arg == "--baseline") {
+            opts.baseline = v;
+        } else if (arg == "--tolerance") {
+            opts.tolerance = std::max(0.0, std::atof(v));
+        }
+    }
+    return true;
+}
+
+// ---------------------------------------------------------------------------
+// Timing helpers
+// ---------------------------------------------------------------------------
+
+double elapsed_ms(const std::function<void()>& fn) {
+    const auto start = std::chrono::steady_clock::now();
+    fn();
+    return std::chrono::duration<double, std::milli>(
+        std::chrono::steady_clock::now() - start).count();
+}
+
+/// Nearest-rank percentile (0-100) of `samples`.
+double percentile(std::vector<double> samples, double pct) {
+    if (samples.empty()) return 0.0;
+    std::sort(samples.begin(), samples.end());
+    const size_t rank = static_cast<size_t>(
+        std::ceil(pct / 100.0 * static_cast<double>(samples.size())));
+    return samples[std::min(samples.size() - 1, rank > 0 ? rank - 1 : 0)];
+}
+
+/// Median wall time of `runs` calls.
+double median_ms(int runs, const std::function<void()>& fn) {
+    std::vector<double> times;
+    for (int r = 0; r < runs; ++r) times.push_back(elapsed_ms(fn));
+    return percentile(std::move(times), 50.0);
+}
+
+double peak_rss_mb() {
+    struct rusage usage {};
+    getrusage(RUSAGE_SELF, &usage);
+#if defined(__APPLE__)
+    const double bytes = static_cast<double>(usage.ru_maxrss);            // bytes
+#else
+    const double bytes = static_cast<double>(usage.ru_maxrss) * 1024.0;   // KiB
+#endif
+    return bytes / (1024.0 * 1024.0);
+}
+
+// ---------------------------------------------------------------------------
+// Corpus
+// ---------------------------------------------------------------------------
+
+struct Fixture {
+    std::string        name;
+    std::string        path;         // empty for synthetic fixtures
+    bool               compressed = false;
+    std::vector<float> pcm;          // 16 kHz mono float32
+
+    double seconds() const { return static_cast<double>(pcm.size()) / kRate; }
+};
+
+/// Deterministic speech-like test signal: harmonic bursts with pauses and
+/// a little noise, so VAD and the decoder both have something to do.
+std::vector<float> synthetic_clip(double seconds) {
+    std::vector<float> pcm(static_cast<size_t>(seconds * kRate));
+    uint32_t noise = 12345;
+    for (size_t i = 0; i < pcm.size(); ++i) {
+        const double t = static_cast<double>(i) / kRate;
+        const bool voiced = std::fmod(t, 2.5) < 1.8;
+        const double f0 = 120.0 + 30.0 * std::sin(t * 1.7);
+        double v = 0.0;
+        if (voiced) {
+            for (int h = 1; h <= 6; ++h) v += std::sin(2.0 * kPi * f0 * h * t) / h;
+            v *= 0.15;
+        }
+        noise = noise * 1664525u + 1013904223u;
+        v += (static_cast<double>(noise >> 8) / 16777216.0 - 0.5) * 0.004;
+        pcm[i] = static_cast<float>(v);
+    }
+    return pcm;
+}
+
+bool read_raw_pcm(const std::string& path, std::vector<float>& pcm) {
+    std::ifstream in(path, std::ios::binary | std::ios::ate);
+    if (!in) return false;
+    const auto bytes = static_cast<size_t>(in.tellg());
+    pcm.resize(bytes / sizeof(float));
+    in.seekg(0);
+    return static_cast<bool>(in.read(reinterpret_cast<char*>(pcm.data()),
+                                     static_cast<std::streamsize>(pcm.size() * sizeof(float))));
+}
+
+std::vector<Fixture> load_corpus(const std::string& dir, const vr::AudioConverter& converter) {
+    std::vector<Fixture> corpus;
+    if (!dir.empty()) {
+        std::vector<fs::path> files;
+        std::error_code ec;
+        for (const auto& entry : fs::directory_iterator(dir, ec)) {
+            if (entry.is_regular_file()) files.push_back(entry.path());
+        }
+        if (ec) fprintf(stderr, "[vr_bench] cannot read corpus %s: %s\n",
+                        dir.c_str(), ec.message().c_str());
+        std::sort(files.begin(), files.end());
+
+        for (const auto& file : files) {
+            Fixture fx;
+            fx.name = file.filename().string();
+            fx.path = file.string();
+            const std::string ext = file.extension().string();
+            if (ext == ".f32" || ext == ".pcm") {
+                if (!read_raw_pcm(fx.path, fx.pcm)) fx.pcm.clear();
+            } else {
+                fx.compressed = true;
+                fx.pcm = converter.m4a_to_pcm(fx.path, kRate);
+            }
+            if (fx.pcm.empty()) {
+                fprintf(stderr, "[vr_bench] skipping unreadable fixture %s\n", fx.name.c_str());
+                continue;
+            }
+            corpus.push_back(std::move(fx));
+        }
+    }
+    if (corpus.empty()) {
+        fprintf(stderr, "[vr_bench] no corpus fixtures; using a synthetic 35 s clip\n");
+        Fixture fx;
+        fx.name = "synthetic-35s";
+        fx.pcm  = synthetic_clip(vr::WhisperEngine::kStreamWindowSec);
+        corpus.push_back(std::move(fx));
+    }
+    return corpus;
+}
+
+// ---------------------------------------------------------------------------
+// JSON
+// ---------------------------------------------------------------------------
+
+std::string json_string(const std::string& s) {
+    std::string out = "\"";
+    for (char c : s) {
+        switch (c) {
+            case '"':  out += "\\\""; break;
+            case '\\': out += "\\\\"; break;
+            case '\n': out += "\\n";  break;
+            case '\t': out += "\\t";  break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20) {
+                    char buf[8];
+                    snprintf(buf, sizeof(buf), "\\u%04x", c);
+                    out += buf;
+                } else {
+                    out += c;
+                }
+        }
+    }
+    return out + "\"";
+}
+
+std::string json_number(double v) {
+    if (!std::isfinite(v)) return "null";
+    char buf[32];
+    snprintf(buf, sizeof(buf), "%.6g", v);
+    return buf;
+}
+
+/// Read the flat "metrics" object back out of a previous report.  Only
+/// understands what write_report() emits: one `"key": number` per line.
+std::map<std::string, double> read_baseline(const std::string& path) {
+    std::map<std::string, double> metrics;
+    std::ifstream in(path);
+    std::string line;
+    bool inside = false;
+    while (std::getline(in, line)) {
+        if (!inside) {
+            inside = line.find("\"metrics\"") != std::string::npos;
+            continue;
+        }
+        if (line.find('}') != std::string::npos) break;
+        const size_t k0 = line.find('"');
+        const size_t k1 = k0 == std::string::npos ? k0 : line.find('"', k0 + 1);
+        const size_t colon = k1 == std::string::npos ? k1 : line.find(':', k1);
+        if (colon == std::string::npos) continue;
+        const std::string value = line.substr(colon + 1);
+        if (value.find("null") != std::string::npos) continue;
+        metrics[line.substr(k0 + 1, k1 - k0 - 1)] = std::atof(value.c_str());
+    }
+    return metrics;
+}
+
+// ---------------------------------------------------------------------------
+// Benchmarks
+// ---------------------------------------------------------------------------
+
+using Metrics = std::map<std::string, double>;
+
+void bench_decode(const std::vector<Fixture>& corpus, const vr::AudioConverter& converter,
+                  int runs, Metrics& m) {
+    for (const auto& fx : corpus) {
+        if (!fx.compressed) continue;
+        const double ms = median_ms(runs, [&] { converter.m4a_to_pcm(fx.path, kRate); });
+        m["decode/" + fx.name + "/rtf"] = ms / 1000.0 / fx.seconds();
+        fprintf(stderr, "[vr_bench] decode %s: %.1f ms\n", fx.name.c_str(), ms);
+    }
+}
+
+void bench_resample(int runs, Metrics& m) {
+    const std::vector<float> clip = synthetic_clip(60.0);
+    for (int rate : {48000, 44100}) {
+        // Upsample once untimed to get a realistic input at `rate`.
+        const std::vector<float> input = vr::AudioConverter::resample(clip, kRate, rate);
+        const double ms = median_ms(runs, [&] {
+            vr::AudioConverter::resample(input, rate, kRate);
+        });
+        m["resample/" + std::to_string(rate) + "-16000/rtf"] = ms / 1000.0 / 60.0;
+        fprintf(stderr, "[vr_bench] resample %d -> 16000 (60 s): %.2f ms\n", rate, ms);
+    }
+}
+
+void bench_transcribe(const Options& opts, const std::vector<Fixture>& corpus, Metrics& m) {
+    for (const auto& model : opts.models) {
+        const std::string tag = fs::path(model).stem().string();
+        vr::WhisperEngine engine;
+        engine.set_vad_enabled(opts.vad);
+
+        // preload() includes the warm-up inference (and thread calibration),
+        // so the timed runs below see a hot model.
+        bool loaded = false;
+        const double load_ms = elapsed_ms([&] { loaded = engine.preload(model).get(); });
+        if (!loaded) {
+            fprintf(stderr, "[vr_bench] failed to load model %s\n", model.c_str());
+            continue;
+        }
+        m["model/" + tag + "/load_ms"] = load_ms;
+
+        for (int threads : opts.threads) {
+            engine.set_thread_count(threads);
+            const std::string variant = threads > 0
+                ? "t" + std::to_string(threads)
+                : "auto";   // the resolved count is logged below
+            for (const auto& fx : corpus) {
+                const double ms = median_ms(opts.runs, [&] {
+                    engine.transcribe(fx.pcm.data(), fx.pcm.size(), kRate);
+                });
+                m["transcribe/" + tag + "/" + variant + "/" + fx.name + "/rtf"] =
+                    ms / 1000.0 / fx.seconds();
+                fprintf(stderr, "[vr_bench] transcribe %s %s (%d threads) %s: %.0f ms, RTF %.3f\n",
+                        tag.c_str(), variant.c_str(), engine.thread_count(),
+                        fx.name.c_str(), ms, ms / 1000.0 / fx.seconds());
+            }
+        }
+    }
+}
+
+std::vector<uint8_t> pcm_bytes(const float* samples, size_t count) {
+    const auto* p = reinterpret_cast<const uint8_t*>(samples);
+    return std::vector<uint8_t>(p, p + count * sizeof(float));
+}
+
+void bench_database(const Options& opts, const std::string& db_path, Metrics& m) {
+    vr::DatabaseManager db(db_path);
+    if (!db.open()) {
+        fprintf(stderr, "[vr_bench] cannot open database %s\n", db_path.c_str());
+        return;
+    }
+
+    // Recording-sized chunks (35 s), encoded with the default storage codec.
+    const std::vector<float> chunk = synthetic_clip(vr::WhisperEngine::kStreamWindowSec);
+    const std::vector<uint8_t> bytes = pcm_bytes(chunk.data(), chunk.size());
+    const int64_t chunk_ms = static_cast<int64_t>(vr::WhisperEngine::kStreamWindowSec) * 1000;
+
+    const std::string session = db.create_session();
+    std::vector<double> add_times;
+    for (int i = 0; i < opts.db_chunks; ++i) {
+        add_times.push_back(elapsed_ms([&] { db.add_chunk(session, i, bytes, chunk_ms); }));
+    }
+
+    std::vector<double> get_times;
+    for (int r = 0; r < opts.runs; ++r) {
+        get_times.push_back(elapsed_ms([&] { db.get_chunks(session); }));
+    }
+
+    m["db/add_chunk/p50_ms"] = percentile(add_times, 50.0);
+    m["db/add_chunk/p95_ms"] = percentile(add_times, 95.0);
+    m["db/add_chunk/max_ms"] = percentile(add_times, 100.0);
+    m["db/get_chunks/p50_ms"] = percentile(get_times, 50.0);
+    fprintf(stderr, "[vr_bench] add_chunk p50 %.2f ms p95 %.2f ms; get_chunks(%d) p50 %.2f ms\n",
+            m["db/add_chunk/p50_ms"], m["db/add_chunk/p95_ms"], opts.db_chunks,
+            m["db/get_chunks/p50_ms"]);
+    db.close();
+}
+
+/// One session through every stage, as the app runs it: decode the
+/// fixture, store it as 35 s chunks, read the audio back, transcribe,
+/// and save the transcript.
+void bench_pipeline(const Options& opts, const std::vector<Fixture>& corpus,
+                    const vr::AudioConverter& converter, const std::string& db_path,
+                    Metrics& m) {
+    if (opts.models.empty()) return;
+    vr::WhisperEngine engine;
+    engine.set_vad_enabled(opts.vad);
+    if (!engine.preload(opts.models.front()).get()) return;
+
+    vr::DatabaseManager db(db_path);
+    if (!db.open()) return;
+
+    const size_t chunk_samples = static_cast<size_t>(vr::WhisperEngine::kStreamWindowSec) * kRate;
+    for (const auto& fx : corpus) {
+        const double ms = median_ms(opts.runs, [&] {
+            const std::vector<float> pcm = fx.compressed ? converter.m4a_to_pcm(fx.path, kRate)
+                                                         : fx.pcm;
+            const std::string session = db.create_session();
+            for (size_t off = 0, i = 0; off < pcm.size(); off += chunk_samples, ++i) {
+                const size_t n = std::min(chunk_samples, pcm.size() - off);
+                db.add_chunk(session, static_cast<int>(i), pcm_bytes(pcm.data() + off, n),
+                             static_cast<int64_t>(n) * 1000 / kRate);
+            }
+            std::vector<float> audio;
+            for (const auto& c : db.get_chunks(session)) {
+                const auto* s = reinterpret_cast<const float*>(c.audio_data.data());
+                audio.insert(audio.end(), s, s + c.audio_data.size() / sizeof(float));
+            }
+            const std::string text = engine.transcribe(audio.data(), audio.size(), kRate);
+            db.update_transcript(session, text, static_cast<int64_t>(audio.size()) * 1000 / kRate);
+        });
+        m["pipeline/" + fx.name + "/rtf"] = ms / 1000.0 / fx.seconds();
+        fprintf(stderr, "[vr_bench] pipeline %s: %.0f ms\n", fx.name.c_str(), ms);
+    }
+    db.close();
+}
+
+// ---------------------------------------------------------------------------
+// Report
+// ---------------------------------------------------------------------------
+
+struct Regression {
+    std::string key;
+    double      baseline;
+    double      current;
+};
+
+std::vector<Regression> compare(const Metrics& current, const Metrics& baseline,
+                                double tolerance) {
+    std::vector<Regression> out;
+    for (const auto& [key, value] : current) {
+        const auto it = baseline.find(key);
+        if (it == baseline.end() || it->second <= 0.0) continue;
+        if (value > it->second * (1.0 + tolerance)) {
+            out.push_back({key, it->second, value});
+        }
+    }
+    return out;
+}
+
+std::string write_report(const Options& opts, const Metrics& metrics,
+                         const std::vector<Regression>* regressions) {
+    const vr::CpuTopology& cpu = vr::CpuTopology::current();
+    std::ostringstream js;
+    js << "{\n";
+    js << "  \"schema\": 1,\n";
+    js << "  \"host\": {\"performance_cores\": " << cpu.performance_cores
+       << ", \"efficiency_cores\": " << cpu.efficiency_cores
+       << ", \"logical_cores\": " << cpu.logical_cores << "},\n";
+    js << "  \"config\": {\"runs\": " << opts.runs
+       << ", \"db_chunks\": " << opts.db_chunks
+       << ", \"vad\": " << (opts.vad ? "true" : "false")
+#if defined(NDEBUG)
+       << ", \"optimized\": true"
+#else
+       << ", \"optimized\": false"
+#endif
+       << ", \"models\": [";
+    for (size_t i = 0; i < opts.models.size(); ++i) {
+        js << (i ? ", " : "") << json_string(opts.models[i]);
+    }
+    js << "]},\n";
+
+    // One metric per line: read_baseline() depends on it.
+    js << "  \"metrics\": {\n";
+    size_t n = 0;
+    for (const auto& [key, value] : metrics) {
+        js << "    " << json_string(key) << ": " << json_number(value)
+           << (++n < metrics.size() ? ",\n" : "\n");
+    }
+    js << "  }";
+
+    if (regressions) {
+        js << ",\n  \"tolerance\": " << json_number(opts.tolerance)
+           << ",\n  \"regressions\": [";
+        for (size_t i = 0; i < regressions->size(); ++i) {
+            const Regression& r = (*regressions)[i];
+            js << (i ? ",\n" : "\n") << "    {\"metric\": " << json_string(r.key)
+               << ", \"baseline\": " << json_number(r.baseline)
+               << ", \"current\": " << json_number(r.current) << "}";
+        }
+        js << (regressions->empty() ? "]" : "\n  ]");
+    }
+    js << "\n}\n";
+    return js.str();
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    Options opts;
+    if (!parse_options(argc, argv, opts)) {
+        usage();
+        return 1;
+    }
+
+    vr::AudioConverter converter;
+    const std::vector<Fixture> corpus = load_corpus(opts.corpus, converter);
+
+    const std::string db_path =
+        (fs::temp_directory_path() / ("vr_bench-" + std::to_string(getpid()) + ".db")).string();
+
+    Metrics metrics;
+    bench_decode(corpus, converter, opts.runs, metrics);
+    bench_resample(opts.runs, metrics);
+    bench_database(opts, db_path, metrics);
+    bench_transcribe(opts, corpus, metrics);
+    bench_pipeline(opts, corpus, converter, db_path, metrics);
+    metrics["peak_rss_mb"] = peak_rss_mb();
+
+    for (const char* suffix : {"", "-wal", "-shm"}) {
+        std::error_code ec;
+        fs::remove(db_path + suffix, ec);
+    }
+
+    std::vector<Regression> regressions;
+    if (!opts.baseline.empty()) {
+        const Metrics baseline = read_baseline(opts.baseline);
+        if (baseline.empty()) {
+            fprintf(stderr, "[vr_bench] no metrics in baseline %s\n", opts.baseline.c_str());
+        }
+        regressions = compare(metrics, baseline, opts.tolerance);
+        for (const auto& r : regressions) {
+            fprintf(stderr, "[vr_bench] REGRESSION %s: %.4g -> %.4g (+%.0f%%)\n",
+                    r.key.c_str(), r.baseline, r.current,
+                    (r.current / r.baseline - 1.0) * 100.0);
+        }
+    }
+
+    const std::string report = write_report(
+        opts, metrics, opts.baseline.empty() ? nullptr : &regressions);
+    if (opts.out.empty()) {
+        fputs(report.c_str(), stdout);
+    } else {
+        std::ofstream(opts.out) << report;
+        fprintf(stderr, "[vr_bench] wrote %s\n", opts.out.c_str());
+    }
+
+    return regressions.empty() ? 0 : 2;
+}
@@ -0,0 +1,75 @@
+//
+//  CaptureBridge.h
+//  Objective-C interface wrapping the C++ CaptureBuffer (lock-free capture
+//  ring + chunking consumer thread).
+//
+//  The audio tap writes through the plain C function VRCaptureWrite() so the
+//  real-time thread never takes a lock, allocates, or sends an Obj-C message.
+//
+
+#import <Foundation/Foundation.h>
+
+#import "MeteringBridge.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+/// Opaque producer handle for VRCaptureWrite().  Valid for the lifetime of
+/// the VRCaptureBuffer that vended it.
+typedef struct VRCaptureProducer *VRCaptureProducerRef;
+
+/// Write `count` 16 kHz mono Float32 samples from the audio tap.
+/// Real-time safe: meters the buffer and copies it into a preallocated ring.
+FOUNDATION_EXPORT void VRCaptureWrite(VRCaptureProducerRef producer,
+                                      const float *samples,
+                                      NSInteger count);
+
+/// Accumulates captured PCM into fixed-size chunks off the audio thread.
+///
+/// Usage from Swift:
+/// ```swift
+/// let capture = VRCaptureBuffer(chunkSamples: 35 * 16000)
+/// capture.onChunk = { data, index in ... }   // called on a background thread
+/// capture.start()
+/// // tap: VRCaptureWrite(capture.producer, samples, frameCount)
+/// var first = 0
+/// let remaining = capture.stop(withFirstChunkIndex: &first)
+/// ```
+@interface VRCaptureBuffer : NSObject
+
+/// The ring holds one chunk plus two seconds of headroom.
+- (instancetype)initWithChunkSamples:(NSInteger)chunkSamples NS_DESIGNATED_INITIALIZER;
+- (instancetype)init NS_UNAVAILABLE;
+
+/// Handle to pass to VRCaptureWrite() from the audio thread.
+@property (nonatomic, readonly) VRCaptureProducerRef producer;
+
+/// Called on the consumer thread with each full chunk (raw Float32 bytes)
+/// and its index.  Set before -start.
+@property (nonatomic, copy, nullable) void (^onChunk)(NSData *pcmData, NSInteger chunkIndex);
+
+/// Latest levels from the audio thread.
+@property (nonatomic, readonly) VRMeterLevels currentLevels;
+
+/// Index the next chunk will get (= chunks emitted so far).
+@property (nonatomic, readonly) NSInteger chunkIndex;
+
+/// Samples the audio thread dropped because the ring was full.
+@property (nonatomic, readonly) NSInteger droppedSamples;
+
+/// The last `maxCount` samples captured (at most ten seconds) as raw
+/// Float32 bytes, oldest first, e.g. for live captions.  Any thread.
+/// `capturedSamples` receives the samples captured since -start.
+- (NSData *)recentSamplesWithMaxCount:(NSInteger)maxCount
+                      capturedSamples:(NSInteger * _Nullable)capturedSamples;
+
+/// Reset the chunk index and start the consumer thread.
+- (void)start;
+
+/// Stop once the producer has stopped.  Returns every chunk still buffered
+/// (full ones not yet passed to onChunk, then the final partial one), in
+/// order; they are numbered consecutively from `firstChunkIndex`.
+- (NSArray<NSData *> *)stopWithFirstChunkIndex:(NSInteger *)firstChunkIndex;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,109 @@
+//
+//  CaptureBridge.mm
+//  Obj-C++ implementation – bridges vr::CaptureBuffer to Obj-C.
+//
+
+#import "CaptureBridge.h"
+
+#include "CaptureBuffer.hpp"
+
+#include <memory>
+#include <vector>
+
+/// Seconds of ring headroom beyond one chunk.
+static const size_t kHeadroomSeconds = 2;
+
+void VRCaptureWrite(VRCaptureProducerRef producer, const float *samples, NSInteger count) {
+    if (!producer || !samples || count <= 0) return;
+    reinterpret_cast<vr::CaptureBuffer *>(producer)->write(samples, static_cast<size_t>(count));
+}
+
+// ---------------------------------------------------------------------------
+// Private interface
+// ---------------------------------------------------------------------------
+
+@interface VRCaptureBuffer () {
+    std::unique_ptr<vr::CaptureBuffer> _capture;
+}
+@end
+
+// ---------------------------------------------------------------------------
+// Implementation
+// ---------------------------------------------------------------------------
+
+@implementation VRCaptureBuffer
+
+- (instancetype)initWithChunkSamples:(NSInteger)chunkSamples {
+    self = [super init];
+    if (self) {
+        // The callback reads onChunk through a weak reference: the consumer
+        // thread must not keep the bridge alive.
+        __weak VRCaptureBuffer *weakSelf = self;
+        _capture = std::make_unique<vr::CaptureBuffer>(
+            static_cast<size_t>(MAX(chunkSamples, 1)),
+            kHeadroomSeconds * vr::CaptureBuffer::kSampleRate,
+            [weakSelf](vr::AudioChunk chunk) {
+                @autoreleasepool {
+                    VRCaptureBuffer *strongSelf = weakSelf;
+                    void (^handler)(NSData *, NSInteger) = strongSelf.onChunk;
+                    if (!handler) return;
+                    NSData *data = [NSData dataWithBytes:chunk.audio_data.data()
+                                                  length:chunk.audio_data.size()];
+                    handler(data, chunk.chunk_index);
+                }
+            });
+    }
+    return self;
+}
+
+- (VRCaptureProducerRef)producer {
+    return reinterpret_cast<VRCaptureProducerRef>(_capture.get());
+}
+
+- (VRMeterLevels)currentLevels {
+    const vr::MeterLevels levels = _capture->levels();
+    VRMeterLevels out = {};
+    out.rms  = levels.rms;
+    out.peak = levels.peak;
+    for (size_t b = 0; b < vr::kMeterBands; ++b) {
+        out.bands[b] = levels.bands[b];
+    }
+    return out;
+}
+
+- (NSInteger)chunkIndex {
+    return _capture->chunk_index();
+}
+
+- (NSInteger)droppedSamples {
+    return static_cast<NSInteger>(_capture->dropped());
+}
+
+- (NSData *)recentSamplesWithMaxCount:(NSInteger)maxCount
+                      capturedSamples:(NSInteger *)capturedSamples {
+    std::vector<float> recent;
+    const size_t total = _capture->recent(recent, static_cast<size_t>(MAX(maxCount, 0)));
+    if (capturedSamples) *capturedSamples = static_cast<NSInteger>(total);
+    return [NSData dataWithBytes:recent.data() length:recent.size() * sizeof(float)];
+}
+
+- (void)start {
+    _capture->start();
+}
+
+- (NSArray<NSData *> *)stopWithFirstChunkIndex:(NSInteger *)firstChunkIndex {
+    std::vector<vr::AudioChunk> remaining = _capture->stop();
+    if (firstChunkIndex) {
+        *firstChunkIndex = remaining.empty() ? _capture->chunk_index()
+                                             : remaining.front().chunk_index;
+    }
+
+    NSMutableArray<NSData *> *out = [NSMutableArray arrayWithCapacity:remaining.size()];
+    for (const auto &chunk : remaining) {
+        [out addObject:[NSData dataWithBytes:chunk.audio_data.data()
+                                      length:chunk.audio_data.size()]];
+    }
+    return out;
+}
+
+@end
@@ -0,0 +1,28 @@
+//
+//  MeteringBridge.h
+//  C interface to the C++ metering kernel (vr::compute_meter_levels).
+//
+//  Plain C function rather than an Obj-C method so it can be called from the
+//  real-time audio tap without an objc_msgSend or any allocation.
+//
+
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/// Number of entries in `VRMeterLevels.bands`.
+#define VRMeterBandCount 4
+
+/// Levels for one buffer of 16 kHz mono Float32 audio, each 0.0-1.0.
+typedef struct {
+    float rms;
+    float peak;
+    /// Band RMS, low to high: 0-1 kHz, 1-2 kHz, 2-4 kHz, 4-8 kHz.
+    float bands[VRMeterBandCount];
+} VRMeterLevels;
+
+/// Compute RMS, peak, and band levels for `count` samples in one pass.
+/// Real-time safe: no locks, no allocation.
+FOUNDATION_EXPORT VRMeterLevels VRComputeMeterLevels(const float *samples, NSInteger count);
+
+NS_ASSUME_NONNULL_END
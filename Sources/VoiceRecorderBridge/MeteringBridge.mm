@@ -0,0 +1,25 @@
+//
+//  MeteringBridge.mm
+//  Obj-C++ implementation – forwards to vr::compute_meter_levels.
+//
+
+#import "MeteringBridge.h"
+
+#include "Metering.hpp"
+
+static_assert(VRMeterBandCount == vr::kMeterBands,
+              "VRMeterBandCount must match vr::kMeterBands");
+
+VRMeterLevels VRComputeMeterLevels(const float *samples, NSInteger count) {
+    VRMeterLevels out = {};
+    if (!samples || count <= 0) return out;
+
+    const vr::MeterLevels levels =
+        vr::compute_meter_levels(samples, static_cast<size_t>(count));
+    out.rms  = levels.rms;
+    out.peak = levels.peak;
+    for (size_t b = 0; b < vr::kMeterBands; ++b) {
+        out.bands[b] = levels.bands[b];
+    }
+    return out;
+}
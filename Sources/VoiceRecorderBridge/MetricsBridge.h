@@ -0,0 +1,40 @@
+//
+//  MetricsBridge.h
+//  Obj-C view of the core's per-stage latency histograms
+//  (vr::stage_snapshot), for debug logging and diagnostics.
+//
+
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/// Latency summary of one pipeline stage since launch (or the last
+/// +resetMetrics).  Percentiles are accurate to within ~10%.
+@interface VRStageMetrics : NSObject
+
+/// Stage name, e.g. "chunk_persist", "encoder".
+@property (nonatomic, copy) NSString *name;
+@property (nonatomic) uint64_t count;
+@property (nonatomic) double totalMs;
+@property (nonatomic) double p50Ms;
+@property (nonatomic) double p95Ms;
+@property (nonatomic) double p99Ms;
+@property (nonatomic) double maxMs;
+
+@end
+
+@interface VRPipelineMetrics : NSObject
+
+/// Every stage, in pipeline order (chunk_persist … transcribe).
++ (NSArray<VRStageMetrics *> *)metricsSnapshot;
+
+/// Stages that have recorded at least one span, as a single line such as
+/// "encoder n=3 p50=412.0ms p95=498.1ms; decoder …".
++ (NSString *)summary;
+
+/// Zero every histogram.
++ (void)resetMetrics;
+
+@end
+
+NS_ASSUME_NONNULL_END
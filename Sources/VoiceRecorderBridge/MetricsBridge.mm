@@ -0,0 +1,54 @@
+//
+//  MetricsBridge.mm
+//  Obj-C++ implementation – forwards to vr::stage_snapshot.
+//
+
+#import "MetricsBridge.h"
+
+#include "Instrumentation.hpp"
+
+@implementation VRStageMetrics
+
+- (instancetype)init {
+    if ((self = [super init])) {
+        _name = @"";
+    }
+    return self;
+}
+
+@end
+
+@implementation VRPipelineMetrics
+
++ (NSArray<VRStageMetrics *> *)metricsSnapshot {
+    const std::vector<vr::StageStats> stats = vr::stage_snapshot();
+    NSMutableArray<VRStageMetrics *> *out = [NSMutableArray arrayWithCapacity:stats.size()];
+    for (const auto& s : stats) {
+        VRStageMetrics *m = [[VRStageMetrics alloc] init];
+        m.name    = @(vr::stage_name(s.stage));
+        m.count   = s.count;
+        m.totalMs = s.total_ms;
+        m.p50Ms   = s.p50_ms;
+        m.p95Ms   = s.p95_ms;
+        m.p99Ms   = s.p99_ms;
+        m.maxMs   = s.max_ms;
+        [out addObject:m];
+    }
+    return out;
+}
+
++ (NSString *)summary {
+    NSMutableArray<NSString *> *parts = [NSMutableArray array];
+    for (VRStageMetrics *m in [self metricsSnapshot]) {
+        if (m.count == 0) continue;
+        [parts addObject:[NSString stringWithFormat:@"%@ n=%llu p50=%.1fms p95=%.1fms",
+                          m.name, (unsigned long long)m.count, m.p50Ms, m.p95Ms]];
+    }
+    return [parts componentsJoinedByString:@"; "];
+}
+
++ (void)resetMetrics {
+    vr::reset_stage_metrics();
+}
+
+@end
@@ -0,0 +1,28 @@
+//
+//  SegmentBridge.h
+//  Obj-C mirror of vr::TranscriptSegment, shared by WhisperBridge (which
+//  produces segments) and StorageBridge (which stores them).
+//
+
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/// One timed piece of a transcript.  Times are milliseconds from the start
+/// of the session's audio.
+@interface VRTranscriptSegment : NSObject
+
+@property (nonatomic) NSInteger startMs;
+@property (nonatomic) NSInteger endMs;
+@property (nonatomic, strong) NSString *text;
+
+/// Mean token probability, 0.0-1.0.  Low values mark spans worth
+/// re-transcribing on a more accurate model.
+@property (nonatomic) float probability;
+
+/// Chunk containing `startMs`, or -1 if not yet stored.
+@property (nonatomic) NSInteger chunkIndex;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,18 @@
+//
+//  SegmentBridge.mm
+//  Obj-C++ implementation – VRTranscriptSegment value object.
+//
+
+#import "SegmentBridge.h"
+
+@implementation VRTranscriptSegment
+
+- (instancetype)init {
+    if ((self = [super init])) {
+        _text = @"";
+        _chunkIndex = -1;
+    }
+    return self;
+}
+
+@end
@@ -8,8 +8,16 @@
 
 #import <Foundation/Foundation.h>
 
+#import "SegmentBridge.h"
+
 NS_ASSUME_NONNULL_BEGIN
 
+/// Which pass produced a stored transcript (mirrors vr::TranscriptVersion).
+typedef NS_ENUM(NSInteger, VRTranscriptVersion) {
+    VRTranscriptVersionDraft   = 1,   // fast pass, pasted right after recording
+    VRTranscriptVersionRefined = 2,   // background high-accuracy pass
+};
+
 // ---------------------------------------------------------------------------
 // VRSession – Obj-C mirror of vr::RecordingSession
 // ---------------------------------------------------------------------------
@@ -34,10 +42,64 @@ NS_ASSUME_NONNULL_BEGIN
 @property (nonatomic) NSInteger durationMs;
 
 /// Final concatenated transcript, or nil if not yet transcribed.
+/// Always nil on summaries from `getSessionSummariesFromOffset:limit:` —
+/// load it with `getTranscriptForSession:`.
 @property (nonatomic, strong, nullable) NSString *transcript;
 
+/// Which pass produced `transcript`.  Set on full sessions only.
+@property (nonatomic) VRTranscriptVersion transcriptVersion;
+
+/// Short transcript preview (first ~120 characters).  Set on summaries.
+@property (nonatomic, strong, nullable) NSString *preview;
+
+/// Search excerpt with matched terms wrapped in VRSnippetHighlightOpen /
+/// VRSnippetHighlightClose.  Set only on results of `searchSessions:limit:`.
+@property (nonatomic, strong, nullable) NSString *snippet;
+
+/// bm25 relevance of a search result (lower is better; 0 otherwise).
+@property (nonatomic) double rank;
+
 @end
 
+/// Markers bracketing matched terms in `VRSession.snippet`.
+FOUNDATION_EXPORT NSString * const VRSnippetHighlightOpen;
+FOUNDATION_EXPORT NSString * const VRSnippetHighlightClose;
+
+// ---------------------------------------------------------------------------
+// Crash recovery types
+// ---------------------------------------------------------------------------
+
+/// Where one chunk sits in its session's audio (mirrors vr::ChunkSpan).
+@interface VRChunkSpan : NSObject
+
+@property (nonatomic) NSInteger chunkIndex;
+@property (nonatomic) NSInteger beginMs;
+@property (nonatomic) NSInteger endMs;
+
+@end
+
+// ---------------------------------------------------------------------------
+// Waveform types
+// ---------------------------------------------------------------------------
+
+/// One column of a session's waveform overview (mirrors vr::WaveformBin),
+/// as sample values in [-1, 1].
+@interface VRWaveformBin : NSObject
+
+@property (nonatomic) float min;
+@property (nonatomic) float max;
+@property (nonatomic) float rms;
+
+@end
+
+/// How the recovery of an orphaned session ended (mirrors
+/// vr::RecoveryOutcome).
+typedef NS_ENUM(NSInteger, VRRecoveryOutcome) {
+    VRRecoveryOutcomeRecovered = 0,   // transcribed and completed
+    VRRecoveryOutcomeDiscarded,       // too short to transcribe; deleted
+    VRRecoveryOutcomeFailed,          // marked failed; can be retried by hand
+};
+
 // ---------------------------------------------------------------------------
 // StorageBridge
 // ---------------------------------------------------------------------------
@@ -68,39 +130,206 @@ NS_ASSUME_NONNULL_BEGIN
 /// @return The UUID string of the newly created session.
 - (NSString *)createSession;
 
-/// Persist an audio chunk for the given session.
+/// Queue an audio chunk for the given session.  Returns immediately; the
+/// write is committed on a background writer thread.  Call
+/// `flushSession:` before reading the session's audio back.
 /// @param audioData  Raw PCM bytes (16kHz mono Float32).
 /// @param sessionId  The session this chunk belongs to.
 /// @param index      Zero-based chunk index within the session.
-/// @return YES if the chunk was stored successfully, NO on failure.
+/// @return YES if the chunk was queued, NO if the database is unavailable.
 - (BOOL)addChunk:(NSData *)audioData
        toSession:(NSString *)sessionId
          atIndex:(NSInteger)index;
 
-/// Replace (or set) the transcript text for a session.
+/// Block until every queued write for `sessionId` is committed.
+/// @return NO if any of those writes failed.
+- (BOOL)flushSession:(NSString *)sessionId;
+
+/// Asynchronous `flushSession:`; `completion` runs on a background queue.
+- (void)flushSessionInBackground:(NSString *)sessionId
+                      completion:(void (^)(BOOL ok))completion;
+
+/// Replace (or set) the transcript text for a session (as a draft).
 - (void)updateTranscript:(NSString *)transcript
               forSession:(NSString *)sessionId;
 
+/// Same, recording which pass produced the text.  A refined transcript is
+/// never replaced by a draft.
+- (void)updateTranscript:(NSString *)transcript
+              forSession:(NSString *)sessionId
+                 version:(VRTranscriptVersion)version;
+
+/// Store the partial transcript produced for one chunk by the streaming
+/// transcriber while the session is still recording.
+- (void)updateTranscript:(NSString *)transcript
+                forChunk:(NSInteger)index
+               ofSession:(NSString *)sessionId;
+
 /// Mark a session as complete with the given total duration.
 - (void)completeSession:(NSString *)sessionId
            withDuration:(NSInteger)durationMs;
 
+// ---- Segments -------------------------------------------------------------
+
+/// Replace every stored segment of a session with `segments` (from a full
+/// transcription).  Each is filed under the chunk containing its start.
+/// The session transcript is left as is.
+- (BOOL)replaceSegments:(NSArray<VRTranscriptSegment *> *)segments
+             forSession:(NSString *)sessionId;
+
+/// Partial re-transcription: replace the stored segments lying entirely
+/// within `[startMs, endMs]` with `segments`, then rebuild the session
+/// transcript from all of its segments and store it as `version`, in one
+/// transaction.
+/// @return The rebuilt transcript, or nil on failure.
+- (NSString * _Nullable)replaceSegments:(NSArray<VRTranscriptSegment *> *)segments
+                             forSession:(NSString *)sessionId
+                                 fromMs:(NSInteger)startMs
+                                   toMs:(NSInteger)endMs
+                                version:(VRTranscriptVersion)version;
+
+/// A session's segments in time order (for seeking by text).
+- (NSArray<VRTranscriptSegment *> *)getSegmentsForSession:(NSString *)sessionId;
+
+/// Segments whose mean token probability is below `threshold`, in time
+/// order – the spans worth re-transcribing.
+- (NSArray<VRTranscriptSegment *> *)getLowConfidenceSegmentsForSession:(NSString *)sessionId
+                                                             threshold:(float)threshold;
+
 // ---- Queries --------------------------------------------------------------
 
 /// Return every session in the database, ordered by creation time descending.
 - (NSArray<VRSession *> *)getAllSessions;
 
-/// Reconstruct the full audio for a session by concatenating all of its
-/// chunks' raw PCM data.  Returns nil if no chunks exist.
+/// Return one page of session summaries (metadata + `preview`, no full
+/// transcript), ordered by creation time descending.  Cheap enough to call
+/// from the main thread when the history list opens or scrolls.
+- (NSArray<VRSession *> *)getSessionSummariesFromOffset:(NSInteger)offset
+                                                  limit:(NSInteger)limit;
+
+/// Full-text search over all transcripts, best match first.  `query` is
+/// plain user text (every word must match; the last may be a prefix).
+/// Results carry metadata plus `snippet`; `transcript` is nil.
+- (NSArray<VRSession *> *)searchSessions:(NSString *)query
+                                   limit:(NSInteger)limit;
+
+/// Load the full transcript for one session (detail view).  Returns nil if
+/// the session does not exist or has no transcript yet.
+- (NSString * _Nullable)getTranscriptForSession:(NSString *)sessionId;
+
+/// The full audio of a session as 16 kHz mono Float32 PCM: its chunks
+/// concatenated, or for an archived session the archive's mapped samples
+/// (no copy).  Returns nil if no audio exists.
 - (NSData * _Nullable)getAudioForSession:(NSString *)sessionId;
 
-/// Permanently delete a session and all its chunks.
+/// Permanently delete a session and all its chunks and segments (and its
+/// archive file, if it has one).
 - (void)deleteSession:(NSString *)sessionId;
 
 /// Find sessions whose status is still "recording" (likely left behind by a
 /// crash).  The Swift layer can decide whether to attempt recovery.
 - (NSArray<VRSession *> *)getOrphanedSessions;
 
+// ---- Waveforms ------------------------------------------------------------
+
+/// The session's waveform in `pixels` columns, from the min/max/RMS
+/// pyramid stored with each chunk — reads a few hundred bytes, never any
+/// audio, so it is cheap enough for every row of the history list.  Empty
+/// if no waveform is stored (older sessions, until backfilled).
+- (NSArray<VRWaveformBin *> *)waveformOverviewForSession:(NSString *)sessionId
+                                                 pixels:(NSInteger)pixels;
+
+/// Compute and store the waveform of every session recorded before
+/// waveforms were stored, from its audio, in the background (on the
+/// archive queue).  `completion` gets the number of sessions filled in.
+- (void)backfillWaveformsWithCompletion:(void (^ _Nullable)(NSInteger backfilled))completion;
+
+// ---- Crash recovery -------------------------------------------------------
+// Called by WhisperBridge's recovery worker, one chunk at a time.
+
+/// Time span of every chunk of a session, in order.  Reads no audio.
+- (NSArray<VRChunkSpan *> *)getChunkSpansForSession:(NSString *)sessionId;
+
+/// One chunk as 16 kHz mono Float32 PCM, or nil if it does not exist.
+- (NSData * _Nullable)getAudioForSession:(NSString *)sessionId
+                              chunkIndex:(NSInteger)chunkIndex;
+
+/// Milliseconds of the session already recovered (0 if not started).
+- (NSInteger)recoveryProgressForSession:(NSString *)sessionId;
+
+/// Store the segments recovered for `[startMs, endMs]` and advance the
+/// recovery progress to `endMs`, in one transaction.  The session stays
+/// orphaned until -finishRecoveryOfSession:outcome:.
+- (BOOL)saveRecoveredSegments:(NSArray<VRTranscriptSegment *> *)segments
+                   forSession:(NSString *)sessionId
+                       fromMs:(NSInteger)startMs
+                         toMs:(NSInteger)endMs;
+
+/// Apply a recovery outcome: Recovered stores the transcript built from
+/// the saved segments and completes the session (marking it failed if no
+/// speech was found), Discarded deletes it, Failed marks it failed.
+- (void)finishRecoveryOfSession:(NSString *)sessionId
+                        outcome:(VRRecoveryOutcome)outcome;
+
+// ---- Transcript cache -----------------------------------------------------
+// Backing store for WhisperBridge's transcript cache; see
+// -[WhisperBridge attachTranscriptCacheToStorage:].
+
+/// The cache entry stored under `key`, or nil on a miss.
+- (NSData * _Nullable)transcriptCacheEntryForKey:(NSString *)key;
+
+/// Store `entry` under `key`.  Entries owned by a session are removed when
+/// it is deleted; the oldest are dropped once the cache is full.
+- (void)storeTranscriptCacheEntry:(NSData *)entry
+                           forKey:(NSString *)key
+                          session:(NSString * _Nullable)sessionId;
+
+// ---- Archives -------------------------------------------------------------
+// Completed sessions' audio moves out of the database into one archive file
+// each (`archives/` next to the database), leaving only metadata and the
+// file name behind.  Archives are float WAVs, so playback opens them
+// directly and reads map just the range they touch.
+
+/// Move a completed session's audio into its archive file.  YES if it is
+/// archived (now or already); NO if it is still recording or writing failed.
+- (BOOL)archiveSession:(NSString *)sessionId;
+
+/// `archiveSession:` on a background queue (one archive write at a time).
+- (void)archiveSessionInBackground:(NSString *)sessionId;
+
+/// Archive every completed session still stored in the database, then
+/// compact the database if any moved.  Runs in the background; `completion`
+/// gets the number archived.
+- (void)archiveStoredSessionsWithCompletion:(void (^ _Nullable)(NSInteger archived))completion;
+
+/// File URL of the session's audio as a WAV file any player can open (its
+/// archive), or nil while the audio is still in the database.
+- (NSURL * _Nullable)playableAudioURLForSession:(NSString *)sessionId;
+
+/// Write a self-contained archive of the session (audio, transcript and
+/// segments) to `url` for importing elsewhere.  `compressed` stores FLAC
+/// (about a quarter of the size, but not playable as a WAV).
+- (BOOL)exportSession:(NSString *)sessionId
+                toURL:(NSURL *)url
+           compressed:(BOOL)compressed;
+
+/// Import an exported archive as a session, copying it into the archive
+/// directory.  Keeps the original session id unless it already exists here.
+/// @return The imported session's id, or nil if the file is not a valid archive.
+- (NSString * _Nullable)importSessionFromURL:(NSURL *)url;
+
+/// Bulk export for moving history between machines: every session not
+/// still recording, as `<directory>/<id>.vrsession`, in the background.
+/// `completion` gets the number written.
+- (void)exportAllSessionsToDirectory:(NSURL *)directory
+                          compressed:(BOOL)compressed
+                          completion:(void (^)(NSInteger exported))completion;
+
+/// `importSessionFromURL:` for each of `urls`, in the background.
+/// `completion` gets the ids of the sessions imported.
+- (void)importSessionsFromURLs:(NSArray<NSURL *> *)urls
+                    completion:(void (^)(NSArray<NSString *> *sessionIds))completion;
+
 @end
 
 NS_ASSUME_NONNULL_END
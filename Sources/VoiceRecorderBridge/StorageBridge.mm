@@ -9,10 +9,16 @@
 #import "StorageBridge.h"
 
 #include "DatabaseManager.hpp"
+#include "SessionArchive.hpp"
 #include "Types.hpp"
+#include "WaveformPyramid.hpp"
+#include "WriteQueue.hpp"
 
+#include <cstdio>
 #include <memory>
+#include <optional>
 #include <string>
+#include <utility>
 #include <vector>
 
 // ---------------------------------------------------------------------------
@@ -22,6 +28,16 @@
 @implementation VRSession
 @end
 
+@implementation VRChunkSpan
+@end
+
+@implementation VRWaveformBin
+@end
+
+// Must match vr::kSnippetOpen / vr::kSnippetClose (Types.hpp).
+NSString * const VRSnippetHighlightOpen  = @"\x02";
+NSString * const VRSnippetHighlightClose = @"\x03";
+
 // ---------------------------------------------------------------------------
 // Error domain & codes
 // ---------------------------------------------------------------------------
@@ -41,7 +57,12 @@ typedef NS_ENUM(NSInteger, StorageBridgeErrorCode) {
 
 @interface StorageBridge () {
     std::unique_ptr<vr::DatabaseManager> _db;
+    std::unique_ptr<vr::WriteQueue>      _writer;   // recording-time writes
+    dispatch_queue_t                     _flushQueue;
+    dispatch_queue_t                     _archiveQueue;       // serial, utility QoS
+    NSString                            *_archiveDirectory;
 }
+- (std::string)archivePathForSession:(const std::string &)sid;
 @end
 
 // ---------------------------------------------------------------------------
@@ -56,6 +77,8 @@ static VRSession *SessionToObjC(const vr::RecordingSession &s) {
     obj.completedAt = static_cast<NSInteger>(s.completed_at);
     obj.status      = [[NSString alloc] initWithUTF8String:vr::status_to_string(s.status)];
     obj.durationMs  = static_cast<NSInteger>(s.duration_ms);
+    obj.transcriptVersion = s.transcript_version == vr::TranscriptVersion::refined
+                                ? VRTranscriptVersionRefined : VRTranscriptVersionDraft;
 
     if (!s.transcript.empty()) {
         obj.transcript = [[NSString alloc] initWithUTF8String:s.transcript.c_str()];
@@ -66,6 +89,172 @@ static VRSession *SessionToObjC(const vr::RecordingSession &s) {
     return obj;
 }
 
+/// Convert a C++ SessionSummary to an Obj-C VRSession (transcript left nil).
+static VRSession *SummaryToObjC(const vr::SessionSummary &s) {
+    VRSession *obj = [[VRSession alloc] init];
+    obj.sessionId   = [[NSString alloc] initWithUTF8String:s.id.c_str()];
+    obj.createdAt   = static_cast<NSInteger>(s.created_at);
+    obj.completedAt = static_cast<NSInteger>(s.completed_at);
+    obj.status      = [[NSString alloc] initWithUTF8String:vr::status_to_string(s.status)];
+    obj.durationMs  = static_cast<NSInteger>(s.duration_ms);
+
+    if (!s.preview.empty()) {
+        obj.preview = [[NSString alloc] initWithUTF8String:s.preview.c_str()];
+    }
+
+    return obj;
+}
+
+/// VRTranscriptVersion → vr::TranscriptVersion.
+static vr::TranscriptVersion VersionFromObjC(VRTranscriptVersion version) {
+    return version == VRTranscriptVersionRefined ? vr::TranscriptVersion::refined
+                                                 : vr::TranscriptVersion::draft;
+}
+
+/// Convert stored segments to VRTranscriptSegment objects.
+static NSArray<VRTranscriptSegment *> *SegmentsToObjC(const std::vector<vr::TranscriptSegment> &segments) {
+    NSMutableArray<VRTranscriptSegment *> *result =
+        [[NSMutableArray alloc] initWithCapacity:segments.size()];
+    for (const auto &s : segments) {
+        VRTranscriptSegment *obj = [[VRTranscriptSegment alloc] init];
+        obj.startMs     = static_cast<NSInteger>(s.t0_ms);
+        obj.endMs       = static_cast<NSInteger>(s.t1_ms);
+        obj.text        = [[NSString alloc] initWithUTF8String:s.text.c_str()] ?: @"";
+        obj.probability = s.avg_prob;
+        obj.chunkIndex  = static_cast<NSInteger>(s.chunk_index);
+        [result addObject:obj];
+    }
+    return [result copy];
+}
+
+/// Convert VRTranscriptSegment objects to C++ segments (chunk index is
+/// assigned by the database).
+static std::vector<vr::TranscriptSegment> SegmentsFromObjC(NSArray<VRTranscriptSegment *> *segments) {
+    std::vector<vr::TranscriptSegment> result;
+    result.reserve(segments.count);
+    for (VRTranscriptSegment *obj in segments) {
+        vr::TranscriptSegment s;
+        s.t0_ms    = static_cast<int64_t>(obj.startMs);
+        s.t1_ms    = static_cast<int64_t>(obj.endMs);
+        s.text     = obj.text.length ? std::string([obj.text UTF8String]) : std::string();
+        s.avg_prob = obj.probability;
+        result.push_back(std::move(s));
+    }
+    return result;
+}
+
+/// Write a session's audio, transcript and segments to a new archive at
+/// `path`, taking the audio from `sourceArchive` (a resolved path) if it
+/// is already archived, else from its chunk rows.
+static bool WriteSessionArchive(vr::DatabaseManager &db, const std::string &sid,
+                                const std::string &sourceArchive,
+                                const std::string &path, vr::ChunkCodec codec) {
+    std::optional<vr::RecordingSession> session = db.get_session(sid);
+    if (!session) return false;
+
+    vr::ArchiveMetadata metadata;
+    metadata.session  = *session;
+    metadata.segments = db.get_segments(sid);
+
+    vr::SessionArchiveWriter writer(path, codec);
+    if (!writer.open()) return false;
+
+    bool ok = true;
+    if (!sourceArchive.empty()) {
+        vr::SessionArchive source(sourceArchive);
+        if (!source.open()) return false;
+        for (size_t i = 0; ok && i < source.chunks().size(); ++i) {
+            ok = writer.add_chunk(source.chunk(i));
+        }
+    } else {
+        // One statement, so one snapshot: either every blob or, if the
+        // session was archived meanwhile, none.
+        const bool read = db.for_each_stored_chunk(sid, [&](const vr::ChunkView &chunk) {
+            ok = writer.add_chunk(chunk);
+            return ok;
+        });
+        ok = ok && read;
+    }
+
+    uint64_t samples = 0;
+    for (const vr::ArchiveChunk &c : writer.chunks()) samples += c.sample_count;
+    if (!ok || samples == 0) return false;
+
+    return writer.finish(metadata);
+}
+
+/// A session's whole audio from its archive: the mapped samples themselves
+/// for a float archive (the NSData keeps the mapping alive), else decoded.
+static NSData *AudioFromArchive(const std::string &path) {
+    auto archive = std::make_shared<vr::SessionArchive>(path);
+    if (!archive->open() || archive->total_samples() == 0) return nil;
+
+    if (const float *samples = archive->samples()) {
+        return [[NSData alloc] initWithBytesNoCopy:const_cast<float *>(samples)
+                                            length:archive->total_samples() * sizeof(float)
+                                       deallocator:^(void *, NSUInteger) { (void)archive; }];
+    }
+
+    std::vector<float> pcm;
+    if (!archive->read_pcm(0, 0, pcm) || pcm.empty()) return nil;
+    return [NSData dataWithBytes:pcm.data() length:pcm.size() * sizeof(float)];
+}
+
+/// One chunk of an archived session (`path` resolved) as float32 PCM into
+/// `pcm`.  False if the archive cannot be opened, has no such chunk, or
+/// the chunk fails to decode (logged).
+static bool ChunkFromArchive(const std::string &path, NSInteger chunkIndex,
+                             std::vector<float> &pcm) {
+    vr::SessionArchive archive(path);
+    if (!archive.open()) {
+        NSLog(@"[StorageBridge] Cannot open archive %s", path.c_str());
+        return false;
+    }
+    for (size_t i = 0; i < archive.chunks().size(); ++i) {
+        if (archive.chunks()[i].chunk_index != chunkIndex) continue;
+        if (!archive.read_chunk(i, pcm)) {
+            NSLog(@"[StorageBridge] Chunk %ld of archive %s failed to decode",
+                  static_cast<long>(chunkIndex), path.c_str());
+            return false;
+        }
+        return true;
+    }
+    return false;
+}
+
+/// Build and store every chunk's waveform pyramid from the session's audio:
+/// its archive (a resolved path) if it has one, else its chunk rows.
+/// False if the audio could not be read or there was none.
+static bool StoreSessionWaveform(vr::DatabaseManager &db, const std::string &sid,
+                                 const std::string &archivePath) {
+    std::vector<std::pair<int, vr::WaveformPyramid>> pyramids;
+    if (!archivePath.empty()) {
+        vr::SessionArchive archive(archivePath);
+        if (!archive.open()) return false;
+        std::vector<float> pcm;
+        for (size_t i = 0; i < archive.chunks().size(); ++i) {
+            if (!archive.read_chunk(i, pcm)) return false;
+            pyramids.emplace_back(archive.chunks()[i].chunk_index,
+                                  vr::build_waveform_pyramid(pcm.data(), pcm.size()));
+        }
+    } else {
+        // Stored after the walk: the reader is held during the callback.
+        const bool read = db.for_each_chunk(sid, [&](const vr::ChunkView &chunk) {
+            pyramids.emplace_back(chunk.chunk_index,
+                                  vr::build_waveform_pyramid(
+                                      reinterpret_cast<const float *>(chunk.data),
+                                      chunk.size / sizeof(float)));
+            return true;
+        });
+        if (!read) return false;
+    }
+
+    for (const auto &[chunkIndex, pyramid] : pyramids) {
+        if (!db.store_waveform(sid, chunkIndex, pyramid)) return false;
+    }
+    return !pyramids.empty();
+}
+
 // ---------------------------------------------------------------------------
 // Implementation
 // ---------------------------------------------------------------------------
@@ -81,15 +270,36 @@ static VRSession *SessionToObjC(const vr::RecordingSession &s) {
             if (!_db->open()) {
                 NSLog(@"[StorageBridge] Failed to open database at: %@", dbPath);
                 _db = nullptr;
+            } else {
+                _writer = std::make_unique<vr::WriteQueue>(*_db);
             }
         } catch (const std::exception &e) {
             NSLog(@"[StorageBridge] DatabaseManager init failed: %s", e.what());
+            _writer = nullptr;
             _db = nullptr;
         }
+        _flushQueue = dispatch_queue_create("com.brainphart.storage.flush",
+                                            DISPATCH_QUEUE_CONCURRENT);
+        _archiveQueue = dispatch_queue_create(
+            "com.brainphart.storage.archive",
+            dispatch_queue_attr_make_with_qos_class(DISPATCH_QUEUE_SERIAL, QOS_CLASS_UTILITY, 0));
+
+        _archiveDirectory = [[dbPath stringByDeletingLastPathComponent]
+                                stringByAppendingPathComponent:@"archives"];
+        [[NSFileManager defaultManager] createDirectoryAtPath:_archiveDirectory
+                                  withIntermediateDirectories:YES
+                                                   attributes:nil
+                                                        error:nil];
     }
     return self;
 }
 
+- (void)dealloc {
+    // Drain queued writes before the database they target goes away.
+    _writer.reset();
+    _db.reset();
+}
+
 - (instancetype)init {
     // Fallback: resolve via HOME env (non-sandbox only).
     NSArray *paths = NSSearchPathForDirectoriesInDomains(
@@ -124,7 +334,7 @@ static VRSession *SessionToObjC(const vr::RecordingSession &s) {
 - (BOOL)addChunk:(NSData *)audioData
        toSession:(NSString *)sessionId
          atIndex:(NSInteger)index {
-    if (!_db) {
+    if (!_db || !_writer) {
         NSLog(@"[StorageBridge] addChunk called but database is not initialized.");
         return NO;
     }
@@ -138,39 +348,90 @@ static VRSession *SessionToObjC(const vr::RecordingSession &s) {
         std::string sid = std::string([sessionId UTF8String]);
         int32_t idx = static_cast<int32_t>(index);
 
-        // Copy NSData bytes into the vector.
+        // Copy NSData bytes into the vector the queue takes ownership of.
         const uint8_t *bytes = static_cast<const uint8_t *>(audioData.bytes);
         std::vector<uint8_t> data(bytes, bytes + audioData.length);
 
-        bool ok = _db->add_chunk(sid, idx, data, 0);
+        // 16 kHz mono Float32: 64 bytes per millisecond.
+        const int64_t durationMs =
+            static_cast<int64_t>(audioData.length / sizeof(float)) * 1000 / 16000;
+
+        _writer->add_chunk(sid, idx, std::move(data), durationMs);
+        NSLog(@"[StorageBridge] Queued chunk %d for session %@ (%lu bytes)",
+              idx, sessionId, (unsigned long)audioData.length);
+        return YES;
+
+    } catch (const std::exception &e) {
+        NSLog(@"[StorageBridge] addChunk exception: %s", e.what());
+        return NO;
+    }
+}
+
+- (BOOL)flushSession:(NSString *)sessionId {
+    if (!_writer) return NO;
+
+    try {
+        std::string sid = std::string([sessionId UTF8String]);
+        bool ok = _writer->flush_and_wait(sid);
         if (!ok) {
-            NSLog(@"[StorageBridge] add_chunk returned false for session %@ chunk %d (%lu bytes)",
-                  sessionId, idx, (unsigned long)audioData.length);
-        } else {
-            NSLog(@"[StorageBridge] Stored chunk %d for session %@ (%lu bytes)",
-                  idx, sessionId, (unsigned long)audioData.length);
+            NSLog(@"[StorageBridge] queued writes failed for session %@", sessionId);
         }
         return ok ? YES : NO;
-
     } catch (const std::exception &e) {
-        NSLog(@"[StorageBridge] addChunk exception: %s", e.what());
+        NSLog(@"[StorageBridge] flushSession exception: %s", e.what());
         return NO;
     }
 }
 
+- (void)flushSessionInBackground:(NSString *)sessionId
+                      completion:(void (^)(BOOL ok))completion {
+    NSString *sid = [sessionId copy];
+    dispatch_async(_flushQueue, ^{
+        BOOL ok = [self flushSession:sid];
+        completion(ok);
+    });
+}
+
 - (void)updateTranscript:(NSString *)transcript
               forSession:(NSString *)sessionId {
+    [self updateTranscript:transcript forSession:sessionId version:VRTranscriptVersionDraft];
+}
+
+- (void)updateTranscript:(NSString *)transcript
+              forSession:(NSString *)sessionId
+                 version:(VRTranscriptVersion)version {
     if (!_db) return;
 
     try {
         std::string sid  = std::string([sessionId UTF8String]);
         std::string text = std::string([transcript UTF8String]);
-        _db->update_transcript(sid, text, 0);
+        _db->update_transcript(sid, text, 0, VersionFromObjC(version));
     } catch (const std::exception &e) {
         NSLog(@"[StorageBridge] updateTranscript exception: %s", e.what());
     }
 }
 
+- (void)updateTranscript:(NSString *)transcript
+                forChunk:(NSInteger)index
+               ofSession:(NSString *)sessionId {
+    if (!_db) return;
+
+    try {
+        std::string sid  = std::string([sessionId UTF8String]);
+        std::string text = std::string([transcript UTF8String]);
+        // Rides the write queue so it stays ordered after the chunk insert
+        // and shares its transaction when they arrive together.
+        if (_writer) {
+            _writer->update_chunk_transcript(sid, static_cast<int32_t>(index), std::move(text));
+        } else if (!_db->update_chunk_transcript(sid, static_cast<int32_t>(index), text)) {
+            NSLog(@"[StorageBridge] update_chunk_transcript returned false for session %@ chunk %ld",
+                  sessionId, (long)index);
+        }
+    } catch (const std::exception &e) {
+        NSLog(@"[StorageBridge] updateTranscript:forChunk: exception: %s", e.what());
+    }
+}
+
 - (void)completeSession:(NSString *)sessionId
            withDuration:(NSInteger)durationMs {
     if (!_db) return;
@@ -184,6 +445,76 @@ static VRSession *SessionToObjC(const vr::RecordingSession &s) {
     }
 }
 
+// ---- Segments -------------------------------------------------------------
+
+- (BOOL)replaceSegments:(NSArray<VRTranscriptSegment *> *)segments
+             forSession:(NSString *)sessionId {
+    if (!_db) return NO;
+
+    try {
+        std::string sid = std::string([sessionId UTF8String]);
+        // Segments are filed by chunk duration, so queued chunks must land first.
+        if (_writer) _writer->flush_and_wait(sid);
+        if (!_db->replace_segments(sid, SegmentsFromObjC(segments))) {
+            NSLog(@"[StorageBridge] replace_segments returned false for session %@", sessionId);
+            return NO;
+        }
+        return YES;
+    } catch (const std::exception &e) {
+        NSLog(@"[StorageBridge] replaceSegments exception: %s", e.what());
+        return NO;
+    }
+}
+
+- (NSString * _Nullable)replaceSegments:(NSArray<VRTranscriptSegment *> *)segments
+                             forSession:(NSString *)sessionId
+                                 fromMs:(NSInteger)startMs
+                                   toMs:(NSInteger)endMs
+                                version:(VRTranscriptVersion)version {
+    if (!_db) return nil;
+
+    try {
+        std::string sid = std::string([sessionId UTF8String]);
+        if (_writer) _writer->flush_and_wait(sid);
+        if (!_db->replace_segments_in_range(sid, static_cast<int64_t>(startMs),
+                                            static_cast<int64_t>(endMs),
+                                            SegmentsFromObjC(segments),
+                                            VersionFromObjC(version))) {
+            NSLog(@"[StorageBridge] replace_segments_in_range returned false for session %@",
+                  sessionId);
+            return nil;
+        }
+        return [self getTranscriptForSession:sessionId] ?: @"";
+    } catch (const std::exception &e) {
+        NSLog(@"[StorageBridge] replaceSegments:fromMs:toMs: exception: %s", e.what());
+        return nil;
+    }
+}
+
+- (NSArray<VRTranscriptSegment *> *)getSegmentsForSession:(NSString *)sessionId {
+    if (!_db) return @[];
+
+    try {
+        return SegmentsToObjC(_db->get_segments(std::string([sessionId UTF8String])));
+    } catch (const std::exception &e) {
+        NSLog(@"[StorageBridge] getSegmentsForSession exception: %s", e.what());
+        return @[];
+    }
+}
+
+- (NSArray<VRTranscriptSegment *> *)getLowConfidenceSegmentsForSession:(NSString *)sessionId
+                                                             threshold:(float)threshold {
+    if (!_db) return @[];
+
+    try {
+        return SegmentsToObjC(_db->get_low_confidence_segments(
+            std::string([sessionId UTF8String]), threshold));
+    } catch (const std::exception &e) {
+        NSLog(@"[StorageBridge] getLowConfidenceSegmentsForSession exception: %s", e.what());
+        return @[];
+    }
+}
+
 // ---- Queries --------------------------------------------------------------
 
 - (NSArray<VRSession *> *)getAllSessions {
@@ -206,40 +537,108 @@ static VRSession *SessionToObjC(const vr::RecordingSession &s) {
     }
 }
 
-- (NSData * _Nullable)getAudioForSession:(NSString *)sessionId {
+- (NSArray<VRSession *> *)getSessionSummariesFromOffset:(NSInteger)offset
+                                                  limit:(NSInteger)limit {
+    if (!_db) return @[];
+
+    try {
+        std::vector<vr::SessionSummary> page = _db->get_session_summaries(
+            static_cast<int>(offset), static_cast<int>(limit));
+        NSMutableArray<VRSession *> *result =
+            [[NSMutableArray alloc] initWithCapacity:page.size()];
+
+        for (const auto &s : page) {
+            [result addObject:SummaryToObjC(s)];
+        }
+
+        return [result copy];
+
+    } catch (const std::exception &e) {
+        NSLog(@"[StorageBridge] getSessionSummaries exception: %s", e.what());
+        return @[];
+    }
+}
+
+- (NSArray<VRSession *> *)searchSessions:(NSString *)query
+                                   limit:(NSInteger)limit {
+    if (!_db) return @[];
+
+    try {
+        std::string q = std::string([query UTF8String]);
+        std::vector<vr::SearchHit> hits = _db->search(q, static_cast<int>(limit));
+        NSMutableArray<VRSession *> *result =
+            [[NSMutableArray alloc] initWithCapacity:hits.size()];
+
+        for (const auto &h : hits) {
+            VRSession *obj = SummaryToObjC(h.session);
+            obj.snippet = [[NSString alloc] initWithUTF8String:h.snippet.c_str()];
+            obj.rank    = h.rank;
+            [result addObject:obj];
+        }
+
+        return [result copy];
+
+    } catch (const std::exception &e) {
+        NSLog(@"[StorageBridge] searchSessions exception: %s", e.what());
+        return @[];
+    }
+}
+
+- (NSString * _Nullable)getTranscriptForSession:(NSString *)sessionId {
     if (!_db) return nil;
 
     try {
         std::string sid = std::string([sessionId UTF8String]);
-        std::vector<vr::AudioChunk> chunks = _db->get_chunks(sid);
+        std::optional<std::string> text = _db->get_transcript(sid);
+        if (!text || text->empty()) return nil;
+        return [[NSString alloc] initWithUTF8String:text->c_str()];
+    } catch (const std::exception &e) {
+        NSLog(@"[StorageBridge] getTranscriptForSession exception: %s", e.what());
+        return nil;
+    }
+}
 
-        if (chunks.empty()) {
-            return nil;
-        }
+- (NSData * _Nullable)getAudioForSession:(NSString *)sessionId {
+    if (!_db) return nil;
 
-        // For a single chunk, return it directly.
-        if (chunks.size() == 1) {
-            const auto &data = chunks[0].audio_data;
-            return [[NSData alloc] initWithBytes:data.data() length:data.size()];
+    try {
+        std::string sid = std::string([sessionId UTF8String]);
+
+        std::string archive = [self archivePathForSession:sid];
+        if (!archive.empty()) {
+            return AudioFromArchive(archive);
         }
 
-        // Multiple chunks: concatenate raw PCM data.
         // Chunks are stored as 16kHz mono Float32 PCM bytes, so simple
         // byte concatenation produces a valid continuous PCM stream.
         //
-        // Estimate total size for a single allocation.
-        size_t totalSize = 0;
-        for (const auto &chunk : chunks) {
-            totalSize += chunk.audio_data.size();
+        // Size the destination once, then stream each blob straight from
+        // SQLite's row buffer into it — no per-chunk std::vector copies.
+        int64_t totalSize = _db->get_audio_size(sid);
+        if (totalSize <= 0) {
+            return nil;
         }
 
-        NSMutableData *combined = [[NSMutableData alloc] initWithCapacity:totalSize];
-        for (const auto &chunk : chunks) {
-            [combined appendBytes:chunk.audio_data.data()
-                           length:chunk.audio_data.size()];
+        NSMutableData *combined =
+            [[NSMutableData alloc] initWithCapacity:static_cast<NSUInteger>(totalSize)];
+        bool ok = _db->for_each_chunk(sid, [combined](const vr::ChunkView &chunk) {
+            if (chunk.size > 0) {
+                [combined appendBytes:chunk.data length:chunk.size];
+            }
+            return true;
+        });
+
+        if (!ok) {
+            NSLog(@"[StorageBridge] for_each_chunk failed for session %@", sessionId);
+            return nil;
+        }
+        if (combined.length == 0) {
+            // Archived between the two reads: the blobs are already gone.
+            archive = [self archivePathForSession:sid];
+            return archive.empty() ? nil : AudioFromArchive(archive);
         }
 
-        return [combined copy];
+        return combined;
 
     } catch (const std::exception &e) {
         NSLog(@"[StorageBridge] getAudioForSession exception: %s", e.what());
@@ -252,7 +651,13 @@ static VRSession *SessionToObjC(const vr::RecordingSession &s) {
 
     try {
         std::string sid = std::string([sessionId UTF8String]);
-        _db->delete_session(sid);
+        // Let queued chunk inserts land first, or they would recreate rows
+        // for a session that no longer exists.
+        if (_writer) _writer->flush_and_wait(sid);
+        const std::string archive = [self archivePathForSession:sid];
+        if (_db->delete_session(sid) && !archive.empty()) {
+            std::remove(archive.c_str());
+        }
     } catch (const std::exception &e) {
         NSLog(@"[StorageBridge] deleteSession exception: %s", e.what());
     }
@@ -278,4 +683,377 @@ static VRSession *SessionToObjC(const vr::RecordingSession &s) {
     }
 }
 
+// ---- Waveforms ------------------------------------------------------------
+
+- (NSArray<VRWaveformBin *> *)waveformOverviewForSession:(NSString *)sessionId
+                                                 pixels:(NSInteger)pixels {
+    if (!_db || pixels <= 0) return @[];
+
+    try {
+        const std::vector<vr::WaveformBin> bins =
+            _db->get_waveform_overview(std::string([sessionId UTF8String]),
+                                       static_cast<size_t>(pixels));
+        NSMutableArray<VRWaveformBin *> *result =
+            [[NSMutableArray alloc] initWithCapacity:bins.size()];
+        for (const auto &b : bins) {
+            VRWaveformBin *obj = [[VRWaveformBin alloc] init];
+            obj.min = b.min / 32767.0f;
+            obj.max = b.max / 32767.0f;
+            obj.rms = b.rms / 32767.0f;
+            [result addObject:obj];
+        }
+        return [result copy];
+    } catch (const std::exception &e) {
+        NSLog(@"[StorageBridge] waveformOverviewForSession exception: %s", e.what());
+        return @[];
+    }
+}
+
+- (void)backfillWaveformsWithCompletion:(void (^ _Nullable)(NSInteger backfilled))completion {
+    dispatch_async(_archiveQueue, ^{
+        NSInteger backfilled = 0;
+        if (self->_db) {
+            try {
+                for (const std::string &sid : self->_db->get_sessions_without_waveform()) {
+                    if (StoreSessionWaveform(*self->_db, sid, [self archivePathForSession:sid])) {
+                        ++backfilled;
+                    } else {
+                        NSLog(@"[StorageBridge] No waveform for session %s", sid.c_str());
+                    }
+                }
+            } catch (const std::exception &e) {
+                NSLog(@"[StorageBridge] backfillWaveforms exception: %s", e.what());
+            }
+        }
+        if (completion) completion(backfilled);
+    });
+}
+
+// ---- Crash recovery -------------------------------------------------------
+
+- (NSArray<VRChunkSpan *> *)getChunkSpansForSession:(NSString *)sessionId {
+    if (!_db) return @[];
+
+    try {
+        std::vector<vr::ChunkSpan> spans = _db->get_chunk_spans(std::string([sessionId UTF8String]));
+        NSMutableArray<VRChunkSpan *> *result =
+            [[NSMutableArray alloc] initWithCapacity:spans.size()];
+        for (const auto &s : spans) {
+            VRChunkSpan *span = [[VRChunkSpan alloc] init];
+            span.chunkIndex = static_cast<NSInteger>(s.chunk_index);
+            span.beginMs    = static_cast<NSInteger>(s.begin_ms);
+            span.endMs      = static_cast<NSInteger>(s.end_ms);
+            [result addObject:span];
+        }
+        return [result copy];
+    } catch (const std::exception &e) {
+        NSLog(@"[StorageBridge] getChunkSpansForSession exception: %s", e.what());
+        return @[];
+    }
+}
+
+- (NSData * _Nullable)getAudioForSession:(NSString *)sessionId
+                              chunkIndex:(NSInteger)chunkIndex {
+    if (!_db) return nil;
+
+    try {
+        const std::string sid = std::string([sessionId UTF8String]);
+        std::vector<float> pcm;
+        std::string path = [self archivePathForSession:sid];
+        if (path.empty()) {
+            pcm = _db->get_chunk_audio(sid, static_cast<int>(chunkIndex));
+            if (pcm.empty()) {
+                // Archived between the two reads: the blob is already gone.
+                path = [self archivePathForSession:sid];
+            }
+        }
+        if (!path.empty() && !ChunkFromArchive(path, chunkIndex, pcm)) return nil;
+        if (pcm.empty()) return nil;
+        return [NSData dataWithBytes:pcm.data() length:pcm.size() * sizeof(float)];
+    } catch (const std::exception &e) {
+        NSLog(@"[StorageBridge] getAudioForSession:chunkIndex: exception: %s", e.what());
+        return nil;
+    }
+}
+
+- (NSInteger)recoveryProgressForSession:(NSString *)sessionId {
+    if (!_db) return 0;
+
+    try {
+        return static_cast<NSInteger>(
+            _db->get_recovery_progress(std::string([sessionId UTF8String])));
+    } catch (const std::exception &e) {
+        NSLog(@"[StorageBridge] recoveryProgressForSession exception: %s", e.what());
+        return 0;
+    }
+}
+
+- (BOOL)saveRecoveredSegments:(NSArray<VRTranscriptSegment *> *)segments
+                   forSession:(NSString *)sessionId
+                       fromMs:(NSInteger)startMs
+                         toMs:(NSInteger)endMs {
+    if (!_db) return NO;
+
+    try {
+        if (!_db->save_recovered_range(std::string([sessionId UTF8String]),
+                                       static_cast<int64_t>(startMs),
+                                       static_cast<int64_t>(endMs),
+                                       SegmentsFromObjC(segments))) {
+            NSLog(@"[StorageBridge] save_recovered_range returned false for session %@", sessionId);
+            return NO;
+        }
+        return YES;
+    } catch (const std::exception &e) {
+        NSLog(@"[StorageBridge] saveRecoveredSegments exception: %s", e.what());
+        return NO;
+    }
+}
+
+- (void)finishRecoveryOfSession:(NSString *)sessionId
+                        outcome:(VRRecoveryOutcome)outcome {
+    if (!_db) return;
+
+    try {
+        std::string sid = std::string([sessionId UTF8String]);
+        switch (outcome) {
+            case VRRecoveryOutcomeRecovered: {
+                const std::vector<vr::TranscriptSegment> segments = _db->get_segments(sid);
+                const std::string transcript = vr::join_segments(segments);
+                if (transcript.empty()) {
+                    _db->mark_failed(sid);
+                    break;
+                }
+                const std::vector<vr::ChunkSpan> spans = _db->get_chunk_spans(sid);
+                _db->update_transcript(sid, transcript, spans.empty() ? 0 : spans.back().end_ms);
+                break;
+            }
+            case VRRecoveryOutcomeDiscarded:
+                _db->delete_session(sid);
+                break;
+            case VRRecoveryOutcomeFailed:
+                _db->mark_failed(sid);
+                break;
+        }
+    } catch (const std::exception &e) {
+        NSLog(@"[StorageBridge] finishRecoveryOfSession exception: %s", e.what());
+    }
+}
+
+// ---- Transcript cache -----------------------------------------------------
+
+- (NSData * _Nullable)transcriptCacheEntryForKey:(NSString *)key {
+    if (!_db || key.length == 0) return nil;
+
+    try {
+        std::vector<uint8_t> entry;
+        if (!_db->get_cached_transcript(std::string([key UTF8String]), entry)) return nil;
+        return [NSData dataWithBytes:entry.data() length:entry.size()];
+    } catch (const std::exception &e) {
+        NSLog(@"[StorageBridge] transcriptCacheEntryForKey exception: %s", e.what());
+        return nil;
+    }
+}
+
+- (void)storeTranscriptCacheEntry:(NSData *)entry
+                           forKey:(NSString *)key
+                          session:(NSString * _Nullable)sessionId {
+    if (!_db || key.length == 0 || entry.length == 0) return;
+
+    try {
+        const auto *bytes = static_cast<const uint8_t *>(entry.bytes);
+        const std::string sid = sessionId.length > 0 ? std::string([sessionId UTF8String]) : "";
+        if (!_db->put_cached_transcript(std::string([key UTF8String]), sid,
+                                        std::vector<uint8_t>(bytes, bytes + entry.length))) {
+            NSLog(@"[StorageBridge] put_cached_transcript returned false for key %@", key);
+        }
+    } catch (const std::exception &e) {
+        NSLog(@"[StorageBridge] storeTranscriptCacheEntry exception: %s", e.what());
+    }
+}
+
+// ---- Archives -------------------------------------------------------------
+
+/// Absolute path of the session's archive, or empty if it has none.  The
+/// database records file names relative to the archive directory.
+- (std::string)archivePathForSession:(const std::string &)sid {
+    const std::string name = _db ? _db->get_archive_path(sid) : std::string();
+    if (name.empty() || name.front() == '/') return name;
+    return std::string([[_archiveDirectory stringByAppendingPathComponent:@(name.c_str())]
+                           fileSystemRepresentation]);
+}
+
+- (BOOL)archiveSession:(NSString *)sessionId {
+    if (!_db) return NO;
+
+    try {
+        std::string sid = std::string([sessionId UTF8String]);
+        if (_writer) _writer->flush_and_wait(sid);
+        if (!_db->get_archive_path(sid).empty()) return YES;
+
+        std::optional<vr::RecordingSession> session = _db->get_session(sid);
+        if (!session || session->status == vr::RecordingStatus::recording) {
+            NSLog(@"[StorageBridge] Not archiving session %@: missing or still recording", sessionId);
+            return NO;
+        }
+
+        NSString *name = [sessionId stringByAppendingPathExtension:@(vr::SessionArchive::kFileExtension)];
+        const std::string path = std::string(
+            [[_archiveDirectory stringByAppendingPathComponent:name] fileSystemRepresentation]);
+        if (!WriteSessionArchive(*_db, sid, std::string(), path, vr::ChunkCodec::pcm_f32)) {
+            NSLog(@"[StorageBridge] Writing archive for session %@ failed", sessionId);
+            return NO;
+        }
+        if (!_db->attach_archive(sid, std::string([name UTF8String]))) {
+            // Deleted while it was being written; nothing points at the file.
+            std::remove(path.c_str());
+            NSLog(@"[StorageBridge] attach_archive returned false for session %@", sessionId);
+            return NO;
+        }
+        NSLog(@"[StorageBridge] Archived session %@", sessionId);
+        return YES;
+    } catch (const std::exception &e) {
+        NSLog(@"[StorageBridge] archiveSession exception: %s", e.what());
+        return NO;
+    }
+}
+
+- (void)archiveSessionInBackground:(NSString *)sessionId {
+    NSString *sid = [sessionId copy];
+    dispatch_async(_archiveQueue, ^{
+        [self archiveSession:sid];
+    });
+}
+
+- (void)archiveStoredSessionsWithCompletion:(void (^ _Nullable)(NSInteger archived))completion {
+    dispatch_async(_archiveQueue, ^{
+        NSInteger archived = 0;
+        if (self->_db) {
+            try {
+                for (const std::string &sid : self->_db->get_unarchived_sessions()) {
+                    if ([self archiveSession:@(sid.c_str())]) ++archived;
+                }
+                // The blobs' pages are free but still in the file.
+                if (archived > 0) self->_db->vacuum();
+            } catch (const std::exception &e) {
+                NSLog(@"[StorageBridge] archiveStoredSessions exception: %s", e.what());
+            }
+        }
+        if (completion) completion(archived);
+    });
+}
+
+- (NSURL * _Nullable)playableAudioURLForSession:(NSString *)sessionId {
+    if (!_db) return nil;
+
+    try {
+        const std::string path = [self archivePathForSession:std::string([sessionId UTF8String])];
+        if (path.empty()) return nil;
+        vr::SessionArchive archive(path);
+        if (!archive.open() || !archive.playable()) return nil;
+        return [NSURL fileURLWithPath:@(path.c_str())];
+    } catch (const std::exception &e) {
+        NSLog(@"[StorageBridge] playableAudioURLForSession exception: %s", e.what());
+        return nil;
+    }
+}
+
+- (BOOL)exportSession:(NSString *)sessionId
+                toURL:(NSURL *)url
+           compressed:(BOOL)compressed {
+    if (!_db) return NO;
+
+    try {
+        std::string sid = std::string([sessionId UTF8String]);
+        if (_writer) _writer->flush_and_wait(sid);
+        // Rewritten even when archived, so the metadata is current.
+        if (!WriteSessionArchive(*_db, sid, [self archivePathForSession:sid],
+                                 std::string(url.fileSystemRepresentation),
+                                 compressed ? vr::ChunkCodec::flac_s16 : vr::ChunkCodec::pcm_f32)) {
+            NSLog(@"[StorageBridge] Exporting session %@ to %@ failed", sessionId, url.path);
+            return NO;
+        }
+        return YES;
+    } catch (const std::exception &e) {
+        NSLog(@"[StorageBridge] exportSession exception: %s", e.what());
+        return NO;
+    }
+}
+
+- (NSString * _Nullable)importSessionFromURL:(NSURL *)url {
+    if (!_db) return nil;
+
+    try {
+        vr::SessionArchive source{std::string(url.fileSystemRepresentation)};
+        if (!source.open()) return nil;
+
+        NSString *name = [[NSUUID UUID].UUIDString.lowercaseString
+                             stringByAppendingPathExtension:@(vr::SessionArchive::kFileExtension)];
+        NSString *dest = [_archiveDirectory stringByAppendingPathComponent:name];
+        NSError *error = nil;
+        if (![[NSFileManager defaultManager] copyItemAtPath:url.path toPath:dest error:&error]) {
+            NSLog(@"[StorageBridge] Copying %@ into the archive directory failed: %@",
+                  url.path, error.localizedDescription);
+            return nil;
+        }
+
+        // Nothing is recording or transcribing it here, whatever its state
+        // when exported.
+        vr::RecordingSession session = source.metadata().session;
+        session.status = session.transcript.empty() ? vr::RecordingStatus::failed
+                                                    : vr::RecordingStatus::complete;
+
+        const std::string sid = _db->import_session(session, source.spans(),
+                                                    source.metadata().segments,
+                                                    std::string([name UTF8String]));
+        if (sid.empty()) {
+            [[NSFileManager defaultManager] removeItemAtPath:dest error:nil];
+            NSLog(@"[StorageBridge] import_session failed for %@", url.path);
+            return nil;
+        }
+        if (!StoreSessionWaveform(*_db, sid, std::string([dest fileSystemRepresentation]))) {
+            NSLog(@"[StorageBridge] No waveform for imported session %s", sid.c_str());
+        }
+        return [[NSString alloc] initWithUTF8String:sid.c_str()];
+    } catch (const std::exception &e) {
+        NSLog(@"[StorageBridge] importSessionFromURL exception: %s", e.what());
+        return nil;
+    }
+}
+
+- (void)exportAllSessionsToDirectory:(NSURL *)directory
+                          compressed:(BOOL)compressed
+                          completion:(void (^)(NSInteger exported))completion {
+    NSURL *dir = [directory copy];
+    dispatch_async(_archiveQueue, ^{
+        NSInteger exported = 0;
+        if (self->_db) {
+            try {
+                for (const vr::RecordingSession &s : self->_db->get_sessions()) {
+                    if (s.status == vr::RecordingStatus::recording) continue;
+                    NSString *sid = @(s.id.c_str());
+                    NSURL *url = [dir URLByAppendingPathComponent:
+                        [sid stringByAppendingPathExtension:@(vr::SessionArchive::kFileExtension)]];
+                    if ([self exportSession:sid toURL:url compressed:compressed]) ++exported;
+                }
+            } catch (const std::exception &e) {
+                NSLog(@"[StorageBridge] exportAllSessions exception: %s", e.what());
+            }
+        }
+        completion(exported);
+    });
+}
+
+- (void)importSessionsFromURLs:(NSArray<NSURL *> *)urls
+                    completion:(void (^)(NSArray<NSString *> *sessionIds))completion {
+    NSArray<NSURL *> *files = [urls copy];
+    dispatch_async(_archiveQueue, ^{
+        NSMutableArray<NSString *> *imported = [[NSMutableArray alloc] initWithCapacity:files.count];
+        for (NSURL *url in files) {
+            NSString *sid = [self importSessionFromURL:url];
+            if (sid) [imported addObject:sid];
+        }
+        completion([imported copy]);
+    });
+}
+
 @end
@@ -8,3 +8,7 @@
 
 #import "WhisperBridge.h"
 #import "StorageBridge.h"
+#import "MeteringBridge.h"
+#import "CaptureBridge.h"
+#import "SegmentBridge.h"
+#import "MetricsBridge.h"
@@ -2,14 +2,48 @@
 //  WhisperBridge.h
 //  Objective-C interface wrapping the C++ WhisperEngine + AudioConverter.
 //
-//  Thread-safe.  Transcription runs on a background dispatch queue; progress
-//  and completion blocks are always dispatched back to the main queue.
+//  Thread-safe.  One-shot transcriptions run on a priority scheduler's
+//  workers (see VRTranscriptionPriority); progress and completion blocks are
+//  always dispatched back to the main queue.
 //
 
 #import <Foundation/Foundation.h>
 
+#import "CaptureBridge.h"
+#import "SegmentBridge.h"
+#import "StorageBridge.h"
+
 NS_ASSUME_NONNULL_BEGIN
 
+/// Model speed / accuracy tier (mirrors vr::ModelTier).  Used both to
+/// register models and to route requests; Automatic only applies to
+/// requests (short clips go to the fast tier, the rest to standard).
+typedef NS_ENUM(NSInteger, VRModelTier) {
+    VRModelTierAutomatic = 0,
+    VRModelTierFast,
+    VRModelTierStandard,
+    VRModelTierAccurate,
+};
+
+/// Scheduling class of a one-shot transcription (mirrors vr::JobPriority).
+/// Background jobs never take the last free engine state and are
+/// preempted (then restarted) when a more urgent job needs a worker.
+typedef NS_ENUM(NSInteger, VRTranscriptionPriority) {
+    VRTranscriptionPriorityInteractive = 0,   // a dictation that just stopped
+    VRTranscriptionPriorityUserInitiated,     // a retry the user asked for
+    VRTranscriptionPriorityBackground,        // bulk work nobody is waiting on
+};
+
+/// Cancellation token for one queued transcription.
+@interface VRTranscriptionJob : NSObject
+
+/// Drop the job if it is still queued, abort it if it is running.  Its
+/// completion then receives a cancellation error (see
+/// +[WhisperBridge isCancellationError:]).  No effect once it finished.
+- (void)cancel;
+
+@end
+
 /// Obj-C wrapper around `vr::WhisperEngine` and `vr::AudioConverter`.
 ///
 /// Typical usage from Swift:
@@ -26,13 +60,65 @@ NS_ASSUME_NONNULL_BEGIN
 /// Returns YES on success, NO on failure (bad path, corrupt model, etc.).
 - (BOOL)loadModel:(NSString *)modelPath;
 
-/// Whether a model has been successfully loaded and is ready for inference.
+/// Load and warm up a model in the background (see WhisperEngine::preload).
+/// Returns immediately.  Transcription requests made before the load
+/// finishes wait for it.  The completion block receives the result on the
+/// **main queue**.
+- (void)preloadModel:(NSString *)modelPath
+          completion:(void (^ _Nullable)(BOOL success))completionBlock;
+
+/// Whether a model is loaded, or a preload is in progress, so transcription
+/// requests can be made.
 - (BOOL)isModelLoaded;
 
+// ---- Model registry -------------------------------------------------------
+
+/// Load an additional model in the background and register it for routing
+/// under `identifier` (e.g. a tiny model as VRModelTierFast).  Loaded
+/// models beyond `modelMemoryBudget` are evicted least-recently-used first.
+/// The completion block receives the result on the **main queue**.
+- (void)registerModel:(NSString *)modelPath
+           identifier:(NSString *)identifier
+                 tier:(VRModelTier)tier
+           completion:(void (^ _Nullable)(BOOL success))completionBlock;
+
+/// Unregister a model.  Requests already running on it finish normally.
+- (BOOL)unregisterModel:(NSString *)identifier;
+
+/// Atomically make a registered model the default for new requests.
+- (BOOL)makeDefaultModel:(NSString *)identifier;
+
+/// Approximate memory budget for all loaded models, in bytes.
+@property (nonatomic) NSUInteger modelMemoryBudget;
+
+// ---- Threading ------------------------------------------------------------
+
+/// CPU threads per transcription request.  Reads the effective count for a
+/// request running alone on the default model; set a positive value to
+/// override the automatic policy, or 0 to restore it (calibrated per model,
+/// split across concurrent requests).
+@property (nonatomic) NSInteger inferenceThreadCount;
+
+/// Whether `inferenceThreadCount` is an override rather than automatic.
+@property (nonatomic, readonly) BOOL inferenceThreadCountOverridden;
+
+/// Performance / efficiency core counts detected on this Mac.
+@property (nonatomic, readonly) NSInteger performanceCoreCount;
+@property (nonatomic, readonly) NSInteger efficiencyCoreCount;
+
+/// File that persists per-model thread calibration across launches.  Call
+/// before loading models.
++ (void)setThreadCalibrationCachePath:(NSString *)path;
+
+/// Skip silence with voice-activity detection before inference (default YES).
+/// Audio with no detected speech completes with an empty transcript.
+@property (nonatomic) BOOL voiceActivityDetectionEnabled;
+
 /// Transcribe audio from an M4A (or other supported) file on disk.
 ///
 /// The file is first converted to raw PCM via AudioConverter, then fed into
-/// WhisperEngine.  The work happens on a background serial queue.
+/// WhisperEngine.  Runs as an interactive job on the scheduler; independent
+/// requests run in parallel up to the engine's state pool size.
 ///
 /// @param audioPath      Absolute path to the audio file (typically M4A).
 /// @param sampleRate     Desired decode sample rate (e.g. 16000).
@@ -48,7 +134,7 @@ NS_ASSUME_NONNULL_BEGIN
 /// Transcribe raw PCM Float32 audio data directly (no file I/O needed).
 ///
 /// The data should be mono Float32 samples at the given sample rate.
-/// Runs on a background serial queue.
+/// Runs as an interactive job (see above).
 ///
 /// @param pcmData         Raw PCM data (mono Float32 samples as bytes).
 /// @param sampleRate      Sample rate of the PCM data (e.g. 16000).
@@ -61,6 +147,191 @@ NS_ASSUME_NONNULL_BEGIN
                completion:(void (^)(NSString * _Nullable transcript,
                                     NSError * _Nullable error))completionBlock;
 
+/// Same as above, routed to a specific model tier (e.g. VRModelTierAccurate
+/// for retries and crash recovery).  Falls back to whatever is loaded.
+- (void)transcribePCMData:(NSData *)pcmData
+               sampleRate:(int)sampleRate
+                     tier:(VRModelTier)tier
+                 progress:(void (^)(float progress))progressBlock
+               completion:(void (^)(NSString * _Nullable transcript,
+                                    NSError * _Nullable error))completionBlock;
+
+/// Transcribe `[startMs, endMs)` of the PCM data (endMs <= 0 means to the
+/// end) and deliver timed segments with their token confidence, e.g. to
+/// re-run low-confidence spans on VRModelTierAccurate.  Segment times are
+/// relative to the start of `pcmData`, not of the range.  The completion
+/// block receives the joined transcript and its segments on the
+/// **main queue**.
+- (void)transcribeSegmentsOfPCMData:(NSData *)pcmData
+                         sampleRate:(int)sampleRate
+                             fromMs:(NSInteger)startMs
+                               toMs:(NSInteger)endMs
+                               tier:(VRModelTier)tier
+                           progress:(void (^ _Nullable)(float progress))progressBlock
+                         completion:(void (^)(NSString * _Nullable transcript,
+                                              NSArray<VRTranscriptSegment *> * _Nullable segments,
+                                              NSError * _Nullable error))completionBlock;
+
+/// Same, scheduled as `priority` and tagged with `sessionId`.  A repeat
+/// request for the same session (and range) supersedes one still queued or
+/// running, whose completion gets a cancellation error; the new request
+/// keeps the more urgent priority.  Short clips (a few seconds) of
+/// non-interactive requests are batched onto one engine state.
+/// @return A token that cancels the request.
+- (VRTranscriptionJob *)transcribeSegmentsOfPCMData:(NSData *)pcmData
+                                         sampleRate:(int)sampleRate
+                                             fromMs:(NSInteger)startMs
+                                               toMs:(NSInteger)endMs
+                                               tier:(VRModelTier)tier
+                                           priority:(VRTranscriptionPriority)priority
+                                          sessionId:(NSString * _Nullable)sessionId
+                                           progress:(void (^ _Nullable)(float progress))progressBlock
+                                         completion:(void (^)(NSString * _Nullable transcript,
+                                                              NSArray<VRTranscriptSegment *> * _Nullable segments,
+                                                              NSError * _Nullable error))completionBlock;
+
+/// Transcribe a stored session chunk by chunk (each chunk prompted with the
+/// tail of the one before), scheduled as `priority` and tagged with
+/// `sessionId` like the call above.  Only one chunk's audio is in memory at
+/// a time, and with a transcript cache attached chunks already transcribed
+/// with the same model and parameters come from the cache — a retry reruns
+/// only what failed.  Segment times are relative to the session.
+/// @return A token that cancels the request.
+- (VRTranscriptionJob *)transcribeSession:(NSString *)sessionId
+                              fromStorage:(StorageBridge *)storage
+                                     tier:(VRModelTier)tier
+                                 priority:(VRTranscriptionPriority)priority
+                                 progress:(void (^ _Nullable)(float progress))progressBlock
+                               completion:(void (^)(NSString * _Nullable transcript,
+                                                    NSArray<VRTranscriptSegment *> * _Nullable segments,
+                                                    NSError * _Nullable error))completionBlock;
+
+/// Cancel every queued or running one-shot transcription of `sessionId`.
+- (void)cancelTranscriptionsForSession:(NSString *)sessionId;
+
+/// One-shot transcriptions queued or running at `priority`.
+- (NSInteger)pendingTranscriptionsWithPriority:(VRTranscriptionPriority)priority;
+
+/// Whether `error` is the completion error of a cancelled or superseded
+/// request (rather than a failure worth reporting).
++ (BOOL)isCancellationError:(NSError * _Nullable)error;
+
+// ---- Transcript cache -----------------------------------------------------
+
+/// Cache transcription results in `storage`, keyed by a hash of the audio,
+/// the model it routes to and the decode parameters, so identical requests
+/// (retries, re-imports, an interrupted recovery) skip inference.  Used by
+/// one-shot transcriptions and crash recovery.  Call once, at launch,
+/// before any transcription is requested.
+- (void)attachTranscriptCacheToStorage:(StorageBridge *)storage;
+
+// ---- Background refinement ---------------------------------------------
+
+/// Queue a second, high-accuracy pass over a finished session: the
+/// accurate tier with beam search, on a low-priority background thread,
+/// one session at a time.  `loaderBlock` is called on that thread when the
+/// job starts and should return the session's 16 kHz mono Float32 PCM.
+/// `completionBlock` receives the refined transcript and its segments on
+/// the **main queue**; it is not called if refinement fails or finds no
+/// speech.  Re-queuing a session replaces its pending job.
+- (void)refineSession:(NSString *)sessionId
+          audioLoader:(NSData * _Nullable (^)(void))loaderBlock
+           completion:(void (^)(NSString *transcript,
+                                NSArray<VRTranscriptSegment *> *segments))completionBlock;
+
+/// Drop any pending or running refinement of `sessionId`.
+- (void)cancelRefinementForSession:(NSString *)sessionId;
+
+/// Yield to a live recording: aborts the running refinement (it restarts
+/// after -resumeRefinement) and holds the queue.  Calls nest.
+- (void)pauseRefinement;
+- (void)resumeRefinement;
+
+/// Sessions queued or being refined.
+@property (nonatomic, readonly) NSInteger pendingRefinements;
+
+// ---- Crash recovery -------------------------------------------------------
+
+/// Transcribe sessions orphaned by a crash, off the launch path: returns
+/// immediately, and a background-QoS worker recovers the sessions one at a
+/// time on the accurate tier, chunk by chunk, checkpointing each chunk in
+/// `storage` so an interrupted recovery resumes where it stopped (also
+/// across launches).  Sessions shorter than `minimumDurationMs` are
+/// discarded.  `completionBlock` runs on the **main queue** once per
+/// session.  Call once, at launch; later calls queue more sessions with the
+/// first call's storage and completion.
+- (void)recoverSessions:(NSArray<NSString *> *)sessionIds
+            fromStorage:(StorageBridge *)storage
+      minimumDurationMs:(NSInteger)minimumDurationMs
+             completion:(void (^)(NSString *sessionId,
+                                  VRRecoveryOutcome outcome))completionBlock;
+
+/// Stop recovering.  Progress is kept; the sessions stay orphaned and are
+/// resumed at the next launch.
+- (void)cancelRecovery;
+
+/// Stop recovering `sessionId` (e.g. it is being deleted).
+- (void)cancelRecoveryForSession:(NSString *)sessionId;
+
+/// Yield to a live recording or transcription: aborts the chunk being
+/// recovered (it is redone after -resumeRecovery) and holds the queue.
+/// Calls nest.
+- (void)pauseRecovery;
+- (void)resumeRecovery;
+
+/// Orphaned sessions queued or being recovered.
+@property (nonatomic, readonly) NSInteger pendingRecoveries;
+
+// ---- Streaming ------------------------------------------------------------
+
+/// Start an incremental transcription stream for a new recording.
+/// Chunks handed to -feedStreamPCMData:completion: are transcribed on the
+/// background queue while recording continues, so the wait after stop only
+/// covers the final chunk.  Discards any stream already in progress.
+- (void)beginStreamWithSampleRate:(int)sampleRate;
+
+/// Append a chunk of mono Float32 PCM to the current stream.
+/// Complete 35-second windows are transcribed immediately; the completion
+/// block receives their text (empty if the chunk only partially filled a
+/// window) on the **main queue**.
+- (void)feedStreamPCMData:(NSData *)pcmData
+               completion:(void (^ _Nullable)(NSString * _Nullable text,
+                                              NSError * _Nullable error))completionBlock;
+
+/// Transcribe whatever audio is still buffered and close the stream.
+/// The completion block receives the full transcript and the segments of
+/// every window, timed from the start of the stream, on the **main queue**.
+- (void)finishStreamWithProgress:(void (^)(float progress))progressBlock
+                      completion:(void (^)(NSString * _Nullable transcript,
+                                           NSArray<VRTranscriptSegment *> * _Nullable segments,
+                                           NSError * _Nullable error))completionBlock;
+
+/// Drop the current stream without transcribing its buffered tail.
+- (void)cancelStream;
+
+/// Milliseconds of audio each stream window re-transcribes from the end
+/// of the previous one, so words cut by the boundary come out whole; the
+/// repeated words are merged away.  0 disables it.  Applies from the next
+/// -beginStreamWithSampleRate:.  Each window is also prompted with the
+/// transcript so far, with or without overlap.
+@property (nonatomic) NSInteger streamOverlapMs;
+
+// ---- Live captions --------------------------------------------------------
+
+/// Caption the recording in `capture` while it runs: about every 500 ms
+/// the last few seconds are decoded on the fast model, on an engine state
+/// of their own.  Captions back off when decoding falls behind, while a
+/// transcription runs (stream windows always go first) and when capture
+/// drops audio.  `handler` runs on the **main queue** with the settled
+/// text (its last words) and the tentative text after it, which later
+/// updates may revise.  Replaces captions already running.
+- (void)startLiveCaptionsFromCapture:(VRCaptureBuffer *)capture
+                             handler:(void (^)(NSString *stable, NSString *partial))handler;
+
+/// Stop captioning and free the caption state.  Updates already
+/// dispatched may still arrive.
+- (void)stopLiveCaptions;
+
 /// Explicitly free the whisper engine and all GGML backends.
 /// Must be called before process exit to avoid a crash in ggml_metal_rsets_free
 /// when C++ static destructors race with the Metal residency-set background thread.
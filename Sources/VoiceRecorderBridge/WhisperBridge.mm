@@ -7,8 +7,16 @@
 
 #include "WhisperEngine.hpp"
 #include "AudioConverter.hpp"
+#include "CpuTopology.hpp"
+#include "LiveCaptioner.hpp"
+#include "RecoveryScheduler.hpp"
+#include "RefinementQueue.hpp"
+#include "TranscriptCache.hpp"
+#include "TranscriptionScheduler.hpp"
 
+#include <algorithm>
 #include <memory>
+#include <optional>
 #include <string>
 #include <vector>
 
@@ -23,8 +31,96 @@ typedef NS_ENUM(NSInteger, WhisperBridgeErrorCode) {
     WhisperBridgeErrorConversionFailed,
     WhisperBridgeErrorTranscriptionFailed,
     WhisperBridgeErrorFileNotFound,
+    WhisperBridgeErrorCancelled,
 };
 
+/// VRTranscriptionPriority → vr::JobPriority.
+static vr::JobPriority PriorityFromObjC(VRTranscriptionPriority priority) {
+    switch (priority) {
+        case VRTranscriptionPriorityUserInitiated: return vr::JobPriority::user_initiated;
+        case VRTranscriptionPriorityBackground:    return vr::JobPriority::background;
+        default:                                   return vr::JobPriority::interactive;
+    }
+}
+
+/// Completion error for a cancelled or superseded request.
+static NSError *CancelledError(void) {
+    return [NSError errorWithDomain:kWhisperBridgeErrorDomain
+                               code:WhisperBridgeErrorCancelled
+                           userInfo:@{NSLocalizedDescriptionKey: @"Transcription was cancelled."}];
+}
+
+/// VRModelTier → vr::ModelTier; Automatic maps to nullopt (engine routing).
+static std::optional<vr::ModelTier> TierFromObjC(VRModelTier tier) {
+    switch (tier) {
+        case VRModelTierFast:     return vr::ModelTier::fast;
+        case VRModelTierStandard: return vr::ModelTier::standard;
+        case VRModelTierAccurate: return vr::ModelTier::accurate;
+        default:                  return std::nullopt;
+    }
+}
+
+/// Convert engine segments to VRTranscriptSegment objects.
+static NSArray<VRTranscriptSegment *> *SegmentsToObjC(const std::vector<vr::TranscriptSegment> &segments) {
+    NSMutableArray<VRTranscriptSegment *> *result =
+        [[NSMutableArray alloc] initWithCapacity:segments.size()];
+    for (const auto &s : segments) {
+        VRTranscriptSegment *obj = [[VRTranscriptSegment alloc] init];
+        obj.startMs     = static_cast<NSInteger>(s.t0_ms);
+        obj.endMs       = static_cast<NSInteger>(s.t1_ms);
+        obj.text        = [[NSString alloc] initWithUTF8String:s.text.c_str()] ?: @"";
+        obj.probability = s.avg_prob;
+        obj.chunkIndex  = static_cast<NSInteger>(s.chunk_index);
+        [result addObject:obj];
+    }
+    return [result copy];
+}
+
+/// Convert VRTranscriptSegment objects back to engine segments.
+static std::vector<vr::TranscriptSegment> SegmentsFromObjC(NSArray<VRTranscriptSegment *> *segments) {
+    std::vector<vr::TranscriptSegment> result;
+    result.reserve(segments.count);
+    for (VRTranscriptSegment *obj in segments) {
+        vr::TranscriptSegment s;
+        s.t0_ms       = static_cast<int64_t>(obj.startMs);
+        s.t1_ms       = static_cast<int64_t>(obj.endMs);
+        s.text        = obj.text.length ? std::string([obj.text UTF8String]) : std::string();
+        s.avg_prob    = obj.probability;
+        s.chunk_index = static_cast<int32_t>(obj.chunkIndex);
+        result.push_back(std::move(s));
+    }
+    return result;
+}
+
+/// The session's chunk spans from `storage` (reads no audio).
+static std::vector<vr::ChunkSpan> SpansFromStorage(StorageBridge *storage, NSString *sessionId) {
+    std::vector<vr::ChunkSpan> spans;
+    @autoreleasepool {
+        for (VRChunkSpan *span in [storage getChunkSpansForSession:sessionId]) {
+            vr::ChunkSpan s;
+            s.chunk_index = static_cast<int32_t>(span.chunkIndex);
+            s.begin_ms    = static_cast<int64_t>(span.beginMs);
+            s.end_ms      = static_cast<int64_t>(span.endMs);
+            spans.push_back(s);
+        }
+    }
+    return spans;
+}
+
+/// One chunk of a session from `storage` as 16 kHz mono float32.
+static std::vector<float> ChunkFromStorage(StorageBridge *storage, NSString *sessionId,
+                                           const vr::ChunkSpan &span) {
+    std::vector<float> pcm;
+    @autoreleasepool {
+        NSData *data = [storage getAudioForSession:sessionId chunkIndex:span.chunk_index];
+        if (data.length >= sizeof(float)) {
+            const float *samples = static_cast<const float *>(data.bytes);
+            pcm.assign(samples, samples + data.length / sizeof(float));
+        }
+    }
+    return pcm;
+}
+
 // ---------------------------------------------------------------------------
 // Private interface
 // ---------------------------------------------------------------------------
@@ -32,10 +128,42 @@ typedef NS_ENUM(NSInteger, WhisperBridgeErrorCode) {
 @interface WhisperBridge () {
     std::unique_ptr<vr::WhisperEngine>   _engine;
     std::unique_ptr<vr::AudioConverter>  _converter;
-    dispatch_queue_t                     _workerQueue;
+    std::unique_ptr<vr::RefinementQueue> _refiner;       // background second pass
+    std::unique_ptr<vr::RecoveryScheduler> _recovery;    // crash recovery, created on demand
+    NSInteger                            _recoveryPauses; // pauses made before _recovery existed
+    std::unique_ptr<vr::TranscriptionScheduler> _scheduler;   // one-shot jobs, by priority
+    std::unique_ptr<vr::TranscriptCache> _cache;         // results by content, once attached
+    std::unique_ptr<vr::LiveCaptioner> _captioner;       // while a recording is captioned
+    dispatch_queue_t                     _streamQueue;   // serial: stream calls, in order
 }
 @end
 
+// ---------------------------------------------------------------------------
+// VRTranscriptionJob
+// ---------------------------------------------------------------------------
+
+@interface VRTranscriptionJob () {
+    void (^_cancelHandler)(void);
+}
+- (instancetype)initWithCancelHandler:(void (^)(void))handler;
+@end
+
+@implementation VRTranscriptionJob
+
+- (instancetype)initWithCancelHandler:(void (^)(void))handler {
+    self = [super init];
+    if (self) {
+        _cancelHandler = [handler copy];
+    }
+    return self;
+}
+
+- (void)cancel {
+    if (_cancelHandler) _cancelHandler();
+}
+
+@end
+
 // ---------------------------------------------------------------------------
 // Implementation
 // ---------------------------------------------------------------------------
@@ -47,7 +175,11 @@ typedef NS_ENUM(NSInteger, WhisperBridgeErrorCode) {
     if (self) {
         _engine    = std::make_unique<vr::WhisperEngine>();
         _converter = std::make_unique<vr::AudioConverter>();
-        _workerQueue = dispatch_queue_create("com.brainphart.whisperbridge.worker",
+        _refiner   = std::make_unique<vr::RefinementQueue>(*_engine);
+        // One worker per engine state, so each running job holds one.
+        _scheduler = std::make_unique<vr::TranscriptionScheduler>(
+            vr::WhisperEngine::kDefaultStateCount);
+        _streamQueue = dispatch_queue_create("com.brainphart.whisperbridge.stream",
                                              DISPATCH_QUEUE_SERIAL);
     }
     return self;
@@ -73,8 +205,116 @@ typedef NS_ENUM(NSInteger, WhisperBridgeErrorCode) {
     }
 }
 
+- (void)preloadModel:(NSString *)modelPath
+          completion:(void (^ _Nullable)(BOOL success))completionBlock {
+    void (^safeCompletion)(BOOL) = [completionBlock copy];
+    if (!modelPath || modelPath.length == 0) {
+        NSLog(@"[WhisperBridge] preloadModel called with empty path");
+        if (safeCompletion) {
+            dispatch_async(dispatch_get_main_queue(), ^{ safeCompletion(NO); });
+        }
+        return;
+    }
+
+    NSLog(@"[WhisperBridge] Preloading model from: %@", modelPath);
+    std::shared_future<bool> loaded = _engine->preload(std::string([modelPath UTF8String]));
+
+    // Wait off the main thread; the load itself runs on the engine's thread.
+    dispatch_async(dispatch_get_global_queue(QOS_CLASS_UTILITY, 0), ^{
+        BOOL ok = NO;
+        try {
+            ok = loaded.get() ? YES : NO;
+        } catch (const std::exception &e) {
+            NSLog(@"[WhisperBridge] preloadModel exception: %s", e.what());
+        }
+        NSLog(@"[WhisperBridge] Model preload %@", ok ? @"succeeded" : @"FAILED");
+        if (safeCompletion) {
+            dispatch_async(dispatch_get_main_queue(), ^{ safeCompletion(ok); });
+        }
+    });
+}
+
 - (BOOL)isModelLoaded {
-    return _engine->is_loaded() ? YES : NO;
+    return (_engine->is_loaded() || _engine->is_loading()) ? YES : NO;
+}
+
+// ---- Model registry -------------------------------------------------------
+
+- (void)registerModel:(NSString *)modelPath
+           identifier:(NSString *)identifier
+                 tier:(VRModelTier)tier
+           completion:(void (^ _Nullable)(BOOL success))completionBlock {
+    void (^safeCompletion)(BOOL) = [completionBlock copy];
+    const std::string path = modelPath.length ? std::string([modelPath UTF8String]) : std::string();
+    const std::string ident = identifier.length ? std::string([identifier UTF8String]) : path;
+    const vr::ModelTier engineTier = TierFromObjC(tier).value_or(vr::ModelTier::standard);
+
+    dispatch_async(dispatch_get_global_queue(QOS_CLASS_UTILITY, 0), ^{
+        BOOL ok = NO;
+        if (!path.empty() && self->_engine) {
+            try {
+                ok = self->_engine->add_model(ident, path, engineTier) ? YES : NO;
+            } catch (const std::exception &e) {
+                NSLog(@"[WhisperBridge] registerModel exception: %s", e.what());
+            }
+        }
+        NSLog(@"[WhisperBridge] Register model %@ (%@) %@", identifier, modelPath,
+              ok ? @"succeeded" : @"FAILED");
+        if (safeCompletion) {
+            dispatch_async(dispatch_get_main_queue(), ^{ safeCompletion(ok); });
+        }
+    });
+}
+
+- (BOOL)unregisterModel:(NSString *)identifier {
+    if (!_engine || identifier.length == 0) return NO;
+    return _engine->remove_model(std::string([identifier UTF8String])) ? YES : NO;
+}
+
+- (BOOL)makeDefaultModel:(NSString *)identifier {
+    if (!_engine || identifier.length == 0) return NO;
+    return _engine->set_default_model(std::string([identifier UTF8String])) ? YES : NO;
+}
+
+- (NSUInteger)modelMemoryBudget {
+    return _engine ? static_cast<NSUInteger>(_engine->memory_budget()) : 0;
+}
+
+- (void)setModelMemoryBudget:(NSUInteger)bytes {
+    if (_engine) _engine->set_memory_budget(static_cast<size_t>(bytes));
+}
+
+- (NSInteger)inferenceThreadCount {
+    return _engine ? static_cast<NSInteger>(_engine->thread_count()) : 0;
+}
+
+- (void)setInferenceThreadCount:(NSInteger)count {
+    if (_engine) _engine->set_thread_count(static_cast<int>(std::max<NSInteger>(0, count)));
+}
+
+- (BOOL)inferenceThreadCountOverridden {
+    return (_engine && _engine->thread_count_overridden()) ? YES : NO;
+}
+
+- (NSInteger)performanceCoreCount {
+    return vr::CpuTopology::current().performance_cores;
+}
+
+- (NSInteger)efficiencyCoreCount {
+    return vr::CpuTopology::current().efficiency_cores;
+}
+
++ (void)setThreadCalibrationCachePath:(NSString *)path {
+    vr::WhisperEngine::set_calibration_cache_path(path.length ? std::string([path UTF8String])
+                                                              : std::string());
+}
+
+- (BOOL)voiceActivityDetectionEnabled {
+    return (_engine && _engine->vad_enabled()) ? YES : NO;
+}
+
+- (void)setVoiceActivityDetectionEnabled:(BOOL)enabled {
+    if (_engine) _engine->set_vad_enabled(enabled == YES);
 }
 
 // ---- Transcription --------------------------------------------------------
@@ -85,15 +325,21 @@ typedef NS_ENUM(NSInteger, WhisperBridgeErrorCode) {
                    completion:(void (^)(NSString * _Nullable transcript,
                                         NSError * _Nullable error))completionBlock {
 
-    // Capture Obj-C blocks into the dispatch call.
     // Copy blocks so they outlive this scope.
     void (^safeProgress)(float) = [progressBlock copy];
     void (^safeCompletion)(NSString * _Nullable, NSError * _Nullable) = [completionBlock copy];
 
-    dispatch_async(_workerQueue, ^{
+    if (!_scheduler) {
+        [self dispatchCompletion:safeCompletion transcript:nil error:CancelledError()];
+        return;
+    }
+
+    vr::TranscriptionJob job;
+    job.priority = vr::JobPriority::interactive;
+    job.run = [self, audioPath, sampleRate, safeProgress, safeCompletion](const std::atomic<bool> &abort) {
 
         // 1. Pre-flight checks
-        if (!self->_engine->is_loaded()) {
+        if (![self isModelLoaded]) {
             NSError *err = [NSError errorWithDomain:kWhisperBridgeErrorDomain
                                                code:WhisperBridgeErrorModelNotLoaded
                                            userInfo:@{NSLocalizedDescriptionKey:
@@ -148,9 +394,18 @@ typedef NS_ENUM(NSInteger, WhisperBridgeErrorCode) {
 
         // 4. Run transcription
         NSLog(@"[WhisperBridge] PCM samples: %zu, running whisper...", pcm.size());
+        vr::TranscribeOptions options;
+        options.abort = &abort;
         std::string result;
         try {
-            result = self->_engine->transcribe(pcm, sampleRate, cppProgress);
+            if (self->_cache) {
+                result = vr::join_segments(self->_cache->transcribe(
+                    pcm.data(), pcm.size(), sampleRate, std::string(), cppProgress, options));
+            } else {
+                result = self->_engine->transcribe(pcm, sampleRate, cppProgress, options);
+            }
+        } catch (const vr::TranscriptionAborted &) {
+            throw;   // the scheduler delivers the cancellation
         } catch (const std::exception &e) {
             NSError *err = [NSError errorWithDomain:kWhisperBridgeErrorDomain
                                                code:WhisperBridgeErrorTranscriptionFailed
@@ -164,7 +419,11 @@ typedef NS_ENUM(NSInteger, WhisperBridgeErrorCode) {
         NSLog(@"[WhisperBridge] Transcription complete, length=%zu", result.size());
         NSString *transcript = [[NSString alloc] initWithUTF8String:result.c_str()];
         [self dispatchCompletion:safeCompletion transcript:transcript error:nil];
-    });
+    };
+    job.cancelled = [self, safeCompletion]() {
+        [self dispatchCompletion:safeCompletion transcript:nil error:CancelledError()];
+    };
+    _scheduler->submit(std::move(job));
 }
 
 // ---- Direct PCM transcription ---------------------------------------------
@@ -174,19 +433,114 @@ typedef NS_ENUM(NSInteger, WhisperBridgeErrorCode) {
                  progress:(void (^)(float progress))progressBlock
                completion:(void (^)(NSString * _Nullable transcript,
                                     NSError * _Nullable error))completionBlock {
+    [self transcribePCMData:pcmData
+                 sampleRate:sampleRate
+                       tier:VRModelTierAutomatic
+                   progress:progressBlock
+                 completion:completionBlock];
+}
 
-    void (^safeProgress)(float) = [progressBlock copy];
+- (void)transcribePCMData:(NSData *)pcmData
+               sampleRate:(int)sampleRate
+                     tier:(VRModelTier)tier
+                 progress:(void (^)(float progress))progressBlock
+               completion:(void (^)(NSString * _Nullable transcript,
+                                    NSError * _Nullable error))completionBlock {
     void (^safeCompletion)(NSString * _Nullable, NSError * _Nullable) = [completionBlock copy];
+    [self transcribeSegmentsOfPCMData:pcmData
+                           sampleRate:sampleRate
+                               fromMs:0
+                                 toMs:0
+                                 tier:tier
+                             progress:progressBlock
+                           completion:^(NSString * _Nullable transcript,
+                                        NSArray<VRTranscriptSegment *> * _Nullable segments,
+                                        NSError * _Nullable error) {
+        if (safeCompletion) safeCompletion(transcript, error);
+    }];
+}
+
+- (void)transcribeSegmentsOfPCMData:(NSData *)pcmData
+                         sampleRate:(int)sampleRate
+                             fromMs:(NSInteger)startMs
+                               toMs:(NSInteger)endMs
+                               tier:(VRModelTier)tier
+                           progress:(void (^ _Nullable)(float progress))progressBlock
+                         completion:(void (^)(NSString * _Nullable transcript,
+                                              NSArray<VRTranscriptSegment *> * _Nullable segments,
+                                              NSError * _Nullable error))completionBlock {
+    [self transcribeSegmentsOfPCMData:pcmData
+                           sampleRate:sampleRate
+                               fromMs:startMs
+                                 toMs:endMs
+                                 tier:tier
+                             priority:VRTranscriptionPriorityInteractive
+                            sessionId:nil
+                             progress:progressBlock
+                           completion:completionBlock];
+}
+
+- (VRTranscriptionJob *)transcribeSegmentsOfPCMData:(NSData *)pcmData
+                                         sampleRate:(int)sampleRate
+                                             fromMs:(NSInteger)startMs
+                                               toMs:(NSInteger)endMs
+                                               tier:(VRModelTier)tier
+                                           priority:(VRTranscriptionPriority)priority
+                                          sessionId:(NSString * _Nullable)sessionId
+                                           progress:(void (^ _Nullable)(float progress))progressBlock
+                                         completion:(void (^)(NSString * _Nullable transcript,
+                                                              NSArray<VRTranscriptSegment *> * _Nullable segments,
+                                                              NSError * _Nullable error))completionBlock {
+
+    vr::TranscribeOptions options;
+    options.tier     = TierFromObjC(tier);
+    options.begin_ms = static_cast<int64_t>(MAX(startMs, 0));
+    options.end_ms   = static_cast<int64_t>(MAX(endMs, 0));
+    void (^safeProgress)(float) = [progressBlock copy];
+    void (^safeCompletion)(NSString * _Nullable, NSArray<VRTranscriptSegment *> * _Nullable,
+                           NSError * _Nullable) = [completionBlock copy];
+
+    if (!_scheduler) {
+        [self dispatchSegmentsCompletion:safeCompletion transcript:nil segments:nil
+                                   error:CancelledError()];
+        return [[VRTranscriptionJob alloc] initWithCancelHandler:^{}];
+    }
+
+    vr::TranscriptionJob job;
+    job.priority = PriorityFromObjC(priority);
+    if (sessionId.length > 0) {
+        job.session_id = std::string([sessionId UTF8String]);
+        job.key        = job.session_id;
+        if (options.begin_ms > 0 || options.end_ms > 0) {
+            job.key += "@" + std::to_string(options.begin_ms) + "-" + std::to_string(options.end_ms);
+        }
+    }
+    // Length of what will actually be transcribed, for batching.
+    if (sampleRate > 0) {
+        const size_t total = pcmData.length / sizeof(float);
+        const auto at_ms = [&](int64_t ms) {
+            return std::min(total, static_cast<size_t>(ms * sampleRate / 1000));
+        };
+        const size_t from = at_ms(options.begin_ms);
+        const size_t to   = options.end_ms > 0 ? at_ms(options.end_ms) : total;
+        job.samples = to > from ? to - from : 0;
+    }
+    if (job.priority == vr::JobPriority::background) {
+        // Background QoS keeps the job on the efficiency cores; size the
+        // request for them, as refinement does.
+        options.n_threads = vr::CpuTopology::current().efficiency_cores;
+    }
 
-    dispatch_async(_workerQueue, ^{
+    const std::string sid = job.session_id;
+    job.run = [self, pcmData, sampleRate, options, sid, safeProgress, safeCompletion](const std::atomic<bool> &abort) {
 
         // 1. Pre-flight checks
-        if (!self->_engine->is_loaded()) {
+        if (![self isModelLoaded]) {
             NSError *err = [NSError errorWithDomain:kWhisperBridgeErrorDomain
                                                code:WhisperBridgeErrorModelNotLoaded
                                            userInfo:@{NSLocalizedDescriptionKey:
                                                           @"Whisper model is not loaded."}];
-            [self dispatchCompletion:safeCompletion transcript:nil error:err];
+            [self dispatchSegmentsCompletion:safeCompletion transcript:nil segments:nil error:err];
             return;
         }
 
@@ -195,14 +549,14 @@ typedef NS_ENUM(NSInteger, WhisperBridgeErrorCode) {
                                                code:WhisperBridgeErrorConversionFailed
                                            userInfo:@{NSLocalizedDescriptionKey:
                                                           @"PCM data is empty."}];
-            [self dispatchCompletion:safeCompletion transcript:nil error:err];
+            [self dispatchSegmentsCompletion:safeCompletion transcript:nil segments:nil error:err];
             return;
         }
 
-        // 2. Interpret NSData as Float32 samples
+        // 2. Interpret NSData as Float32 samples (borrowed — the job
+        //    retains pcmData for the duration of the call).
         size_t sampleCount = pcmData.length / sizeof(float);
         const float *rawSamples = static_cast<const float *>(pcmData.bytes);
-        std::vector<float> pcm(rawSamples, rawSamples + sampleCount);
 
         // 3. Build progress callback
         vr::ProgressCallback cppProgress = nullptr;
@@ -215,34 +569,553 @@ typedef NS_ENUM(NSInteger, WhisperBridgeErrorCode) {
         }
 
         // 4. Run transcription
-        NSLog(@"[WhisperBridge] PCM samples: %zu (direct), running whisper...", pcm.size());
-        std::string result;
+        NSLog(@"[WhisperBridge] PCM samples: %zu (direct, %lld-%lld ms), running whisper...",
+              sampleCount, (long long)options.begin_ms, (long long)options.end_ms);
+        vr::TranscribeOptions jobOptions = options;
+        jobOptions.abort = &abort;
+        std::vector<vr::TranscriptSegment> segments;
         try {
-            result = self->_engine->transcribe(pcm, sampleRate, cppProgress);
+            if (self->_cache) {
+                segments = self->_cache->transcribe(rawSamples, sampleCount, sampleRate, sid,
+                                                    cppProgress, jobOptions);
+            } else {
+                segments = self->_engine->transcribe_segments(rawSamples, sampleCount, sampleRate,
+                                                              cppProgress, jobOptions);
+            }
+        } catch (const vr::TranscriptionAborted &) {
+            throw;   // the scheduler delivers the cancellation or reruns the job
         } catch (const std::exception &e) {
             NSError *err = [NSError errorWithDomain:kWhisperBridgeErrorDomain
                                                code:WhisperBridgeErrorTranscriptionFailed
                                            userInfo:@{NSLocalizedDescriptionKey:
                     [NSString stringWithFormat:@"Transcription failed: %s", e.what()]}];
-            [self dispatchCompletion:safeCompletion transcript:nil error:err];
+            [self dispatchSegmentsCompletion:safeCompletion transcript:nil segments:nil error:err];
             return;
         }
 
         // 5. Deliver result
-        NSLog(@"[WhisperBridge] Transcription complete (direct), length=%zu", result.size());
+        const std::string result = vr::join_segments(segments);
+        NSLog(@"[WhisperBridge] Transcription complete (direct), %zu segments, length=%zu",
+              segments.size(), result.size());
         NSString *transcript = [[NSString alloc] initWithUTF8String:result.c_str()];
-        [self dispatchCompletion:safeCompletion transcript:transcript error:nil];
+        [self dispatchSegmentsCompletion:safeCompletion
+                              transcript:transcript
+                                segments:SegmentsToObjC(segments)
+                                   error:nil];
+    };
+    job.cancelled = [self, safeCompletion]() {
+        [self dispatchSegmentsCompletion:safeCompletion transcript:nil segments:nil
+                                   error:CancelledError()];
+    };
+
+    const vr::JobToken token = _scheduler->submit(std::move(job));
+    __weak WhisperBridge *weakSelf = self;
+    return [[VRTranscriptionJob alloc] initWithCancelHandler:^{
+        WhisperBridge *strongSelf = weakSelf;
+        if (strongSelf && strongSelf->_scheduler) strongSelf->_scheduler->cancel(token);
+    }];
+}
+
+- (VRTranscriptionJob *)transcribeSession:(NSString *)sessionId
+                              fromStorage:(StorageBridge *)storage
+                                     tier:(VRModelTier)tier
+                                 priority:(VRTranscriptionPriority)priority
+                                 progress:(void (^ _Nullable)(float progress))progressBlock
+                               completion:(void (^)(NSString * _Nullable transcript,
+                                                    NSArray<VRTranscriptSegment *> * _Nullable segments,
+                                                    NSError * _Nullable error))completionBlock {
+
+    vr::TranscribeOptions options;
+    options.tier = TierFromObjC(tier);
+    void (^safeProgress)(float) = [progressBlock copy];
+    void (^safeCompletion)(NSString * _Nullable, NSArray<VRTranscriptSegment *> * _Nullable,
+                           NSError * _Nullable) = [completionBlock copy];
+
+    if (!_scheduler || sessionId.length == 0) {
+        [self dispatchSegmentsCompletion:safeCompletion transcript:nil segments:nil
+                                   error:CancelledError()];
+        return [[VRTranscriptionJob alloc] initWithCancelHandler:^{}];
+    }
+
+    // Spans only (no audio) here; chunks are loaded one at a time on the
+    // worker.
+    const std::vector<vr::ChunkSpan> spans = SpansFromStorage(storage, sessionId);
+
+    vr::TranscriptionJob job;
+    job.priority   = PriorityFromObjC(priority);
+    job.session_id = std::string([sessionId UTF8String]);
+    job.key        = job.session_id;
+    if (!spans.empty() && spans.back().end_ms > 0) {
+        job.samples = static_cast<size_t>(spans.back().end_ms) * 16;   // 16 kHz
+    }
+    if (job.priority == vr::JobPriority::background) {
+        options.n_threads = vr::CpuTopology::current().efficiency_cores;
+    }
+
+    const std::string sid = job.session_id;
+    job.run = [self, storage, sessionId, spans, sid, options, safeProgress, safeCompletion](const std::atomic<bool> &abort) {
+
+        if (![self isModelLoaded]) {
+            NSError *err = [NSError errorWithDomain:kWhisperBridgeErrorDomain
+                                               code:WhisperBridgeErrorModelNotLoaded
+                                           userInfo:@{NSLocalizedDescriptionKey:
+                                                          @"Whisper model is not loaded."}];
+            [self dispatchSegmentsCompletion:safeCompletion transcript:nil segments:nil error:err];
+            return;
+        }
+
+        vr::ProgressCallback cppProgress = nullptr;
+        if (safeProgress) {
+            cppProgress = [safeProgress](float p) {
+                dispatch_async(dispatch_get_main_queue(), ^{
+                    safeProgress(p);
+                });
+            };
+        }
+
+        NSLog(@"[WhisperBridge] Transcribing session %@ (%zu chunks)...", sessionId, spans.size());
+        vr::TranscribeOptions jobOptions = options;
+        jobOptions.abort = &abort;
+        bool anyAudio = false;
+        const auto load = [storage, sessionId, &anyAudio](const vr::ChunkSpan &span) {
+            std::vector<float> pcm = ChunkFromStorage(storage, sessionId, span);
+            anyAudio = anyAudio || !pcm.empty();
+            return pcm;
+        };
+        std::vector<vr::TranscriptSegment> segments;
+        try {
+            if (self->_cache) {
+                segments = self->_cache->transcribe_session(sid, spans, load, cppProgress, jobOptions);
+            } else {
+                vr::TranscriptCache uncached(*self->_engine, vr::TranscriptCache::Store{});
+                segments = uncached.transcribe_session(sid, spans, load, cppProgress, jobOptions);
+            }
+        } catch (const vr::TranscriptionAborted &) {
+            throw;   // the scheduler delivers the cancellation or reruns the job
+        } catch (const std::exception &e) {
+            NSError *err = [NSError errorWithDomain:kWhisperBridgeErrorDomain
+                                               code:WhisperBridgeErrorTranscriptionFailed
+                                           userInfo:@{NSLocalizedDescriptionKey:
+                    [NSString stringWithFormat:@"Transcription failed: %s", e.what()]}];
+            [self dispatchSegmentsCompletion:safeCompletion transcript:nil segments:nil error:err];
+            return;
+        }
+
+        if (!anyAudio) {
+            NSError *err = [NSError errorWithDomain:kWhisperBridgeErrorDomain
+                                               code:WhisperBridgeErrorConversionFailed
+                                           userInfo:@{NSLocalizedDescriptionKey:
+                                                          @"No audio data found for session."}];
+            [self dispatchSegmentsCompletion:safeCompletion transcript:nil segments:nil error:err];
+            return;
+        }
+
+        const std::string result = vr::join_segments(segments);
+        NSLog(@"[WhisperBridge] Transcription complete (session %@), %zu segments, length=%zu",
+              sessionId, segments.size(), result.size());
+        NSString *transcript = [[NSString alloc] initWithUTF8String:result.c_str()];
+        [self dispatchSegmentsCompletion:safeCompletion
+                              transcript:transcript
+                                segments:SegmentsToObjC(segments)
+                                   error:nil];
+    };
+    job.cancelled = [self, safeCompletion]() {
+        [self dispatchSegmentsCompletion:safeCompletion transcript:nil segments:nil
+                                   error:CancelledError()];
+    };
+
+    const vr::JobToken token = _scheduler->submit(std::move(job));
+    __weak WhisperBridge *weakSelf = self;
+    return [[VRTranscriptionJob alloc] initWithCancelHandler:^{
+        WhisperBridge *strongSelf = weakSelf;
+        if (strongSelf && strongSelf->_scheduler) strongSelf->_scheduler->cancel(token);
+    }];
+}
+
+- (void)cancelTranscriptionsForSession:(NSString *)sessionId {
+    if (!_scheduler || sessionId.length == 0) return;
+    _scheduler->cancel(std::string([sessionId UTF8String]));
+}
+
+- (NSInteger)pendingTranscriptionsWithPriority:(VRTranscriptionPriority)priority {
+    return _scheduler ? static_cast<NSInteger>(_scheduler->pending(PriorityFromObjC(priority))) : 0;
+}
+
++ (BOOL)isCancellationError:(NSError * _Nullable)error {
+    return (error && [error.domain isEqualToString:kWhisperBridgeErrorDomain] &&
+            error.code == WhisperBridgeErrorCancelled) ? YES : NO;
+}
+
+// ---- Transcript cache -------------------------------------------------------
+
+- (void)attachTranscriptCacheToStorage:(StorageBridge *)storage {
+    if (!_engine || _cache) return;
+
+    // Both hooks run on whichever worker is transcribing.
+    vr::TranscriptCache::Store store;
+    store.get = [storage](const std::string &key, std::vector<uint8_t> &entry) {
+        @autoreleasepool {
+            NSData *data = [storage transcriptCacheEntryForKey:
+                                [[NSString alloc] initWithUTF8String:key.c_str()]];
+            if (!data) return false;
+            const auto *bytes = static_cast<const uint8_t *>(data.bytes);
+            entry.assign(bytes, bytes + data.length);
+            return true;
+        }
+    };
+    store.put = [storage](const std::string &key, const std::string &sid,
+                          const std::vector<uint8_t> &entry) {
+        @autoreleasepool {
+            NSData *data = [NSData dataWithBytes:entry.data() length:entry.size()];
+            NSString *sessionId = sid.empty() ? nil : [[NSString alloc] initWithUTF8String:sid.c_str()];
+            [storage storeTranscriptCacheEntry:data
+                                        forKey:[[NSString alloc] initWithUTF8String:key.c_str()]
+                                       session:sessionId];
+        }
+    };
+    _cache = std::make_unique<vr::TranscriptCache>(*_engine, std::move(store));
+}
+
+// ---- Background refinement ---------------------------------------------
+
+- (void)refineSession:(NSString *)sessionId
+          audioLoader:(NSData * _Nullable (^)(void))loaderBlock
+           completion:(void (^)(NSString *transcript,
+                                NSArray<VRTranscriptSegment *> *segments))completionBlock {
+    if (!_refiner || sessionId.length == 0 || !loaderBlock) return;
+
+    NSData * _Nullable (^safeLoader)(void) = [loaderBlock copy];
+    void (^safeCompletion)(NSString *, NSArray<VRTranscriptSegment *> *) = [completionBlock copy];
+
+    vr::RefinementQueue::AudioLoader load = [safeLoader]() {
+        std::vector<float> pcm;
+        @autoreleasepool {
+            NSData *data = safeLoader();
+            if (data.length >= sizeof(float)) {
+                const float *samples = static_cast<const float *>(data.bytes);
+                pcm.assign(samples, samples + data.length / sizeof(float));
+            }
+        }
+        return pcm;
+    };
+    vr::RefinementQueue::Completion done =
+        [safeCompletion](const std::string &sid, const std::vector<vr::TranscriptSegment> &segments) {
+            const std::string text = vr::join_segments(segments);
+            NSLog(@"[WhisperBridge] Refined session %s, %zu segments, length=%zu",
+                  sid.c_str(), segments.size(), text.size());
+            if (!safeCompletion) return;
+            NSString *transcript = [[NSString alloc] initWithUTF8String:text.c_str()];
+            NSArray<VRTranscriptSegment *> *objcSegments = SegmentsToObjC(segments);
+            dispatch_async(dispatch_get_main_queue(), ^{
+                safeCompletion(transcript, objcSegments);
+            });
+        };
+
+    _refiner->enqueue(std::string([sessionId UTF8String]), std::move(load), std::move(done));
+}
+
+- (void)cancelRefinementForSession:(NSString *)sessionId {
+    if (_refiner && sessionId.length > 0) {
+        _refiner->cancel(std::string([sessionId UTF8String]));
+    }
+}
+
+- (void)pauseRefinement {
+    if (_refiner) _refiner->pause();
+}
+
+- (void)resumeRefinement {
+    if (_refiner) _refiner->resume();
+}
+
+- (NSInteger)pendingRefinements {
+    return _refiner ? static_cast<NSInteger>(_refiner->pending()) : 0;
+}
+
+// ---- Crash recovery -----------------------------------------------------------
+
+- (void)recoverSessions:(NSArray<NSString *> *)sessionIds
+            fromStorage:(StorageBridge *)storage
+      minimumDurationMs:(NSInteger)minimumDurationMs
+             completion:(void (^)(NSString *sessionId,
+                                  VRRecoveryOutcome outcome))completionBlock {
+    if (!_engine || sessionIds.count == 0) return;
+
+    if (!_recovery) {
+        void (^safeCompletion)(NSString *, VRRecoveryOutcome) = [completionBlock copy];
+
+        // Every hook runs on the scheduler's worker thread.
+        vr::RecoveryScheduler::Store store;
+        store.spans = [storage](const std::string &sid) {
+            return SpansFromStorage(storage, [[NSString alloc] initWithUTF8String:sid.c_str()]);
+        };
+        store.progress = [storage](const std::string &sid) {
+            @autoreleasepool {
+                NSString *sessionId = [[NSString alloc] initWithUTF8String:sid.c_str()];
+                return static_cast<int64_t>([storage recoveryProgressForSession:sessionId]);
+            }
+        };
+        store.saved = [storage](const std::string &sid) {
+            @autoreleasepool {
+                NSString *sessionId = [[NSString alloc] initWithUTF8String:sid.c_str()];
+                return SegmentsFromObjC([storage getSegmentsForSession:sessionId]);
+            }
+        };
+        store.load = [storage](const std::string &sid, const vr::ChunkSpan &span) {
+            return ChunkFromStorage(storage, [[NSString alloc] initWithUTF8String:sid.c_str()], span);
+        };
+        store.checkpoint = [storage](const std::string &sid, const vr::ChunkSpan &span,
+                                     const std::vector<vr::TranscriptSegment> &segments) {
+            @autoreleasepool {
+                NSString *sessionId = [[NSString alloc] initWithUTF8String:sid.c_str()];
+                return static_cast<bool>([storage saveRecoveredSegments:SegmentsToObjC(segments)
+                                                             forSession:sessionId
+                                                                 fromMs:static_cast<NSInteger>(span.begin_ms)
+                                                                   toMs:static_cast<NSInteger>(span.end_ms)]);
+            }
+        };
+        store.finish = [storage, safeCompletion](const std::string &sid, vr::RecoveryOutcome outcome) {
+            VRRecoveryOutcome result = VRRecoveryOutcomeFailed;
+            switch (outcome) {
+                case vr::RecoveryOutcome::recovered: result = VRRecoveryOutcomeRecovered; break;
+                case vr::RecoveryOutcome::discarded: result = VRRecoveryOutcomeDiscarded; break;
+                case vr::RecoveryOutcome::failed:    result = VRRecoveryOutcomeFailed;    break;
+            }
+            NSString *sessionId = [[NSString alloc] initWithUTF8String:sid.c_str()];
+            [storage finishRecoveryOfSession:sessionId outcome:result];
+            NSLog(@"[WhisperBridge] Recovery of session %@ finished (outcome %ld)",
+                  sessionId, static_cast<long>(result));
+            if (!safeCompletion) return;
+            dispatch_async(dispatch_get_main_queue(), ^{
+                safeCompletion(sessionId, result);
+            });
+        };
+
+        _recovery = std::make_unique<vr::RecoveryScheduler>(
+            *_engine, std::move(store), static_cast<int64_t>(minimumDurationMs), _cache.get());
+        for (NSInteger i = 0; i < _recoveryPauses; ++i) _recovery->pause();
+    }
+
+    std::vector<std::string> ids;
+    ids.reserve(sessionIds.count);
+    for (NSString *sessionId in sessionIds) {
+        ids.emplace_back([sessionId UTF8String]);
+    }
+    _recovery->start(ids);
+}
+
+- (void)cancelRecovery {
+    if (_recovery) _recovery->cancel();
+}
+
+- (void)cancelRecoveryForSession:(NSString *)sessionId {
+    if (_recovery && sessionId.length > 0) {
+        _recovery->cancel(std::string([sessionId UTF8String]));
+    }
+}
+
+- (void)pauseRecovery {
+    if (_recovery) {
+        _recovery->pause();
+    } else {
+        ++_recoveryPauses;
+    }
+}
+
+- (void)resumeRecovery {
+    if (_recovery) {
+        _recovery->resume();
+    } else if (_recoveryPauses > 0) {
+        --_recoveryPauses;
+    }
+}
+
+- (NSInteger)pendingRecoveries {
+    return _recovery ? static_cast<NSInteger>(_recovery->pending()) : 0;
+}
+
+// ---- Streaming --------------------------------------------------------------
+
+// All stream calls go through the serial stream queue, so chunks are fed to
+// the engine strictly in the order they were recorded.
+
+- (void)beginStreamWithSampleRate:(int)sampleRate {
+    dispatch_async(_streamQueue, ^{
+        self->_engine->begin_stream(sampleRate);
+        NSLog(@"[WhisperBridge] Stream started (sampleRate=%d)", sampleRate);
+    });
+}
+
+- (void)feedStreamPCMData:(NSData *)pcmData
+               completion:(void (^ _Nullable)(NSString * _Nullable text,
+                                              NSError * _Nullable error))completionBlock {
+
+    void (^safeCompletion)(NSString * _Nullable, NSError * _Nullable) = [completionBlock copy];
+    NSData *chunk = [pcmData copy];
+
+    dispatch_async(_streamQueue, ^{
+
+        if (![self isModelLoaded]) {
+            NSError *err = [NSError errorWithDomain:kWhisperBridgeErrorDomain
+                                               code:WhisperBridgeErrorModelNotLoaded
+                                           userInfo:@{NSLocalizedDescriptionKey:
+                                                          @"Whisper model is not loaded."}];
+            [self dispatchCompletion:safeCompletion transcript:nil error:err];
+            return;
+        }
+
+        size_t sampleCount = chunk.length / sizeof(float);
+        const float *samples = static_cast<const float *>(chunk.bytes);
+
+        std::string text;
+        try {
+            text = self->_engine->feed(samples, sampleCount);
+        } catch (const std::exception &e) {
+            NSError *err = [NSError errorWithDomain:kWhisperBridgeErrorDomain
+                                               code:WhisperBridgeErrorTranscriptionFailed
+                                           userInfo:@{NSLocalizedDescriptionKey:
+                    [NSString stringWithFormat:@"Stream transcription failed: %s", e.what()]}];
+            [self dispatchCompletion:safeCompletion transcript:nil error:err];
+            return;
+        }
+
+        NSLog(@"[WhisperBridge] Stream fed %zu samples, produced length=%zu",
+              sampleCount, text.size());
+        NSString *partial = [[NSString alloc] initWithUTF8String:text.c_str()];
+        [self dispatchCompletion:safeCompletion transcript:partial error:nil];
     });
 }
 
+- (void)finishStreamWithProgress:(void (^)(float progress))progressBlock
+                      completion:(void (^)(NSString * _Nullable transcript,
+                                           NSArray<VRTranscriptSegment *> * _Nullable segments,
+                                           NSError * _Nullable error))completionBlock {
+
+    void (^safeProgress)(float) = [progressBlock copy];
+    void (^safeCompletion)(NSString * _Nullable, NSArray<VRTranscriptSegment *> * _Nullable,
+                           NSError * _Nullable) = [completionBlock copy];
+
+    dispatch_async(_streamQueue, ^{
+
+        if (![self isModelLoaded]) {
+            self->_engine->cancel_stream();
+            NSError *err = [NSError errorWithDomain:kWhisperBridgeErrorDomain
+                                               code:WhisperBridgeErrorModelNotLoaded
+                                           userInfo:@{NSLocalizedDescriptionKey:
+                                                          @"Whisper model is not loaded."}];
+            [self dispatchSegmentsCompletion:safeCompletion transcript:nil segments:nil error:err];
+            return;
+        }
+
+        vr::ProgressCallback cppProgress = nullptr;
+        if (safeProgress) {
+            cppProgress = [safeProgress](float p) {
+                dispatch_async(dispatch_get_main_queue(), ^{
+                    safeProgress(p);
+                });
+            };
+        }
+
+        std::string result;
+        try {
+            result = self->_engine->finish(cppProgress);
+        } catch (const std::exception &e) {
+            NSError *err = [NSError errorWithDomain:kWhisperBridgeErrorDomain
+                                               code:WhisperBridgeErrorTranscriptionFailed
+                                           userInfo:@{NSLocalizedDescriptionKey:
+                    [NSString stringWithFormat:@"Transcription failed: %s", e.what()]}];
+            [self dispatchSegmentsCompletion:safeCompletion transcript:nil segments:nil error:err];
+            return;
+        }
+
+        // finish() leaves the stream's segments readable until the next
+        // begin_stream(), which can only run after this block on the queue.
+        NSArray<VRTranscriptSegment *> *segments = SegmentsToObjC(self->_engine->stream_segments());
+        NSLog(@"[WhisperBridge] Stream finished, %lu segments, length=%zu",
+              (unsigned long)segments.count, result.size());
+        NSString *transcript = [[NSString alloc] initWithUTF8String:result.c_str()];
+        [self dispatchSegmentsCompletion:safeCompletion
+                              transcript:transcript
+                                segments:segments
+                                   error:nil];
+    });
+}
+
+- (void)cancelStream {
+    dispatch_async(_streamQueue, ^{
+        self->_engine->cancel_stream();
+    });
+}
+
+- (NSInteger)streamOverlapMs {
+    return _engine ? static_cast<NSInteger>(_engine->stream_overlap_ms()) : 0;
+}
+
+- (void)setStreamOverlapMs:(NSInteger)streamOverlapMs {
+    if (_engine) _engine->set_stream_overlap_ms(static_cast<int>(MAX(streamOverlapMs, 0)));
+}
+
+// ---- Live captions ------------------------------------------------------------
+
+- (void)startLiveCaptionsFromCapture:(VRCaptureBuffer *)capture
+                             handler:(void (^)(NSString *stable, NSString *partial))handler {
+    if (!_engine) return;
+    _captioner.reset();
+
+    void (^safeHandler)(NSString *, NSString *) = [handler copy];
+
+    // Both hooks and the callback run on the captioner's worker thread.
+    vr::LiveCaptioner::Source source;
+    source.recent = [capture](std::vector<float> &out, size_t maxSamples) {
+        @autoreleasepool {
+            NSInteger captured = 0;
+            NSData *data = [capture recentSamplesWithMaxCount:static_cast<NSInteger>(maxSamples)
+                                              capturedSamples:&captured];
+            const float *samples = static_cast<const float *>(data.bytes);
+            out.assign(samples, samples + data.length / sizeof(float));
+            return static_cast<size_t>(captured);
+        }
+    };
+    source.dropped = [capture]() {
+        return static_cast<size_t>(capture.droppedSamples);
+    };
+    vr::LiveCaptioner::Callback onCaption = [safeHandler](const vr::LiveCaption &caption) {
+        if (!safeHandler) return;
+        NSString *stable  = [[NSString alloc] initWithUTF8String:caption.stable.c_str()] ?: @"";
+        NSString *partial = [[NSString alloc] initWithUTF8String:caption.partial.c_str()] ?: @"";
+        dispatch_async(dispatch_get_main_queue(), ^{
+            safeHandler(stable, partial);
+        });
+    };
+
+    _captioner = std::make_unique<vr::LiveCaptioner>(*_engine, std::move(source),
+                                                     std::move(onCaption));
+    NSLog(@"[WhisperBridge] Live captions started");
+}
+
+- (void)stopLiveCaptions {
+    if (!_captioner) return;
+    _captioner.reset();
+    NSLog(@"[WhisperBridge] Live captions stopped");
+}
+
 // ---- Helpers --------------------------------------------------------------
 
 // ---- Shutdown ---------------------------------------------------------------
 
 - (void)shutdown {
-    // Synchronously drain the worker queue so any in-flight transcription finishes
-    // before we destroy the engine.
-    dispatch_sync(_workerQueue, ^{});
+    // Drain the stream queue, then stop the scheduler: queued one-shot jobs
+    // complete with a cancellation error and running ones are aborted and
+    // joined, so nothing is inside the engine when we destroy it.
+    dispatch_sync(_streamQueue, ^{});
+    _captioner.reset();
+    _scheduler.reset();
+
+    // Abort any refinement or recovery still running; queued ones are
+    // dropped (recovery progress is already saved).
+    _refiner.reset();
+    _recovery.reset();
+    _cache.reset();   // after everything that transcribes through it
 
     // Explicitly free the engine (and its whisper context / GGML backends).
     // This removes Metal residency sets so the static ggml_metal_device
@@ -261,4 +1134,17 @@ typedef NS_ENUM(NSInteger, WhisperBridgeErrorCode) {
     });
 }
 
+/// Dispatch a segments completion block to the main queue.
+- (void)dispatchSegmentsCompletion:(void (^)(NSString * _Nullable,
+                                             NSArray<VRTranscriptSegment *> * _Nullable,
+                                             NSError * _Nullable))block
+                        transcript:(NSString * _Nullable)transcript
+                          segments:(NSArray<VRTranscriptSegment *> * _Nullable)segments
+                             error:(NSError * _Nullable)error {
+    if (!block) return;
+    dispatch_async(dispatch_get_main_queue(), ^{
+        block(transcript, segments, error);
+    });
+}
+
 @end
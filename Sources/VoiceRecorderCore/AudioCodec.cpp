@@ -0,0 +1,231 @@
+#include "AudioCodec.hpp"
+
+#include "AudioConverter.hpp"
+#include "AvArena.hpp"
+#include "Instrumentation.hpp"
+#include "SampleFormat.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+extern "C" {
+#include <libavformat/avformat.h>
+#include <libavcodec/avcodec.h>
+#include <libavutil/channel_layout.h>
+}
+
+namespace vr {
+
+// ---------------------------------------------------------------------------
+// In-memory output for the FLAC muxer
+// ---------------------------------------------------------------------------
+
+namespace {
+
+/// Growable byte sink with a write cursor.  The FLAC muxer seeks back to
+/// the start on close to patch STREAMINFO, so seek must be supported.
+struct MemoryWriter {
+    std::vector<uint8_t> bytes;
+    size_t               pos = 0;
+};
+
+int memory_write(void* opaque, const uint8_t* buf, int buf_size) {
+    auto* w = static_cast<MemoryWriter*>(opaque);
+    size_t n = static_cast<size_t>(buf_size);
+    if (w->pos + n > w->bytes.size()) {
+        w->bytes.resize(w->pos + n);
+    }
+    std::memcpy(w->bytes.data() + w->pos, buf, n);
+    w->pos += n;
+    return buf_size;
+}
+
+int64_t memory_seek(void* opaque, int64_t offset, int whence) {
+    auto* w = static_cast<MemoryWriter*>(opaque);
+    if (whence & AVSEEK_SIZE) {
+        return static_cast<int64_t>(w->bytes.size());
+    }
+    int64_t base = 0;
+    switch (whence & ~AVSEEK_FORCE) {
+        case SEEK_SET: base = 0; break;
+        case SEEK_CUR: base = static_cast<int64_t>(w->pos); break;
+        case SEEK_END: base = static_cast<int64_t>(w->bytes.size()); break;
+        default: return AVERROR(EINVAL);
+    }
+    int64_t target = base + offset;
+    if (target < 0) return AVERROR(EINVAL);
+    w->pos = static_cast<size_t>(target);
+    return target;
+}
+
+constexpr int kAvioBufferSize = 32 * 1024;
+
+/// Float [-1, 1] to int16 with rounding and clipping.
+using ToS16 = FormatKernel<SampleType::f32, SampleType::s16, 1, Interleaving::interleaved>;
+
+std::vector<uint8_t> encode_flac(const float* samples, size_t count,
+                                 int sample_rate) {
+    const AVCodec* flac = avcodec_find_encoder(AV_CODEC_ID_FLAC);
+    if (!flac) throw std::runtime_error("FLAC encoder not available");
+
+    MemoryWriter writer;
+    writer.bytes.reserve(count);   // ~2 bytes/sample before compression
+
+    // The frame (with its sample buffer) and packet are the thread's
+    // AvArena objects, so encoding chunk after chunk allocates neither.
+    AvArena& arena = AvArena::local();
+
+    AVFormatContext* ofmt = nullptr;
+    AVCodecContext*  enc  = nullptr;
+    AVIOContext*     avio = nullptr;
+    AVPacket*        pkt   = nullptr;
+
+    auto cleanup = [&]() {
+        if (pkt) av_packet_unref(pkt);
+        avcodec_free_context(&enc);   // drops the encoder's frame references
+        if (ofmt) {
+            ofmt->pb = nullptr;
+            avformat_free_context(ofmt);
+            ofmt = nullptr;
+        }
+        if (avio) {
+            av_freep(&avio->buffer);
+            avio_context_free(&avio);
+        }
+    };
+
+    auto fail = [&](const char* what) {
+        cleanup();
+        throw std::runtime_error(std::string("FLAC encode failed: ") + what);
+    };
+
+    if (avformat_alloc_output_context2(&ofmt, nullptr, "flac", nullptr) < 0 || !ofmt) {
+        fail("no muxer");
+    }
+
+    auto* avio_buf = static_cast<unsigned char*>(av_malloc(kAvioBufferSize));
+    if (!avio_buf) fail("out of memory");
+    avio = avio_alloc_context(avio_buf, kAvioBufferSize, 1, &writer,
+                              nullptr, &memory_write, &memory_seek);
+    if (!avio) { av_free(avio_buf); fail("avio_alloc_context"); }
+    ofmt->pb = avio;
+    ofmt->flags |= AVFMT_FLAG_CUSTOM_IO;
+
+    AVStream* stream = avformat_new_stream(ofmt, nullptr);
+    enc = avcodec_alloc_context3(flac);
+    if (!stream || !enc) fail("stream/context alloc");
+
+    AVChannelLayout mono_layout = AV_CHANNEL_LAYOUT_MONO;
+    enc->sample_rate = sample_rate;
+    av_channel_layout_copy(&enc->ch_layout, &mono_layout);
+    enc->sample_fmt  = AV_SAMPLE_FMT_S16;
+    enc->time_base   = AVRational{1, sample_rate};
+    enc->compression_level = 5;   // FFmpeg default; higher levels gain little on speech
+
+    if (avcodec_open2(enc, flac, nullptr) < 0) fail("avcodec_open2");
+    if (avcodec_parameters_from_context(stream->codecpar, enc) < 0) fail("codecpar");
+    stream->time_base = enc->time_base;
+
+    if (avformat_write_header(ofmt, nullptr) < 0) fail("write_header");
+
+    const int frame_size = enc->frame_size > 0 ? enc->frame_size : 4096;
+    AVFrame* frame = arena.encode_frame(AV_SAMPLE_FMT_S16, frame_size, sample_rate);
+    pkt = arena.packet();
+    if (!frame || !pkt) fail("frame/packet alloc");
+
+    auto drain = [&]() {
+        while (avcodec_receive_packet(enc, pkt) == 0) {
+            pkt->stream_index = stream->index;
+            av_interleaved_write_frame(ofmt, pkt);   // unrefs pkt
+        }
+    };
+
+    int64_t pts = 0;
+    for (size_t offset = 0; offset < count; offset += frame_size) {
+        const int n = static_cast<int>(std::min<size_t>(frame_size, count - offset));
+        if (av_frame_make_writable(frame) < 0) fail("frame not writable");
+        frame->nb_samples = n;
+        const auto* src = reinterpret_cast<const uint8_t*>(samples + offset);
+        ToS16::run(&src, static_cast<size_t>(n), reinterpret_cast<int16_t*>(frame->data[0]));
+        frame->pts = pts;
+        pts += n;
+
+        if (avcodec_send_frame(enc, frame) < 0) fail("send_frame");
+        drain();
+    }
+
+    avcodec_send_frame(enc, nullptr);
+    drain();
+
+    if (av_write_trailer(ofmt) < 0) fail("write_trailer");
+    avio_flush(avio);
+
+    std::vector<uint8_t> out = std::move(writer.bytes);
+    cleanup();
+    return out;
+}
+
+} // namespace
+
+// ---------------------------------------------------------------------------
+// encode
+// ---------------------------------------------------------------------------
+
+std::vector<uint8_t> AudioCodec::encode(const float* samples, size_t count,
+                                        ChunkCodec codec,
+                                        int sample_rate) {
+    switch (codec) {
+        case ChunkCodec::pcm_f32: {
+            const auto* bytes = reinterpret_cast<const uint8_t*>(samples);
+            return std::vector<uint8_t>(bytes, bytes + count * sizeof(float));
+        }
+        case ChunkCodec::flac_s16: {
+            if (!samples || count == 0) {
+                throw std::runtime_error("FLAC encode failed: no samples");
+            }
+            StageSpan span(Stage::audio_encode);
+            return encode_flac(samples, count, sample_rate);
+        }
+        case ChunkCodec::m4a:
+            break;
+    }
+    throw std::runtime_error(std::string("Encoding to ") + codec_to_string(codec)
+                             + " is not supported");
+}
+
+// ---------------------------------------------------------------------------
+// decode
+// ---------------------------------------------------------------------------
+
+std::vector<float> AudioCodec::decode(const uint8_t* data, size_t size,
+                                      ChunkCodec codec,
+                                      int sample_rate) {
+    std::vector<float> out;
+    decode(data, size, codec, out, sample_rate);
+    return out;
+}
+
+void AudioCodec::decode(const uint8_t* data, size_t size,
+                        ChunkCodec codec,
+                        std::vector<float>& out,
+                        int sample_rate) {
+    out.clear();
+    if (!data || size == 0) return;
+
+    if (codec == ChunkCodec::pcm_f32) {
+        out.resize(size / sizeof(float));
+        std::memcpy(out.data(), data, out.size() * sizeof(float));
+        return;
+    }
+
+    // FLAC and M4A are both self-describing containers; the in-memory
+    // FFmpeg demux/decode path handles them (and resamples if needed).
+    AudioConverter converter;
+    converter.m4a_to_pcm(data, size, out, sample_rate);
+}
+
+} // namespace vr
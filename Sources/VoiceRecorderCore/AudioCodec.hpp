@@ -0,0 +1,39 @@
+#pragma once
+
+#include "Types.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace vr {
+
+/// Encodes / decodes chunk audio for storage in the chunks table.
+///
+/// The capture format is 16 kHz mono float32 (64 KB/s).  New chunks are
+/// stored as 16-bit FLAC, which is lossless at that precision and roughly
+/// 4-8x smaller for speech.  Decoding always yields float32 samples in
+/// [-1, 1] at the recording rate, whatever the stored codec.
+class AudioCodec {
+public:
+    /// Encode mono float32 samples.  pcm_f32 returns the raw bytes; m4a is
+    /// decode-only.  Throws std::runtime_error on failure.
+    static std::vector<uint8_t> encode(const float* samples, size_t count,
+                                       ChunkCodec codec,
+                                       int sample_rate = 16000);
+
+    /// Decode a stored blob back to mono float32 samples at `sample_rate`.
+    /// Throws std::runtime_error on failure.
+    static std::vector<float> decode(const uint8_t* data, size_t size,
+                                     ChunkCodec codec,
+                                     int sample_rate = 16000);
+
+    /// As above, decoding into `out` (replacing its contents), so a loop
+    /// over many chunks reuses one buffer.
+    static void decode(const uint8_t* data, size_t size,
+                       ChunkCodec codec,
+                       std::vector<float>& out,
+                       int sample_rate = 16000);
+};
+
+} // namespace vr
@@ -1,8 +1,14 @@
 #include "AudioConverter.hpp"
+#include "AvArena.hpp"
+#include "Instrumentation.hpp"
+#include "Resampler.hpp"
+#include "SampleFormat.hpp"
 
 #include <algorithm>
+#include <cerrno>
 #include <cmath>
 #include <cstdio>
+#include <cstring>
 #include <stdexcept>
 
 extern "C" {
@@ -28,8 +34,6 @@ AudioConverter::~AudioConverter() = default;
 
 std::vector<float> AudioConverter::m4a_to_pcm(const std::string& input_path,
                                               int target_sample_rate) const {
-    std::vector<float> pcm_out;
-
     // 1. Open input file
     AVFormatContext* fmt_ctx = nullptr;
     int ret = avformat_open_input(&fmt_ctx, input_path.c_str(), nullptr, nullptr);
@@ -39,7 +43,177 @@ std::vector<float> AudioConverter::m4a_to_pcm(const std::string& input_path,
         throw std::runtime_error(std::string("Failed to open audio file '") + input_path + "': " + errbuf);
     }
 
-    ret = avformat_find_stream_info(fmt_ctx, nullptr);
+    std::vector<float> pcm;
+    decode_opened(fmt_ctx, target_sample_rate, pcm);
+    return pcm;
+}
+
+// ---------------------------------------------------------------------------
+// m4a_to_pcm  (in-memory buffer via custom AVIOContext)
+// ---------------------------------------------------------------------------
+
+namespace {
+
+/// Read/seek cursor over a caller-owned byte buffer.
+struct MemoryReader {
+    const uint8_t* data;
+    size_t         size;
+    size_t         pos;
+};
+
+int memory_read(void* opaque, uint8_t* buf, int buf_size) {
+    auto* r = static_cast<MemoryReader*>(opaque);
+    size_t remaining = r->size - r->pos;
+    if (remaining == 0) return AVERROR_EOF;
+    size_t n = std::min(remaining, static_cast<size_t>(buf_size));
+    std::memcpy(buf, r->data + r->pos, n);
+    r->pos += n;
+    return static_cast<int>(n);
+}
+
+int64_t memory_seek(void* opaque, int64_t offset, int whence) {
+    auto* r = static_cast<MemoryReader*>(opaque);
+    if (whence & AVSEEK_SIZE) {
+        return static_cast<int64_t>(r->size);
+    }
+    int64_t base = 0;
+    switch (whence & ~AVSEEK_FORCE) {
+        case SEEK_SET: base = 0; break;
+        case SEEK_CUR: base = static_cast<int64_t>(r->pos); break;
+        case SEEK_END: base = static_cast<int64_t>(r->size); break;
+        default: return AVERROR(EINVAL);
+    }
+    int64_t target = base + offset;
+    if (target < 0 || target > static_cast<int64_t>(r->size)) {
+        return AVERROR(EINVAL);
+    }
+    r->pos = static_cast<size_t>(target);
+    return target;
+}
+
+constexpr int kAvioBufferSize = 32 * 1024;
+
+} // namespace
+
+std::vector<float> AudioConverter::m4a_to_pcm(const uint8_t* data, size_t size,
+                                              int target_sample_rate) const {
+    std::vector<float> pcm;
+    m4a_to_pcm(data, size, pcm, target_sample_rate);
+    return pcm;
+}
+
+void AudioConverter::m4a_to_pcm(const uint8_t* data, size_t size,
+                                std::vector<float>& out,
+                                int target_sample_rate) const {
+    if (!data || size == 0) {
+        throw std::runtime_error("Audio buffer is empty");
+    }
+
+    MemoryReader reader{data, size, 0};
+
+    auto* avio_buf = static_cast<unsigned char*>(av_malloc(kAvioBufferSize));
+    if (!avio_buf) throw std::runtime_error("Failed to allocate AVIO buffer");
+
+    AVIOContext* avio = avio_alloc_context(avio_buf, kAvioBufferSize, 0, &reader,
+                                           &memory_read, nullptr, &memory_seek);
+    if (!avio) {
+        av_free(avio_buf);
+        throw std::runtime_error("Failed to allocate AVIOContext");
+    }
+
+    // The AVIO buffer may be reallocated by FFmpeg, so always free it
+    // through the context rather than the original pointer.
+    auto free_avio = [&avio]() {
+        av_freep(&avio->buffer);
+        avio_context_free(&avio);
+    };
+
+    AVFormatContext* fmt_ctx = avformat_alloc_context();
+    if (!fmt_ctx) {
+        free_avio();
+        throw std::runtime_error("Failed to allocate AVFormatContext");
+    }
+    fmt_ctx->pb = avio;
+    fmt_ctx->flags |= AVFMT_FLAG_CUSTOM_IO;
+
+    // avformat_open_input frees fmt_ctx on failure (but not the custom pb).
+    int ret = avformat_open_input(&fmt_ctx, nullptr, nullptr, nullptr);
+    if (ret < 0) {
+        free_avio();
+        char errbuf[256];
+        av_strerror(ret, errbuf, sizeof(errbuf));
+        throw std::runtime_error(std::string("Failed to open in-memory audio: ") + errbuf);
+    }
+
+    try {
+        decode_opened(fmt_ctx, target_sample_rate, out);
+    } catch (...) {
+        free_avio();
+        throw;
+    }
+    free_avio();
+}
+
+// ---------------------------------------------------------------------------
+// decode_opened  (shared by the path and memory overloads)
+// ---------------------------------------------------------------------------
+
+namespace {
+
+/// Extra room reserved past the container's stated duration: decoder and
+/// resampler delay, and durations rounded down by the muxer.
+constexpr int64_t kDecodeSlackSamples = 8192;
+
+/// Never trust a header for more than this (4 h at 48 kHz) up front.
+constexpr int64_t kMaxReserveSamples = int64_t{48000} * 60 * 60 * 4;
+
+/// Samples at `rate` the demuxer expects the stream to hold, or 0 if it
+/// doesn't say.
+int64_t expected_samples(const AVFormatContext* fmt_ctx, const AVStream* stream, int rate) {
+    int64_t n = 0;
+    if (stream->duration > 0) {   // AV_NOPTS_VALUE is negative
+        n = av_rescale_q(stream->duration, stream->time_base, AVRational{1, rate});
+    } else if (fmt_ctx->duration > 0) {
+        n = av_rescale_q(fmt_ctx->duration, AVRational{1, AV_TIME_BASE}, AVRational{1, rate});
+    }
+    return n > 0 ? std::min(n + kDecodeSlackSamples, kMaxReserveSamples) : 0;
+}
+
+/// Kernel turning the decoder's frames into mono float at the source rate,
+/// or nullptr if the format needs libswresample.  Covers what the chunk
+/// codecs produce — FLAC as S16, AAC as FLTP — in mono or stereo.
+DownmixKernel downmix_kernel_for(AVSampleFormat fmt, int channels) {
+    using I = Interleaving;
+    using T = SampleType;
+    if (channels == 1) {
+        switch (fmt) {
+            case AV_SAMPLE_FMT_FLT:
+            case AV_SAMPLE_FMT_FLTP: return &FormatKernel<T::f32, T::f32, 1, I::interleaved>::run;
+            case AV_SAMPLE_FMT_S16:
+            case AV_SAMPLE_FMT_S16P: return &FormatKernel<T::s16, T::f32, 1, I::interleaved>::run;
+            default: break;
+        }
+    } else if (channels == 2) {
+        switch (fmt) {
+            case AV_SAMPLE_FMT_FLT:  return &FormatKernel<T::f32, T::f32, 2, I::interleaved>::run;
+            case AV_SAMPLE_FMT_FLTP: return &FormatKernel<T::f32, T::f32, 2, I::planar>::run;
+            case AV_SAMPLE_FMT_S16:  return &FormatKernel<T::s16, T::f32, 2, I::interleaved>::run;
+            case AV_SAMPLE_FMT_S16P: return &FormatKernel<T::s16, T::f32, 2, I::planar>::run;
+            default: break;
+        }
+    }
+    return nullptr;
+}
+
+} // namespace
+
+void AudioConverter::decode_opened(AVFormatContext* fmt_ctx,
+                                   int target_sample_rate,
+                                   std::vector<float>& out) {
+    StageSpan span(Stage::audio_decode);
+    out.clear();
+
+    int ret = avformat_find_stream_info(fmt_ctx, nullptr);
     if (ret < 0) { avformat_close_input(&fmt_ctx); throw std::runtime_error("Failed to find stream info in audio file"); }
 
     // 2. Find the audio stream
@@ -60,23 +234,63 @@ std::vector<float> AudioConverter::m4a_to_pcm(const std::string& input_path,
         throw std::runtime_error("Failed to open audio decoder");
     }
 
-    // 4. Set up resampler
-    AVChannelLayout out_layout = AV_CHANNEL_LAYOUT_MONO;
+    // 4. Set up the converter to packed mono float at the source rate: a
+    //    compile-time kernel for the formats the chunk codecs produce, swr
+    //    for anything else.  The rate change is done afterwards by the
+    //    cached polyphase Resampler.
+    const int source_rate = dec_ctx->sample_rate;
+    const DownmixKernel kernel =
+        downmix_kernel_for(dec_ctx->sample_fmt, dec_ctx->ch_layout.nb_channels);
     SwrContext* swr = nullptr;
-    ret = swr_alloc_set_opts2(&swr,
-        &out_layout, AV_SAMPLE_FMT_FLT, target_sample_rate,
-        &dec_ctx->ch_layout, dec_ctx->sample_fmt, dec_ctx->sample_rate,
-        0, nullptr);
-    if (ret < 0 || swr_init(swr) < 0) {
+    if (!kernel) {
+        AVChannelLayout out_layout = AV_CHANNEL_LAYOUT_MONO;
+        ret = swr_alloc_set_opts2(&swr,
+            &out_layout, AV_SAMPLE_FMT_FLT, source_rate,
+            &dec_ctx->ch_layout, dec_ctx->sample_fmt, dec_ctx->sample_rate,
+            0, nullptr);
+        if (ret < 0 || swr_init(swr) < 0) {
+            avcodec_free_context(&dec_ctx);
+            avformat_close_input(&fmt_ctx);
+            if (swr) swr_free(&swr);
+            throw std::runtime_error("Failed to initialize audio resampler");
+        }
+    }
+
+    // Source-rate PCM goes straight into `out` when no rate change follows,
+    // otherwise into the thread's staging buffer.  Either is reserved from
+    // the container's duration, and the kernel (or swr) writes into its
+    // tail directly, so the loop below does no per-frame allocation or copy.
+    AvArena& arena = AvArena::local();
+    const bool convert_rate = source_rate != target_sample_rate;
+    std::vector<float>& pcm = convert_rate ? arena.staging() : out;
+    pcm.reserve(static_cast<size_t>(expected_samples(fmt_ctx, stream, source_rate)));
+
+    auto convert = [&](const uint8_t** in, int in_samples) {
+        if (kernel) {
+            if (!in || in_samples <= 0) return;   // nothing buffered to flush
+            const size_t used = pcm.size();
+            pcm.resize(used + static_cast<size_t>(in_samples));
+            kernel(in, static_cast<size_t>(in_samples), pcm.data() + used);
+            return;
+        }
+        const int room = static_cast<int>(swr_get_delay(swr, source_rate) + in_samples);
+        if (room <= 0) return;
+        const size_t used = pcm.size();
+        pcm.resize(used + static_cast<size_t>(room));
+        auto* dst = reinterpret_cast<uint8_t*>(pcm.data() + used);
+        const int converted = swr_convert(swr, &dst, room, in, in_samples);
+        pcm.resize(used + static_cast<size_t>(std::max(0, converted)));
+    };
+
+    // 5. Read packets, decode frames, convert
+    AVPacket* pkt = arena.packet();
+    AVFrame* frame = arena.frame();
+    if (!pkt || !frame) {
+        swr_free(&swr);
         avcodec_free_context(&dec_ctx);
         avformat_close_input(&fmt_ctx);
-        if (swr) swr_free(&swr);
-        throw std::runtime_error("Failed to initialize audio resampler");
+        throw std::runtime_error("Failed to allocate packet/frame");
     }
-
-    // 5. Read packets, decode frames, resample
-    AVPacket* pkt = av_packet_alloc();
-    AVFrame* frame = av_frame_alloc();
     while (av_read_frame(fmt_ctx, pkt) >= 0) {
         if (pkt->stream_index != audio_idx) {
             av_packet_unref(pkt);
@@ -84,18 +298,7 @@ std::vector<float> AudioConverter::m4a_to_pcm(const std::string& input_path,
         }
         avcodec_send_packet(dec_ctx, pkt);
         while (avcodec_receive_frame(dec_ctx, frame) == 0) {
-            int out_samples = av_rescale_rnd(
-                swr_get_delay(swr, dec_ctx->sample_rate) + frame->nb_samples,
-                target_sample_rate, dec_ctx->sample_rate, AV_ROUND_UP);
-
-            std::vector<float> buf(out_samples);
-            uint8_t* out_buf = reinterpret_cast<uint8_t*>(buf.data());
-            int converted = swr_convert(swr, &out_buf, out_samples,
-                                        (const uint8_t**)frame->extended_data,
-                                        frame->nb_samples);
-            if (converted > 0) {
-                pcm_out.insert(pcm_out.end(), buf.begin(), buf.begin() + converted);
-            }
+            convert(const_cast<const uint8_t**>(frame->extended_data), frame->nb_samples);
         }
         av_packet_unref(pkt);
     }
@@ -103,40 +306,28 @@ std::vector<float> AudioConverter::m4a_to_pcm(const std::string& input_path,
     // 6. Flush decoder
     avcodec_send_packet(dec_ctx, nullptr);
     while (avcodec_receive_frame(dec_ctx, frame) == 0) {
-        int out_samples = av_rescale_rnd(
-            swr_get_delay(swr, dec_ctx->sample_rate) + frame->nb_samples,
-            target_sample_rate, dec_ctx->sample_rate, AV_ROUND_UP);
-        std::vector<float> buf(out_samples);
-        uint8_t* out_buf = reinterpret_cast<uint8_t*>(buf.data());
-        int converted = swr_convert(swr, &out_buf, out_samples,
-                                    (const uint8_t**)frame->extended_data,
-                                    frame->nb_samples);
-        if (converted > 0) {
-            pcm_out.insert(pcm_out.end(), buf.begin(), buf.begin() + converted);
-        }
+        convert(const_cast<const uint8_t**>(frame->extended_data), frame->nb_samples);
     }
 
-    // 7. Flush resampler
-    {
-        int out_samples = swr_get_delay(swr, target_sample_rate);
-        if (out_samples > 0) {
-            std::vector<float> buf(out_samples);
-            uint8_t* out_buf = reinterpret_cast<uint8_t*>(buf.data());
-            int converted = swr_convert(swr, &out_buf, out_samples, nullptr, 0);
-            if (converted > 0) {
-                pcm_out.insert(pcm_out.end(), buf.begin(), buf.begin() + converted);
-            }
-        }
-    }
+    // 7. Flush the converter (only swr holds samples back)
+    convert(nullptr, 0);
 
-    // 8. Cleanup
-    av_frame_free(&frame);
-    av_packet_free(&pkt);
+    // 8. Cleanup (the packet and frame go back to the arena unreferenced)
+    av_frame_unref(frame);
     swr_free(&swr);
     avcodec_free_context(&dec_ctx);
     avformat_close_input(&fmt_ctx);
 
-    return pcm_out;
+    // 9. Rate conversion (skipped when the file is already at the target).
+    if (convert_rate) {
+        auto resampler = pcm.empty() ? nullptr : Resampler::get(source_rate, target_sample_rate);
+        if (resampler) {
+            resampler->process(pcm.data(), pcm.size(), out);
+        } else {
+            out.assign(pcm.begin(), pcm.end());
+        }
+        arena.trim();
+    }
 }
 
 // ---------------------------------------------------------------------------
@@ -154,35 +345,7 @@ std::vector<float> AudioConverter::resample(const std::vector<float>& input_data
         return input_data;   // no-op
     }
 
-    AVChannelLayout mono_layout = AV_CHANNEL_LAYOUT_MONO;
-    SwrContext* swr = nullptr;
-    int ret = swr_alloc_set_opts2(&swr,
-        &mono_layout, AV_SAMPLE_FMT_FLT, output_rate,
-        &mono_layout, AV_SAMPLE_FMT_FLT, input_rate,
-        0, nullptr);
-    if (ret < 0 || swr_init(swr) < 0) {
-        if (swr) swr_free(&swr);
-        return {};
-    }
-
-    int max_out = av_rescale_rnd(input_data.size(), output_rate, input_rate, AV_ROUND_UP);
-    std::vector<float> output(max_out);
-
-    const uint8_t* in_buf = reinterpret_cast<const uint8_t*>(input_data.data());
-    uint8_t* out_buf = reinterpret_cast<uint8_t*>(output.data());
-
-    int converted = swr_convert(swr, &out_buf, max_out, &in_buf, static_cast<int>(input_data.size()));
-    // Flush
-    if (converted >= 0) {
-        int flushed = swr_convert(swr, &out_buf, max_out - converted, nullptr, 0);
-        if (flushed > 0) converted += flushed;
-    }
-    swr_free(&swr);
-    if (converted > 0) {
-        output.resize(converted);
-        return output;
-    }
-    return {};
+    return Resampler::get(input_rate, output_rate)->process(input_data.data(), input_data.size());
 }
 
 } // namespace vr
@@ -1,8 +1,13 @@
 #pragma once
 
+#include <cstddef>
+#include <cstdint>
 #include <string>
 #include <vector>
 
+// Forward-declare in global namespace to match avformat.h
+struct AVFormatContext;
+
 namespace vr {
 
 /// Converts audio between formats using FFmpeg's libavcodec / libswresample.
@@ -22,11 +27,33 @@ public:
     std::vector<float> m4a_to_pcm(const std::string& input_path,
                                   int target_sample_rate = 16000) const;
 
-    /// Resample raw float32 PCM data from one rate to another.
-    /// Uses FFmpeg's libswresample for high-quality conversion.
+    /// Decode an in-memory M4A (or any FFmpeg-demuxable) buffer to float32
+    /// PCM, e.g. straight from a sqlite3_column_blob() pointer.  Reads go
+    /// through a custom AVIOContext, so no temp file is written.  The
+    /// buffer only needs to stay valid for the duration of the call.
+    std::vector<float> m4a_to_pcm(const uint8_t* data, size_t size,
+                                  int target_sample_rate = 16000) const;
+
+    /// As above, decoding into `out` (replacing its contents) so a caller
+    /// decoding many buffers reuses one allocation.
+    void m4a_to_pcm(const uint8_t* data, size_t size,
+                    std::vector<float>& out,
+                    int target_sample_rate = 16000) const;
+
+    /// Resample raw float32 PCM data from one rate to another, through the
+    /// cached polyphase Resampler for that rate pair.
     static std::vector<float> resample(const std::vector<float>& input_data,
                                        int input_rate,
                                        int output_rate);
+
+private:
+    /// Shared demux -> decode -> resample loop into `out`.  Takes
+    /// ownership of `fmt_ctx` (an opened input) and always closes it.
+    /// Packets, frames and the source-rate buffer come from the thread's
+    /// AvArena, and the output is reserved from the stream duration.
+    static void decode_opened(AVFormatContext* fmt_ctx,
+                              int target_sample_rate,
+                              std::vector<float>& out);
 };
 
 } // namespace vr
@@ -1,5 +1,7 @@
 #include "AudioRecorder.hpp"
 
+#include "Metering.hpp"
+
 #include <chrono>
 #include <cmath>
 #include <cstdio>
@@ -349,16 +351,8 @@ void AudioRecorder::finalize_chunk() {
 // ---------------------------------------------------------------------------
 
 float AudioRecorder::compute_rms(const float* samples, size_t count) {
-    if (!samples || count == 0) return 0.0f;
-
-    double sum = 0.0;
-    for (size_t i = 0; i < count; ++i) {
-        sum += static_cast<double>(samples[i]) * static_cast<double>(samples[i]);
-    }
-    float rms = static_cast<float>(std::sqrt(sum / static_cast<double>(count)));
-
-    // Clamp to [0, 1].
-    return std::min(1.0f, std::max(0.0f, rms));
+    // Shared single-pass kernel (NEON on Apple Silicon); already clamped.
+    return compute_meter_levels(samples, count).rms;
 }
 
 } // namespace vr
@@ -0,0 +1,77 @@
+#include "AvArena.hpp"
+
+extern "C" {
+#include <libavcodec/avcodec.h>
+#include <libavutil/channel_layout.h>
+#include <libavutil/frame.h>
+}
+
+namespace vr {
+
+AvArena& AvArena::local() {
+    static thread_local AvArena arena;
+    return arena;
+}
+
+AvArena::~AvArena() {
+    av_frame_free(&encode_frame_);
+    av_frame_free(&frame_);
+    av_packet_free(&packet_);
+}
+
+AVPacket* AvArena::packet() {
+    if (!packet_) packet_ = av_packet_alloc();
+    return packet_;
+}
+
+AVFrame* AvArena::frame() {
+    if (!frame_) frame_ = av_frame_alloc();
+    return frame_;
+}
+
+AVFrame* AvArena::encode_frame(int sample_format, int nb_samples, int sample_rate) {
+    if (!encode_frame_) {
+        encode_frame_ = av_frame_alloc();
+        if (!encode_frame_) return nullptr;
+    }
+
+    AVFrame* f = encode_frame_;
+    const bool reusable = f->buf[0] && f->format == sample_format &&
+                          f->sample_rate == sample_rate &&
+                          encode_capacity_ >= nb_samples;
+    if (!reusable) {
+        av_frame_unref(f);
+        encode_capacity_ = 0;
+        AVChannelLayout mono = AV_CHANNEL_LAYOUT_MONO;
+        f->format      = sample_format;
+        f->sample_rate = sample_rate;
+        f->nb_samples  = nb_samples;
+        if (av_channel_layout_copy(&f->ch_layout, &mono) < 0 ||
+            av_frame_get_buffer(f, 0) < 0) {
+            av_frame_unref(f);
+            return nullptr;
+        }
+        encode_capacity_ = nb_samples;
+    }
+
+    // A previous encoder may still reference the buffer; copy-on-write
+    // only then, at full capacity.
+    f->nb_samples = encode_capacity_;
+    if (av_frame_make_writable(f) < 0) return nullptr;
+    f->nb_samples = nb_samples;
+    f->pts        = 0;
+    return f;
+}
+
+std::vector<float>& AvArena::staging() {
+    staging_.clear();
+    return staging_;
+}
+
+void AvArena::trim() {
+    if (staging_.capacity() > kMaxRetainedSamples) {
+        std::vector<float>().swap(staging_);
+    }
+}
+
+} // namespace vr
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+// Forward-declare in global namespace to match the FFmpeg headers.
+struct AVPacket;
+struct AVFrame;
+
+namespace vr {
+
+/// Per-thread FFmpeg packets, frames and PCM staging, reused by every
+/// decode (AudioConverter) and encode (AudioCodec) on that thread.
+///
+/// Bulk work — re-transcribing a session, recovering orphans, streaming a
+/// session's chunks out of SQLite — decodes or encodes one chunk after
+/// another on the same thread.  Keeping the objects (and the buffers they
+/// own) alive across calls makes the steady-state loops allocation-free
+/// instead of allocating a packet, a frame and a PCM buffer per chunk.
+///
+/// Users borrow an object for the duration of one call and hand it back
+/// unreferenced (av_packet_unref / av_frame_unref); calls do not nest.
+class AvArena {
+public:
+    /// The calling thread's arena, created on first use and freed when the
+    /// thread exits.
+    static AvArena& local();
+
+    ~AvArena();
+
+    AvArena(const AvArena&) = delete;
+    AvArena& operator=(const AvArena&) = delete;
+
+    /// Empty packet / frame for a demux-and-decode loop; nullptr if
+    /// allocation failed.
+    AVPacket* packet();
+    AVFrame*  frame();
+
+    /// Writable mono frame with a buffer of `nb_samples` samples of
+    /// `sample_format` (an AVSampleFormat), for feeding an encoder.  The
+    /// buffer is kept between calls and only reallocated when the shape
+    /// changes.  nullptr on failure.
+    AVFrame* encode_frame(int sample_format, int nb_samples, int sample_rate);
+
+    /// Float scratch (e.g. PCM at the source rate before rate conversion),
+    /// cleared but keeping its capacity.
+    std::vector<float>& staging();
+
+    /// Call when done with staging(): frees it if it grew past
+    /// kMaxRetainedSamples, so one huge decode doesn't pin its buffer for
+    /// the thread's lifetime.
+    void trim();
+
+    /// 4 Mi samples (16 MB): a 35 s chunk even at 96 kHz.
+    static constexpr size_t kMaxRetainedSamples = size_t{4} << 20;
+
+private:
+    AvArena() = default;
+
+    AVPacket*          packet_       = nullptr;
+    AVFrame*           frame_        = nullptr;
+    AVFrame*           encode_frame_ = nullptr;
+    int                encode_capacity_ = 0;   // samples in encode_frame_'s buffer
+    std::vector<float> staging_;
+};
+
+} // namespace vr
@@ -0,0 +1,132 @@
+#include "BackgroundWorker.hpp"
+
+#include <algorithm>
+#include <utility>
+
+#if defined(__APPLE__)
+#include <pthread.h>
+#include <pthread/qos.h>
+#endif
+
+namespace vr {
+
+// ---------------------------------------------------------------------------
+// Construction / destruction
+// ---------------------------------------------------------------------------
+
+BackgroundWorker::BackgroundWorker() : worker_(&BackgroundWorker::worker_loop, this) {}
+
+BackgroundWorker::~BackgroundWorker() {
+    {
+        std::lock_guard<std::mutex> lock(mu_);
+        stopping_ = true;
+        queue_.clear();
+        abort_.store(true);
+    }
+    cv_.notify_all();
+    if (worker_.joinable()) worker_.join();
+}
+
+// ---------------------------------------------------------------------------
+// Queue control
+// ---------------------------------------------------------------------------
+
+bool BackgroundWorker::enqueue(const std::string& key, Job job, IfQueued if_queued) {
+    {
+        std::lock_guard<std::mutex> lock(mu_);
+        const auto same = [&](const Entry& e) { return e.key == key; };
+        if (if_queued == IfQueued::keep) {
+            if (key == running_ || std::any_of(queue_.begin(), queue_.end(), same)) return false;
+        } else {
+            queue_.erase(std::remove_if(queue_.begin(), queue_.end(), same), queue_.end());
+        }
+        queue_.push_back(Entry{key, std::move(job)});
+    }
+    cv_.notify_one();
+    return true;
+}
+
+void BackgroundWorker::cancel(const std::string& key) {
+    std::lock_guard<std::mutex> lock(mu_);
+    queue_.erase(std::remove_if(queue_.begin(), queue_.end(),
+                                [&](const Entry& e) { return e.key == key; }),
+                 queue_.end());
+    if (!running_.empty() && running_ == key) {
+        cancel_running_ = true;
+        abort_.store(true);
+    }
+}
+
+void BackgroundWorker::cancel_all() {
+    std::lock_guard<std::mutex> lock(mu_);
+    queue_.clear();
+    if (!running_.empty()) {
+        cancel_running_ = true;
+        abort_.store(true);
+    }
+}
+
+void BackgroundWorker::pause() {
+    std::lock_guard<std::mutex> lock(mu_);
+    ++pause_count_;
+    abort_.store(true);
+}
+
+void BackgroundWorker::resume() {
+    {
+        std::lock_guard<std::mutex> lock(mu_);
+        if (pause_count_ > 0) --pause_count_;
+    }
+    cv_.notify_one();
+}
+
+bool BackgroundWorker::is_paused() const {
+    std::lock_guard<std::mutex> lock(mu_);
+    return pause_count_ > 0;
+}
+
+size_t BackgroundWorker::pending() const {
+    std::lock_guard<std::mutex> lock(mu_);
+    return queue_.size() + (running_.empty() ? 0 : 1);
+}
+
+// ---------------------------------------------------------------------------
+// Worker
+// ---------------------------------------------------------------------------
+
+void BackgroundWorker::worker_loop() {
+#if defined(__APPLE__)
+    // Background QoS: scheduled on the efficiency cores and behind every
+    // user-initiated transcription.
+    pthread_set_qos_class_self_np(QOS_CLASS_BACKGROUND, 0);
+#endif
+
+    std::unique_lock<std::mutex> lock(mu_);
+    for (;;) {
+        cv_.wait(lock, [this] {
+            return stopping_ || (pause_count_ == 0 && !queue_.empty());
+        });
+        if (stopping_) return;
+
+        Entry entry = std::move(queue_.front());
+        queue_.pop_front();
+        running_ = entry.key;
+        cancel_running_ = false;
+        abort_.store(false);   // under mu_: a pause() after this re-raises it
+        lock.unlock();
+
+        const bool finished = entry.job();
+
+        lock.lock();
+        running_.clear();
+        if (!finished && !cancel_running_ && !stopping_) {
+            // Aborted by pause(): retry first once the queue resumes, unless
+            // a newer job for the same key was queued meanwhile.
+            const bool superseded = std::any_of(queue_.begin(), queue_.end(),
+                [&](const Entry& e) { return e.key == entry.key; });
+            if (!superseded) queue_.push_front(std::move(entry));
+        }
+    }
+}
+
+} // namespace vr
@@ -0,0 +1,88 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+
+namespace vr {
+
+/// One background-QoS worker running queued jobs in FIFO order, each keyed
+/// by its session, that yields to live work.  The scaffolding shared by
+/// RefinementQueue and RecoveryScheduler.
+///
+/// pause() holds the queue and raises the abort flag, which the running
+/// job passes to whisper (TranscribeOptions::abort): the job returns false
+/// and is put back at the head of the queue, and nothing starts until
+/// every pause() has been matched by a resume().  A cancelled job is
+/// aborted the same way but not retried.
+class BackgroundWorker {
+public:
+    /// Runs one job on the worker thread; returns false if it was aborted
+    /// and should be retried.
+    using Job = std::function<bool()>;
+
+    /// What enqueue() does when a job for the same key is already queued.
+    enum class IfQueued {
+        replace,   // drop the queued one, queue the new one at the back
+        keep,      // keep the queued (or running) one, drop the new one
+    };
+
+    /// Starts the worker.  Owners declare it as their last member, so it
+    /// starts after (and is joined before) the state its jobs use.
+    BackgroundWorker();
+
+    /// Drops queued jobs, aborts the running one, then joins the worker.
+    ~BackgroundWorker();
+
+    // Non-copyable.
+    BackgroundWorker(const BackgroundWorker&) = delete;
+    BackgroundWorker& operator=(const BackgroundWorker&) = delete;
+
+    /// Queue `job` under `key`.  Returns false if it was dropped (keep).
+    bool enqueue(const std::string& key, Job job, IfQueued if_queued);
+
+    /// Drop the queued job for `key` and abort it if running.
+    void cancel(const std::string& key);
+
+    /// Drop every queued job and abort the running one.
+    void cancel_all();
+
+    /// Hold the queue and abort the running job.  Calls nest.
+    void pause();
+    void resume();
+    bool is_paused() const;
+
+    /// Jobs queued or running.
+    size_t pending() const;
+
+    /// Raised by pause(), cancel() and destruction; polled by whisper
+    /// during inference.  Cleared when the next job starts.
+    const std::atomic<bool>* abort_flag() const { return &abort_; }
+    bool aborted() const { return abort_.load(); }
+
+private:
+    struct Entry {
+        std::string key;
+        Job         job;
+    };
+
+    void worker_loop();
+
+    mutable std::mutex      mu_;
+    std::condition_variable cv_;
+    std::deque<Entry>       queue_;
+    std::string             running_;            // key of the running job, or empty
+    int                     pause_count_ = 0;
+    bool                    cancel_running_ = false;
+    bool                    stopping_ = false;
+    std::atomic<bool>       abort_{false};
+
+    std::thread             worker_;             // declared last: starts after state
+};
+
+} // namespace vr
@@ -0,0 +1,183 @@
+#include "CaptureBuffer.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <utility>
+
+namespace vr {
+
+// ---------------------------------------------------------------------------
+// Construction / destruction
+// ---------------------------------------------------------------------------
+
+CaptureBuffer::CaptureBuffer(size_t chunk_samples, size_t headroom_samples,
+                             ChunkCallback on_chunk)
+    : chunk_samples_(chunk_samples),
+      on_chunk_(std::move(on_chunk)),
+      ring_(chunk_samples + headroom_samples),
+      pending_(chunk_samples * sizeof(float)),
+      recent_(kRecentSamples) {}
+
+CaptureBuffer::~CaptureBuffer() {
+    {
+        std::lock_guard<std::mutex> lock(mu_);
+        stopping_ = true;
+    }
+    cv_.notify_all();
+    if (consumer_.joinable()) consumer_.join();
+}
+
+// ---------------------------------------------------------------------------
+// Producer
+// ---------------------------------------------------------------------------
+
+void CaptureBuffer::write(const float* samples, size_t count) {
+    if (!samples || count == 0) return;
+
+    const MeterLevels levels = compute_meter_levels(samples, count);
+    rms_.store(levels.rms, std::memory_order_relaxed);
+    peak_.store(levels.peak, std::memory_order_relaxed);
+    for (size_t b = 0; b < kMeterBands; ++b) {
+        bands_[b].store(levels.bands[b], std::memory_order_relaxed);
+    }
+
+    // Overflow is counted by the ring; reported by the consumer, since
+    // logging is not real-time safe.
+    ring_.write(samples, count);
+}
+
+MeterLevels CaptureBuffer::levels() const {
+    MeterLevels levels;
+    levels.rms  = rms_.load(std::memory_order_relaxed);
+    levels.peak = peak_.load(std::memory_order_relaxed);
+    for (size_t b = 0; b < kMeterBands; ++b) {
+        levels.bands[b] = bands_[b].load(std::memory_order_relaxed);
+    }
+    return levels;
+}
+
+// ---------------------------------------------------------------------------
+// start / stop
+// ---------------------------------------------------------------------------
+
+void CaptureBuffer::start() {
+    if (consumer_.joinable()) return;
+
+    // Discard anything left from a previous recording.
+    float scratch[1024];
+    while (ring_.read(scratch, 1024) > 0) {}
+    pending_samples_ = 0;
+    chunk_index_.store(0, std::memory_order_release);
+    {
+        std::lock_guard<std::mutex> lock(recent_mu_);
+        recent_total_ = 0;
+    }
+    rms_.store(0.0f, std::memory_order_relaxed);
+    peak_.store(0.0f, std::memory_order_relaxed);
+    for (auto& band : bands_) band.store(0.0f, std::memory_order_relaxed);
+
+    stopping_ = false;
+    consumer_ = std::thread(&CaptureBuffer::consumer_loop, this);
+}
+
+std::vector<AudioChunk> CaptureBuffer::stop() {
+    {
+        std::lock_guard<std::mutex> lock(mu_);
+        stopping_ = true;
+    }
+    cv_.notify_all();
+    if (consumer_.joinable()) consumer_.join();
+
+    if (const size_t lost = ring_.dropped()) {
+        fprintf(stderr, "[CaptureBuffer] ring overflow: %zu samples dropped\n", lost);
+    }
+
+    std::vector<AudioChunk> remaining;
+    drain(&remaining);
+    if (pending_samples_ > 0) {
+        remaining.push_back(take_pending());
+    }
+    return remaining;
+}
+
+// ---------------------------------------------------------------------------
+// Consumer
+// ---------------------------------------------------------------------------
+
+void CaptureBuffer::consumer_loop() {
+    std::unique_lock<std::mutex> lock(mu_);
+    for (;;) {
+        // On stop, leave the rest for stop() to return directly.
+        if (cv_.wait_for(lock, kDrainInterval, [this] { return stopping_; })) return;
+        lock.unlock();
+        drain();
+        lock.lock();
+    }
+}
+
+void CaptureBuffer::drain(std::vector<AudioChunk>* full) {
+    for (;;) {
+        float* dst = reinterpret_cast<float*>(pending_.data()) + pending_samples_;
+        const size_t n = ring_.read(dst, chunk_samples_ - pending_samples_);
+        if (n == 0) return;
+        pending_samples_ += n;
+        remember(dst, n);
+
+        if (pending_samples_ == chunk_samples_) {
+            AudioChunk chunk = take_pending();
+            if (full) {
+                full->push_back(std::move(chunk));
+            } else if (on_chunk_) {
+                on_chunk_(std::move(chunk));
+            }
+        }
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Recent audio
+// ---------------------------------------------------------------------------
+
+void CaptureBuffer::remember(const float* samples, size_t count) {
+    std::lock_guard<std::mutex> lock(recent_mu_);
+    if (count > kRecentSamples) {
+        recent_total_ += count - kRecentSamples;
+        samples += count - kRecentSamples;
+        count = kRecentSamples;
+    }
+    const size_t pos   = recent_total_ % kRecentSamples;
+    const size_t first = std::min(count, kRecentSamples - pos);
+    std::memcpy(recent_.data() + pos, samples, first * sizeof(float));
+    std::memcpy(recent_.data(), samples + first, (count - first) * sizeof(float));
+    recent_total_ += count;
+}
+
+size_t CaptureBuffer::recent(std::vector<float>& out, size_t max_samples) const {
+    std::lock_guard<std::mutex> lock(recent_mu_);
+    const size_t n     = std::min({max_samples, kRecentSamples, recent_total_});
+    const size_t pos   = (recent_total_ - n) % kRecentSamples;
+    const size_t first = std::min(n, kRecentSamples - pos);
+    out.resize(n);
+    std::memcpy(out.data(), recent_.data() + pos, first * sizeof(float));
+    std::memcpy(out.data() + first, recent_.data(), (n - first) * sizeof(float));
+    return recent_total_;
+}
+
+AudioChunk CaptureBuffer::take_pending() {
+    AudioChunk chunk;
+    chunk.chunk_index = chunk_index_.fetch_add(1, std::memory_order_acq_rel);
+    chunk.codec       = ChunkCodec::pcm_f32;
+    chunk.duration_ms = static_cast<int64_t>(pending_samples_) * 1000 / kSampleRate;
+
+    pending_.resize(pending_samples_ * sizeof(float));
+    chunk.audio_data = std::move(pending_);
+
+    // Fresh buffer for the next chunk — allocated here on the consumer
+    // thread, never on the producer.
+    pending_ = std::vector<uint8_t>(chunk_samples_ * sizeof(float));
+    pending_samples_ = 0;
+    return chunk;
+}
+
+} // namespace vr
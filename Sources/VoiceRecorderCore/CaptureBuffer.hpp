@@ -0,0 +1,126 @@
+#pragma once
+
+#include "Metering.hpp"
+#include "SpscRingBuffer.hpp"
+#include "Types.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace vr {
+
+/// Hand-off from the real-time capture tap to the rest of the pipeline.
+///
+/// The tap calls write() with 16 kHz mono float32 samples: that meters the
+/// buffer and copies it into a preallocated SPSC ring, with no locks or
+/// allocation.  A consumer thread drains the ring into fixed-size chunks and
+/// hands each full one to the chunk callback (on the consumer thread), ready
+/// for DatabaseManager::add_chunk / WriteQueue::add_chunk.  The consumer
+/// also keeps the last few seconds it drained, for live captions.
+class CaptureBuffer {
+public:
+    /// `chunk` carries chunk_index, pcm_f32 audio_data and duration_ms;
+    /// session_id is left empty for the caller to fill in.
+    using ChunkCallback = std::function<void(AudioChunk chunk)>;
+
+    /// `chunk_samples` samples per chunk.  The ring holds one full chunk
+    /// plus `headroom_samples`, so a stalled consumer can fall a whole
+    /// chunk behind before the tap starts dropping audio.
+    CaptureBuffer(size_t chunk_samples, size_t headroom_samples, ChunkCallback on_chunk);
+
+    /// Stops the consumer (discarding any partial chunk).
+    ~CaptureBuffer();
+
+    // Non-copyable.
+    CaptureBuffer(const CaptureBuffer&) = delete;
+    CaptureBuffer& operator=(const CaptureBuffer&) = delete;
+
+    // -- Producer (real-time thread) ----------------------------------------
+
+    /// Meter and enqueue `count` samples.  Never blocks or allocates.
+    void write(const float* samples, size_t count);
+
+    // -- Control (main thread) ----------------------------------------------
+
+    /// Reset the chunk index and start the consumer thread.
+    void start();
+
+    /// Stop the consumer and return everything still buffered, in order:
+    /// any full chunks the consumer had not emitted yet, then the final
+    /// partial chunk (if non-empty).  These are returned rather than passed
+    /// to the callback so the caller can store them before it starts
+    /// transcribing.  Call once the producer has stopped writing.
+    std::vector<AudioChunk> stop();
+
+    /// Latest levels written by the producer.  Fields are published
+    /// independently, so a read may mix two consecutive buffers — harmless
+    /// for a meter.
+    MeterLevels levels() const;
+
+    /// Index the next chunk will get (= chunks emitted so far).
+    int32_t chunk_index() const { return chunk_index_.load(std::memory_order_acquire); }
+
+    /// Samples the producer dropped because the ring was full.
+    size_t dropped() const { return ring_.dropped(); }
+
+    /// Capture sample rate (16 kHz mono, what whisper expects).
+    static constexpr int kSampleRate = 16000;
+
+    /// How often the consumer drains the ring.
+    static constexpr std::chrono::milliseconds kDrainInterval{20};
+
+    /// Copy the last `max_samples` samples drained (at most kRecentSamples)
+    /// into `out`, oldest first.  Safe from any thread.
+    /// @return  Samples drained since start(): the stream position just
+    ///          past out.back().
+    size_t recent(std::vector<float>& out, size_t max_samples) const;
+
+    /// Audio kept for recent(): ten seconds.
+    static constexpr size_t kRecentSamples = 10 * kSampleRate;
+
+private:
+    void consumer_loop();
+
+    /// Move everything readable into the pending chunk.  Full chunks go
+    /// to `full` if given, else to the callback.
+    void drain(std::vector<AudioChunk>* full = nullptr);
+
+    /// Package pending_ as chunk `chunk_index_` and reset it.
+    AudioChunk take_pending();
+
+    /// Append drained samples to the recent() history.
+    void remember(const float* samples, size_t count);
+
+    const size_t            chunk_samples_;
+    ChunkCallback           on_chunk_;
+    SpscRingBuffer          ring_;
+
+    // Meter levels, written by the producer.
+    std::atomic<float>      rms_{0.0f};
+    std::atomic<float>      peak_{0.0f};
+    std::atomic<float>      bands_[kMeterBands] = {};
+
+    // Consumer-owned chunk assembly.
+    std::vector<uint8_t>    pending_;            // chunk_samples_ floats, preallocated
+    size_t                  pending_samples_ = 0;
+    std::atomic<int32_t>    chunk_index_{0};
+
+    // History for recent(), a circular buffer — guarded by recent_mu_.
+    std::vector<float>      recent_;             // kRecentSamples, preallocated
+    size_t                  recent_total_ = 0;   // samples drained since start()
+    mutable std::mutex      recent_mu_;
+
+    std::mutex              mu_;
+    std::condition_variable cv_;
+    bool                    stopping_ = false;
+    std::thread             consumer_;
+};
+
+} // namespace vr
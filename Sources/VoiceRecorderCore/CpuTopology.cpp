@@ -0,0 +1,55 @@
+#include "CpuTopology.hpp"
+
+#include <algorithm>
+#include <thread>
+
+#if defined(__APPLE__)
+#include <sys/sysctl.h>
+#include <sys/types.h>
+#endif
+
+namespace vr {
+
+namespace {
+
+#if defined(__APPLE__)
+/// Integer sysctl by name; `fallback` if the key doesn't exist.
+int sysctl_int(const char* name, int fallback) {
+    int value = 0;
+    size_t size = sizeof(value);
+    if (sysctlbyname(name, &value, &size, nullptr, 0) != 0 || value <= 0) {
+        return fallback;
+    }
+    return value;
+}
+#endif
+
+CpuTopology detect() {
+    CpuTopology t;
+    const int hw = static_cast<int>(std::thread::hardware_concurrency());
+    t.logical_cores     = std::max(1, hw);
+    t.performance_cores = t.logical_cores;
+
+#if defined(__APPLE__)
+    t.logical_cores = sysctl_int("hw.logicalcpu", t.logical_cores);
+    const int physical = sysctl_int("hw.physicalcpu", t.logical_cores);
+    if (sysctl_int("hw.nperflevels", 1) >= 2) {
+        t.performance_cores = sysctl_int("hw.perflevel0.physicalcpu", physical);
+        t.efficiency_cores  = sysctl_int("hw.perflevel1.physicalcpu", 0);
+    } else {
+        t.performance_cores = physical;   // Intel Macs: one level
+    }
+#endif
+
+    t.performance_cores = std::max(1, t.performance_cores);
+    return t;
+}
+
+} // namespace
+
+const CpuTopology& CpuTopology::current() {
+    static const CpuTopology topology = detect();
+    return topology;
+}
+
+} // namespace vr
@@ -0,0 +1,20 @@
+#pragma once
+
+namespace vr {
+
+/// Core counts of the host CPU, split by performance level.
+///
+/// On Apple Silicon the sysctl perflevel keys report the performance
+/// (perflevel0) and efficiency (perflevel1) clusters separately, e.g.
+/// 8P + 4E on an M3 Pro.  Elsewhere every core counts as a performance
+/// core and efficiency_cores is 0.
+struct CpuTopology {
+    int performance_cores = 1;   // physical cores in the fastest cluster
+    int efficiency_cores  = 0;   // physical cores in the efficiency cluster
+    int logical_cores     = 1;   // schedulable hardware threads in total
+
+    /// Topology of this machine, detected on first use.  Thread-safe.
+    static const CpuTopology& current();
+};
+
+} // namespace vr
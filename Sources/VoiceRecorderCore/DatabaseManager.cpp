@@ -1,8 +1,14 @@
 #include "DatabaseManager.hpp"
 
+#include "AudioCodec.hpp"
+#include "Instrumentation.hpp"
+
+#include <algorithm>
 #include <chrono>
+#include <cstdio>
 #include <cstdlib>
 #include <filesystem>
+#include <iterator>
 #include <random>
 #include <sstream>
 #include <stdexcept>
@@ -38,20 +44,40 @@ private:
 };
 
 // ---------------------------------------------------------------------------
-// RAII helper for SQLite prepared statements
+// RAII lease on a cached prepared statement
 // ---------------------------------------------------------------------------
 
+/// Borrows the connection's prepared statement for `sql`, preparing and
+/// caching it on first use.  On destruction the statement is reset and its
+/// bindings cleared so the next caller starts clean (and a read statement
+/// never pins an old WAL snapshot).  Callers hold the connection's mutex.
 class Statement {
 public:
-    Statement(sqlite3* db, const char* sql) {
-        int rc = sqlite3_prepare_v2(db, sql, -1, &stmt_, nullptr);
+    Statement(sqlite3* db, StatementCache& cache, const char* sql) {
+        auto it = cache.find(sql);
+        if (it != cache.end()) {
+            stmt_ = it->second;
+            return;
+        }
+        int rc = sqlite3_prepare_v3(db, sql, -1, SQLITE_PREPARE_PERSISTENT,
+                                    &stmt_, nullptr);
         if (rc != SQLITE_OK) {
+            fprintf(stderr, "[DatabaseManager] prepare failed: %s (%s)\n",
+                    sqlite3_errmsg(db), sql);
             stmt_ = nullptr;
+            return;
         }
+        cache.emplace(sql, stmt_);
     }
     ~Statement() {
-        if (stmt_) sqlite3_finalize(stmt_);
+        if (stmt_) {
+            sqlite3_reset(stmt_);
+            sqlite3_clear_bindings(stmt_);
+        }
     }
+    Statement(const Statement&) = delete;
+    Statement& operator=(const Statement&) = delete;
+
     operator sqlite3_stmt*() const { return stmt_; }
     bool ok() const { return stmt_ != nullptr; }
 
@@ -59,6 +85,37 @@ private:
     sqlite3_stmt* stmt_ = nullptr;
 };
 
+/// Finalize every cached statement and close the connection.
+static void close_connection(sqlite3*& db, StatementCache& cache) {
+    for (auto& entry : cache) {
+        sqlite3_finalize(entry.second);
+    }
+    cache.clear();
+    if (db) {
+        sqlite3_close(db);
+        db = nullptr;
+    }
+}
+
+/// sessions.transcript_version at column `col`; NULL (pre-column rows) is a draft.
+static TranscriptVersion version_from_column(sqlite3_stmt* stmt, int col) {
+    return sqlite3_column_int(stmt, col) == static_cast<int>(TranscriptVersion::refined)
+        ? TranscriptVersion::refined : TranscriptVersion::draft;
+}
+
+/// Per-connection tuning shared by the writer and the reader.
+static void apply_connection_pragmas(sqlite3* db) {
+    // Wait out brief lock contention (checkpoint, schema change) instead of
+    // failing immediately with SQLITE_BUSY.
+    sqlite3_busy_timeout(db, 5000);
+
+    // Memory-map the database for reads and keep a larger page cache; both
+    // are per-connection.  Negative cache_size is in KiB.
+    sqlite3_exec(db, "PRAGMA mmap_size=268435456", nullptr, nullptr, nullptr);
+    sqlite3_exec(db, "PRAGMA cache_size=-8192", nullptr, nullptr, nullptr);
+    sqlite3_exec(db, "PRAGMA temp_store=MEMORY", nullptr, nullptr, nullptr);
+}
+
 // ---------------------------------------------------------------------------
 // Construction / destruction
 // ---------------------------------------------------------------------------
@@ -99,18 +156,48 @@ bool DatabaseManager::open() {
     // Enable WAL mode for crash safety and concurrent reads.
     sqlite3_exec(db_, "PRAGMA journal_mode=WAL", nullptr, nullptr, nullptr);
 
+    // Under WAL, NORMAL only syncs at checkpoint: a power loss can drop the
+    // last commits but never corrupts the database.
+    sqlite3_exec(db_, "PRAGMA synchronous=NORMAL", nullptr, nullptr, nullptr);
+
     // Enable foreign keys.
     sqlite3_exec(db_, "PRAGMA foreign_keys=ON", nullptr, nullptr, nullptr);
 
-    return create_tables();
+    apply_connection_pragmas(db_);
+
+    // Replace SQLite's inline auto-checkpoint with our own schedule (see
+    // on_wal_commit) so a chunk insert rarely pays for a checkpoint.
+    last_checkpoint_ = std::chrono::steady_clock::now();
+    sqlite3_wal_hook(db_, &DatabaseManager::on_wal_commit, this);
+
+    if (!create_tables()) return false;
+
+    // Separate read-only connection for history / detail / chunk reads.
+    // WAL lets it read a committed snapshot while the writer is inserting,
+    // and its own mutex means reads never queue behind a chunk insert.
+    std::lock_guard<std::mutex> read_lock(read_mu_);
+    rc = sqlite3_open_v2(db_path_.c_str(), &read_db_,
+                         SQLITE_OPEN_READONLY, nullptr);
+    if (rc != SQLITE_OK) {
+        fprintf(stderr, "[DatabaseManager] read connection failed: %s\n",
+                read_db_ ? sqlite3_errmsg(read_db_) : "out of memory");
+        if (read_db_) {
+            sqlite3_close(read_db_);
+            read_db_ = nullptr;
+        }
+        close_connection(db_, stmts_);
+        return false;
+    }
+    apply_connection_pragmas(read_db_);
+
+    return true;
 }
 
 void DatabaseManager::close() {
     std::lock_guard<std::mutex> lock(mu_);
-    if (db_) {
-        sqlite3_close(db_);
-        db_ = nullptr;
-    }
+    std::lock_guard<std::mutex> read_lock(read_mu_);
+    close_connection(read_db_, read_stmts_);
+    close_connection(db_, stmts_);
 }
 
 bool DatabaseManager::is_open() const {
@@ -118,6 +205,36 @@ bool DatabaseManager::is_open() const {
     return db_ != nullptr;
 }
 
+// ---------------------------------------------------------------------------
+// WAL checkpointing
+// ---------------------------------------------------------------------------
+
+bool DatabaseManager::checkpoint() {
+    std::lock_guard<std::mutex> lock(mu_);
+    if (!db_) return false;
+    return run_checkpoint();
+}
+
+bool DatabaseManager::run_checkpoint() {
+    // PASSIVE copies whatever frames it can without waiting on readers, so
+    // it never blocks the history list.
+    int rc = sqlite3_wal_checkpoint_v2(db_, nullptr, SQLITE_CHECKPOINT_PASSIVE,
+                                       nullptr, nullptr);
+    last_checkpoint_ = std::chrono::steady_clock::now();
+    return rc == SQLITE_OK;
+}
+
+int DatabaseManager::on_wal_commit(void* ctx, sqlite3*, const char*, int wal_pages) {
+    // Runs on the writer thread after each commit, with mu_ held.
+    auto* self = static_cast<DatabaseManager*>(ctx);
+    const auto elapsed = std::chrono::steady_clock::now() - self->last_checkpoint_;
+    if (wal_pages >= kCheckpointPages ||
+        (wal_pages > 0 && elapsed >= std::chrono::seconds(kCheckpointIntervalSec))) {
+        self->run_checkpoint();
+    }
+    return SQLITE_OK;
+}
+
 // ---------------------------------------------------------------------------
 // create_tables
 // ---------------------------------------------------------------------------
@@ -131,7 +248,11 @@ bool DatabaseManager::create_tables() {
             completed_at INTEGER,
             status TEXT DEFAULT 'recording',
             duration_ms INTEGER,
-            transcript TEXT
+            transcript TEXT,
+            preview TEXT,
+            transcript_version INTEGER,
+            recovered_ms INTEGER,
+            archive_path TEXT
         );
     )SQL";
 
@@ -143,10 +264,45 @@ bool DatabaseManager::create_tables() {
             audio_blob BLOB NOT NULL,
             duration_ms INTEGER,
             created_at INTEGER NOT NULL,
+            transcript TEXT,
+            codec TEXT DEFAULT 'pcm_f32',
+            pcm_bytes INTEGER,
             FOREIGN KEY (session_id) REFERENCES sessions(id)
         );
     )SQL";
 
+    const char* create_segments = R"SQL(
+        CREATE TABLE IF NOT EXISTS segments (
+            id INTEGER PRIMARY KEY AUTOINCREMENT,
+            session_id TEXT NOT NULL,
+            chunk_index INTEGER NOT NULL,
+            t0_ms INTEGER NOT NULL,
+            t1_ms INTEGER NOT NULL,
+            text TEXT NOT NULL,
+            avg_prob REAL,
+            FOREIGN KEY (session_id) REFERENCES sessions(id)
+        );
+    )SQL";
+
+    const char* create_waveforms = R"SQL(
+        CREATE TABLE IF NOT EXISTS waveforms (
+            session_id TEXT NOT NULL,
+            level INTEGER NOT NULL,
+            chunk_index INTEGER NOT NULL,
+            bins BLOB NOT NULL,
+            PRIMARY KEY (session_id, level, chunk_index)
+        ) WITHOUT ROWID;
+    )SQL";
+
+    const char* create_transcript_cache = R"SQL(
+        CREATE TABLE IF NOT EXISTS transcript_cache (
+            cache_key TEXT PRIMARY KEY,
+            session_id TEXT,
+            entry BLOB NOT NULL,
+            created_at INTEGER NOT NULL
+        ) WITHOUT ROWID;
+    )SQL";
+
     char* err = nullptr;
 
     // Create sessions table.
@@ -163,6 +319,92 @@ bool DatabaseManager::create_tables() {
     sqlite3_exec(db_, "ALTER TABLE sessions ADD COLUMN transcript TEXT",
                  nullptr, nullptr, nullptr);
 
+    // Migrate sessions: which pass wrote the transcript (TranscriptVersion).
+    // NULL on older rows, read back as a draft.
+    sqlite3_exec(db_, "ALTER TABLE sessions ADD COLUMN transcript_version INTEGER",
+                 nullptr, nullptr, nullptr);
+
+    // Migrate sessions: crash-recovery progress (save_recovered_range).
+    sqlite3_exec(db_, "ALTER TABLE sessions ADD COLUMN recovered_ms INTEGER",
+                 nullptr, nullptr, nullptr);
+
+    // Migrate sessions: where the audio went once archived (attach_archive).
+    sqlite3_exec(db_, "ALTER TABLE sessions ADD COLUMN archive_path TEXT",
+                 nullptr, nullptr, nullptr);
+
+    // Migrate sessions: transcript preview for the history list.  Backfill
+    // rows transcribed before the column existed (one-time; later rows get
+    // their preview in update_transcript).
+    if (sqlite3_exec(db_, "ALTER TABLE sessions ADD COLUMN preview TEXT",
+                     nullptr, nullptr, nullptr) == SQLITE_OK) {
+        const std::string backfill =
+            "UPDATE sessions SET preview = substr(transcript, 1, " +
+            std::to_string(kPreviewChars) + ") WHERE transcript IS NOT NULL";
+        sqlite3_exec(db_, backfill.c_str(), nullptr, nullptr, nullptr);
+    }
+
+    // Full-text index over sessions.transcript.  External-content FTS5
+    // keyed by the sessions rowid, so transcripts are not stored twice;
+    // triggers keep it in sync with every insert/update/delete.  (Rowids
+    // of a TEXT-keyed table can change under VACUUM, so vacuum() follows
+    // it with a 'rebuild'.)
+    bool fts_exists = false;
+    {
+        Statement stmt(db_, stmts_,
+            "SELECT 1 FROM sqlite_master WHERE type = 'table' AND name = 'sessions_fts'");
+        fts_exists = stmt.ok() && sqlite3_step(stmt) == SQLITE_ROW;
+    }
+
+    const char* create_fts = R"SQL(
+        CREATE VIRTUAL TABLE IF NOT EXISTS sessions_fts USING fts5(
+            transcript,
+            content='sessions',
+            content_rowid='rowid',
+            tokenize='porter unicode61 remove_diacritics 2'
+        );
+
+        CREATE TRIGGER IF NOT EXISTS sessions_fts_ai AFTER INSERT ON sessions
+        WHEN new.transcript IS NOT NULL BEGIN
+            INSERT INTO sessions_fts(rowid, transcript)
+            VALUES (new.rowid, new.transcript);
+        END;
+
+        CREATE TRIGGER IF NOT EXISTS sessions_fts_ad AFTER DELETE ON sessions
+        WHEN old.transcript IS NOT NULL BEGIN
+            INSERT INTO sessions_fts(sessions_fts, rowid, transcript)
+            VALUES ('delete', old.rowid, old.transcript);
+        END;
+
+        CREATE TRIGGER IF NOT EXISTS sessions_fts_au AFTER UPDATE OF transcript ON sessions
+        BEGIN
+            INSERT INTO sessions_fts(sessions_fts, rowid, transcript)
+            SELECT 'delete', old.rowid, old.transcript WHERE old.transcript IS NOT NULL;
+            INSERT INTO sessions_fts(rowid, transcript)
+            SELECT new.rowid, new.transcript WHERE new.transcript IS NOT NULL;
+        END;
+    )SQL";
+
+    rc = sqlite3_exec(db_, create_fts, nullptr, nullptr, &err);
+    if (rc != SQLITE_OK) {
+        // Search is optional (SQLite built without FTS5); keep going.
+        fprintf(stderr, "[DatabaseManager] FTS5 unavailable: %s\n", err ? err : "unknown");
+        if (err) {
+            sqlite3_free(err);
+            err = nullptr;
+        }
+    } else if (!fts_exists) {
+        // One-time backfill of transcripts written before the index existed.
+        sqlite3_exec(db_, "INSERT INTO sessions_fts(sessions_fts) VALUES ('rebuild')",
+                     nullptr, nullptr, nullptr);
+    }
+
+    // Covering index for get_session_summaries(): every selected column is
+    // in the index, so paging the history never touches the table rows.
+    sqlite3_exec(db_,
+        "CREATE INDEX IF NOT EXISTS idx_sessions_created_at "
+        "ON sessions(created_at DESC, id, completed_at, status, duration_ms, preview)",
+        nullptr, nullptr, nullptr);
+
     // Create chunks table (no-op if table already exists).
     rc = sqlite3_exec(db_, create_chunks, nullptr, nullptr, &err);
     if (rc != SQLITE_OK && err) {
@@ -177,12 +419,47 @@ bool DatabaseManager::create_tables() {
         "ALTER TABLE chunks RENAME COLUMN chunk_num TO chunk_index",
         nullptr, nullptr, nullptr);
 
+    // Migrate chunks: per-chunk partial transcript from streaming mode.
+    sqlite3_exec(db_, "ALTER TABLE chunks ADD COLUMN transcript TEXT",
+                 nullptr, nullptr, nullptr);
+
+    // Migrate chunks: storage codec.  Rows that predate the column read
+    // back as 'pcm_f32', which is exactly what they contain.
+    sqlite3_exec(db_, "ALTER TABLE chunks ADD COLUMN codec TEXT DEFAULT 'pcm_f32'",
+                 nullptr, nullptr, nullptr);
+    sqlite3_exec(db_, "ALTER TABLE chunks ADD COLUMN pcm_bytes INTEGER",
+                 nullptr, nullptr, nullptr);
+
     // Create index (safe — chunk_index now exists either way).
     sqlite3_exec(db_,
         "CREATE INDEX IF NOT EXISTS idx_chunks_session "
         "ON chunks(session_id, chunk_index)",
         nullptr, nullptr, nullptr);
 
+    // Segment timings for seek and partial re-transcription.
+    sqlite3_exec(db_, create_segments, nullptr, nullptr, nullptr);
+    sqlite3_exec(db_,
+        "CREATE INDEX IF NOT EXISTS idx_segments_session "
+        "ON segments(session_id, t0_ms)",
+        nullptr, nullptr, nullptr);
+
+    // Waveform pyramids.  Clustered on (session, level, chunk) so one
+    // level of one session is a single contiguous range of small pages.
+    sqlite3_exec(db_, create_waveforms, nullptr, nullptr, nullptr);
+
+    // Content-addressed transcription results (see TranscriptCache).  Not
+    // tied to a session by key, but rows remember which session stored
+    // them so deleting it takes its text with it.
+    sqlite3_exec(db_, create_transcript_cache, nullptr, nullptr, nullptr);
+    sqlite3_exec(db_,
+        "CREATE INDEX IF NOT EXISTS idx_transcript_cache_session "
+        "ON transcript_cache(session_id)",
+        nullptr, nullptr, nullptr);
+    sqlite3_exec(db_,
+        "CREATE INDEX IF NOT EXISTS idx_transcript_cache_created "
+        "ON transcript_cache(created_at)",
+        nullptr, nullptr, nullptr);
+
     return true;
 }
 
@@ -201,7 +478,7 @@ std::string DatabaseManager::create_session() {
 
     const char* sql =
         "INSERT INTO sessions (id, created_at, status) VALUES (?, ?, 'recording')";
-    Statement stmt(db_, sql);
+    Statement stmt(db_, stmts_, sql);
     if (!stmt.ok()) return "";
 
     sqlite3_bind_text(stmt, 1, id.c_str(), -1, SQLITE_TRANSIENT);
@@ -216,28 +493,46 @@ std::string DatabaseManager::create_session() {
 
 bool DatabaseManager::update_transcript(const std::string& session_id,
                                         const std::string& transcript,
-                                        int64_t duration_ms) {
+                                        int64_t duration_ms,
+                                        TranscriptVersion version) {
     std::lock_guard<std::mutex> lock(mu_);
     if (!db_) return false;
 
     Transaction txn(db_);
+    if (!update_transcript_locked(session_id, transcript, duration_ms, version)) return false;
+    txn.commit();
+    return true;
+}
 
+bool DatabaseManager::update_transcript_locked(const std::string& session_id,
+                                               const std::string& transcript,
+                                               int64_t duration_ms,
+                                               TranscriptVersion version) {
+    // A refinement keeps the original completion time and duration (0 means
+    // "unchanged"), and the version guard stops a late draft from
+    // overwriting a refined transcript.
     const char* sql =
-        "UPDATE sessions SET transcript = ?, duration_ms = ?, "
-        "status = 'complete', completed_at = ? WHERE id = ?";
-    Statement stmt(db_, sql);
+        "UPDATE sessions SET transcript = ?, "
+        "duration_ms = CASE WHEN ? > 0 THEN ? ELSE duration_ms END, "
+        "status = 'complete', completed_at = COALESCE(completed_at, ?), "
+        "preview = ?, transcript_version = ? "
+        "WHERE id = ? AND COALESCE(transcript_version, 0) <= ?";
+    Statement stmt(db_, stmts_, sql);
     if (!stmt.ok()) return false;
 
+    const std::string preview = make_preview(transcript);
+    const int v = static_cast<int>(version);
+
     sqlite3_bind_text(stmt, 1, transcript.c_str(), -1, SQLITE_TRANSIENT);
     sqlite3_bind_int64(stmt, 2, duration_ms);
-    sqlite3_bind_int64(stmt, 3, now_unix());
-    sqlite3_bind_text(stmt, 4, session_id.c_str(), -1, SQLITE_TRANSIENT);
+    sqlite3_bind_int64(stmt, 3, duration_ms);
+    sqlite3_bind_int64(stmt, 4, now_unix());
+    sqlite3_bind_text(stmt, 5, preview.c_str(), -1, SQLITE_TRANSIENT);
+    sqlite3_bind_int(stmt, 6, v);
+    sqlite3_bind_text(stmt, 7, session_id.c_str(), -1, SQLITE_TRANSIENT);
+    sqlite3_bind_int(stmt, 8, v);
 
-    int rc = sqlite3_step(stmt);
-    if (rc != SQLITE_DONE) return false;
-
-    txn.commit();
-    return true;
+    return sqlite3_step(stmt) == SQLITE_DONE;
 }
 
 bool DatabaseManager::mark_failed(const std::string& session_id) {
@@ -250,28 +545,35 @@ bool DatabaseManager::update_status(const std::string& session_id,
     if (!db_) return false;
 
     Transaction txn(db_);
+    if (!update_status_locked(session_id, status)) return false;
+
+    txn.commit();
+    return true;
+}
 
+bool DatabaseManager::update_status_locked(const std::string& session_id,
+                                           RecordingStatus status) {
     const char* sql = "UPDATE sessions SET status = ? WHERE id = ?";
-    Statement stmt(db_, sql);
+    Statement stmt(db_, stmts_, sql);
     if (!stmt.ok()) return false;
 
     sqlite3_bind_text(stmt, 1, status_to_string(status), -1, SQLITE_STATIC);
     sqlite3_bind_text(stmt, 2, session_id.c_str(), -1, SQLITE_TRANSIENT);
 
-    int rc = sqlite3_step(stmt);
-    if (rc != SQLITE_DONE) return false;
-
-    txn.commit();
-    return true;
+    return sqlite3_step(stmt) == SQLITE_DONE;
 }
 
 bool DatabaseManager::update_duration(const std::string& session_id,
                                       int64_t duration_ms) {
     std::lock_guard<std::mutex> lock(mu_);
     if (!db_) return false;
+    return update_duration_locked(session_id, duration_ms);
+}
 
+bool DatabaseManager::update_duration_locked(const std::string& session_id,
+                                             int64_t duration_ms) {
     const char* sql = "UPDATE sessions SET duration_ms = ? WHERE id = ?";
-    Statement stmt(db_, sql);
+    Statement stmt(db_, stmts_, sql);
     if (!stmt.ok()) return false;
 
     sqlite3_bind_int64(stmt, 1, duration_ms);
@@ -282,13 +584,14 @@ bool DatabaseManager::update_duration(const std::string& session_id,
 
 std::optional<RecordingSession> DatabaseManager::get_session(
     const std::string& session_id) const {
-    std::lock_guard<std::mutex> lock(mu_);
-    if (!db_) return std::nullopt;
+    std::lock_guard<std::mutex> lock(read_mu_);
+    if (!read_db_) return std::nullopt;
 
     const char* sql =
-        "SELECT id, created_at, completed_at, status, duration_ms, transcript "
+        "SELECT id, created_at, completed_at, status, duration_ms, transcript, "
+        "transcript_version "
         "FROM sessions WHERE id = ?";
-    Statement stmt(db_, sql);
+    Statement stmt(read_db_, read_stmts_, sql);
     if (!stmt.ok()) return std::nullopt;
 
     sqlite3_bind_text(stmt, 1, session_id.c_str(), -1, SQLITE_TRANSIENT);
@@ -306,19 +609,21 @@ std::optional<RecordingSession> DatabaseManager::get_session(
                          ? 0 : sqlite3_column_int64(stmt, 4);
     const char* t  = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 5));
     s.transcript   = t ? t : "";
+    s.transcript_version = version_from_column(stmt, 6);
 
     return s;
 }
 
 std::vector<RecordingSession> DatabaseManager::get_sessions() const {
-    std::lock_guard<std::mutex> lock(mu_);
+    std::lock_guard<std::mutex> lock(read_mu_);
     std::vector<RecordingSession> results;
-    if (!db_) return results;
+    if (!read_db_) return results;
 
     const char* sql =
-        "SELECT id, created_at, completed_at, status, duration_ms, transcript "
+        "SELECT id, created_at, completed_at, status, duration_ms, transcript, "
+        "transcript_version "
         "FROM sessions ORDER BY created_at DESC";
-    Statement stmt(db_, sql);
+    Statement stmt(read_db_, read_stmts_, sql);
     if (!stmt.ok()) return results;
 
     while (sqlite3_step(stmt) == SQLITE_ROW) {
@@ -333,22 +638,126 @@ std::vector<RecordingSession> DatabaseManager::get_sessions() const {
                              ? 0 : sqlite3_column_int64(stmt, 4);
         const char* t  = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 5));
         s.transcript   = t ? t : "";
+        s.transcript_version = version_from_column(stmt, 6);
         results.push_back(std::move(s));
     }
 
     return results;
 }
 
+std::vector<SessionSummary> DatabaseManager::get_session_summaries(
+    int offset, int limit) const {
+    std::lock_guard<std::mutex> lock(read_mu_);
+    std::vector<SessionSummary> results;
+    if (!read_db_ || limit <= 0) return results;
+
+    const char* sql =
+        "SELECT id, created_at, completed_at, status, duration_ms, preview "
+        "FROM sessions INDEXED BY idx_sessions_created_at "
+        "ORDER BY created_at DESC LIMIT ? OFFSET ?";
+    Statement stmt(read_db_, read_stmts_, sql);
+    if (!stmt.ok()) return results;
+
+    sqlite3_bind_int(stmt, 1, limit);
+    sqlite3_bind_int(stmt, 2, offset < 0 ? 0 : offset);
+
+    results.reserve(static_cast<size_t>(limit));
+    while (sqlite3_step(stmt) == SQLITE_ROW) {
+        SessionSummary s;
+        s.id           = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 0));
+        s.created_at   = sqlite3_column_int64(stmt, 1);
+        s.completed_at = sqlite3_column_type(stmt, 2) == SQLITE_NULL
+                             ? 0 : sqlite3_column_int64(stmt, 2);
+        s.status       = status_from_string(
+            reinterpret_cast<const char*>(sqlite3_column_text(stmt, 3)));
+        s.duration_ms  = sqlite3_column_type(stmt, 4) == SQLITE_NULL
+                             ? 0 : sqlite3_column_int64(stmt, 4);
+        const char* p  = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 5));
+        s.preview      = p ? p : "";
+        results.push_back(std::move(s));
+    }
+
+    return results;
+}
+
+std::vector<SearchHit> DatabaseManager::search(const std::string& query,
+                                               int limit) const {
+    std::vector<SearchHit> results;
+    const std::string match = to_match_expression(query);
+    if (match.empty() || limit <= 0) return results;
+
+    std::lock_guard<std::mutex> lock(read_mu_);
+    if (!read_db_) return results;
+
+    // bm25 ordering and snippet() run inside FTS5; only `limit` session
+    // rows are joined back for their metadata.
+    const char* sql =
+        "SELECT s.id, s.created_at, s.completed_at, s.status, s.duration_ms, "
+        "       bm25(sessions_fts) AS rank, "
+        "       snippet(sessions_fts, 0, ?, ?, '...', 16) "
+        "FROM sessions_fts JOIN sessions s ON s.rowid = sessions_fts.rowid "
+        "WHERE sessions_fts MATCH ? ORDER BY rank LIMIT ?";
+    Statement stmt(read_db_, read_stmts_, sql);
+    if (!stmt.ok()) return results;
+
+    sqlite3_bind_text(stmt, 1, kSnippetOpen, -1, SQLITE_STATIC);
+    sqlite3_bind_text(stmt, 2, kSnippetClose, -1, SQLITE_STATIC);
+    sqlite3_bind_text(stmt, 3, match.c_str(), -1, SQLITE_TRANSIENT);
+    sqlite3_bind_int(stmt, 4, limit);
+
+    int rc;
+    while ((rc = sqlite3_step(stmt)) == SQLITE_ROW) {
+        SearchHit h;
+        h.session.id           = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 0));
+        h.session.created_at   = sqlite3_column_int64(stmt, 1);
+        h.session.completed_at = sqlite3_column_type(stmt, 2) == SQLITE_NULL
+                                     ? 0 : sqlite3_column_int64(stmt, 2);
+        h.session.status       = status_from_string(
+            reinterpret_cast<const char*>(sqlite3_column_text(stmt, 3)));
+        h.session.duration_ms  = sqlite3_column_type(stmt, 4) == SQLITE_NULL
+                                     ? 0 : sqlite3_column_int64(stmt, 4);
+        h.rank                 = sqlite3_column_double(stmt, 5);
+        const char* snip       = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 6));
+        h.snippet              = snip ? snip : "";
+        results.push_back(std::move(h));
+    }
+
+    if (rc != SQLITE_DONE) {
+        fprintf(stderr, "[DatabaseManager] search failed: %s\n", sqlite3_errmsg(read_db_));
+    }
+
+    return results;
+}
+
+std::optional<std::string> DatabaseManager::get_transcript(
+    const std::string& session_id) const {
+    std::lock_guard<std::mutex> lock(read_mu_);
+    if (!read_db_) return std::nullopt;
+
+    const char* sql = "SELECT transcript FROM sessions WHERE id = ?";
+    Statement stmt(read_db_, read_stmts_, sql);
+    if (!stmt.ok()) return std::nullopt;
+
+    sqlite3_bind_text(stmt, 1, session_id.c_str(), -1, SQLITE_TRANSIENT);
+
+    if (sqlite3_step(stmt) != SQLITE_ROW) return std::nullopt;
+    const char* t = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 0));
+    return std::string(t ? t : "");
+}
+
 bool DatabaseManager::delete_session(const std::string& session_id) {
     std::lock_guard<std::mutex> lock(mu_);
     if (!db_) return false;
 
     Transaction txn(db_);
 
-    // Delete chunks first (foreign key).
-    {
-        const char* sql = "DELETE FROM chunks WHERE session_id = ?";
-        Statement stmt(db_, sql);
+    // Delete segments, waveforms, cached transcripts and chunks first
+    // (foreign key).
+    if (!write_segments_locked(session_id, 0, -1, {})) return false;
+    for (const char* sql : {"DELETE FROM waveforms WHERE session_id = ?",
+                            "DELETE FROM transcript_cache WHERE session_id = ?",
+                            "DELETE FROM chunks WHERE session_id = ?"}) {
+        Statement stmt(db_, stmts_, sql);
         if (!stmt.ok()) return false;
         sqlite3_bind_text(stmt, 1, session_id.c_str(), -1, SQLITE_TRANSIENT);
         if (sqlite3_step(stmt) != SQLITE_DONE) return false;
@@ -357,7 +766,7 @@ bool DatabaseManager::delete_session(const std::string& session_id) {
     // Delete session.
     {
         const char* sql = "DELETE FROM sessions WHERE id = ?";
-        Statement stmt(db_, sql);
+        Statement stmt(db_, stmts_, sql);
         if (!stmt.ok()) return false;
         sqlite3_bind_text(stmt, 1, session_id.c_str(), -1, SQLITE_TRANSIENT);
         if (sqlite3_step(stmt) != SQLITE_DONE) return false;
@@ -368,14 +777,15 @@ bool DatabaseManager::delete_session(const std::string& session_id) {
 }
 
 std::vector<RecordingSession> DatabaseManager::get_orphaned_sessions() const {
-    std::lock_guard<std::mutex> lock(mu_);
+    std::lock_guard<std::mutex> lock(read_mu_);
     std::vector<RecordingSession> results;
-    if (!db_) return results;
+    if (!read_db_) return results;
 
     const char* sql =
-        "SELECT id, created_at, completed_at, status, duration_ms, transcript "
+        "SELECT id, created_at, completed_at, status, duration_ms, transcript, "
+        "transcript_version "
         "FROM sessions WHERE status = 'recording' ORDER BY created_at DESC";
-    Statement stmt(db_, sql);
+    Statement stmt(read_db_, read_stmts_, sql);
     if (!stmt.ok()) return results;
 
     while (sqlite3_step(stmt) == SQLITE_ROW) {
@@ -390,79 +800,910 @@ std::vector<RecordingSession> DatabaseManager::get_orphaned_sessions() const {
                              ? 0 : sqlite3_column_int64(stmt, 4);
         const char* t  = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 5));
         s.transcript   = t ? t : "";
+        s.transcript_version = version_from_column(stmt, 6);
         results.push_back(std::move(s));
     }
 
     return results;
 }
 
+int64_t DatabaseManager::get_recovery_progress(const std::string& session_id) const {
+    std::lock_guard<std::mutex> lock(read_mu_);
+    if (!read_db_) return 0;
+
+    Statement stmt(read_db_, read_stmts_,
+        "SELECT COALESCE(recovered_ms, 0) FROM sessions WHERE id = ?");
+    if (!stmt.ok()) return 0;
+
+    sqlite3_bind_text(stmt, 1, session_id.c_str(), -1, SQLITE_TRANSIENT);
+
+    if (sqlite3_step(stmt) != SQLITE_ROW) return 0;
+    return sqlite3_column_int64(stmt, 0);
+}
+
+bool DatabaseManager::save_recovered_range(const std::string& session_id,
+                                           int64_t begin_ms, int64_t end_ms,
+                                           const std::vector<TranscriptSegment>& segments) {
+    std::lock_guard<std::mutex> lock(mu_);
+    if (!db_) return false;
+
+    Transaction txn(db_);
+    if (!write_segments_locked(session_id, begin_ms, std::max(begin_ms, end_ms), segments)) {
+        return false;
+    }
+
+    Statement stmt(db_, stmts_, "UPDATE sessions SET recovered_ms = ? WHERE id = ?");
+    if (!stmt.ok()) return false;
+    sqlite3_bind_int64(stmt, 1, end_ms);
+    sqlite3_bind_text(stmt, 2, session_id.c_str(), -1, SQLITE_TRANSIENT);
+    if (sqlite3_step(stmt) != SQLITE_DONE) return false;
+
+    txn.commit();
+    return true;
+}
+
+// ---------------------------------------------------------------------------
+// Segments
+// ---------------------------------------------------------------------------
+
+bool DatabaseManager::replace_segments(const std::string& session_id,
+                                       const std::vector<TranscriptSegment>& segments) {
+    std::lock_guard<std::mutex> lock(mu_);
+    if (!db_) return false;
+
+    Transaction txn(db_);
+    if (!write_segments_locked(session_id, 0, -1, segments)) return false;
+    txn.commit();
+    return true;
+}
+
+bool DatabaseManager::replace_segments_in_range(const std::string& session_id,
+                                                int64_t begin_ms, int64_t end_ms,
+                                                const std::vector<TranscriptSegment>& segments,
+                                                TranscriptVersion version) {
+    std::lock_guard<std::mutex> lock(mu_);
+    if (!db_) return false;
+
+    Transaction txn(db_);
+    if (!write_segments_locked(session_id, begin_ms, std::max(begin_ms, end_ms), segments)) {
+        return false;
+    }
+
+    // Rebuild the transcript on the writer connection, which sees the
+    // uncommitted rows above.
+    std::string transcript;
+    {
+        Statement stmt(db_, stmts_,
+            "SELECT text FROM segments WHERE session_id = ? ORDER BY t0_ms, id");
+        if (!stmt.ok()) return false;
+        sqlite3_bind_text(stmt, 1, session_id.c_str(), -1, SQLITE_TRANSIENT);
+        while (sqlite3_step(stmt) == SQLITE_ROW) {
+            const char* t = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 0));
+            if (t) transcript += t;
+        }
+    }
+    if (!update_transcript_locked(session_id, transcript, 0, version)) return false;
+
+    txn.commit();
+    return true;
+}
+
+bool DatabaseManager::write_segments_locked(const std::string& session_id,
+                                            int64_t begin_ms, int64_t end_ms,
+                                            const std::vector<TranscriptSegment>& segments) {
+    {
+        const char* sql = end_ms < 0
+            ? "DELETE FROM segments WHERE session_id = ?"
+            : "DELETE FROM segments WHERE session_id = ? AND t0_ms >= ? AND t1_ms <= ?";
+        Statement stmt(db_, stmts_, sql);
+        if (!stmt.ok()) return false;
+        sqlite3_bind_text(stmt, 1, session_id.c_str(), -1, SQLITE_TRANSIENT);
+        if (end_ms >= 0) {
+            sqlite3_bind_int64(stmt, 2, begin_ms);
+            sqlite3_bind_int64(stmt, 3, end_ms);
+        }
+        if (sqlite3_step(stmt) != SQLITE_DONE) return false;
+    }
+    if (segments.empty()) return true;
+
+    // Chunk start times from the recorded durations, to file each segment
+    // under the chunk its start falls in.
+    std::vector<std::pair<int64_t, int32_t>> chunk_starts;   // (start_ms, chunk_index)
+    {
+        Statement stmt(db_, stmts_,
+            "SELECT chunk_index, duration_ms FROM chunks WHERE session_id = ? "
+            "ORDER BY chunk_index");
+        if (!stmt.ok()) return false;
+        sqlite3_bind_text(stmt, 1, session_id.c_str(), -1, SQLITE_TRANSIENT);
+        int64_t start = 0;
+        while (sqlite3_step(stmt) == SQLITE_ROW) {
+            chunk_starts.emplace_back(start, sqlite3_column_int(stmt, 0));
+            start += sqlite3_column_int64(stmt, 1);
+        }
+    }
+    auto chunk_for = [&chunk_starts](int64_t t_ms) -> int32_t {
+        auto it = std::upper_bound(chunk_starts.begin(), chunk_starts.end(),
+                                   std::make_pair(t_ms, INT32_MAX));
+        return it == chunk_starts.begin() ? 0 : std::prev(it)->second;
+    };
+
+    Statement stmt(db_, stmts_,
+        "INSERT INTO segments (session_id, chunk_index, t0_ms, t1_ms, text, avg_prob) "
+        "VALUES (?, ?, ?, ?, ?, ?)");
+    if (!stmt.ok()) return false;
+    for (const TranscriptSegment& seg : segments) {
+        sqlite3_bind_text(stmt, 1, session_id.c_str(), -1, SQLITE_TRANSIENT);
+        sqlite3_bind_int(stmt, 2, chunk_for(seg.t0_ms));
+        sqlite3_bind_int64(stmt, 3, seg.t0_ms);
+        sqlite3_bind_int64(stmt, 4, seg.t1_ms);
+        sqlite3_bind_text(stmt, 5, seg.text.c_str(), -1, SQLITE_TRANSIENT);
+        sqlite3_bind_double(stmt, 6, seg.avg_prob);
+        if (sqlite3_step(stmt) != SQLITE_DONE) return false;
+        sqlite3_reset(stmt);
+    }
+    return true;
+}
+
+std::vector<TranscriptSegment> DatabaseManager::get_segments(
+    const std::string& session_id) const {
+    return query_segments(session_id, -1.0f);
+}
+
+std::vector<TranscriptSegment> DatabaseManager::get_low_confidence_segments(
+    const std::string& session_id, float threshold) const {
+    return query_segments(session_id, threshold);
+}
+
+std::vector<TranscriptSegment> DatabaseManager::query_segments(
+    const std::string& session_id, float below) const {
+    std::lock_guard<std::mutex> lock(read_mu_);
+    std::vector<TranscriptSegment> results;
+    if (!read_db_) return results;
+
+    const char* sql = below < 0.0f
+        ? "SELECT chunk_index, t0_ms, t1_ms, text, avg_prob FROM segments "
+          "WHERE session_id = ? ORDER BY t0_ms, id"
+        : "SELECT chunk_index, t0_ms, t1_ms, text, avg_prob FROM segments "
+          "WHERE session_id = ? AND avg_prob < ? ORDER BY t0_ms, id";
+    Statement stmt(read_db_, read_stmts_, sql);
+    if (!stmt.ok()) return results;
+
+    sqlite3_bind_text(stmt, 1, session_id.c_str(), -1, SQLITE_TRANSIENT);
+    if (below >= 0.0f) sqlite3_bind_double(stmt, 2, below);
+
+    while (sqlite3_step(stmt) == SQLITE_ROW) {
+        TranscriptSegment seg;
+        seg.chunk_index = sqlite3_column_int(stmt, 0);
+        seg.t0_ms       = sqlite3_column_int64(stmt, 1);
+        seg.t1_ms       = sqlite3_column_int64(stmt, 2);
+        const char* t   = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 3));
+        seg.text        = t ? t : "";
+        seg.avg_prob    = static_cast<float>(sqlite3_column_double(stmt, 4));
+        results.push_back(std::move(seg));
+    }
+
+    return results;
+}
+
 // ---------------------------------------------------------------------------
 // Chunk operations
 // ---------------------------------------------------------------------------
 
+void DatabaseManager::set_storage_codec(ChunkCodec codec) {
+    std::lock_guard<std::mutex> lock(mu_);
+    storage_codec_ = codec;
+}
+
+ChunkCodec DatabaseManager::storage_codec() const {
+    std::lock_guard<std::mutex> lock(mu_);
+    return storage_codec_;
+}
+
 bool DatabaseManager::add_chunk(const std::string& session_id,
                                 int chunk_index,
                                 const std::vector<uint8_t>& audio_data,
                                 int64_t duration_ms) {
+    WriteOp op = encode_chunk(session_id, chunk_index,
+                              audio_data.data(), audio_data.size(), duration_ms);
+    return insert_chunk(session_id, chunk_index, op.data.data(), op.data.size(),
+                        duration_ms, op.codec, op.pcm_bytes, op.waveform);
+}
+
+WriteOp DatabaseManager::encode_chunk(const std::string& session_id,
+                                      int chunk_index,
+                                      const uint8_t* pcm, size_t size,
+                                      int64_t duration_ms) const {
+    WriteOp op;
+    op.kind        = WriteOp::Kind::add_chunk;
+    op.session_id  = session_id;
+    op.chunk_index = chunk_index;
+    op.duration_ms = duration_ms;
+    op.pcm_bytes   = static_cast<int64_t>(size);
+    op.waveform    = build_waveform_pyramid(reinterpret_cast<const float*>(pcm),
+                                            size / sizeof(float));
+
+    // Encode outside the lock — FLAC on a 35 s chunk takes a few ms and
+    // must not stall readers.
+    const ChunkCodec codec = storage_codec();
+    if (codec != ChunkCodec::pcm_f32) {
+        try {
+            op.data = AudioCodec::encode(reinterpret_cast<const float*>(pcm),
+                                         size / sizeof(float), codec);
+            op.codec = codec;
+            return op;
+        } catch (const std::exception& e) {
+            fprintf(stderr, "[DatabaseManager] %s encode failed for chunk %d, storing raw PCM: %s\n",
+                    codec_to_string(codec), chunk_index, e.what());
+        }
+    }
+
+    op.data.assign(pcm, pcm + size);
+    op.codec = ChunkCodec::pcm_f32;
+    return op;
+}
+
+bool DatabaseManager::add_chunk(const std::string& session_id,
+                                int chunk_index,
+                                const std::vector<uint8_t>& encoded_data,
+                                int64_t duration_ms,
+                                ChunkCodec codec) {
+    const int64_t pcm_bytes = codec == ChunkCodec::pcm_f32
+                                  ? static_cast<int64_t>(encoded_data.size()) : -1;
+
+    // A chunk without a waveform still gets stored; its thumbnail is just
+    // missing until backfilled.
+    WaveformPyramid waveform;
+    try {
+        if (codec == ChunkCodec::pcm_f32) {
+            waveform = build_waveform_pyramid(
+                reinterpret_cast<const float*>(encoded_data.data()),
+                encoded_data.size() / sizeof(float));
+        } else {
+            const std::vector<float> pcm =
+                AudioCodec::decode(encoded_data.data(), encoded_data.size(), codec);
+            waveform = build_waveform_pyramid(pcm.data(), pcm.size());
+        }
+    } catch (const std::exception& e) {
+        fprintf(stderr, "[DatabaseManager] no waveform for chunk %d: %s\n",
+                chunk_index, e.what());
+    }
+
+    return insert_chunk(session_id, chunk_index,
+                        encoded_data.data(), encoded_data.size(),
+                        duration_ms, codec, pcm_bytes, waveform);
+}
+
+bool DatabaseManager::insert_chunk(const std::string& session_id,
+                                   int chunk_index,
+                                   const uint8_t* data, size_t size,
+                                   int64_t duration_ms,
+                                   ChunkCodec codec,
+                                   int64_t pcm_bytes,
+                                   const WaveformPyramid& waveform) {
+    StageSpan span(Stage::chunk_persist);
     std::lock_guard<std::mutex> lock(mu_);
     if (!db_) return false;
 
     Transaction txn(db_);
+    if (!insert_chunk_locked(session_id, chunk_index, data, size,
+                             duration_ms, codec, pcm_bytes)) {
+        return false;
+    }
+    insert_waveform_or_log_locked(session_id, chunk_index, waveform);
 
+    txn.commit();
+    return true;
+}
+
+bool DatabaseManager::insert_chunk_locked(const std::string& session_id,
+                                          int chunk_index,
+                                          const uint8_t* data, size_t size,
+                                          int64_t duration_ms,
+                                          ChunkCodec codec,
+                                          int64_t pcm_bytes) {
     const char* sql =
-        "INSERT INTO chunks (session_id, chunk_index, audio_blob, duration_ms, created_at) "
-        "VALUES (?, ?, ?, ?, ?)";
-    Statement stmt(db_, sql);
+        "INSERT INTO chunks (session_id, chunk_index, audio_blob, duration_ms, "
+        "created_at, codec, pcm_bytes) VALUES (?, ?, ?, ?, ?, ?, ?)";
+    Statement stmt(db_, stmts_, sql);
     if (!stmt.ok()) return false;
 
     sqlite3_bind_text(stmt, 1, session_id.c_str(), -1, SQLITE_TRANSIENT);
     sqlite3_bind_int(stmt, 2, chunk_index);
-    sqlite3_bind_blob(stmt, 3, audio_data.data(),
-                      static_cast<int>(audio_data.size()), SQLITE_TRANSIENT);
+    sqlite3_bind_blob(stmt, 3, data, static_cast<int>(size), SQLITE_TRANSIENT);
     sqlite3_bind_int64(stmt, 4, duration_ms);
     sqlite3_bind_int64(stmt, 5, now_unix());
+    sqlite3_bind_text(stmt, 6, codec_to_string(codec), -1, SQLITE_STATIC);
+    if (pcm_bytes >= 0) {
+        sqlite3_bind_int64(stmt, 7, pcm_bytes);
+    } else {
+        sqlite3_bind_null(stmt, 7);
+    }
 
-    int rc = sqlite3_step(stmt);
-    if (rc != SQLITE_DONE) return false;
+    return sqlite3_step(stmt) == SQLITE_DONE;
+}
 
-    txn.commit();
+bool DatabaseManager::insert_waveform_locked(const std::string& session_id,
+                                             int chunk_index,
+                                             const WaveformPyramid& waveform) {
+    if (waveform.empty()) return true;
+
+    Statement stmt(db_, stmts_,
+        "INSERT OR REPLACE INTO waveforms (session_id, level, chunk_index, bins) "
+        "VALUES (?, ?, ?, ?)");
+    if (!stmt.ok()) return false;
+
+    for (size_t level = 0; level < kWaveformLevels; ++level) {
+        const std::vector<uint8_t> bins = pack_waveform_bins(waveform.levels[level]);
+        sqlite3_reset(stmt);
+        sqlite3_bind_text(stmt, 1, session_id.c_str(), -1, SQLITE_TRANSIENT);
+        sqlite3_bind_int(stmt, 2, static_cast<int>(level));
+        sqlite3_bind_int(stmt, 3, chunk_index);
+        sqlite3_bind_blob(stmt, 4, bins.data(), static_cast<int>(bins.size()),
+                          SQLITE_TRANSIENT);
+        if (sqlite3_step(stmt) != SQLITE_DONE) return false;
+    }
     return true;
 }
 
+void DatabaseManager::insert_waveform_or_log_locked(const std::string& session_id,
+                                                    int chunk_index,
+                                                    const WaveformPyramid& waveform) {
+    if (waveform.empty()) return;
+
+    // A savepoint, so a failure part way through drops only the waveform
+    // rows and the enclosing transaction still commits the chunk.
+    sqlite3_exec(db_, "SAVEPOINT waveform", nullptr, nullptr, nullptr);
+    if (!insert_waveform_locked(session_id, chunk_index, waveform)) {
+        fprintf(stderr, "[DatabaseManager] no waveform stored for chunk %d: %s\n",
+                chunk_index, sqlite3_errmsg(db_));
+        sqlite3_exec(db_, "ROLLBACK TO waveform", nullptr, nullptr, nullptr);
+    }
+    sqlite3_exec(db_, "RELEASE waveform", nullptr, nullptr, nullptr);
+}
+
 std::vector<AudioChunk> DatabaseManager::get_chunks(
     const std::string& session_id) const {
-    std::lock_guard<std::mutex> lock(mu_);
+    std::lock_guard<std::mutex> lock(read_mu_);
     std::vector<AudioChunk> results;
-    if (!db_) return results;
+    if (!read_db_) return results;
 
     const char* sql =
-        "SELECT session_id, chunk_index, audio_blob, duration_ms "
+        "SELECT session_id, chunk_index, audio_blob, duration_ms, transcript, codec "
         "FROM chunks WHERE session_id = ? ORDER BY chunk_index ASC";
-    Statement stmt(db_, sql);
+    Statement stmt(read_db_, read_stmts_, sql);
     if (!stmt.ok()) return results;
 
     sqlite3_bind_text(stmt, 1, session_id.c_str(), -1, SQLITE_TRANSIENT);
 
-    while (sqlite3_step(stmt) == SQLITE_ROW) {
+    std::vector<float> pcm;   // decoded PCM, reused across rows
+
+    // blob_read covers stepping to the row and pulling its columns (the
+    // blob's overflow pages load on sqlite3_column_blob), not the decode.
+    for (uint64_t read_start = stage_clock_ns();
+         sqlite3_step(stmt) == SQLITE_ROW;
+         read_start = stage_clock_ns()) {
         AudioChunk c;
         c.session_id  = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 0));
         c.chunk_index = sqlite3_column_int(stmt, 1);
 
+        const char* codec_str = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 5));
+        const ChunkCodec codec = codec_from_string(codec_str ? codec_str : "");
+
         const void* blob = sqlite3_column_blob(stmt, 2);
         int blob_size    = sqlite3_column_bytes(stmt, 2);
+        record_stage(Stage::blob_read, stage_clock_ns() - read_start);
         if (blob && blob_size > 0) {
             const auto* data = static_cast<const uint8_t*>(blob);
-            c.audio_data.assign(data, data + blob_size);
+            if (codec == ChunkCodec::pcm_f32) {
+                c.audio_data.assign(data, data + blob_size);
+            } else {
+                try {
+                    AudioCodec::decode(data, static_cast<size_t>(blob_size), codec, pcm);
+                    const auto* bytes = reinterpret_cast<const uint8_t*>(pcm.data());
+                    c.audio_data.assign(bytes, bytes + pcm.size() * sizeof(float));
+                } catch (const std::exception& e) {
+                    fprintf(stderr, "[DatabaseManager] decode failed for chunk %d of %s: %s\n",
+                            c.chunk_index, session_id.c_str(), e.what());
+                    continue;
+                }
+            }
         }
 
         c.duration_ms = sqlite3_column_type(stmt, 3) == SQLITE_NULL
                             ? 0 : sqlite3_column_int64(stmt, 3);
+        const char* t = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 4));
+        c.transcript  = t ? t : "";
+        c.codec       = ChunkCodec::pcm_f32;
         results.push_back(std::move(c));
     }
 
     return results;
 }
 
+bool DatabaseManager::for_each_chunk(const std::string& session_id,
+                                     const ChunkVisitor& visit) const {
+    return visit_chunks(session_id, visit, /*decode=*/true);
+}
+
+bool DatabaseManager::for_each_stored_chunk(const std::string& session_id,
+                                            const ChunkVisitor& visit) const {
+    return visit_chunks(session_id, visit, /*decode=*/false);
+}
+
+bool DatabaseManager::visit_chunks(const std::string& session_id,
+                                   const ChunkVisitor& visit,
+                                   bool decode) const {
+    std::lock_guard<std::mutex> lock(read_mu_);
+    if (!read_db_) return false;
+
+    const char* sql =
+        "SELECT chunk_index, audio_blob, duration_ms, codec "
+        "FROM chunks WHERE session_id = ? ORDER BY chunk_index ASC";
+    Statement stmt(read_db_, read_stmts_, sql);
+    if (!stmt.ok()) return false;
+
+    sqlite3_bind_text(stmt, 1, session_id.c_str(), -1, SQLITE_TRANSIENT);
+
+    std::vector<float> scratch;   // decoded PCM, reused across rows
+
+    int rc;
+    for (uint64_t read_start = stage_clock_ns();
+         (rc = sqlite3_step(stmt)) == SQLITE_ROW;
+         read_start = stage_clock_ns()) {
+        ChunkView view;
+        view.chunk_index = sqlite3_column_int(stmt, 0);
+        view.data        = static_cast<const uint8_t*>(sqlite3_column_blob(stmt, 1));
+        view.size        = static_cast<size_t>(sqlite3_column_bytes(stmt, 1));
+        view.duration_ms = sqlite3_column_type(stmt, 2) == SQLITE_NULL
+                               ? 0 : sqlite3_column_int64(stmt, 2);
+        const char* codec_str = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 3));
+        view.codec       = codec_from_string(codec_str ? codec_str : "");
+        if (!view.data) view.size = 0;
+        record_stage(Stage::blob_read, stage_clock_ns() - read_start);
+
+        if (decode && view.codec != ChunkCodec::pcm_f32 && view.size > 0) {
+            try {
+                AudioCodec::decode(view.data, view.size, view.codec, scratch);
+            } catch (const std::exception& e) {
+                fprintf(stderr, "[DatabaseManager] decode failed for chunk %d of %s: %s\n",
+                        view.chunk_index, session_id.c_str(), e.what());
+                continue;
+            }
+            view.data  = reinterpret_cast<const uint8_t*>(scratch.data());
+            view.size  = scratch.size() * sizeof(float);
+            view.codec = ChunkCodec::pcm_f32;
+        }
+
+        if (!visit(view)) return true;
+    }
+
+    return rc == SQLITE_DONE;
+}
+
+std::vector<ChunkSpan> DatabaseManager::get_chunk_spans(
+    const std::string& session_id) const {
+    std::lock_guard<std::mutex> lock(read_mu_);
+    std::vector<ChunkSpan> spans;
+    if (!read_db_) return spans;
+
+    // 16 kHz mono float32 is 64 bytes per millisecond.
+    const char* sql =
+        "SELECT chunk_index, COALESCE(NULLIF(duration_ms, 0), pcm_bytes / 64, 0) "
+        "FROM chunks WHERE session_id = ? ORDER BY chunk_index ASC";
+    Statement stmt(read_db_, read_stmts_, sql);
+    if (!stmt.ok()) return spans;
+
+    sqlite3_bind_text(stmt, 1, session_id.c_str(), -1, SQLITE_TRANSIENT);
+
+    int64_t start = 0;
+    while (sqlite3_step(stmt) == SQLITE_ROW) {
+        ChunkSpan span;
+        span.chunk_index = sqlite3_column_int(stmt, 0);
+        span.begin_ms    = start;
+        span.end_ms      = start + sqlite3_column_int64(stmt, 1);
+        start = span.end_ms;
+        spans.push_back(span);
+    }
+    return spans;
+}
+
+std::vector<float> DatabaseManager::get_chunk_audio(const std::string& session_id,
+                                                    int chunk_index) const {
+    std::lock_guard<std::mutex> lock(read_mu_);
+    std::vector<float> pcm;
+    if (!read_db_) return pcm;
+
+    const char* sql =
+        "SELECT audio_blob, codec FROM chunks WHERE session_id = ? AND chunk_index = ?";
+    Statement stmt(read_db_, read_stmts_, sql);
+    if (!stmt.ok()) return pcm;
+
+    sqlite3_bind_text(stmt, 1, session_id.c_str(), -1, SQLITE_TRANSIENT);
+    sqlite3_bind_int(stmt, 2, chunk_index);
+
+    const uint64_t read_start = stage_clock_ns();
+    if (sqlite3_step(stmt) != SQLITE_ROW) return pcm;
+    const auto* data = static_cast<const uint8_t*>(sqlite3_column_blob(stmt, 0));
+    const size_t size = static_cast<size_t>(sqlite3_column_bytes(stmt, 0));
+    const char* codec_str = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 1));
+    const ChunkCodec codec = codec_from_string(codec_str ? codec_str : "");
+    record_stage(Stage::blob_read, stage_clock_ns() - read_start);
+    if (!data || size == 0) return pcm;
+
+    try {
+        pcm = AudioCodec::decode(data, size, codec);
+    } catch (const std::exception& e) {
+        fprintf(stderr, "[DatabaseManager] decode failed for chunk %d of %s: %s\n",
+                chunk_index, session_id.c_str(), e.what());
+        pcm.clear();
+    }
+    return pcm;
+}
+
+int64_t DatabaseManager::get_audio_size(const std::string& session_id) const {
+    std::lock_guard<std::mutex> lock(read_mu_);
+    if (!read_db_) return 0;
+
+    // pcm_bytes is recorded at insert time; length() on a BLOB reads the
+    // size from the record header without loading overflow pages.
+    const char* sql =
+        "SELECT COALESCE(SUM(COALESCE(pcm_bytes, length(audio_blob))), 0) "
+        "FROM chunks WHERE session_id = ?";
+    Statement stmt(read_db_, read_stmts_, sql);
+    if (!stmt.ok()) return 0;
+
+    sqlite3_bind_text(stmt, 1, session_id.c_str(), -1, SQLITE_TRANSIENT);
+
+    if (sqlite3_step(stmt) != SQLITE_ROW) return 0;
+    return sqlite3_column_int64(stmt, 0);
+}
+
+bool DatabaseManager::update_chunk_transcript(const std::string& session_id,
+                                              int chunk_index,
+                                              const std::string& transcript) {
+    std::lock_guard<std::mutex> lock(mu_);
+    if (!db_) return false;
+    return update_chunk_transcript_locked(session_id, chunk_index, transcript);
+}
+
+bool DatabaseManager::update_chunk_transcript_locked(const std::string& session_id,
+                                                     int chunk_index,
+                                                     const std::string& transcript) {
+    const char* sql =
+        "UPDATE chunks SET transcript = ? WHERE session_id = ? AND chunk_index = ?";
+    Statement stmt(db_, stmts_, sql);
+    if (!stmt.ok()) return false;
+
+    sqlite3_bind_text(stmt, 1, transcript.c_str(), -1, SQLITE_TRANSIENT);
+    sqlite3_bind_text(stmt, 2, session_id.c_str(), -1, SQLITE_TRANSIENT);
+    sqlite3_bind_int(stmt, 3, chunk_index);
+
+    return sqlite3_step(stmt) == SQLITE_DONE;
+}
+
+// ---------------------------------------------------------------------------
+// Archives
+// ---------------------------------------------------------------------------
+
+std::string DatabaseManager::get_archive_path(const std::string& session_id) const {
+    std::lock_guard<std::mutex> lock(read_mu_);
+    if (!read_db_) return "";
+
+    Statement stmt(read_db_, read_stmts_, "SELECT archive_path FROM sessions WHERE id = ?");
+    if (!stmt.ok()) return "";
+
+    sqlite3_bind_text(stmt, 1, session_id.c_str(), -1, SQLITE_TRANSIENT);
+
+    if (sqlite3_step(stmt) != SQLITE_ROW) return "";
+    const char* path = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 0));
+    return path ? path : "";
+}
+
+bool DatabaseManager::attach_archive(const std::string& session_id,
+                                     const std::string& archive_path) {
+    std::lock_guard<std::mutex> lock(mu_);
+    if (!db_ || archive_path.empty()) return false;
+
+    Transaction txn(db_);
+    {
+        Statement stmt(db_, stmts_, "UPDATE sessions SET archive_path = ? WHERE id = ?");
+        if (!stmt.ok()) return false;
+        sqlite3_bind_text(stmt, 1, archive_path.c_str(), -1, SQLITE_TRANSIENT);
+        sqlite3_bind_text(stmt, 2, session_id.c_str(), -1, SQLITE_TRANSIENT);
+        if (sqlite3_step(stmt) != SQLITE_DONE || sqlite3_changes(db_) == 0) return false;
+    }
+    {
+        // Keep the decoded size (rows without one get their blob length,
+        // as get_audio_size() would have estimated) before emptying the blob.
+        Statement stmt(db_, stmts_,
+            "UPDATE chunks SET pcm_bytes = COALESCE(pcm_bytes, length(audio_blob)), "
+            "audio_blob = zeroblob(0) WHERE session_id = ?");
+        if (!stmt.ok()) return false;
+        sqlite3_bind_text(stmt, 1, session_id.c_str(), -1, SQLITE_TRANSIENT);
+        if (sqlite3_step(stmt) != SQLITE_DONE) return false;
+    }
+
+    txn.commit();
+    return true;
+}
+
+std::vector<std::string> DatabaseManager::get_unarchived_sessions() const {
+    std::lock_guard<std::mutex> lock(read_mu_);
+    std::vector<std::string> ids;
+    if (!read_db_) return ids;
+
+    Statement stmt(read_db_, read_stmts_,
+        "SELECT id FROM sessions WHERE status = 'complete' AND archive_path IS NULL "
+        "ORDER BY created_at ASC");
+    if (!stmt.ok()) return ids;
+
+    while (sqlite3_step(stmt) == SQLITE_ROW) {
+        ids.emplace_back(reinterpret_cast<const char*>(sqlite3_column_text(stmt, 0)));
+    }
+    return ids;
+}
+
+std::string DatabaseManager::import_session(const RecordingSession& session,
+                                            const std::vector<ChunkSpan>& chunks,
+                                            const std::vector<TranscriptSegment>& segments,
+                                            const std::string& archive_path) {
+    std::lock_guard<std::mutex> lock(mu_);
+    if (!db_ || archive_path.empty()) return "";
+
+    Transaction txn(db_);
+
+    // Re-importing onto the machine it came from keeps both copies.
+    std::string id = session.id;
+    if (!id.empty()) {
+        Statement stmt(db_, stmts_, "SELECT 1 FROM sessions WHERE id = ?");
+        if (!stmt.ok()) return "";
+        sqlite3_bind_text(stmt, 1, id.c_str(), -1, SQLITE_TRANSIENT);
+        if (sqlite3_step(stmt) == SQLITE_ROW) id.clear();
+    }
+    if (id.empty()) id = generate_uuid();
+
+    {
+        const char* sql =
+            "INSERT INTO sessions (id, created_at, completed_at, status, duration_ms, "
+            "transcript, preview, transcript_version, archive_path) "
+            "VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?)";
+        Statement stmt(db_, stmts_, sql);
+        if (!stmt.ok()) return "";
+
+        const std::string preview = make_preview(session.transcript);
+        sqlite3_bind_text(stmt, 1, id.c_str(), -1, SQLITE_TRANSIENT);
+        sqlite3_bind_int64(stmt, 2, session.created_at);
+        if (session.completed_at > 0) {
+            sqlite3_bind_int64(stmt, 3, session.completed_at);
+        } else {
+            sqlite3_bind_null(stmt, 3);
+        }
+        sqlite3_bind_text(stmt, 4, status_to_string(session.status), -1, SQLITE_STATIC);
+        sqlite3_bind_int64(stmt, 5, session.duration_ms);
+        if (!session.transcript.empty()) {
+            sqlite3_bind_text(stmt, 6, session.transcript.c_str(), -1, SQLITE_TRANSIENT);
+            sqlite3_bind_text(stmt, 7, preview.c_str(), -1, SQLITE_TRANSIENT);
+        } else {
+            sqlite3_bind_null(stmt, 6);
+            sqlite3_bind_null(stmt, 7);
+        }
+        sqlite3_bind_int(stmt, 8, static_cast<int>(session.transcript_version));
+        sqlite3_bind_text(stmt, 9, archive_path.c_str(), -1, SQLITE_TRANSIENT);
+        if (sqlite3_step(stmt) != SQLITE_DONE) return "";
+    }
+
+    // Blob-less chunk rows (audio_blob is NOT NULL, so bind an empty blob).
+    // 16 kHz mono float32 is 64 bytes per millisecond.
+    static const uint8_t kEmpty = 0;
+    for (const ChunkSpan& span : chunks) {
+        const int64_t duration_ms = span.end_ms - span.begin_ms;
+        if (!insert_chunk_locked(id, span.chunk_index, &kEmpty, 0, duration_ms,
+                                 ChunkCodec::pcm_f32, duration_ms * 64)) {
+            return "";
+        }
+    }
+    if (!write_segments_locked(id, 0, -1, segments)) return "";
+
+    txn.commit();
+    return id;
+}
+
+bool DatabaseManager::vacuum() {
+    std::lock_guard<std::mutex> lock(mu_);
+    if (!db_) return false;
+
+    char* err = nullptr;
+    if (sqlite3_exec(db_, "VACUUM", nullptr, nullptr, &err) != SQLITE_OK) {
+        fprintf(stderr, "[DatabaseManager] VACUUM failed: %s\n", err ? err : "unknown");
+        if (err) sqlite3_free(err);
+        return false;
+    }
+
+    // VACUUM may renumber the sessions rowids the FTS index is keyed by.
+    // Fails harmlessly if SQLite was built without FTS5.
+    sqlite3_exec(db_, "INSERT INTO sessions_fts(sessions_fts) VALUES ('rebuild')",
+                 nullptr, nullptr, nullptr);
+    run_checkpoint();
+    return true;
+}
+
+// ---------------------------------------------------------------------------
+// Waveforms
+// ---------------------------------------------------------------------------
+
+std::vector<WaveformBin> DatabaseManager::get_waveform_overview(
+    const std::string& session_id, size_t pixels) const {
+    std::vector<WaveformBin> overview;
+    if (pixels == 0) return overview;
+
+    // Chunk start times from the recorded durations, as for playback.
+    const std::vector<ChunkSpan> spans = get_chunk_spans(session_id);
+    if (spans.empty() || spans.back().end_ms <= 0) return overview;
+    const int64_t total_ms = spans.back().end_ms;
+
+    std::unordered_map<int, int64_t> begin_ms;
+    for (const ChunkSpan& span : spans) begin_ms[span.chunk_index] = span.begin_ms;
+
+    // One column per finest bin at most; beyond that columns would be empty.
+    const int64_t finest = (total_ms + kWaveformBinMs[0] - 1) / kWaveformBinMs[0];
+    pixels = std::min(pixels, static_cast<size_t>(finest));
+    const size_t level = waveform_level_for(total_ms, pixels);
+
+    std::lock_guard<std::mutex> lock(read_mu_);
+    if (!read_db_) return overview;
+
+    Statement stmt(read_db_, read_stmts_,
+        "SELECT chunk_index, bins FROM waveforms "
+        "WHERE session_id = ? AND level = ? ORDER BY chunk_index ASC");
+    if (!stmt.ok()) return overview;
+
+    sqlite3_bind_text(stmt, 1, session_id.c_str(), -1, SQLITE_TRANSIENT);
+    sqlite3_bind_int(stmt, 2, static_cast<int>(level));
+
+    WaveformOverview builder(total_ms, pixels);
+    bool any = false;
+    while (sqlite3_step(stmt) == SQLITE_ROW) {
+        const auto it = begin_ms.find(sqlite3_column_int(stmt, 0));
+        if (it == begin_ms.end()) continue;
+        builder.add(it->second, kWaveformBinMs[level],
+                    static_cast<const uint8_t*>(sqlite3_column_blob(stmt, 1)),
+                    static_cast<size_t>(sqlite3_column_bytes(stmt, 1)));
+        any = true;
+    }
+    if (any) overview = builder.finish();
+    return overview;
+}
+
+bool DatabaseManager::store_waveform(const std::string& session_id, int chunk_index,
+                                     const WaveformPyramid& waveform) {
+    std::lock_guard<std::mutex> lock(mu_);
+    if (!db_) return false;
+
+    Transaction txn(db_);
+    if (!insert_waveform_locked(session_id, chunk_index, waveform)) return false;
+
+    txn.commit();
+    return true;
+}
+
+std::vector<std::string> DatabaseManager::get_sessions_without_waveform() const {
+    std::lock_guard<std::mutex> lock(read_mu_);
+    std::vector<std::string> ids;
+    if (!read_db_) return ids;
+
+    Statement stmt(read_db_, read_stmts_,
+        "SELECT id FROM sessions s WHERE status != 'recording' "
+        "AND EXISTS (SELECT 1 FROM chunks c WHERE c.session_id = s.id "
+        "AND NOT EXISTS (SELECT 1 FROM waveforms w WHERE w.session_id = s.id "
+        "AND w.level = 0 AND w.chunk_index = c.chunk_index)) "
+        "ORDER BY created_at ASC");
+    if (!stmt.ok()) return ids;
+
+    while (sqlite3_step(stmt) == SQLITE_ROW) {
+        ids.emplace_back(reinterpret_cast<const char*>(sqlite3_column_text(stmt, 0)));
+    }
+    return ids;
+}
+
+// ---------------------------------------------------------------------------
+// Transcript cache
+// ---------------------------------------------------------------------------
+
+bool DatabaseManager::get_cached_transcript(const std::string& key,
+                                            std::vector<uint8_t>& entry) const {
+    std::lock_guard<std::mutex> lock(read_mu_);
+    if (!read_db_) return false;
+
+    Statement stmt(read_db_, read_stmts_,
+        "SELECT entry FROM transcript_cache WHERE cache_key = ?");
+    if (!stmt.ok()) return false;
+
+    sqlite3_bind_text(stmt, 1, key.c_str(), -1, SQLITE_TRANSIENT);
+    if (sqlite3_step(stmt) != SQLITE_ROW) return false;
+
+    const auto* blob = static_cast<const uint8_t*>(sqlite3_column_blob(stmt, 0));
+    entry.assign(blob, blob + sqlite3_column_bytes(stmt, 0));
+    return true;
+}
+
+bool DatabaseManager::put_cached_transcript(const std::string& key,
+                                            const std::string& session_id,
+                                            const std::vector<uint8_t>& entry) {
+    std::lock_guard<std::mutex> lock(mu_);
+    if (!db_) return false;
+
+    Transaction txn(db_);
+    {
+        Statement stmt(db_, stmts_,
+            "INSERT OR REPLACE INTO transcript_cache (cache_key, session_id, entry, created_at) "
+            "VALUES (?, ?, ?, ?)");
+        if (!stmt.ok()) return false;
+        sqlite3_bind_text(stmt, 1, key.c_str(), -1, SQLITE_TRANSIENT);
+        if (session_id.empty()) {
+            sqlite3_bind_null(stmt, 2);
+        } else {
+            sqlite3_bind_text(stmt, 2, session_id.c_str(), -1, SQLITE_TRANSIENT);
+        }
+        sqlite3_bind_blob(stmt, 3, entry.data(), static_cast<int>(entry.size()), SQLITE_TRANSIENT);
+        sqlite3_bind_int64(stmt, 4, now_unix());
+        if (sqlite3_step(stmt) != SQLITE_DONE) return false;
+    }
+    {
+        // Oldest entries beyond the cap go; cheap through the created_at index.
+        Statement stmt(db_, stmts_,
+            "DELETE FROM transcript_cache WHERE cache_key IN ("
+            "SELECT cache_key FROM transcript_cache "
+            "ORDER BY created_at DESC LIMIT -1 OFFSET ?)");
+        if (!stmt.ok()) return false;
+        sqlite3_bind_int(stmt, 1, kTranscriptCacheEntries);
+        if (sqlite3_step(stmt) != SQLITE_DONE) return false;
+    }
+
+    txn.commit();
+    return true;
+}
+
+// ---------------------------------------------------------------------------
+// Batched writes
+// ---------------------------------------------------------------------------
+
+bool DatabaseManager::apply_batch(const std::vector<WriteOp>& ops) {
+    if (ops.empty()) return true;
+
+    StageSpan span(Stage::chunk_persist);
+    std::lock_guard<std::mutex> lock(mu_);
+    if (!db_) return false;
+
+    // One transaction (one WAL commit) for the whole batch.
+    Transaction txn(db_);
+    for (const auto& op : ops) {
+        if (!apply_locked(op)) return false;   // rolls back the batch
+    }
+
+    txn.commit();
+    return true;
+}
+
+bool DatabaseManager::apply_locked(const WriteOp& op) {
+    switch (op.kind) {
+    case WriteOp::Kind::add_chunk:
+        if (!insert_chunk_locked(op.session_id, op.chunk_index,
+                                 op.data.data(), op.data.size(),
+                                 op.duration_ms, op.codec, op.pcm_bytes)) {
+            return false;
+        }
+        insert_waveform_or_log_locked(op.session_id, op.chunk_index, op.waveform);
+        return true;
+    case WriteOp::Kind::chunk_transcript:
+        return update_chunk_transcript_locked(op.session_id, op.chunk_index, op.text);
+    case WriteOp::Kind::duration:
+        return update_duration_locked(op.session_id, op.duration_ms);
+    case WriteOp::Kind::status:
+        return update_status_locked(op.session_id, op.status);
+    }
+    return false;
+}
+
 // ---------------------------------------------------------------------------
 // Utility
 // ---------------------------------------------------------------------------
@@ -499,6 +1740,39 @@ std::string DatabaseManager::generate_uuid() {
     return uuid;
 }
 
+std::string DatabaseManager::to_match_expression(const std::string& query) {
+    std::string expr;
+    std::istringstream words(query);
+    std::string word;
+    while (words >> word) {
+        if (!expr.empty()) expr += ' ';
+        expr += '"';
+        for (char c : word) {
+            if (c == '"') expr += '"';   // FTS5 escapes a quote by doubling it
+            expr += c;
+        }
+        expr += '"';
+    }
+    if (!expr.empty()) expr += '*';
+    return expr;
+}
+
+std::string DatabaseManager::make_preview(const std::string& transcript) {
+    size_t chars = 0;
+    size_t i = 0;
+    while (i < transcript.size() && chars < kPreviewChars) {
+        // Skip UTF-8 continuation bytes (10xxxxxx) so we only ever stop on
+        // a code point boundary.
+        ++i;
+        while (i < transcript.size() &&
+               (static_cast<unsigned char>(transcript[i]) & 0xC0) == 0x80) {
+            ++i;
+        }
+        ++chars;
+    }
+    return transcript.substr(0, i);
+}
+
 int64_t DatabaseManager::now_unix() {
     return static_cast<int64_t>(
         std::chrono::duration_cast<std::chrono::seconds>(
@@ -1,17 +1,41 @@
 #pragma once
 
 #include "Types.hpp"
+#include "WaveformPyramid.hpp"
+#include <chrono>
 #include <memory>
 #include <mutex>
 #include <optional>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 // Forward-declare sqlite3 so we don't leak its header into consumers.
 struct sqlite3;
+struct sqlite3_stmt;
 
 namespace vr {
 
+/// Prepared statements owned by one connection, keyed by SQL text.
+using StatementCache = std::unordered_map<std::string, sqlite3_stmt*>;
+
+/// One deferred write, applied with others in a single transaction by
+/// DatabaseManager::apply_batch() (see WriteQueue).
+struct WriteOp {
+    enum class Kind { add_chunk, chunk_transcript, duration, status };
+
+    Kind                 kind = Kind::add_chunk;
+    std::string          session_id;
+    int                  chunk_index = 0;                 // add_chunk, chunk_transcript
+    std::vector<uint8_t> data;                            // add_chunk: encoded bytes
+    ChunkCodec           codec = ChunkCodec::pcm_f32;     // add_chunk
+    int64_t              pcm_bytes = -1;                  // add_chunk: decoded size, <0 = unknown
+    WaveformPyramid      waveform;                        // add_chunk: overview bins, empty = none
+    int64_t              duration_ms = 0;                 // add_chunk, duration
+    RecordingStatus      status = RecordingStatus::recording;  // status
+    std::string          text;                            // chunk_transcript
+};
+
 /// Persistent storage for recording sessions and audio chunks.
 ///
 /// Database location:
@@ -19,6 +43,10 @@ namespace vr {
 ///
 /// Uses SQLite WAL mode for crash-safe writes.  All mutating operations
 /// are wrapped in explicit transactions.
+///
+/// Two connections are kept open: a writer (guarded by mu_) and a read-only
+/// reader (guarded by read_mu_), so chunk inserts during recording never
+/// block the history list.  Each connection caches its prepared statements.
 class DatabaseManager {
 public:
     /// Construct with an explicit database file path.
@@ -41,15 +69,24 @@ public:
     /// Whether the database is open.
     bool is_open() const;
 
+    /// Run a PASSIVE WAL checkpoint now (e.g. when a recording stops).
+    /// Checkpoints are otherwise scheduled after commits; see on_wal_commit.
+    bool checkpoint();
+
     // ---- Sessions ----
 
     /// Create a new recording session.  Returns the generated UUID.
     std::string create_session();
 
     /// Update the transcript for a session and mark it complete.
+    /// `duration_ms` <= 0 leaves the stored duration alone.  `version`
+    /// records which pass produced the text; a transcript is never replaced
+    /// by one of a lower version, so a refinement that lands first wins.
+    /// Returns true even if the guard skipped the row.
     bool update_transcript(const std::string& session_id,
                            const std::string& transcript,
-                           int64_t duration_ms);
+                           int64_t duration_ms,
+                           TranscriptVersion version = TranscriptVersion::draft);
 
     /// Mark a session as failed.
     bool mark_failed(const std::string& session_id);
@@ -66,27 +103,303 @@ public:
     /// Retrieve all sessions, most recent first.
     std::vector<RecordingSession> get_sessions() const;
 
+    /// One page of history rows, most recent first.  Reads only the
+    /// covering index on created_at, so cost is proportional to the page,
+    /// not to the size of the transcripts.
+    std::vector<SessionSummary> get_session_summaries(int offset, int limit) const;
+
+    /// Full transcript for one session, loaded on demand by the detail view.
+    /// nullopt if the session does not exist; empty if not yet transcribed.
+    std::optional<std::string> get_transcript(const std::string& session_id) const;
+
     /// Delete a session and all its chunks.
     bool delete_session(const std::string& session_id);
 
     /// Find sessions still in 'recording' status (crash recovery).
     std::vector<RecordingSession> get_orphaned_sessions() const;
 
+    /// Audio of an orphaned session already recovered, in ms from its start
+    /// (see save_recovered_range); 0 if recovery has not started.
+    int64_t get_recovery_progress(const std::string& session_id) const;
+
+    /// Crash-recovery checkpoint: replace the segments within [begin_ms,
+    /// end_ms] with `segments` and record end_ms as the recovery progress,
+    /// in one transaction.  The session stays orphaned (status and
+    /// transcript untouched) until update_transcript() completes it, so an
+    /// interrupted recovery resumes from the last saved range.
+    bool save_recovered_range(const std::string& session_id,
+                              int64_t begin_ms, int64_t end_ms,
+                              const std::vector<TranscriptSegment>& segments);
+
+    // ---- Search ----
+
+    /// Full-text search over transcripts, ranked by bm25.  `query` is plain
+    /// user text: each word must match, and the last word matches as a
+    /// prefix so results update while typing.  Served entirely from the
+    /// FTS5 index — only the `limit` hits are read back, each with a short
+    /// highlighted snippet.
+    std::vector<SearchHit> search(const std::string& query, int limit) const;
+
+    // ---- Segments ----
+
+    /// Replace every stored segment of a session (e.g. after a full
+    /// transcription).  Each segment is filed under the chunk containing
+    /// its start time, from the chunks' recorded durations.
+    bool replace_segments(const std::string& session_id,
+                          const std::vector<TranscriptSegment>& segments);
+
+    /// Partial re-transcription: replace the segments lying entirely within
+    /// [begin_ms, end_ms] with `segments`, then rebuild the session
+    /// transcript from all of its segments and store it as `version`
+    /// (subject to update_transcript()'s version guard).  One transaction.
+    bool replace_segments_in_range(const std::string& session_id,
+                                   int64_t begin_ms, int64_t end_ms,
+                                   const std::vector<TranscriptSegment>& segments,
+                                   TranscriptVersion version);
+
+    /// Segments of a session in time order.
+    std::vector<TranscriptSegment> get_segments(const std::string& session_id) const;
+
+    /// Segments whose average token probability is below `threshold`, in
+    /// time order — candidates for replace_segments_in_range().
+    std::vector<TranscriptSegment> get_low_confidence_segments(
+        const std::string& session_id, float threshold) const;
+
     // ---- Chunks ----
 
-    /// Append an audio chunk to a session.
+    /// Codec used for new chunks passed as raw PCM (default flac_s16).
+    void set_storage_codec(ChunkCodec codec);
+    ChunkCodec storage_codec() const;
+
+    /// Append an audio chunk to a session, with its waveform pyramid.
+    /// @param audio_data  Raw 16 kHz mono float32 PCM bytes.  Encoded with
+    ///                    storage_codec() before insert; if encoding fails
+    ///                    the raw PCM is stored instead so no audio is lost.
     bool add_chunk(const std::string& session_id,
                    int chunk_index,
                    const std::vector<uint8_t>& audio_data,
                    int64_t duration_ms);
 
+    /// Append a chunk that is already encoded as `codec` (stored verbatim).
+    /// It is decoded once to build the waveform pyramid.
+    bool add_chunk(const std::string& session_id,
+                   int chunk_index,
+                   const std::vector<uint8_t>& encoded_data,
+                   int64_t duration_ms,
+                   ChunkCodec codec);
+
     /// Retrieve all chunks for a session, ordered by chunk_index.
+    /// audio_data is always decoded float32 PCM (codec == pcm_f32).
     std::vector<AudioChunk> get_chunks(const std::string& session_id) const;
 
+    /// Stream a session's chunks to `visit` in chunk_index order as float32
+    /// PCM.  Raw pcm_f32 rows borrow SQLite's row buffer without copying;
+    /// compressed rows are decoded into a scratch buffer reused across rows.
+    /// Either way a ChunkView is only valid during the callback.  The
+    /// reader lock is held throughout, so the visitor must not call other
+    /// read methods on this DatabaseManager.  Returns false if the query
+    /// failed.
+    bool for_each_chunk(const std::string& session_id,
+                        const ChunkVisitor& visit) const;
+
+    /// Like for_each_chunk() but hands out the stored (possibly compressed)
+    /// bytes with their codec, for callers that decode off the DB thread.
+    bool for_each_stored_chunk(const std::string& session_id,
+                               const ChunkVisitor& visit) const;
+
+    /// Time span of every chunk of a session, in chunk_index order, from
+    /// the recorded durations (decoded size where none was recorded).
+    /// Reads no audio.
+    std::vector<ChunkSpan> get_chunk_spans(const std::string& session_id) const;
+
+    /// One chunk decoded to float32 PCM; empty if it does not exist or
+    /// fails to decode.
+    std::vector<float> get_chunk_audio(const std::string& session_id,
+                                       int chunk_index) const;
+
+    /// Total decoded PCM bytes for a session, so callers can size a single
+    /// destination buffer up front.  Rows without a recorded PCM size
+    /// (legacy m4a) contribute their blob length as an estimate.
+    int64_t get_audio_size(const std::string& session_id) const;
+
+    /// Store the partial transcript produced for one chunk while the
+    /// session is still recording (streaming transcription).
+    bool update_chunk_transcript(const std::string& session_id,
+                                 int chunk_index,
+                                 const std::string& transcript);
+
+    // ---- Archives ----
+    //
+    // A session's audio can move out of the database into a SessionArchive
+    // file.  Its chunk rows stay (index, duration, partial transcript) so
+    // spans and segment filing keep working, but their blobs are emptied;
+    // sessions.archive_path records where the audio went.
+
+    /// Archive location recorded for a session, as passed to
+    /// attach_archive(); empty if its audio is still in the database.
+    std::string get_archive_path(const std::string& session_id) const;
+
+    /// Record `archive_path` for the session and drop its chunk blobs, in
+    /// one transaction.  Call only once the archive is durably written.
+    /// The freed pages are reused by later chunks; vacuum() returns them
+    /// to the filesystem.
+    bool attach_archive(const std::string& session_id, const std::string& archive_path);
+
+    /// Completed sessions whose audio is still in the database, oldest first.
+    std::vector<std::string> get_unarchived_sessions() const;
+
+    /// Register an imported session whose audio lives at `archive_path`:
+    /// the session row (keeping `session.id` unless it is taken, in which
+    /// case a new id is generated), one blob-less row per chunk span, and
+    /// its segments, in one transaction.  Returns the session id, or empty
+    /// on failure.
+    std::string import_session(const RecordingSession& session,
+                               const std::vector<ChunkSpan>& chunks,
+                               const std::vector<TranscriptSegment>& segments,
+                               const std::string& archive_path);
+
+    /// Rebuild the database file without its free pages (after archiving
+    /// moved audio out), then re-sync the full-text index.  Blocks writers
+    /// for the duration; run it off the recording path.
+    bool vacuum();
+
+    // ---- Waveforms ----
+    //
+    // Every chunk's min/max/RMS pyramid (see WaveformPyramid) is stored
+    // next to it in the waveforms table, one small blob per chunk and
+    // level, and outlives the audio blob when the session is archived.
+
+    /// The session's waveform in `pixels` columns, read from the coarsest
+    /// level that still resolves that many, so a list thumbnail costs a few
+    /// hundred bytes whatever the recording's length.  Fewer columns for
+    /// sessions shorter than `pixels` finest bins; empty if the session has
+    /// no stored waveform (recorded before pyramids, until backfilled).
+    std::vector<WaveformBin> get_waveform_overview(const std::string& session_id,
+                                                   size_t pixels) const;
+
+    /// Store (or replace) one chunk's pyramid, e.g. when backfilling
+    /// sessions recorded before pyramids or imported from an archive.
+    bool store_waveform(const std::string& session_id, int chunk_index,
+                        const WaveformPyramid& waveform);
+
+    /// Sessions not still recording with a chunk that has no stored
+    /// waveform (none built yet, or its insert failed), oldest first.
+    std::vector<std::string> get_sessions_without_waveform() const;
+
+    // ---- Transcript cache ----
+    //
+    // Opaque TranscriptCache entries (packed segments) by content key, so a
+    // retried or recovered chunk whose audio, model and decode parameters
+    // are unchanged is not run through whisper again.
+
+    /// The entry stored under `key` into `entry`; false if there is none.
+    bool get_cached_transcript(const std::string& key, std::vector<uint8_t>& entry) const;
+
+    /// Store (or replace) the entry under `key`, remembering `session_id`
+    /// (may be empty) so delete_session() removes it, and drop the oldest
+    /// entries beyond kTranscriptCacheEntries.
+    bool put_cached_transcript(const std::string& key, const std::string& session_id,
+                               const std::vector<uint8_t>& entry);
+
+    /// Entries kept: one per 35 s chunk, so about 40 hours of audio in a
+    /// few MB.
+    static constexpr int kTranscriptCacheEntries = 4096;
+
+    // ---- Batched writes ----
+
+    /// Build an add_chunk WriteOp from raw float32 PCM, encoding it with
+    /// storage_codec() (raw PCM fallback, as add_chunk()) and computing its
+    /// waveform pyramid.  Does not touch the database, so it can run on any
+    /// thread.
+    WriteOp encode_chunk(const std::string& session_id,
+                         int chunk_index,
+                         const uint8_t* pcm, size_t size,
+                         int64_t duration_ms) const;
+
+    /// Apply `ops` in order inside one transaction.  All-or-nothing:
+    /// returns false and rolls back if any op fails.
+    bool apply_batch(const std::vector<WriteOp>& ops);
+
 private:
     /// Run the schema migration (CREATE TABLE IF NOT EXISTS ...).
     bool create_tables();
 
+    /// Insert one chunk row and its waveform (if any) in one transaction.
+    /// `pcm_bytes` < 0 stores NULL.
+    bool insert_chunk(const std::string& session_id,
+                      int chunk_index,
+                      const uint8_t* data, size_t size,
+                      int64_t duration_ms,
+                      ChunkCodec codec,
+                      int64_t pcm_bytes,
+                      const WaveformPyramid& waveform);
+
+    // Single-statement writers shared by the public methods and
+    // apply_batch().  Caller holds mu_ and owns the transaction.
+    bool insert_chunk_locked(const std::string& session_id,
+                             int chunk_index,
+                             const uint8_t* data, size_t size,
+                             int64_t duration_ms,
+                             ChunkCodec codec,
+                             int64_t pcm_bytes);
+    bool insert_waveform_locked(const std::string& session_id,
+                                int chunk_index,
+                                const WaveformPyramid& waveform);
+    /// insert_waveform_locked() alongside a chunk insert: a failure is
+    /// logged and undone, never fatal to the chunk (the thumbnail is
+    /// backfilled later).  Caller holds mu_ inside a transaction.
+    void insert_waveform_or_log_locked(const std::string& session_id,
+                                       int chunk_index,
+                                       const WaveformPyramid& waveform);
+    bool update_chunk_transcript_locked(const std::string& session_id,
+                                        int chunk_index,
+                                        const std::string& transcript);
+    bool update_duration_locked(const std::string& session_id, int64_t duration_ms);
+    bool update_status_locked(const std::string& session_id, RecordingStatus status);
+    bool update_transcript_locked(const std::string& session_id,
+                                  const std::string& transcript,
+                                  int64_t duration_ms,
+                                  TranscriptVersion version);
+
+    /// Delete segments of `session_id` within [begin_ms, end_ms] (all of
+    /// them if end_ms < 0) and insert `segments`.  Caller holds mu_ and
+    /// owns the transaction.
+    bool write_segments_locked(const std::string& session_id,
+                               int64_t begin_ms, int64_t end_ms,
+                               const std::vector<TranscriptSegment>& segments);
+
+    /// Shared row loop behind get_segments / get_low_confidence_segments.
+    std::vector<TranscriptSegment> query_segments(const std::string& session_id,
+                                                  float below) const;
+    bool apply_locked(const WriteOp& op);
+
+    /// Shared row loop behind for_each_chunk / for_each_stored_chunk.
+    bool visit_chunks(const std::string& session_id,
+                      const ChunkVisitor& visit,
+                      bool decode) const;
+
+    /// PASSIVE checkpoint on the writer.  Caller holds mu_.
+    bool run_checkpoint();
+
+    /// sqlite3_wal_hook callback: checkpoint once the WAL reaches
+    /// kCheckpointPages or kCheckpointIntervalSec has passed since the last.
+    static int on_wal_commit(void* ctx, sqlite3* db, const char* db_name, int wal_pages);
+
+    static constexpr int kCheckpointPages       = 4000;   // ~16 MB at 4 KiB pages
+    static constexpr int kCheckpointIntervalSec = 30;
+
+    /// Turn free text into a safe FTS5 MATCH expression: every word is
+    /// quoted (so punctuation can't form operators) and the last one
+    /// becomes a prefix query.  Returns empty if there are no words.
+    static std::string to_match_expression(const std::string& query);
+
+    /// Length of SessionSummary::preview, in characters (code points).
+    static constexpr size_t kPreviewChars = 120;
+
+    /// First kPreviewChars code points of `transcript`, never splitting a
+    /// UTF-8 sequence.
+    static std::string make_preview(const std::string& transcript);
+
     /// Generate a UUID v4 string.
     static std::string generate_uuid();
 
@@ -94,8 +407,15 @@ private:
     static int64_t now_unix();
 
     std::string     db_path_;
-    sqlite3*        db_ = nullptr;
+    sqlite3*        db_ = nullptr;                            // writer
+    StatementCache  stmts_;
+    ChunkCodec      storage_codec_ = ChunkCodec::flac_s16;   // guarded by mu_
+    std::chrono::steady_clock::time_point last_checkpoint_;  // guarded by mu_
     mutable std::mutex mu_;
+
+    sqlite3*               read_db_ = nullptr;               // reader
+    mutable StatementCache read_stmts_;
+    mutable std::mutex     read_mu_;
 };
 
 } // namespace vr
@@ -0,0 +1,204 @@
+#include "Instrumentation.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+
+#if defined(__APPLE__)
+#include <os/log.h>
+#include <os/signpost.h>
+#endif
+
+namespace vr {
+
+namespace {
+
+// ---------------------------------------------------------------------------
+// Histogram
+// ---------------------------------------------------------------------------
+
+// Log-linear buckets over microseconds: 0-7 us exactly, then 8 buckets per
+// power of two (12.5% wide) up to 2^41 us.  Percentiles report the bucket
+// midpoint.
+constexpr int    kSubBits    = 3;
+constexpr size_t kSubBuckets = size_t{1} << kSubBits;
+constexpr int    kMaxOctave  = 41;
+constexpr size_t kBuckets    = kSubBuckets + (kMaxOctave - kSubBits) * kSubBuckets;
+
+size_t bucket_for(uint64_t us) {
+    if (us < kSubBuckets) return static_cast<size_t>(us);
+    int octave = 63 - __builtin_clzll(us);
+    if (octave >= kMaxOctave) return kBuckets - 1;
+    const size_t sub = static_cast<size_t>(us >> (octave - kSubBits)) & (kSubBuckets - 1);
+    return kSubBuckets + static_cast<size_t>(octave - kSubBits) * kSubBuckets + sub;
+}
+
+double bucket_midpoint_us(size_t index) {
+    if (index < kSubBuckets) return static_cast<double>(index);
+    const int octave = static_cast<int>((index - kSubBuckets) / kSubBuckets) + kSubBits;
+    const uint64_t sub   = (index - kSubBuckets) % kSubBuckets;
+    const uint64_t width = uint64_t{1} << (octave - kSubBits);
+    const uint64_t lower = (kSubBuckets + sub) * width;
+    return static_cast<double>(lower) + static_cast<double>(width) / 2.0;
+}
+
+struct Histogram {
+    std::array<std::atomic<uint64_t>, kBuckets> buckets{};
+    std::atomic<uint64_t> count{0};
+    std::atomic<uint64_t> total_ns{0};
+    std::atomic<uint64_t> max_ns{0};
+
+    void record(uint64_t ns) {
+        buckets[bucket_for(ns / 1000)].fetch_add(1, std::memory_order_relaxed);
+        count.fetch_add(1, std::memory_order_relaxed);
+        total_ns.fetch_add(ns, std::memory_order_relaxed);
+        uint64_t prev = max_ns.load(std::memory_order_relaxed);
+        while (ns > prev &&
+               !max_ns.compare_exchange_weak(prev, ns, std::memory_order_relaxed)) {}
+    }
+
+    void reset() {
+        for (auto& b : buckets) b.store(0, std::memory_order_relaxed);
+        count.store(0, std::memory_order_relaxed);
+        total_ns.store(0, std::memory_order_relaxed);
+        max_ns.store(0, std::memory_order_relaxed);
+    }
+};
+
+std::array<Histogram, kStageCount>& histograms() {
+    static std::array<Histogram, kStageCount> h;
+    return h;
+}
+
+// ---------------------------------------------------------------------------
+// Signposts
+// ---------------------------------------------------------------------------
+
+#if defined(__APPLE__)
+
+os_log_t signpost_log() {
+    static const os_log_t log = os_log_create(kSignpostSubsystem, "pipeline");
+    return log;
+}
+
+// os_signpost names must be string literals, hence the switches.
+#define VR_SIGNPOST_CASES(call, log, id)                                   \
+    case Stage::chunk_persist: call(log, id, "chunk_persist"); break;      \
+    case Stage::blob_read:     call(log, id, "blob_read");     break;      \
+    case Stage::audio_decode:  call(log, id, "audio_decode");  break;      \
+    case Stage::audio_encode:  call(log, id, "audio_encode");  break;      \
+    case Stage::resample:      call(log, id, "resample");      break;      \
+    case Stage::mel:           call(log, id, "mel");           break;      \
+    case Stage::encoder:       call(log, id, "encoder");       break;      \
+    case Stage::decoder:       call(log, id, "decoder");       break;      \
+    case Stage::transcribe:    call(log, id, "transcribe");    break;
+
+uint64_t signpost_begin(Stage stage) {
+    const os_log_t log = signpost_log();
+    if (!os_signpost_enabled(log)) return OS_SIGNPOST_ID_NULL;
+    const os_signpost_id_t id = os_signpost_id_generate(log);
+    switch (stage) { VR_SIGNPOST_CASES(os_signpost_interval_begin, log, id) }
+    return id;
+}
+
+void signpost_end(Stage stage, uint64_t id) {
+    if (id == OS_SIGNPOST_ID_NULL) return;
+    const os_log_t log = signpost_log();
+    switch (stage) { VR_SIGNPOST_CASES(os_signpost_interval_end, log, id) }
+}
+
+#undef VR_SIGNPOST_CASES
+
+#else
+
+uint64_t signpost_begin(Stage) { return 0; }
+void signpost_end(Stage, uint64_t) {}
+
+#endif
+
+} // namespace
+
+// ---------------------------------------------------------------------------
+// Public API
+// ---------------------------------------------------------------------------
+
+const char* stage_name(Stage stage) {
+    switch (stage) {
+        case Stage::chunk_persist: return "chunk_persist";
+        case Stage::blob_read:     return "blob_read";
+        case Stage::audio_decode:  return "audio_decode";
+        case Stage::audio_encode:  return "audio_encode";
+        case Stage::resample:      return "resample";
+        case Stage::mel:           return "mel";
+        case Stage::encoder:       return "encoder";
+        case Stage::decoder:       return "decoder";
+        case Stage::transcribe:    return "transcribe";
+    }
+    return "unknown";
+}
+
+uint64_t stage_clock_ns() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+StageSpan::StageSpan(Stage stage)
+    : stage_(stage), start_ns_(stage_clock_ns()), signpost_id_(signpost_begin(stage)) {}
+
+StageSpan::~StageSpan() {
+    signpost_end(stage_, signpost_id_);
+    record_stage(stage_, stage_clock_ns() - start_ns_);
+}
+
+void record_stage(Stage stage, uint64_t duration_ns) {
+    histograms()[static_cast<size_t>(stage)].record(duration_ns);
+}
+
+std::vector<StageStats> stage_snapshot() {
+    std::vector<StageStats> out;
+    out.reserve(kStageCount);
+
+    for (size_t s = 0; s < kStageCount; ++s) {
+        const Histogram& h = histograms()[s];
+        StageStats stats;
+        stats.stage    = static_cast<Stage>(s);
+
+        std::array<uint64_t, kBuckets> counts;
+        uint64_t total = 0;
+        for (size_t b = 0; b < kBuckets; ++b) {
+            counts[b] = h.buckets[b].load(std::memory_order_relaxed);
+            total += counts[b];
+        }
+        stats.count    = total;
+        stats.total_ms = static_cast<double>(h.total_ns.load(std::memory_order_relaxed)) / 1e6;
+        stats.max_ms   = static_cast<double>(h.max_ns.load(std::memory_order_relaxed)) / 1e6;
+
+        if (total > 0) {
+            // Nearest-rank percentiles over the copied buckets, capped at
+            // the true maximum (the top bucket's midpoint can exceed it).
+            const auto at = [&](double pct) {
+                const uint64_t rank = std::max<uint64_t>(
+                    1, static_cast<uint64_t>(pct / 100.0 * static_cast<double>(total) + 0.5));
+                uint64_t seen = 0;
+                for (size_t b = 0; b < kBuckets; ++b) {
+                    seen += counts[b];
+                    if (seen >= rank) {
+                        return std::min(bucket_midpoint_us(b) / 1000.0, stats.max_ms);
+                    }
+                }
+                return stats.max_ms;
+            };
+            stats.p50_ms = at(50.0);
+            stats.p95_ms = at(95.0);
+            stats.p99_ms = at(99.0);
+        }
+        out.push_back(stats);
+    }
+    return out;
+}
+
+void reset_stage_metrics() {
+    for (auto& h : histograms()) h.reset();
+}
+
+} // namespace vr
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace vr {
+
+/// Pipeline stages timed by StageSpan.
+enum class Stage {
+    chunk_persist,   // chunk insert transaction (DatabaseManager / WriteQueue)
+    blob_read,       // stepping chunk rows out of SQLite
+    audio_decode,    // FLAC / M4A → float32 (AudioCodec, AudioConverter)
+    audio_encode,    // float32 → FLAC for storage
+    resample,        // Resampler::process
+    mel,             // log-mel spectrogram, inside whisper_full
+    encoder,         // one encoder pass per 30 s window, inside whisper_full
+    decoder,         // the token decode loop for one window, inside whisper_full
+    transcribe,      // a whole whisper_full call
+};
+
+constexpr size_t kStageCount = static_cast<size_t>(Stage::transcribe) + 1;
+
+/// Stable lower_snake_case name, e.g. "chunk_persist".
+const char* stage_name(Stage stage);
+
+/// Latency summary of one stage since start-up (or reset_stage_metrics()).
+/// Percentiles come from a log-scale histogram, so they are accurate to
+/// within ~10%.
+struct StageStats {
+    Stage    stage;
+    uint64_t count    = 0;
+    double   total_ms = 0.0;
+    double   p50_ms   = 0.0;
+    double   p95_ms   = 0.0;
+    double   p99_ms   = 0.0;
+    double   max_ms   = 0.0;
+};
+
+/// Times one stage for the lifetime of the object.
+///
+/// On Apple platforms the span is also an os_signpost interval (subsystem
+/// kSignpostSubsystem, category "pipeline"), so Instruments' os_signpost
+/// instrument shows every stage on a timeline.  The duration goes into
+/// a process-wide histogram read by stage_snapshot().  Recording is a few
+/// relaxed atomic adds — no locks, no allocation.
+class StageSpan {
+public:
+    explicit StageSpan(Stage stage);
+    ~StageSpan();
+
+    StageSpan(const StageSpan&) = delete;
+    StageSpan& operator=(const StageSpan&) = delete;
+
+private:
+    Stage    stage_;
+    uint64_t start_ns_;
+    uint64_t signpost_id_;
+};
+
+/// Record a duration measured some other way (e.g. from whisper's
+/// callbacks, where no scope brackets the stage).
+void record_stage(Stage stage, uint64_t duration_ns);
+
+/// Monotonic clock in nanoseconds, as used by StageSpan.
+uint64_t stage_clock_ns();
+
+/// Current statistics for every stage, in Stage order.  Thread-safe; the
+/// counters keep moving while it reads, so it is a near-snapshot.
+std::vector<StageStats> stage_snapshot();
+
+/// Zero every histogram.
+void reset_stage_metrics();
+
+/// os_signpost subsystem the spans are logged under.
+constexpr const char* kSignpostSubsystem = "art.brainph.voice";
+
+} // namespace vr
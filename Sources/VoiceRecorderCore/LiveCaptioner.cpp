@@ -0,0 +1,183 @@
+#include "LiveCaptioner.hpp"
+#include "CpuTopology.hpp"
+#include "StreamMerge.hpp"
+#include "Vad.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <utility>
+
+#if defined(__APPLE__)
+#include <pthread.h>
+#include <pthread/qos.h>
+#endif
+
+namespace vr {
+
+namespace {
+
+constexpr size_t kWindowSamples    = static_cast<size_t>(LiveCaptioner::kWindowMs) * 16;
+constexpr size_t kMinWindowSamples = static_cast<size_t>(LiveCaptioner::kMinWindowMs) * 16;
+
+/// Stable words kept for merging the next decode against (merge_overlap()
+/// only looks at the tail).
+constexpr size_t kKeepWords = 64;
+constexpr size_t kMergeWords = 32;
+
+std::string join_words(const std::vector<std::string>& words) {
+    std::string out;
+    for (const std::string& w : words) {
+        if (!out.empty()) out += ' ';
+        out += w;
+    }
+    return out;
+}
+
+} // namespace
+
+// ---------------------------------------------------------------------------
+// Construction / destruction
+// ---------------------------------------------------------------------------
+
+LiveCaptioner::LiveCaptioner(WhisperEngine& engine, Source source, Callback on_caption)
+    : engine_(engine), source_(std::move(source)), on_caption_(std::move(on_caption)),
+      n_threads_(std::max(1, std::min(kMaxThreads, CpuTopology::current().efficiency_cores))),
+      worker_(&LiveCaptioner::worker_loop, this) {}
+
+LiveCaptioner::~LiveCaptioner() {
+    {
+        std::lock_guard<std::mutex> lock(mu_);
+        stopping_ = true;
+        abort_.store(true);
+    }
+    cv_.notify_all();
+    if (worker_.joinable()) worker_.join();
+    engine_.release_caption_states();
+}
+
+// ---------------------------------------------------------------------------
+// Worker
+// ---------------------------------------------------------------------------
+
+void LiveCaptioner::worker_loop() {
+#if defined(__APPLE__)
+    // Below the draft transcription and the UI, above refinement.
+    pthread_set_qos_class_self_np(QOS_CLASS_UTILITY, 0);
+#endif
+    if (source_.dropped) dropped_ = source_.dropped();
+
+    std::unique_lock<std::mutex> lock(mu_);
+    for (;;) {
+        if (cv_.wait_for(lock, interval_, [this] { return stopping_; })) return;
+        lock.unlock();
+        tick();
+        interval_ms_.store(interval_.count());
+        lock.lock();
+    }
+}
+
+void LiveCaptioner::tick() {
+    // Audio is being lost: whatever the cause, stop adding load.
+    if (source_.dropped) {
+        const size_t dropped = source_.dropped();
+        if (dropped > dropped_) {
+            fprintf(stderr, "[LiveCaptioner] capture dropped %zu samples, backing off\n",
+                    dropped - dropped_);
+            dropped_ = dropped;
+            interval_ = kMaxInterval;
+            return;
+        }
+    }
+
+    // A transcription (e.g. the stream's window for a finished chunk) has
+    // the cores; leave them to it.
+    if (engine_.active_requests() > 0) {
+        back_off();
+        return;
+    }
+
+    const size_t end = source_.recent ? source_.recent(window_, kWindowSamples) : 0;
+    if (end == last_end_ || window_.size() < kMinWindowSamples) return;
+    last_end_ = end;
+
+    if (detect_speech(window_.data(), window_.size()).empty()) {
+        settle();
+        return;
+    }
+
+    const auto started = std::chrono::steady_clock::now();
+    std::string text;
+    try {
+        text = engine_.caption(window_.data(), window_.size(), n_threads_, &abort_);
+    } catch (const TranscriptionAborted&) {
+        back_off();   // yielded to a transcription, or stopping
+        return;
+    } catch (const std::exception& e) {
+        fprintf(stderr, "[LiveCaptioner] caption failed: %s\n", e.what());
+        back_off();
+        return;
+    }
+    const auto took = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - started);
+
+    // Keep decoding under half of the interval, so captions never use
+    // more than half of their threads' time.
+    if (took * 2 > interval_) {
+        interval_ = std::min(kMaxInterval, std::max(interval_ * 2, took * 2));
+    } else if (took * 4 < interval_ && interval_ > kBaseInterval) {
+        interval_ = std::max(kBaseInterval, interval_ / 2);
+    }
+
+    update(text);
+}
+
+void LiveCaptioner::back_off() {
+    interval_ = std::min(kMaxInterval, interval_ * 2);
+}
+
+// ---------------------------------------------------------------------------
+// Caption text
+// ---------------------------------------------------------------------------
+
+void LiveCaptioner::update(const std::string& text) {
+    // The window still holds audio whose words are already stable; drop
+    // them from the front of this decode.  (No time fallback: -1.)
+    std::vector<TranscriptSegment> next(1);
+    next[0].text  = text;
+    next[0].t1_ms = kWindowMs;
+    if (!stable_.empty()) merge_overlap(stable_, next, -1, kMergeWords);
+    const std::vector<std::string> words =
+        next.empty() ? std::vector<std::string>{} : split_words(next[0].text);
+
+    // Local agreement: the prefix this decode shares with the previous one
+    // is unlikely to change again.
+    size_t agreed = 0;
+    while (agreed < words.size() && agreed < partial_.size() &&
+           normalize_word(words[agreed]) == normalize_word(partial_[agreed])) {
+        ++agreed;
+    }
+    if (agreed > 0) {
+        std::vector<std::string> settled(words.begin(), words.begin() + static_cast<long>(agreed));
+        stable_ = prompt_tail(stable_ + " " + join_words(settled), kKeepWords);
+    }
+    partial_.assign(words.begin() + static_cast<long>(agreed), words.end());
+    publish();
+}
+
+void LiveCaptioner::settle() {
+    if (partial_.empty()) return;
+    stable_ = prompt_tail(stable_ + " " + join_words(partial_), kKeepWords);
+    partial_.clear();
+    publish();
+}
+
+void LiveCaptioner::publish() {
+    LiveCaption caption;
+    caption.stable  = prompt_tail(stable_, kStableWords);
+    caption.partial = join_words(partial_);
+    if (caption.stable == published_.stable && caption.partial == published_.partial) return;
+    published_ = caption;
+    if (on_caption_) on_caption_(caption);
+}
+
+} // namespace vr
@@ -0,0 +1,126 @@
+#pragma once
+
+#include "WhisperEngine.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace vr {
+
+/// One live caption update.
+struct LiveCaption {
+    std::string stable;    // end of the text two decodes in a row agreed on
+    std::string partial;   // the rest of the latest decode; may still change
+};
+
+/// Live captions for a recording in progress.
+///
+/// A worker re-decodes a sliding window over the last kWindowMs of the
+/// capture about every kBaseInterval, through WhisperEngine::caption() —
+/// the fast model on its own state, with a small token budget.  Words that
+/// two consecutive decodes agree on become stable (they are not revised
+/// again); the rest of the latest decode is the partial text.  A pause in
+/// speech settles the partial text.
+///
+/// Captions are best effort and give way to everything else.  The interval
+/// backs off (doubling, up to kMaxInterval) when a decode takes more than
+/// half of it, while a transcription is running — which also aborts a
+/// caption in flight — and when the capture reports dropped audio; it
+/// creeps back down once decodes are cheap again.  The worker runs at
+/// utility QoS on a couple of threads, below the draft transcription.
+class LiveCaptioner {
+public:
+    /// Where the audio comes from (typically CaptureBuffer).  Called on
+    /// the worker thread.
+    struct Source {
+        /// Copy up to `max_samples` of the most recent 16 kHz mono audio
+        /// into `out`, oldest first; return the samples captured so far.
+        std::function<size_t(std::vector<float>& out, size_t max_samples)> recent;
+
+        /// Samples the capture has dropped so far.  May be empty.
+        std::function<size_t()> dropped;
+    };
+
+    /// Called on the worker thread whenever the caption changes.
+    using Callback = std::function<void(const LiveCaption& caption)>;
+
+    /// Starts captioning.  `engine` must outlive the captioner.
+    LiveCaptioner(WhisperEngine& engine, Source source, Callback on_caption);
+
+    /// Aborts the caption in flight, joins the worker and frees the
+    /// engine's caption states.
+    ~LiveCaptioner();
+
+    // Non-copyable.
+    LiveCaptioner(const LiveCaptioner&) = delete;
+    LiveCaptioner& operator=(const LiveCaptioner&) = delete;
+
+    /// Current gap between decodes.
+    std::chrono::milliseconds interval() const {
+        return std::chrono::milliseconds(interval_ms_.load());
+    }
+
+    /// Audio re-decoded each time.
+    static constexpr int kWindowMs = 5000;
+
+    /// No caption before this much audio has been captured.
+    static constexpr int kMinWindowMs = 1000;
+
+    /// Fastest decode rate, and the slowest the back-off goes to.
+    static constexpr std::chrono::milliseconds kBaseInterval{500};
+    static constexpr std::chrono::milliseconds kMaxInterval{4000};
+
+    /// Words of stable text passed to the callback.
+    static constexpr size_t kStableWords = 24;
+
+    /// Threads per decode (fewer if there are fewer efficiency cores).
+    static constexpr int kMaxThreads = 2;
+
+private:
+    void worker_loop();
+
+    /// One decode of the current window.
+    void tick();
+
+    /// Double the interval (up to kMaxInterval).
+    void back_off();
+
+    /// Fold a decode into the stable / partial text and publish it.
+    void update(const std::string& text);
+
+    /// Move the partial text to the stable text (speech paused).
+    void settle();
+
+    void publish();
+
+    WhisperEngine&          engine_;
+    const Source            source_;
+    const Callback          on_caption_;
+    const int               n_threads_;
+
+    // Worker-owned.
+    std::chrono::milliseconds interval_ = kBaseInterval;
+    std::vector<float>      window_;
+    size_t                  last_end_ = 0;       // capture position of the last decode
+    size_t                  dropped_ = 0;        // capture drops seen so far
+    std::string             stable_;             // tail of the settled text
+    std::vector<std::string> partial_;           // words of the latest decode not yet stable
+    LiveCaption             published_;
+
+    std::atomic<int64_t>    interval_ms_{kBaseInterval.count()};
+    std::atomic<bool>       abort_{false};       // polled by whisper during a caption
+    std::mutex              mu_;
+    std::condition_variable cv_;
+    bool                    stopping_ = false;
+
+    std::thread             worker_;             // declared last: starts after state
+};
+
+} // namespace vr
@@ -0,0 +1,139 @@
+#include "Metering.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+#if defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#define VR_METERING_NEON 1
+#endif
+
+namespace vr {
+
+namespace {
+
+constexpr float kInvSqrt2 = 0.70710678118654752f;
+
+/// Squared-coefficient sums per band, plus the running peak.
+struct Accum {
+    float energy[kMeterBands] = {};   // low .. high
+    float peak = 0.0f;
+};
+
+/// Haar-decompose one block of 8 samples into the four bands.
+inline void haar_block8(const float* x, Accum& acc) {
+    float a1[4];
+    for (int k = 0; k < 4; ++k) {
+        const float e = x[2 * k];
+        const float o = x[2 * k + 1];
+        const float d = (e - o) * kInvSqrt2;
+        a1[k] = (e + o) * kInvSqrt2;
+        acc.energy[3] += d * d;
+        acc.peak = std::max(acc.peak, std::max(std::fabs(e), std::fabs(o)));
+    }
+
+    float a2[2];
+    for (int j = 0; j < 2; ++j) {
+        const float d = (a1[2 * j] - a1[2 * j + 1]) * kInvSqrt2;
+        a2[j] = (a1[2 * j] + a1[2 * j + 1]) * kInvSqrt2;
+        acc.energy[2] += d * d;
+    }
+
+    const float d3 = (a2[0] - a2[1]) * kInvSqrt2;
+    const float a3 = (a2[0] + a2[1]) * kInvSqrt2;
+    acc.energy[1] += d3 * d3;
+    acc.energy[0] += a3 * a3;
+}
+
+#if VR_METERING_NEON
+/// NEON path: 32 samples (four 8-sample Haar blocks) per iteration.
+/// Returns the number of samples consumed.
+size_t haar_neon(const float* x, size_t count, Accum& acc) {
+    const size_t n = count - count % 32;
+    if (n == 0) return 0;
+
+    const float32x4_t r = vdupq_n_f32(kInvSqrt2);
+    float32x4_t e0 = vdupq_n_f32(0.0f), e1 = e0, e2 = e0, e3 = e0;
+    float32x4_t pk = e0;
+
+    for (size_t i = 0; i < n; i += 32) {
+        // Level 1: deinterleave even/odd samples → 16 approx + 16 detail.
+        float32x4_t a1[4];
+        for (int b = 0; b < 4; ++b) {
+            const float32x4x2_t p = vld2q_f32(x + i + 8 * b);
+            const float32x4_t d = vmulq_f32(vsubq_f32(p.val[0], p.val[1]), r);
+            a1[b] = vmulq_f32(vaddq_f32(p.val[0], p.val[1]), r);
+            e3 = vfmaq_f32(e3, d, d);
+            pk = vmaxq_f32(pk, vmaxq_f32(vabsq_f32(p.val[0]), vabsq_f32(p.val[1])));
+        }
+
+        // Level 2: pair adjacent level-1 approximations.
+        float32x4_t a2[2];
+        for (int b = 0; b < 2; ++b) {
+            const float32x4x2_t u = vuzpq_f32(a1[2 * b], a1[2 * b + 1]);
+            const float32x4_t d = vmulq_f32(vsubq_f32(u.val[0], u.val[1]), r);
+            a2[b] = vmulq_f32(vaddq_f32(u.val[0], u.val[1]), r);
+            e2 = vfmaq_f32(e2, d, d);
+        }
+
+        // Level 3.
+        const float32x4x2_t u = vuzpq_f32(a2[0], a2[1]);
+        const float32x4_t d3 = vmulq_f32(vsubq_f32(u.val[0], u.val[1]), r);
+        const float32x4_t a3 = vmulq_f32(vaddq_f32(u.val[0], u.val[1]), r);
+        e1 = vfmaq_f32(e1, d3, d3);
+        e0 = vfmaq_f32(e0, a3, a3);
+    }
+
+    acc.energy[0] += vaddvq_f32(e0);
+    acc.energy[1] += vaddvq_f32(e1);
+    acc.energy[2] += vaddvq_f32(e2);
+    acc.energy[3] += vaddvq_f32(e3);
+    acc.peak = std::max(acc.peak, vmaxvq_f32(pk));
+    return n;
+}
+#endif
+
+inline float clamp01(float v) {
+    return std::min(1.0f, std::max(0.0f, v));
+}
+
+} // namespace
+
+// ---------------------------------------------------------------------------
+// compute_meter_levels
+// ---------------------------------------------------------------------------
+
+MeterLevels compute_meter_levels(const float* samples, size_t count) {
+    MeterLevels levels;
+    if (!samples || count == 0) return levels;
+
+    Accum acc;
+    size_t i = 0;
+
+#if VR_METERING_NEON
+    i = haar_neon(samples, count, acc);
+#endif
+
+    for (; i + 8 <= count; i += 8) {
+        haar_block8(samples + i, acc);
+    }
+
+    // Tail: energy and peak only.
+    float tail_energy = 0.0f;
+    for (; i < count; ++i) {
+        tail_energy += samples[i] * samples[i];
+        acc.peak = std::max(acc.peak, std::fabs(samples[i]));
+    }
+
+    const float inv_n = 1.0f / static_cast<float>(count);
+    float total = tail_energy;
+    for (size_t b = 0; b < kMeterBands; ++b) {
+        total += acc.energy[b];
+        levels.bands[b] = clamp01(std::sqrt(acc.energy[b] * inv_n));
+    }
+    levels.rms  = clamp01(std::sqrt(total * inv_n));
+    levels.peak = clamp01(acc.peak);
+    return levels;
+}
+
+} // namespace vr
@@ -0,0 +1,30 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+
+namespace vr {
+
+/// Number of frequency bands reported by compute_meter_levels().
+constexpr size_t kMeterBands = 4;
+
+/// Levels for one buffer of 16 kHz mono float32 audio, each in [0, 1].
+struct MeterLevels {
+    float rms  = 0.0f;
+    float peak = 0.0f;
+
+    /// Per-band RMS from a 3-level Haar decomposition, low to high:
+    /// 0–1 kHz, 1–2 kHz, 2–4 kHz, 4–8 kHz (at 16 kHz).  The transform is
+    /// orthonormal, so the squared bands sum to rms².
+    std::array<float, kMeterBands> bands{};
+};
+
+/// RMS, peak and band levels in a single pass over `samples`.
+///
+/// Safe to call from the real-time audio thread: no allocation, no locks.
+/// Uses NEON on Apple Silicon; elsewhere a scalar loop the compiler can
+/// vectorise.  A tail of fewer than 8 samples counts towards rms/peak but
+/// not towards the bands.
+MeterLevels compute_meter_levels(const float* samples, size_t count);
+
+} // namespace vr
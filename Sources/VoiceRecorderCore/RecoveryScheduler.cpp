@@ -0,0 +1,180 @@
+#include "RecoveryScheduler.hpp"
+#include "CpuTopology.hpp"
+#include "StreamMerge.hpp"
+
+#include <cstdio>
+#include <utility>
+
+namespace vr {
+
+// ---------------------------------------------------------------------------
+// Construction
+// ---------------------------------------------------------------------------
+
+RecoveryScheduler::RecoveryScheduler(WhisperEngine& engine, Store store,
+                                     int64_t min_duration_ms, TranscriptCache* cache)
+    : engine_(engine), store_(std::move(store)), min_duration_ms_(min_duration_ms),
+      cache_(cache) {}
+
+// ---------------------------------------------------------------------------
+// Queue control
+// ---------------------------------------------------------------------------
+
+void RecoveryScheduler::start(const std::vector<std::string>& session_ids) {
+    for (const std::string& id : session_ids) {
+        if (id.empty()) continue;
+        // An aborted run is requeued by the worker and resumes from the
+        // last checkpoint.
+        worker_.enqueue(id, [this, id] { return run(id); },
+                        BackgroundWorker::IfQueued::keep);
+    }
+}
+
+void RecoveryScheduler::cancel() { worker_.cancel_all(); }
+
+void RecoveryScheduler::cancel(const std::string& session_id) { worker_.cancel(session_id); }
+
+void RecoveryScheduler::pause() { worker_.pause(); }
+
+void RecoveryScheduler::resume() { worker_.resume(); }
+
+bool RecoveryScheduler::is_paused() const { return worker_.is_paused(); }
+
+size_t RecoveryScheduler::pending() const { return worker_.pending(); }
+
+// ---------------------------------------------------------------------------
+// Worker
+// ---------------------------------------------------------------------------
+
+bool RecoveryScheduler::run(const std::string& session_id) {
+    if (!engine_.is_loaded() && !engine_.is_loading()) {
+        // Leave it orphaned so the next launch (with a model) retries.
+        fprintf(stderr, "[RecoveryScheduler] no model loaded, leaving %s for later\n",
+                session_id.c_str());
+        return true;
+    }
+
+    std::vector<ChunkSpan> spans;
+    int64_t recovered_ms = 0;
+    try {
+        spans        = store_.spans(session_id);
+        recovered_ms = store_.progress(session_id);
+    } catch (const std::exception& e) {
+        fprintf(stderr, "[RecoveryScheduler] reading %s failed: %s\n",
+                session_id.c_str(), e.what());
+        store_.finish(session_id, RecoveryOutcome::failed);
+        return true;
+    }
+
+    const int64_t total_ms = spans.empty() ? 0 : spans.back().end_ms;
+    if (total_ms < min_duration_ms_) {
+        fprintf(stderr, "[RecoveryScheduler] %s is %lld ms, discarding\n",
+                session_id.c_str(), static_cast<long long>(total_ms));
+        store_.finish(session_id, RecoveryOutcome::discarded);
+        return true;
+    }
+
+    fprintf(stderr, "[RecoveryScheduler] recovering %s: %lld of %lld ms left\n",
+            session_id.c_str(), static_cast<long long>(total_ms - recovered_ms),
+            static_cast<long long>(total_ms));
+
+    TranscribeOptions options;
+    options.tier      = ModelTier::accurate;
+    options.abort     = worker_.abort_flag();
+    options.n_threads = CpuTopology::current().efficiency_cores;
+    std::string prompt_source;   // audio hash of the chunk the prompt came from (TranscriptCache)
+
+    size_t first = 0;
+    while (first < spans.size() && spans[first].end_ms <= recovered_ms) ++first;
+    if (first > 0 && first < spans.size()) {
+        try {
+            seed_prompt(session_id, spans, first, options, prompt_source);
+        } catch (const std::exception& e) {
+            // Only the first chunk's context is lost; carry on.
+            fprintf(stderr, "[RecoveryScheduler] reading saved text of %s failed: %s\n",
+                    session_id.c_str(), e.what());
+        }
+    }
+
+    for (const ChunkSpan& span : spans) {
+        if (span.end_ms <= recovered_ms) continue;
+        if (worker_.aborted()) return false;
+
+        std::vector<TranscriptSegment> segments;
+        std::string chunk_hash;
+        try {
+            const std::vector<float> pcm = store_.load(session_id, span);
+            if (pcm.empty() && span.end_ms > span.begin_ms) {
+                // Unreadable, not silent: checkpointing it would mark the
+                // chunk recovered with its transcript lost for good.
+                fprintf(stderr, "[RecoveryScheduler] chunk %d of %s has no audio\n",
+                        span.chunk_index, session_id.c_str());
+                store_.finish(session_id, RecoveryOutcome::failed);
+                return true;
+            }
+            if (!pcm.empty() && cache_) {
+                segments = cache_->transcribe(pcm.data(), pcm.size(), 16000, session_id,
+                                              nullptr, options, prompt_source);
+                chunk_hash = TranscriptCache::audio_hash(pcm.data(), pcm.size());
+            } else if (!pcm.empty()) {
+                segments = engine_.transcribe_segments(pcm.data(), pcm.size(), 16000,
+                                                       nullptr, options);
+            }
+        } catch (const TranscriptionAborted&) {
+            fprintf(stderr, "[RecoveryScheduler] %s interrupted at chunk %d\n",
+                    session_id.c_str(), span.chunk_index);
+            return false;
+        } catch (const std::exception& e) {
+            fprintf(stderr, "[RecoveryScheduler] chunk %d of %s failed: %s\n",
+                    span.chunk_index, session_id.c_str(), e.what());
+            store_.finish(session_id, RecoveryOutcome::failed);
+            return true;
+        }
+
+        for (TranscriptSegment& seg : segments) {
+            seg.t0_ms += span.begin_ms;
+            seg.t1_ms += span.begin_ms;
+        }
+        // The next chunk usually continues this one's sentence.
+        if (!segments.empty()) {
+            options.prompt = prompt_tail(join_segments(segments),
+                                         WhisperEngine::kStreamPromptWords);
+            prompt_source = std::move(chunk_hash);
+        }
+
+        if (!store_.checkpoint(session_id, span, segments)) {
+            fprintf(stderr, "[RecoveryScheduler] saving chunk %d of %s failed\n",
+                    span.chunk_index, session_id.c_str());
+            store_.finish(session_id, RecoveryOutcome::failed);
+            return true;
+        }
+    }
+
+    store_.finish(session_id, RecoveryOutcome::recovered);
+    return true;
+}
+
+void RecoveryScheduler::seed_prompt(const std::string& session_id,
+                                    const std::vector<ChunkSpan>& spans, size_t first,
+                                    TranscribeOptions& options,
+                                    std::string& prompt_source) const {
+    if (!store_.saved) return;
+
+    const std::vector<TranscriptSegment> saved = store_.saved(session_id);
+    for (size_t i = first; i-- > 0;) {
+        std::vector<TranscriptSegment> chunk;
+        for (const TranscriptSegment& seg : saved) {
+            if (seg.t0_ms >= spans[i].begin_ms && seg.t0_ms < spans[i].end_ms) chunk.push_back(seg);
+        }
+        if (!chunk.empty()) {
+            options.prompt = prompt_tail(join_segments(chunk), WhisperEngine::kStreamPromptWords);
+            if (cache_) {
+                const std::vector<float> pcm = store_.load(session_id, spans[i]);
+                prompt_source = TranscriptCache::audio_hash(pcm.data(), pcm.size());
+            }
+            return;
+        }
+    }
+}
+
+} // namespace vr
@@ -0,0 +1,120 @@
+#pragma once
+
+#include "BackgroundWorker.hpp"
+#include "TranscriptCache.hpp"
+#include "WhisperEngine.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace vr {
+
+/// How the recovery of one orphaned session ended.
+enum class RecoveryOutcome {
+    recovered,   // every chunk transcribed; the store completes the session
+    discarded,   // shorter than the minimum duration; the store deletes it
+    failed,      // unreadable or a checkpoint could not be saved
+};
+
+/// Crash recovery for sessions left in 'recording' status, off the launch
+/// path.
+///
+/// start() only queues the orphan ids; a single background-QoS worker then
+/// transcribes each session one chunk at a time and checkpoints every
+/// chunk's segments through the Store, so an interrupted recovery resumes
+/// from the last saved chunk (on resume() or at the next launch) instead of
+/// starting over.  A resumed run prompts its first chunk with the text
+/// saved before it, so it decodes (and hits the cache) as an uninterrupted
+/// run would.  Launch cost is one query however much audio was left.
+///
+/// pause() yields to a live recording or transcription through the same
+/// BackgroundWorker as RefinementQueue::pause(): the running chunk is aborted mid-inference and
+/// redone after the matching resume().
+class RecoveryScheduler {
+public:
+    /// Storage hooks, all called on the worker thread.
+    struct Store {
+        /// The session's chunks, in order.
+        std::function<std::vector<ChunkSpan>(const std::string& session_id)> spans;
+
+        /// Audio already recovered, in ms (chunks ending at or before it
+        /// are skipped).
+        std::function<int64_t(const std::string& session_id)> progress;
+
+        /// Segments checkpointed so far (times relative to the session), to
+        /// prompt the first chunk of a resumed recovery.  May be empty.
+        std::function<std::vector<TranscriptSegment>(const std::string& session_id)> saved;
+
+        /// One chunk as 16 kHz mono float32.  Empty for a chunk with a
+        /// non-empty span fails the session (the audio is unreadable).
+        std::function<std::vector<float>(const std::string& session_id,
+                                         const ChunkSpan& span)> load;
+
+        /// Persist the chunk's segments (times relative to the session) and
+        /// advance the progress to span.end_ms.  False fails the session.
+        std::function<bool(const std::string& session_id,
+                           const ChunkSpan& span,
+                           const std::vector<TranscriptSegment>& segments)> checkpoint;
+
+        /// Apply the outcome (complete, delete, or mark failed).
+        std::function<void(const std::string& session_id, RecoveryOutcome outcome)> finish;
+    };
+
+    /// `engine` (and `cache`, if given) must outlive the scheduler.
+    /// Sessions shorter than `min_duration_ms` are discarded without being
+    /// transcribed.  With a cache, chunks already transcribed with the same
+    /// model and parameters are not run again.
+    RecoveryScheduler(WhisperEngine& engine, Store store, int64_t min_duration_ms,
+                      TranscriptCache* cache = nullptr);
+
+    /// Drops queued sessions, aborts the running chunk (its progress is
+    /// kept), then joins the worker.
+    ~RecoveryScheduler() = default;
+
+    // Non-copyable.
+    RecoveryScheduler(const RecoveryScheduler&) = delete;
+    RecoveryScheduler& operator=(const RecoveryScheduler&) = delete;
+
+    /// Queue orphaned sessions, skipping any already queued or running.
+    void start(const std::vector<std::string>& session_ids);
+
+    /// Drop queued recoveries and abort the running one.  Saved progress
+    /// stays, so the sessions are picked up again at the next launch.
+    void cancel();
+
+    /// Drop `session_id` (e.g. the user deleted it).
+    void cancel(const std::string& session_id);
+
+    /// Hold the queue and abort the running chunk (it is redone after
+    /// resume()).  Calls nest.
+    void pause();
+    void resume();
+    bool is_paused() const;
+
+    /// Sessions queued or being recovered.
+    size_t pending() const;
+
+private:
+    /// Recover one session; returns false if it was aborted and should be
+    /// retried.
+    bool run(const std::string& session_id);
+
+    /// Point `options` (and the cache's `prompt_source`) at the text saved
+    /// for the last chunk before `spans[first]` that has any, as the
+    /// uninterrupted run would have.
+    void seed_prompt(const std::string& session_id, const std::vector<ChunkSpan>& spans,
+                     size_t first, TranscribeOptions& options,
+                     std::string& prompt_source) const;
+
+    WhisperEngine&          engine_;
+    const Store             store_;
+    const int64_t           min_duration_ms_;
+    TranscriptCache* const  cache_;              // may be null
+
+    BackgroundWorker        worker_;             // declared last: starts after state
+};
+
+} // namespace vr
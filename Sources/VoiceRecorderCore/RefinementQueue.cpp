@@ -0,0 +1,83 @@
+#include "RefinementQueue.hpp"
+#include "CpuTopology.hpp"
+
+#include <cstdio>
+#include <utility>
+
+namespace vr {
+
+// ---------------------------------------------------------------------------
+// Construction
+// ---------------------------------------------------------------------------
+
+RefinementQueue::RefinementQueue(WhisperEngine& engine) : engine_(engine) {}
+
+// ---------------------------------------------------------------------------
+// Queue control
+// ---------------------------------------------------------------------------
+
+void RefinementQueue::enqueue(const std::string& session_id,
+                              AudioLoader load, Completion done) {
+    Job job{session_id, std::move(load), std::move(done)};
+    worker_.enqueue(session_id, [this, job = std::move(job)] { return run(job); },
+                    BackgroundWorker::IfQueued::replace);
+}
+
+void RefinementQueue::cancel(const std::string& session_id) { worker_.cancel(session_id); }
+
+void RefinementQueue::pause() { worker_.pause(); }
+
+void RefinementQueue::resume() { worker_.resume(); }
+
+bool RefinementQueue::is_paused() const { return worker_.is_paused(); }
+
+size_t RefinementQueue::pending() const { return worker_.pending(); }
+
+// ---------------------------------------------------------------------------
+// Worker
+// ---------------------------------------------------------------------------
+
+bool RefinementQueue::run(const Job& job) {
+    std::vector<float> pcm;
+    try {
+        pcm = job.load ? job.load() : std::vector<float>{};
+    } catch (const std::exception& e) {
+        fprintf(stderr, "[RefinementQueue] loading %s failed: %s\n",
+                job.session_id.c_str(), e.what());
+        return true;
+    }
+    if (pcm.empty()) {
+        fprintf(stderr, "[RefinementQueue] no audio for %s, skipping\n",
+                job.session_id.c_str());
+        return true;
+    }
+
+    TranscribeOptions options;
+    options.tier        = ModelTier::accurate;
+    options.beam_search = true;
+    options.abort       = worker_.abort_flag();
+    // Background QoS keeps this job (and the threads whisper spawns from
+    // it) on the efficiency cores; size the request for them.  Without an
+    // efficiency cluster the engine's policy applies.
+    options.n_threads   = CpuTopology::current().efficiency_cores;
+
+    std::vector<TranscriptSegment> segments;
+    try {
+        segments = engine_.transcribe_segments(pcm.data(), pcm.size(), 16000, nullptr, options);
+    } catch (const TranscriptionAborted&) {
+        fprintf(stderr, "[RefinementQueue] %s interrupted\n", job.session_id.c_str());
+        return false;
+    } catch (const std::exception& e) {
+        fprintf(stderr, "[RefinementQueue] refining %s failed: %s\n",
+                job.session_id.c_str(), e.what());
+        return true;
+    }
+
+    // An empty result (e.g. VAD found no speech) would only erase the draft.
+    if (!segments.empty() && job.done) {
+        job.done(job.session_id, segments);
+    }
+    return true;
+}
+
+} // namespace vr
@@ -0,0 +1,79 @@
+#pragma once
+
+#include "BackgroundWorker.hpp"
+#include "WhisperEngine.hpp"
+
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace vr {
+
+/// Background second pass over finished sessions.
+///
+/// The draft transcript is produced by the normal (fast, greedy) path and
+/// pasted straight away.  Each session is then queued here, and a single
+/// low-priority worker re-transcribes it on the accurate tier with beam
+/// search and hands the resulting segments to the job's completion, which
+/// stores them as TranscriptVersion::refined.  Jobs run one at a time in
+/// FIFO order, so the refinement pass never takes more than one of the
+/// engine's states.
+///
+/// pause() yields to a live recording: the running job is aborted mid-
+/// inference and put back at the head of the queue, and nothing starts
+/// until every pause() has been matched by a resume() (BackgroundWorker).
+class RefinementQueue {
+public:
+    /// Loads the session's audio (16 kHz mono float32) on the worker
+    /// thread, so queued sessions don't hold their PCM in memory.
+    using AudioLoader = std::function<std::vector<float>()>;
+
+    /// Called on the worker thread with the refined segments (the
+    /// transcript is join_segments() of them).
+    using Completion = std::function<void(const std::string& session_id,
+                                          const std::vector<TranscriptSegment>& segments)>;
+
+    /// `engine` must outlive the queue.
+    explicit RefinementQueue(WhisperEngine& engine);
+
+    /// Drops queued jobs, aborts the running one, then joins the worker.
+    ~RefinementQueue() = default;
+
+    // Non-copyable.
+    RefinementQueue(const RefinementQueue&) = delete;
+    RefinementQueue& operator=(const RefinementQueue&) = delete;
+
+    /// Queue `session_id` for refinement, replacing any job already queued
+    /// for it.
+    void enqueue(const std::string& session_id, AudioLoader load, Completion done);
+
+    /// Drop the queued job for `session_id` (e.g. the session was deleted).
+    /// A job already running is aborted and not retried.
+    void cancel(const std::string& session_id);
+
+    /// Hold the queue and abort the running job (it is retried after
+    /// resume()).  Calls nest.
+    void pause();
+    void resume();
+    bool is_paused() const;
+
+    /// Jobs queued or running.
+    size_t pending() const;
+
+private:
+    struct Job {
+        std::string session_id;
+        AudioLoader load;
+        Completion  done;
+    };
+
+    /// Run one job; returns false if it was aborted and should be retried.
+    bool run(const Job& job);
+
+    WhisperEngine&          engine_;
+
+    BackgroundWorker        worker_;             // declared last: starts after state
+};
+
+} // namespace vr
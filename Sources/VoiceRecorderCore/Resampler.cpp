@@ -0,0 +1,182 @@
+#include "Resampler.hpp"
+#include "Instrumentation.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <mutex>
+#include <numeric>
+#include <utility>
+
+#if defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#define VR_RESAMPLER_NEON 1
+#endif
+
+namespace vr {
+
+namespace {
+
+constexpr double kPi = 3.14159265358979323846;
+
+/// Passband edge as a fraction of the lower Nyquist frequency.  Leaves a
+/// transition band so 16 kHz output has no aliasing above ~7.6 kHz.
+constexpr double kCutoff = 0.95;
+
+/// Kaiser window shape (≈ 80 dB stopband).
+constexpr double kKaiserBeta = 8.0;
+
+/// Zeroth-order modified Bessel function, for the Kaiser window.
+double bessel_i0(double x) {
+    double sum = 1.0, term = 1.0;
+    for (int k = 1; k < 32; ++k) {
+        term *= (x / (2.0 * k)) * (x / (2.0 * k));
+        sum += term;
+        if (term < 1e-12 * sum) break;
+    }
+    return sum;
+}
+
+inline float dot(const float* a, const float* b, size_t n) {
+#if VR_RESAMPLER_NEON
+    float32x4_t acc0 = vdupq_n_f32(0.0f), acc1 = acc0;
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        acc0 = vfmaq_f32(acc0, vld1q_f32(a + i),     vld1q_f32(b + i));
+        acc1 = vfmaq_f32(acc1, vld1q_f32(a + i + 4), vld1q_f32(b + i + 4));
+    }
+    float sum = vaddvq_f32(vaddq_f32(acc0, acc1));
+#else
+    // Four independent accumulators so the compiler can vectorise without
+    // reassociating (no -ffast-math).
+    float s0 = 0.0f, s1 = 0.0f, s2 = 0.0f, s3 = 0.0f;
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        s0 += a[i] * b[i];
+        s1 += a[i + 1] * b[i + 1];
+        s2 += a[i + 2] * b[i + 2];
+        s3 += a[i + 3] * b[i + 3];
+    }
+    float sum = (s0 + s1) + (s2 + s3);
+#endif
+    for (; i < n; ++i) sum += a[i] * b[i];
+    return sum;
+}
+
+} // namespace
+
+// ---------------------------------------------------------------------------
+// Cache
+// ---------------------------------------------------------------------------
+
+std::shared_ptr<const Resampler> Resampler::get(int in_rate, int out_rate) {
+    if (in_rate <= 0 || out_rate <= 0) return nullptr;
+
+    static std::mutex mu;
+    static std::map<std::pair<int, int>, std::shared_ptr<const Resampler>> cache;
+
+    std::lock_guard<std::mutex> lock(mu);
+    auto& slot = cache[{in_rate, out_rate}];
+    if (!slot) {
+        slot = std::make_shared<const Resampler>(in_rate, out_rate);
+    }
+    return slot;
+}
+
+// ---------------------------------------------------------------------------
+// Filter design
+// ---------------------------------------------------------------------------
+
+Resampler::Resampler(int in_rate, int out_rate)
+    : in_rate_(in_rate), out_rate_(out_rate) {
+    const int g = std::gcd(in_rate, out_rate);
+    up_   = static_cast<size_t>(out_rate / g);
+    down_ = static_cast<size_t>(in_rate / g);
+
+    // Cutoff relative to the input Nyquist: below the output Nyquist when
+    // downsampling, the input Nyquist when upsampling.
+    const double fc = kCutoff * std::min(1.0, static_cast<double>(up_) / static_cast<double>(down_));
+    half_taps_ = static_cast<size_t>(std::ceil(kZeroCrossings / fc));
+
+    const size_t n_taps = 2 * half_taps_;
+    taps_.resize(up_ * n_taps);
+    const double w = static_cast<double>(half_taps_);
+    const double i0_beta = bessel_i0(kKaiserBeta);
+
+    for (size_t p = 0; p < up_; ++p) {
+        float* phase = taps_.data() + p * n_taps;
+        const double frac = static_cast<double>(p) / static_cast<double>(up_);
+        double sum = 0.0;
+        for (size_t k = 0; k < n_taps; ++k) {
+            // Distance from the ideal output position, in input samples.
+            const double t = (static_cast<double>(k) - w + 1.0) - frac;
+            const double x = fc * t;
+            const double sinc = std::fabs(x) < 1e-9 ? 1.0 : std::sin(kPi * x) / (kPi * x);
+            const double r = t / w;
+            const double win = std::fabs(r) >= 1.0
+                ? 0.0 : bessel_i0(kKaiserBeta * std::sqrt(1.0 - r * r)) / i0_beta;
+            const double h = fc * sinc * win;
+            phase[k] = static_cast<float>(h);
+            sum += h;
+        }
+        // Unity DC gain for every phase.
+        if (sum != 0.0) {
+            for (size_t k = 0; k < n_taps; ++k) {
+                phase[k] = static_cast<float>(phase[k] / sum);
+            }
+        }
+    }
+}
+
+// ---------------------------------------------------------------------------
+// process
+// ---------------------------------------------------------------------------
+
+size_t Resampler::output_length(size_t count) const {
+    return (count * up_ + down_ - 1) / down_;
+}
+
+std::vector<float> Resampler::process(const float* input, size_t count) const {
+    std::vector<float> out;
+    process(input, count, out);
+    return out;
+}
+
+void Resampler::process(const float* input, size_t count, std::vector<float>& out) const {
+    if (!input || count == 0) {
+        out.clear();
+        return;
+    }
+    if (up_ == down_) {
+        out.assign(input, input + count);
+        return;
+    }
+
+    StageSpan span(Stage::resample);
+    const size_t n_out  = output_length(count);
+    const size_t n_taps = 2 * half_taps_;
+    out.resize(n_out);
+
+    // Output n sits at input position n * M / L: `base` whole samples plus
+    // phase p / L.  Tap k reads input[base - W + 1 + k].
+    size_t base = 0, phase = 0;
+    for (size_t n = 0; n < n_out; ++n) {
+        const float* h = taps_.data() + phase * n_taps;
+        const ptrdiff_t first = static_cast<ptrdiff_t>(base) - static_cast<ptrdiff_t>(half_taps_) + 1;
+
+        if (first >= 0 && static_cast<size_t>(first) + n_taps <= count) {
+            out[n] = dot(input + first, h, n_taps);
+        } else {
+            // Edges: samples outside the buffer count as silence.
+            const size_t k0 = first < 0 ? static_cast<size_t>(-first) : 0;
+            const size_t k1 = std::min(n_taps, static_cast<size_t>(static_cast<ptrdiff_t>(count) - first));
+            out[n] = k1 > k0 ? dot(input + first + static_cast<ptrdiff_t>(k0), h + k0, k1 - k0) : 0.0f;
+        }
+
+        phase += down_;
+        base  += phase / up_;
+        phase %= up_;
+    }
+}
+
+} // namespace vr
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+namespace vr {
+
+/// Polyphase windowed-sinc resampler for mono float32 PCM.
+///
+/// The filter bank for a rate pair is designed once and cached; get()
+/// hands out the shared, immutable instance, so every caller converting
+/// 48 kHz → 16 kHz reuses the same taps.  process() is stateless (whole
+/// buffers, zero-padded at both ends) and safe to call concurrently.
+class Resampler {
+public:
+    /// Cached resampler for `in_rate` → `out_rate`.  Returns nullptr for
+    /// non-positive rates.  Thread-safe.
+    static std::shared_ptr<const Resampler> get(int in_rate, int out_rate);
+
+    /// Resample `count` samples into `out` (resized to output_length()).
+    /// When the rates are equal this is a plain copy — callers on the
+    /// 16 kHz fast path should skip the call entirely.
+    void process(const float* input, size_t count, std::vector<float>& out) const;
+
+    std::vector<float> process(const float* input, size_t count) const;
+
+    /// Number of output samples for `count` input samples.
+    size_t output_length(size_t count) const;
+
+    int in_rate() const { return in_rate_; }
+    int out_rate() const { return out_rate_; }
+
+    /// Zero crossings of the sinc kept on each side of the centre tap.
+    static constexpr int kZeroCrossings = 16;
+
+    // Use get().
+    Resampler(int in_rate, int out_rate);
+
+private:
+    int    in_rate_;
+    int    out_rate_;
+    size_t up_;          // L: interpolation factor (out_rate / gcd)
+    size_t down_;        // M: decimation factor (in_rate / gcd)
+    size_t half_taps_;   // W: taps each side; every phase has 2W taps
+
+    /// up_ phases of 2W taps each, phase-major.  Phase p, tap k weights
+    /// input sample (base - W + 1 + k) for outputs whose ideal position
+    /// lies p/up_ past `base`.
+    std::vector<float> taps_;
+};
+
+} // namespace vr
@@ -0,0 +1,130 @@
+#include "SampleFormat.hpp"
+
+#include <cstring>
+
+#if defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#define VR_FORMAT_NEON 1
+#endif
+
+namespace vr {
+
+using detail::convert_scalar;
+
+// ---------------------------------------------------------------------------
+// Float -> float
+// ---------------------------------------------------------------------------
+
+template <>
+void FormatKernel<SampleType::f32, SampleType::f32, 1, Interleaving::interleaved>::run(
+    const uint8_t* const* planes, size_t frames, float* dst) {
+    std::memcpy(dst, planes[0], frames * sizeof(float));
+}
+
+template <>
+void FormatKernel<SampleType::f32, SampleType::f32, 1, Interleaving::planar>::run(
+    const uint8_t* const* planes, size_t frames, float* dst) {
+    std::memcpy(dst, planes[0], frames * sizeof(float));
+}
+
+template <>
+void FormatKernel<SampleType::f32, SampleType::f32, 2, Interleaving::interleaved>::run(
+    const uint8_t* const* planes, size_t frames, float* dst) {
+    size_t i = 0;
+#if VR_FORMAT_NEON
+    const auto* x = reinterpret_cast<const float*>(planes[0]);
+    const float32x4_t half = vdupq_n_f32(0.5f);
+    for (; i + 4 <= frames; i += 4) {
+        const float32x4x2_t lr = vld2q_f32(x + 2 * i);   // deinterleave L/R
+        vst1q_f32(dst + i, vmulq_f32(vaddq_f32(lr.val[0], lr.val[1]), half));
+    }
+#endif
+    convert_scalar<SampleType::f32, SampleType::f32, 2, Interleaving::interleaved>(
+        planes, i, frames, dst);
+}
+
+template <>
+void FormatKernel<SampleType::f32, SampleType::f32, 2, Interleaving::planar>::run(
+    const uint8_t* const* planes, size_t frames, float* dst) {
+    size_t i = 0;
+#if VR_FORMAT_NEON
+    const auto* l = reinterpret_cast<const float*>(planes[0]);
+    const auto* r = reinterpret_cast<const float*>(planes[1]);
+    const float32x4_t half = vdupq_n_f32(0.5f);
+    for (; i + 8 <= frames; i += 8) {
+        const float32x4_t a = vaddq_f32(vld1q_f32(l + i),     vld1q_f32(r + i));
+        const float32x4_t b = vaddq_f32(vld1q_f32(l + i + 4), vld1q_f32(r + i + 4));
+        vst1q_f32(dst + i,     vmulq_f32(a, half));
+        vst1q_f32(dst + i + 4, vmulq_f32(b, half));
+    }
+#endif
+    convert_scalar<SampleType::f32, SampleType::f32, 2, Interleaving::planar>(
+        planes, i, frames, dst);
+}
+
+// ---------------------------------------------------------------------------
+// Int16 -> float
+// ---------------------------------------------------------------------------
+
+template <>
+void FormatKernel<SampleType::s16, SampleType::f32, 1, Interleaving::interleaved>::run(
+    const uint8_t* const* planes, size_t frames, float* dst) {
+    size_t i = 0;
+#if VR_FORMAT_NEON
+    const auto* x = reinterpret_cast<const int16_t*>(planes[0]);
+    const float32x4_t scale = vdupq_n_f32(1.0f / 32768.0f);
+    for (; i + 8 <= frames; i += 8) {
+        const int16x8_t v = vld1q_s16(x + i);
+        vst1q_f32(dst + i,     vmulq_f32(vcvtq_f32_s32(vmovl_s16(vget_low_s16(v))), scale));
+        vst1q_f32(dst + i + 4, vmulq_f32(vcvtq_f32_s32(vmovl_high_s16(v)), scale));
+    }
+#endif
+    convert_scalar<SampleType::s16, SampleType::f32, 1, Interleaving::interleaved>(
+        planes, i, frames, dst);
+}
+
+template <>
+void FormatKernel<SampleType::s16, SampleType::f32, 2, Interleaving::interleaved>::run(
+    const uint8_t* const* planes, size_t frames, float* dst) {
+    size_t i = 0;
+#if VR_FORMAT_NEON
+    const auto* x = reinterpret_cast<const int16_t*>(planes[0]);
+    // Sum in int32 (no overflow), then one multiply does both the /32768
+    // and the /2 of the average.
+    const float32x4_t scale = vdupq_n_f32(0.5f / 32768.0f);
+    for (; i + 8 <= frames; i += 8) {
+        const int16x8x2_t lr = vld2q_s16(x + 2 * i);
+        const int32x4_t lo = vaddl_s16(vget_low_s16(lr.val[0]), vget_low_s16(lr.val[1]));
+        const int32x4_t hi = vaddl_high_s16(lr.val[0], lr.val[1]);
+        vst1q_f32(dst + i,     vmulq_f32(vcvtq_f32_s32(lo), scale));
+        vst1q_f32(dst + i + 4, vmulq_f32(vcvtq_f32_s32(hi), scale));
+    }
+#endif
+    convert_scalar<SampleType::s16, SampleType::f32, 2, Interleaving::interleaved>(
+        planes, i, frames, dst);
+}
+
+// ---------------------------------------------------------------------------
+// Float -> int16
+// ---------------------------------------------------------------------------
+
+template <>
+void FormatKernel<SampleType::f32, SampleType::s16, 1, Interleaving::interleaved>::run(
+    const uint8_t* const* planes, size_t frames, int16_t* dst) {
+    size_t i = 0;
+#if VR_FORMAT_NEON
+    const auto* x = reinterpret_cast<const float*>(planes[0]);
+    const float32x4_t scale = vdupq_n_f32(32767.0f);
+    for (; i + 8 <= frames; i += 8) {
+        // vcvtaq rounds half away from zero (as std::round); vqmovn
+        // saturates to the int16 range, which is the clip.
+        const int32x4_t a = vcvtaq_s32_f32(vmulq_f32(vld1q_f32(x + i), scale));
+        const int32x4_t b = vcvtaq_s32_f32(vmulq_f32(vld1q_f32(x + i + 4), scale));
+        vst1q_s16(dst + i, vcombine_s16(vqmovn_s32(a), vqmovn_s32(b)));
+    }
+#endif
+    convert_scalar<SampleType::f32, SampleType::s16, 1, Interleaving::interleaved>(
+        planes, i, frames, dst);
+}
+
+} // namespace vr
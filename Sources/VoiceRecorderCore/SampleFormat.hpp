@@ -0,0 +1,116 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+namespace vr {
+
+/// Sample types the conversion kernels read and write.
+enum class SampleType {
+    s16,   // int16, full scale 32768
+    f32,   // float in [-1, 1]
+};
+
+/// How a multi-channel buffer is laid out: one plane with the channels
+/// interleaved frame by frame, or one plane per channel (FFmpeg's "P"
+/// formats).  The two are identical for mono.
+enum class Interleaving {
+    interleaved,
+    planar,
+};
+
+template <SampleType T> struct SampleTraits;
+template <> struct SampleTraits<SampleType::s16> { using type = int16_t; };
+template <> struct SampleTraits<SampleType::f32> { using type = float; };
+
+template <SampleType T>
+using sample_t = typename SampleTraits<T>::type;
+
+/// Converts `Channels` channels of `Src` in `Layout` to mono `Dst`, mixing
+/// channels down by averaging them.  Int16 reads as x / 32768 (as
+/// libswresample does) and float writes to int16 as round(x * 32767),
+/// clipped.
+///
+/// The primary template is a scalar loop the compiler specialises for each
+/// combination; the ones on the capture and decode paths — mono copy,
+/// stereo downmix, int16 <-> float — are specialised in SampleFormat.cpp
+/// with NEON bodies on Apple Silicon.  Either way the format, channel
+/// count and layout are fixed at compile time, so there is no per-sample
+/// dispatch and nothing to set up per buffer.
+template <SampleType Src, SampleType Dst, int Channels, Interleaving Layout>
+struct FormatKernel {
+    static_assert(Channels >= 1, "at least one channel");
+
+    /// Convert `frames` frames.  `planes` holds one pointer per channel
+    /// when planar, otherwise just planes[0] — the shape of an AVFrame's
+    /// extended_data.
+    static void run(const uint8_t* const* planes, size_t frames, sample_t<Dst>* dst);
+};
+
+namespace detail {
+
+inline float to_float(float x) { return x; }
+inline float to_float(int16_t x) { return static_cast<float>(x) * (1.0f / 32768.0f); }
+
+template <SampleType Dst>
+inline sample_t<Dst> from_float(float x);
+
+template <>
+inline float from_float<SampleType::f32>(float x) { return x; }
+
+template <>
+inline int16_t from_float<SampleType::s16>(float x) {
+    const float scaled = std::round(x * 32767.0f);
+    return static_cast<int16_t>(std::min(32767.0f, std::max(-32768.0f, scaled)));
+}
+
+/// Scalar body shared by the primary template and the tails of the
+/// vectorised specialisations: frames [begin, end).
+template <SampleType Src, SampleType Dst, int Channels, Interleaving Layout>
+inline void convert_scalar(const uint8_t* const* planes, size_t begin, size_t end,
+                           sample_t<Dst>* dst) {
+    using S = sample_t<Src>;
+    for (size_t i = begin; i < end; ++i) {
+        float acc = 0.0f;
+        for (int c = 0; c < Channels; ++c) {
+            if (Layout == Interleaving::planar) {
+                acc += to_float(reinterpret_cast<const S*>(planes[c])[i]);
+            } else {
+                acc += to_float(reinterpret_cast<const S*>(planes[0])[i * Channels + c]);
+            }
+        }
+        dst[i] = from_float<Dst>(Channels == 1 ? acc : acc * (1.0f / Channels));
+    }
+}
+
+} // namespace detail
+
+template <SampleType Src, SampleType Dst, int Channels, Interleaving Layout>
+void FormatKernel<Src, Dst, Channels, Layout>::run(const uint8_t* const* planes, size_t frames,
+                                                   sample_t<Dst>* dst) {
+    detail::convert_scalar<Src, Dst, Channels, Layout>(planes, 0, frames, dst);
+}
+
+// Specialised in SampleFormat.cpp (NEON on aarch64, scalar elsewhere).
+template <> void FormatKernel<SampleType::f32, SampleType::f32, 1, Interleaving::interleaved>::run(
+    const uint8_t* const*, size_t, float*);
+template <> void FormatKernel<SampleType::f32, SampleType::f32, 1, Interleaving::planar>::run(
+    const uint8_t* const*, size_t, float*);
+template <> void FormatKernel<SampleType::f32, SampleType::f32, 2, Interleaving::interleaved>::run(
+    const uint8_t* const*, size_t, float*);
+template <> void FormatKernel<SampleType::f32, SampleType::f32, 2, Interleaving::planar>::run(
+    const uint8_t* const*, size_t, float*);
+template <> void FormatKernel<SampleType::s16, SampleType::f32, 1, Interleaving::interleaved>::run(
+    const uint8_t* const*, size_t, float*);
+template <> void FormatKernel<SampleType::s16, SampleType::f32, 2, Interleaving::interleaved>::run(
+    const uint8_t* const*, size_t, float*);
+template <> void FormatKernel<SampleType::f32, SampleType::s16, 1, Interleaving::interleaved>::run(
+    const uint8_t* const*, size_t, int16_t*);
+
+/// Signature shared by every kernel producing mono float, for callers that
+/// pick one from a decoder's runtime format once per stream.
+using DownmixKernel = void (*)(const uint8_t* const* planes, size_t frames, float* dst);
+
+} // namespace vr
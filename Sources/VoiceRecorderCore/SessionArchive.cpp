@@ -0,0 +1,586 @@
+#include "SessionArchive.hpp"
+
+#include "AudioCodec.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace vr {
+
+namespace {
+
+constexpr uint32_t kFormatVersion = 1;
+
+/// RIFF sizes are 32-bit; leave room for the index after the payload.
+constexpr uint64_t kMaxPayloadBytes = 0xFFFFFFFFull - (64ull << 20);
+
+// ---------------------------------------------------------------------------
+// Little-endian serialisation
+// ---------------------------------------------------------------------------
+
+class ByteWriter {
+public:
+    void tag(const char* id) { bytes_.insert(bytes_.end(), id, id + 4); }
+    void u8(uint8_t v)   { bytes_.push_back(v); }
+    void u16(uint16_t v) { put(v, 2); }
+    void u32(uint32_t v) { put(v, 4); }
+    void u64(uint64_t v) { put(v, 8); }
+    void i32(int32_t v)  { put(static_cast<uint32_t>(v), 4); }
+    void i64(int64_t v)  { put(static_cast<uint64_t>(v), 8); }
+    void f32(float v) {
+        uint32_t bits;
+        std::memcpy(&bits, &v, sizeof(bits));
+        put(bits, 4);
+    }
+    void str(const std::string& s) {
+        u32(static_cast<uint32_t>(s.size()));
+        bytes_.insert(bytes_.end(), s.begin(), s.end());
+    }
+
+    /// Overwrite a u32 written earlier at byte `offset`.
+    void patch_u32(size_t offset, uint32_t v) {
+        for (int i = 0; i < 4; ++i) bytes_[offset + i] = static_cast<uint8_t>(v >> (8 * i));
+    }
+
+    const uint8_t* data() const { return bytes_.data(); }
+    size_t size() const { return bytes_.size(); }
+
+private:
+    void put(uint64_t v, int n) {
+        for (int i = 0; i < n; ++i) bytes_.push_back(static_cast<uint8_t>(v >> (8 * i)));
+    }
+
+    std::vector<uint8_t> bytes_;
+};
+
+/// Bounds-checked cursor over mapped bytes.  A read past the end yields
+/// zeros and clears ok(), so a parser can check once at the end.
+class ByteReader {
+public:
+    ByteReader(const uint8_t* data, size_t size) : data_(data), size_(size) {}
+
+    uint16_t u16() { return static_cast<uint16_t>(get(2)); }
+    uint32_t u32() { return static_cast<uint32_t>(get(4)); }
+    uint64_t u64() { return get(8); }
+    int32_t  i32() { return static_cast<int32_t>(get(4)); }
+    int64_t  i64() { return static_cast<int64_t>(get(8)); }
+    float f32() {
+        const uint32_t bits = u32();
+        float v;
+        std::memcpy(&v, &bits, sizeof(v));
+        return v;
+    }
+    std::string str() {
+        const uint32_t n = u32();
+        if (!ok_ || n > size_ - pos_) {
+            ok_ = false;
+            return {};
+        }
+        std::string s(reinterpret_cast<const char*>(data_ + pos_), n);
+        pos_ += n;
+        return s;
+    }
+
+    size_t remaining() const { return size_ - pos_; }
+    bool ok() const { return ok_; }
+
+private:
+    uint64_t get(int n) {
+        if (!ok_ || static_cast<size_t>(n) > size_ - pos_) {
+            ok_ = false;
+            return 0;
+        }
+        uint64_t v = 0;
+        for (int i = 0; i < n; ++i) v |= static_cast<uint64_t>(data_[pos_ + i]) << (8 * i);
+        pos_ += static_cast<size_t>(n);
+        return v;
+    }
+
+    const uint8_t* data_;
+    size_t         size_;
+    size_t         pos_ = 0;
+    bool           ok_ = true;
+};
+
+uint32_t load_u32(const uint8_t* p) {
+    return static_cast<uint32_t>(p[0]) | static_cast<uint32_t>(p[1]) << 8 |
+           static_cast<uint32_t>(p[2]) << 16 | static_cast<uint32_t>(p[3]) << 24;
+}
+
+bool is_tag(const uint8_t* p, const char* id) {
+    return std::memcmp(p, id, 4) == 0;
+}
+
+/// Sample count from a FLAC stream's STREAMINFO block (which the muxer
+/// patches on close); 0 if the stream doesn't record it.
+uint64_t flac_total_samples(const uint8_t* data, size_t size) {
+    // "fLaC", a 4-byte block header (type 0 = STREAMINFO), then 34 bytes;
+    // the 36-bit total starts in the low nibble of STREAMINFO byte 13.
+    if (size < 8 + 18 || !is_tag(data, "fLaC") || (data[4] & 0x7F) != 0) return 0;
+    const uint8_t* info = data + 8;
+    return static_cast<uint64_t>(info[13] & 0x0F) << 32 |
+           static_cast<uint64_t>(info[14]) << 24 | static_cast<uint64_t>(info[15]) << 16 |
+           static_cast<uint64_t>(info[16]) << 8  | static_cast<uint64_t>(info[17]);
+}
+
+constexpr size_t kIndexEntryBytes = 4 + 8 * 5;
+
+} // namespace
+
+// ---------------------------------------------------------------------------
+// SessionArchiveWriter
+// ---------------------------------------------------------------------------
+
+SessionArchiveWriter::SessionArchiveWriter(std::string path, ChunkCodec codec)
+    : path_(std::move(path)), partial_path_(path_ + ".partial"), codec_(codec) {}
+
+SessionArchiveWriter::~SessionArchiveWriter() {
+    if (file_) fclose(file_);
+    if (!finished_) std::remove(partial_path_.c_str());
+}
+
+bool SessionArchiveWriter::write(const void* data, size_t size) {
+    if (fwrite(data, 1, size, file_) != size) {
+        fprintf(stderr, "[SessionArchive] write to %s failed: %s\n",
+                partial_path_.c_str(), strerror(errno));
+        return false;
+    }
+    return true;
+}
+
+bool SessionArchiveWriter::open() {
+    if (codec_ != ChunkCodec::pcm_f32 && codec_ != ChunkCodec::flac_s16) {
+        fprintf(stderr, "[SessionArchive] unsupported archive codec %s\n", codec_to_string(codec_));
+        return false;
+    }
+
+    file_ = fopen(partial_path_.c_str(), "wb");
+    if (!file_) {
+        fprintf(stderr, "[SessionArchive] cannot create %s: %s\n",
+                partial_path_.c_str(), strerror(errno));
+        return false;
+    }
+
+    const bool pcm = codec_ == ChunkCodec::pcm_f32;
+    ByteWriter header;
+    header.tag("RIFF");
+    header.u32(0);                                // patched in finish()
+    header.tag(pcm ? "WAVE" : "VRSA");
+    if (pcm) {
+        header.tag("fmt ");
+        header.u32(16);
+        header.u16(3);                            // WAVE_FORMAT_IEEE_FLOAT
+        header.u16(1);                            // mono
+        header.u32(SessionArchive::kSampleRate);
+        header.u32(SessionArchive::kSampleRate * sizeof(float));
+        header.u16(sizeof(float));                // block align
+        header.u16(32);                           // bits per sample
+    }
+    payload_header_ = static_cast<long>(header.size());
+    header.tag(pcm ? "data" : "vrsd");
+    header.u32(0);                                // patched in finish()
+    return write(header.data(), header.size());
+}
+
+bool SessionArchiveWriter::add_chunk(const ChunkView& chunk) {
+    if (!file_) return false;
+
+    ArchiveChunk entry;
+    entry.chunk_index   = chunk.chunk_index;
+    entry.duration_ms   = chunk.duration_ms;
+    entry.sample_offset = total_samples_;
+    entry.byte_offset   = payload_bytes_;
+
+    const uint8_t* bytes = chunk.data;
+    size_t size = chunk.data ? chunk.size : 0;
+    std::vector<uint8_t> encoded;
+
+    try {
+        if (size == 0) {
+            // Nothing stored for this chunk; keep its slot in the timeline.
+        } else if (chunk.codec == codec_ && codec_ == ChunkCodec::pcm_f32) {
+            entry.sample_count = size / sizeof(float);
+            size = entry.sample_count * sizeof(float);
+        } else if (chunk.codec == codec_) {
+            // Same codec: copy the stream, reading its length from the header.
+            entry.sample_count = flac_total_samples(bytes, size);
+            if (entry.sample_count == 0) {
+                AudioCodec::decode(bytes, size, chunk.codec, scratch_);
+                entry.sample_count = scratch_.size();
+            }
+        } else {
+            const float* pcm = reinterpret_cast<const float*>(chunk.data);
+            size_t count = size / sizeof(float);
+            if (chunk.codec != ChunkCodec::pcm_f32) {
+                AudioCodec::decode(bytes, size, chunk.codec, scratch_);
+                pcm   = scratch_.data();
+                count = scratch_.size();
+            }
+            entry.sample_count = count;
+            if (codec_ == ChunkCodec::pcm_f32) {
+                bytes = reinterpret_cast<const uint8_t*>(pcm);
+                size  = count * sizeof(float);
+            } else {
+                encoded = AudioCodec::encode(pcm, count, codec_);
+                bytes = encoded.data();
+                size  = encoded.size();
+            }
+        }
+    } catch (const std::exception& e) {
+        fprintf(stderr, "[SessionArchive] transcoding chunk %d from %s failed: %s\n",
+                chunk.chunk_index, codec_to_string(chunk.codec), e.what());
+        return false;
+    }
+
+    if (payload_bytes_ + size > kMaxPayloadBytes) {
+        fprintf(stderr, "[SessionArchive] %s would exceed the 4 GiB RIFF limit\n", path_.c_str());
+        return false;
+    }
+    if (size > 0 && !write(bytes, size)) return false;
+
+    entry.byte_size = size;
+    payload_bytes_ += size;
+    total_samples_ += entry.sample_count;
+    chunks_.push_back(entry);
+    return true;
+}
+
+bool SessionArchiveWriter::finish(const ArchiveMetadata& metadata) {
+    if (!file_) return false;
+
+    // RIFF chunks start on even offsets.
+    if (payload_bytes_ & 1) {
+        const uint8_t pad = 0;
+        if (!write(&pad, 1)) return false;
+    }
+
+    ByteWriter index;
+    index.tag("vrsx");
+    index.u32(0);                                 // patched below
+    index.u32(kFormatVersion);
+    index.str(codec_to_string(codec_));
+    index.u32(SessionArchive::kSampleRate);
+    index.u32(static_cast<uint32_t>(chunks_.size()));
+    index.u64(total_samples_);
+    for (const ArchiveChunk& c : chunks_) {
+        index.i32(c.chunk_index);
+        index.i64(c.duration_ms);
+        index.u64(c.sample_offset);
+        index.u64(c.sample_count);
+        index.u64(c.byte_offset);
+        index.u64(c.byte_size);
+    }
+
+    const RecordingSession& s = metadata.session;
+    index.str(s.id);
+    index.i64(s.created_at);
+    index.i64(s.completed_at);
+    index.str(status_to_string(s.status));
+    index.i64(s.duration_ms);
+    index.u32(static_cast<uint32_t>(s.transcript_version));
+    index.str(s.transcript);
+    index.u32(static_cast<uint32_t>(metadata.segments.size()));
+    for (const TranscriptSegment& seg : metadata.segments) {
+        index.i64(seg.t0_ms);
+        index.i64(seg.t1_ms);
+        index.f32(seg.avg_prob);
+        index.i32(seg.chunk_index);
+        index.str(seg.text);
+    }
+
+    const size_t index_bytes = index.size() - 8;
+    index.patch_u32(4, static_cast<uint32_t>(index_bytes));
+    if (index_bytes & 1) index.u8(0);             // alignment, not counted in the size
+    if (!write(index.data(), index.size())) return false;
+
+    const long end = ftell(file_);
+    if (end < 0 || static_cast<uint64_t>(end) - 8 > 0xFFFFFFFFull) {
+        fprintf(stderr, "[SessionArchive] %s would exceed the 4 GiB RIFF limit\n", path_.c_str());
+        return false;
+    }
+
+    uint8_t size_bytes[4];
+    auto patch = [&](long offset, uint32_t value) {
+        for (int i = 0; i < 4; ++i) size_bytes[i] = static_cast<uint8_t>(value >> (8 * i));
+        return fseek(file_, offset, SEEK_SET) == 0 && write(size_bytes, 4);
+    };
+    if (!patch(4, static_cast<uint32_t>(end - 8)) ||
+        !patch(payload_header_ + 4, static_cast<uint32_t>(payload_bytes_))) {
+        return false;
+    }
+
+    // Durable before it replaces anything: the database will point at it.
+    const bool synced = fflush(file_) == 0 && fsync(fileno(file_)) == 0;
+    const bool closed = fclose(file_) == 0;
+    file_ = nullptr;
+    if (!synced || !closed) {
+        fprintf(stderr, "[SessionArchive] flushing %s failed: %s\n",
+                partial_path_.c_str(), strerror(errno));
+        return false;
+    }
+    if (std::rename(partial_path_.c_str(), path_.c_str()) != 0) {
+        fprintf(stderr, "[SessionArchive] rename to %s failed: %s\n",
+                path_.c_str(), strerror(errno));
+        return false;
+    }
+
+    finished_ = true;
+    return true;
+}
+
+// ---------------------------------------------------------------------------
+// SessionArchive
+// ---------------------------------------------------------------------------
+
+SessionArchive::SessionArchive(std::string path) : path_(std::move(path)) {}
+
+SessionArchive::~SessionArchive() {
+    if (map_) munmap(const_cast<uint8_t*>(map_), map_size_);
+}
+
+bool SessionArchive::open() {
+    if (map_) return true;
+
+    const int fd = ::open(path_.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        fprintf(stderr, "[SessionArchive] cannot open %s: %s\n", path_.c_str(), strerror(errno));
+        return false;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size < 12) {
+        ::close(fd);
+        fprintf(stderr, "[SessionArchive] %s is not a session archive\n", path_.c_str());
+        return false;
+    }
+
+    void* mapped = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);   // the mapping keeps the file open
+    if (mapped == MAP_FAILED) {
+        fprintf(stderr, "[SessionArchive] mmap of %s failed: %s\n", path_.c_str(), strerror(errno));
+        return false;
+    }
+    map_      = static_cast<const uint8_t*>(mapped);
+    map_size_ = static_cast<size_t>(st.st_size);
+
+    if (!parse()) {
+        fprintf(stderr, "[SessionArchive] %s is not a valid session archive\n", path_.c_str());
+        munmap(mapped, map_size_);
+        map_ = nullptr;
+        map_size_ = 0;
+        chunks_.clear();
+        return false;
+    }
+    return true;
+}
+
+bool SessionArchive::parse() {
+    if (!is_tag(map_, "RIFF")) return false;
+    const bool wave = is_tag(map_ + 8, "WAVE");
+    if (!wave && !is_tag(map_ + 8, "VRSA")) return false;
+
+    // Walk the top-level chunks.  The RIFF size field is not trusted; the
+    // file length bounds everything.
+    const uint8_t* fmt   = nullptr;
+    size_t         fmt_size = 0;
+    const uint8_t* index = nullptr;
+    size_t         index_size = 0;
+    bool           data_chunk = false;
+    for (size_t pos = 12; pos + 8 <= map_size_;) {
+        const uint8_t* id   = map_ + pos;
+        const size_t   size = load_u32(map_ + pos + 4);
+        const size_t   body = pos + 8;
+        if (size > map_size_ - body) return false;
+
+        if (is_tag(id, "fmt ")) {
+            fmt = map_ + body;
+            fmt_size = size;
+        } else if (is_tag(id, "data") || is_tag(id, "vrsd")) {
+            payload_      = map_ + body;
+            payload_size_ = size;
+            data_chunk    = is_tag(id, "data");
+        } else if (is_tag(id, "vrsx")) {
+            index = map_ + body;
+            index_size = size;
+        }
+        pos = body + size + (size & 1);
+    }
+    if (!payload_ || !index) return false;
+
+    ByteReader r(index, index_size);
+    const uint32_t version = r.u32();
+    if (version != kFormatVersion) {
+        fprintf(stderr, "[SessionArchive] %s has format version %u (expected %u)\n",
+                path_.c_str(), version, kFormatVersion);
+        return false;
+    }
+    const std::string codec = r.str();
+    codec_ = codec_from_string(codec);
+    sample_rate_ = static_cast<int>(r.u32());
+    const uint32_t count = r.u32();
+    total_samples_ = r.u64();
+    if (!r.ok() || sample_rate_ <= 0 || count > r.remaining() / kIndexEntryBytes) return false;
+
+    // The payload codec must agree with the container.
+    const bool pcm = codec_ == ChunkCodec::pcm_f32;
+    if (pcm != (wave && data_chunk) || (!pcm && codec_ != ChunkCodec::flac_s16)) return false;
+    if (codec != codec_to_string(codec_)) return false;
+    if (pcm) {
+        ByteReader f(fmt, fmt ? fmt_size : 0);
+        const uint16_t format   = f.u16();
+        const uint16_t channels = f.u16();
+        const uint32_t rate     = f.u32();
+        f.u32();
+        f.u16();
+        const uint16_t bits     = f.u16();
+        if (!f.ok() || format != 3 || channels != 1 || bits != 32 ||
+            rate != static_cast<uint32_t>(sample_rate_) ||
+            reinterpret_cast<uintptr_t>(payload_) % alignof(float) != 0) {
+            return false;
+        }
+    }
+
+    chunks_.resize(count);
+    uint64_t next_sample = 0;
+    for (ArchiveChunk& c : chunks_) {
+        c.chunk_index   = r.i32();
+        c.duration_ms   = r.i64();
+        c.sample_offset = r.u64();
+        c.sample_count  = r.u64();
+        c.byte_offset   = r.u64();
+        c.byte_size     = r.u64();
+        if (c.sample_offset != next_sample ||
+            c.byte_offset > payload_size_ || c.byte_size > payload_size_ - c.byte_offset) {
+            return false;
+        }
+        if (pcm && (c.byte_offset != c.sample_offset * sizeof(float) ||
+                    c.byte_size != c.sample_count * sizeof(float))) {
+            return false;
+        }
+        next_sample += c.sample_count;
+    }
+    if (next_sample != total_samples_) return false;
+
+    RecordingSession& s = metadata_.session;
+    s.id           = r.str();
+    s.created_at   = r.i64();
+    s.completed_at = r.i64();
+    s.status       = status_from_string(r.str());
+    s.duration_ms  = r.i64();
+    s.transcript_version = r.u32() == static_cast<uint32_t>(TranscriptVersion::refined)
+                               ? TranscriptVersion::refined : TranscriptVersion::draft;
+    s.transcript   = r.str();
+    const uint32_t segments = r.u32();
+    if (!r.ok() || segments > r.remaining() / (8 + 8 + 4 + 4 + 4)) return false;
+    metadata_.segments.resize(segments);
+    for (TranscriptSegment& seg : metadata_.segments) {
+        seg.t0_ms       = r.i64();
+        seg.t1_ms       = r.i64();
+        seg.avg_prob    = r.f32();
+        seg.chunk_index = r.i32();
+        seg.text        = r.str();
+    }
+    return r.ok();
+}
+
+std::vector<ChunkSpan> SessionArchive::spans() const {
+    std::vector<ChunkSpan> spans;
+    spans.reserve(chunks_.size());
+    int64_t start = 0;
+    for (const ArchiveChunk& c : chunks_) {
+        ChunkSpan span;
+        span.chunk_index = c.chunk_index;
+        span.begin_ms    = start;
+        span.end_ms      = start + c.duration_ms;
+        start = span.end_ms;
+        spans.push_back(span);
+    }
+    return spans;
+}
+
+const float* SessionArchive::samples() const {
+    if (!map_ || codec_ != ChunkCodec::pcm_f32) return nullptr;
+    return reinterpret_cast<const float*>(payload_);
+}
+
+ChunkView SessionArchive::chunk(size_t i) const {
+    const ArchiveChunk& c = chunks_.at(i);
+    ChunkView view;
+    view.chunk_index = c.chunk_index;
+    view.data        = payload_ + c.byte_offset;
+    view.size        = static_cast<size_t>(c.byte_size);
+    view.duration_ms = c.duration_ms;
+    view.codec       = codec_;
+    return view;
+}
+
+bool SessionArchive::read_chunk(size_t i, std::vector<float>& out) const {
+    const ArchiveChunk& c = chunks_.at(i);
+    if (const float* pcm = samples()) {
+        out.assign(pcm + c.sample_offset, pcm + c.sample_offset + c.sample_count);
+        return true;
+    }
+    if (c.byte_size == 0) {
+        out.clear();
+        return true;
+    }
+    try {
+        AudioCodec::decode(payload_ + c.byte_offset, static_cast<size_t>(c.byte_size),
+                           codec_, out, sample_rate_);
+    } catch (const std::exception& e) {
+        fprintf(stderr, "[SessionArchive] decode failed for chunk %d of %s: %s\n",
+                c.chunk_index, path_.c_str(), e.what());
+        return false;
+    }
+    return true;
+}
+
+bool SessionArchive::read_pcm(int64_t begin_ms, int64_t end_ms, std::vector<float>& out) const {
+    out.clear();
+    if (!map_) return false;
+
+    auto to_sample = [this](int64_t ms) {
+        return std::min<uint64_t>(static_cast<uint64_t>(std::max<int64_t>(ms, 0)) *
+                                      static_cast<uint64_t>(sample_rate_) / 1000,
+                                  total_samples_);
+    };
+    const uint64_t first = to_sample(begin_ms);
+    const uint64_t last  = end_ms <= 0 ? total_samples_ : to_sample(end_ms);
+    if (first >= last) return true;
+
+    if (const float* pcm = samples()) {
+        // Ask for the whole range up front rather than faulting page by page.
+        const uintptr_t page  = static_cast<uintptr_t>(sysconf(_SC_PAGESIZE));
+        const uintptr_t begin = reinterpret_cast<uintptr_t>(pcm + first) & ~(page - 1);
+        const uintptr_t end   = reinterpret_cast<uintptr_t>(pcm + last);
+        madvise(reinterpret_cast<void*>(begin), end - begin, MADV_WILLNEED);
+        out.assign(pcm + first, pcm + last);
+        return true;
+    }
+
+    out.reserve(static_cast<size_t>(last - first));
+    std::vector<float> decoded;   // one chunk, reused
+    for (size_t i = 0; i < chunks_.size(); ++i) {
+        const ArchiveChunk& c = chunks_[i];
+        const uint64_t chunk_end = c.sample_offset + c.sample_count;
+        if (chunk_end <= first) continue;
+        if (c.sample_offset >= last) break;
+
+        if (!read_chunk(i, decoded)) return false;
+        const uint64_t from = std::max(first, c.sample_offset) - c.sample_offset;
+        const uint64_t to   = std::min<uint64_t>(std::min(last, chunk_end) - c.sample_offset,
+                                                 decoded.size());
+        if (from < to) out.insert(out.end(), decoded.begin() + from, decoded.begin() + to);
+    }
+    return true;
+}
+
+} // namespace vr
@@ -0,0 +1,167 @@
+#pragma once
+
+#include "Types.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+namespace vr {
+
+/// One chunk's entry in a session archive's index.
+struct ArchiveChunk {
+    int32_t  chunk_index   = 0;
+    int64_t  duration_ms   = 0;
+    uint64_t sample_offset = 0;   // First sample, counted from the session start
+    uint64_t sample_count  = 0;   // Decoded length
+    uint64_t byte_offset   = 0;   // Into the payload
+    uint64_t byte_size     = 0;   // Stored (possibly compressed) length
+};
+
+/// Everything an archive carries besides the audio, so an exported session
+/// can be imported on another machine as it was.
+struct ArchiveMetadata {
+    RecordingSession               session{};
+    std::vector<TranscriptSegment> segments;
+};
+
+// ---------------------------------------------------------------------------
+// On-disk format
+// ---------------------------------------------------------------------------
+//
+// A RIFF file, little-endian throughout:
+//
+//   "RIFF" <size> "WAVE"        form type "VRSA" when the payload is encoded
+//   "fmt " IEEE float, mono     pcm_f32 only
+//   "data" <payload>            pcm_f32: the session's samples, contiguous
+//   "vrsd" <payload>            flac_s16: each chunk's FLAC stream, in order
+//   "vrsx" <index>              version, codec, sample rate, chunk count,
+//                               total samples, one ArchiveChunk per chunk,
+//                               then the ArchiveMetadata
+//
+// A pcm_f32 archive is therefore an ordinary float WAV: players open it
+// directly, and mapped reads of any time range touch only that range's
+// pages.  flac_s16 is the compact form for export (about a quarter of the
+// size); reading a range decodes just the chunks it overlaps.
+
+/// Streams a session's chunks into a new archive file.
+///
+/// Writes go to `path` + ".partial", which finish() syncs and renames over
+/// `path`, so a crash or failure never leaves a truncated archive behind.
+class SessionArchiveWriter {
+public:
+    /// `codec` is the payload format: pcm_f32 or flac_s16.
+    SessionArchiveWriter(std::string path, ChunkCodec codec);
+
+    /// Deletes the partial file unless finish() succeeded.
+    ~SessionArchiveWriter();
+
+    // Non-copyable.
+    SessionArchiveWriter(const SessionArchiveWriter&) = delete;
+    SessionArchiveWriter& operator=(const SessionArchiveWriter&) = delete;
+
+    /// Create the partial file and write the headers.  False on failure.
+    bool open();
+
+    /// Append the next chunk.  Stored bytes already in the archive's codec
+    /// are copied verbatim; anything else is decoded and, for flac_s16,
+    /// re-encoded.  False on I/O or codec failure (the archive is then
+    /// unusable; drop the writer).
+    bool add_chunk(const ChunkView& chunk);
+
+    /// Write the index and `metadata`, patch the RIFF sizes, fsync, and
+    /// move the file into place.  False on failure.
+    bool finish(const ArchiveMetadata& metadata);
+
+    const std::vector<ArchiveChunk>& chunks() const { return chunks_; }
+
+private:
+    bool write(const void* data, size_t size);
+
+    std::string               path_;
+    std::string               partial_path_;
+    const ChunkCodec          codec_;
+    FILE*                     file_ = nullptr;
+    bool                      finished_ = false;
+    long                      payload_header_ = 0;   // offset of the payload chunk's id
+    uint64_t                  payload_bytes_  = 0;
+    uint64_t                  total_samples_  = 0;
+    std::vector<ArchiveChunk> chunks_;
+    std::vector<float>        scratch_;              // decoded PCM, reused across chunks
+};
+
+/// Read-only, memory-mapped view of an archive file.
+///
+/// open() maps the whole file but reads only its headers and index, so
+/// opening costs the same for a one-minute note as for an hour-long
+/// meeting; audio pages are faulted in by whatever range is read.  Safe to
+/// read from several threads once open.
+class SessionArchive {
+public:
+    explicit SessionArchive(std::string path);
+    ~SessionArchive();
+
+    // Non-copyable.
+    SessionArchive(const SessionArchive&) = delete;
+    SessionArchive& operator=(const SessionArchive&) = delete;
+
+    /// Map and validate the file.  False (with a log line) if it is
+    /// missing, truncated, or not an archive.
+    bool open();
+
+    const std::string& path() const { return path_; }
+
+    /// Payload codec (pcm_f32 or flac_s16).
+    ChunkCodec codec() const { return codec_; }
+    int sample_rate() const { return sample_rate_; }
+
+    /// True if the file is a plain float WAV any audio player can open.
+    bool playable() const { return codec_ == ChunkCodec::pcm_f32; }
+
+    const ArchiveMetadata& metadata() const { return metadata_; }
+    const std::vector<ArchiveChunk>& chunks() const { return chunks_; }
+
+    /// The chunk index as session time spans (as DatabaseManager::get_chunk_spans).
+    std::vector<ChunkSpan> spans() const;
+
+    uint64_t total_samples() const { return total_samples_; }
+
+    /// The whole session's samples, mapped in place; nullptr unless pcm_f32.
+    /// Valid while the archive is alive.
+    const float* samples() const;
+
+    /// Stored bytes of chunks()[i], pointing into the mapping.
+    ChunkView chunk(size_t i) const;
+
+    /// Decode chunks()[i] to float32 PCM.  False if it fails to decode.
+    bool read_chunk(size_t i, std::vector<float>& out) const;
+
+    /// Decode [begin_ms, end_ms) of the session into `out`; end_ms <= 0
+    /// reads to the end.  Only the overlapping chunks are touched.
+    bool read_pcm(int64_t begin_ms, int64_t end_ms, std::vector<float>& out) const;
+
+    /// File extension used for archives in the archive directory.
+    static constexpr const char* kFileExtension = "vrsession";
+
+    /// Archives are written at the app's single recording rate.
+    static constexpr int kSampleRate = 16000;
+
+private:
+    bool parse();
+
+    std::string               path_;
+    const uint8_t*            map_ = nullptr;
+    size_t                    map_size_ = 0;
+
+    const uint8_t*            payload_ = nullptr;   // into map_
+    uint64_t                  payload_size_ = 0;
+    ChunkCodec                codec_ = ChunkCodec::pcm_f32;
+    int                       sample_rate_ = kSampleRate;
+    uint64_t                  total_samples_ = 0;
+    std::vector<ArchiveChunk> chunks_;
+    ArchiveMetadata           metadata_;
+};
+
+} // namespace vr
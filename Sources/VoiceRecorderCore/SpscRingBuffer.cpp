@@ -0,0 +1,74 @@
+#include "SpscRingBuffer.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+namespace vr {
+
+namespace {
+
+size_t round_up_pow2(size_t n) {
+    size_t p = 1;
+    while (p < n) p <<= 1;
+    return p;
+}
+
+} // namespace
+
+SpscRingBuffer::SpscRingBuffer(size_t min_capacity)
+    : capacity_(round_up_pow2(std::max<size_t>(min_capacity, 2))),
+      mask_(capacity_ - 1),
+      data_(new float[capacity_]()) {}
+
+// ---------------------------------------------------------------------------
+// Producer
+// ---------------------------------------------------------------------------
+
+size_t SpscRingBuffer::write(const float* samples, size_t count) {
+    const size_t head = head_.load(std::memory_order_relaxed);
+    const size_t tail = tail_.load(std::memory_order_acquire);
+
+    const size_t space = capacity_ - (head - tail);
+    const size_t n = std::min(count, space);
+    if (n < count) {
+        dropped_.fetch_add(count - n, std::memory_order_relaxed);
+    }
+    if (n == 0) return 0;
+
+    // At most two memcpys: up to the end of storage, then from the start.
+    const size_t pos   = head & mask_;
+    const size_t first = std::min(n, capacity_ - pos);
+    std::memcpy(data_.get() + pos, samples, first * sizeof(float));
+    std::memcpy(data_.get(), samples + first, (n - first) * sizeof(float));
+
+    head_.store(head + n, std::memory_order_release);
+    return n;
+}
+
+// ---------------------------------------------------------------------------
+// Consumer
+// ---------------------------------------------------------------------------
+
+size_t SpscRingBuffer::read(float* out, size_t count) {
+    const size_t tail = tail_.load(std::memory_order_relaxed);
+    const size_t head = head_.load(std::memory_order_acquire);
+
+    const size_t n = std::min(count, head - tail);
+    if (n == 0) return 0;
+
+    const size_t pos   = tail & mask_;
+    const size_t first = std::min(n, capacity_ - pos);
+    std::memcpy(out, data_.get() + pos, first * sizeof(float));
+    std::memcpy(out + first, data_.get(), (n - first) * sizeof(float));
+
+    tail_.store(tail + n, std::memory_order_release);
+    return n;
+}
+
+size_t SpscRingBuffer::available() const {
+    const size_t head = head_.load(std::memory_order_acquire);
+    const size_t tail = tail_.load(std::memory_order_acquire);
+    return head - tail;
+}
+
+} // namespace vr
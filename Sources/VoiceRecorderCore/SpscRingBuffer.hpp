@@ -0,0 +1,54 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+
+namespace vr {
+
+/// Lock-free single-producer / single-consumer ring of float samples.
+///
+/// Storage is allocated once in the constructor; write() and read() never
+/// allocate, lock or block, so the producer side is safe to call from the
+/// real-time audio thread.  Exactly one thread may write and exactly one
+/// (other) thread may read.
+class SpscRingBuffer {
+public:
+    /// Capacity is rounded up to a power of two (at least `min_capacity`).
+    explicit SpscRingBuffer(size_t min_capacity);
+
+    // Non-copyable.
+    SpscRingBuffer(const SpscRingBuffer&) = delete;
+    SpscRingBuffer& operator=(const SpscRingBuffer&) = delete;
+
+    /// Producer: copy up to `count` samples in.  Returns how many fit; the
+    /// rest are dropped (and counted in dropped()).
+    size_t write(const float* samples, size_t count);
+
+    /// Consumer: copy up to `count` samples out.  Returns how many were read.
+    size_t read(float* out, size_t count);
+
+    /// Samples ready to read.  Exact on the consumer thread, a lower bound
+    /// elsewhere.
+    size_t available() const;
+
+    /// Total samples dropped by write() because the ring was full.
+    size_t dropped() const { return dropped_.load(std::memory_order_relaxed); }
+
+    size_t capacity() const { return capacity_; }
+
+private:
+    // Head and tail on separate cache lines so the two threads don't
+    // false-share.  128 bytes covers Apple Silicon's line size.
+    static constexpr size_t kCacheLine = 128;
+
+    const size_t                capacity_;
+    const size_t                mask_;
+    std::unique_ptr<float[]>    data_;
+
+    alignas(kCacheLine) std::atomic<size_t> head_{0};   // written by producer
+    alignas(kCacheLine) std::atomic<size_t> tail_{0};   // written by consumer
+    alignas(kCacheLine) std::atomic<size_t> dropped_{0};
+};
+
+} // namespace vr
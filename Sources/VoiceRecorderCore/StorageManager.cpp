@@ -1,7 +1,9 @@
 #include "StorageManager.hpp"
 
+#include "AudioCodec.hpp"
+
+#include <cstdio>
 #include <filesystem>
-#include <fstream>
 #include <numeric>
 
 namespace vr {
@@ -80,7 +82,8 @@ std::string StorageManager::start_recording(MeteringCallback meter_cb) {
         db_.add_chunk(session_id,
                       chunk.chunk_index,
                       chunk.audio_data,
-                      chunk.duration_ms);
+                      chunk.duration_ms,
+                      ChunkCodec::m4a);
     };
 
     // Create a per-session chunk directory.
@@ -160,8 +163,19 @@ float StorageManager::get_metering() const {
 
 std::string StorageManager::transcribe_session(const std::string& session_id,
                                                ProgressCallback progress) {
-    // Retrieve all chunks from the database.
-    std::vector<AudioChunk> chunks = db_.get_chunks(session_id);
+    // Copy out the stored (still compressed) blobs; decoding happens below
+    // rather than under the database lock.
+    std::vector<AudioChunk> chunks;
+    db_.for_each_stored_chunk(session_id, [&](const ChunkView& view) {
+        AudioChunk c;
+        c.session_id  = session_id;
+        c.chunk_index = view.chunk_index;
+        c.audio_data.assign(view.data, view.data + view.size);
+        c.duration_ms = view.duration_ms;
+        c.codec       = view.codec;
+        chunks.push_back(std::move(c));
+        return true;
+    });
     if (chunks.empty()) {
         db_.mark_failed(session_id);
         return "";
@@ -180,35 +194,26 @@ std::string StorageManager::transcribe_session(const std::string& session_id,
     for (size_t i = 0; i < chunks.size(); ++i) {
         const auto& chunk = chunks[i];
 
-        // Write chunk blob to a temporary M4A file for the converter.
-        std::string tmp_path = data_dir_ + "/tmp_chunk_" + session_id
-                               + "_" + std::to_string(chunk.chunk_index) + ".m4a";
-        {
-            std::ofstream out(tmp_path, std::ios::binary);
-            if (!out.is_open()) continue;
-            out.write(reinterpret_cast<const char*>(chunk.audio_data.data()),
-                      static_cast<std::streamsize>(chunk.audio_data.size()));
-        }
-
-        // Convert M4A to PCM at 16 kHz for whisper.
-        std::vector<float> pcm = converter_.m4a_to_pcm(tmp_path, 16000);
-
-        // Clean up temp file.
-        std::filesystem::remove(tmp_path);
-
-        if (pcm.empty()) continue;
-
-        // Create a per-chunk progress callback that maps to the overall range.
-        ProgressCallback chunk_progress;
-        if (progress) {
-            float base = static_cast<float>(i) * chunk_weight;
-            chunk_progress = [progress, base, chunk_weight](float p) {
-                progress(base + p * chunk_weight);
-            };
+        // Decode the stored blob (M4A, FLAC or raw) straight from memory.
+        std::string text;
+        try {
+            std::vector<float> pcm = AudioCodec::decode(
+                chunk.audio_data.data(), chunk.audio_data.size(), chunk.codec);
+            if (pcm.empty()) continue;
+
+            // Create a per-chunk progress callback that maps to the overall range.
+            ProgressCallback chunk_progress;
+            if (progress) {
+                float base = static_cast<float>(i) * chunk_weight;
+                chunk_progress = [progress, base, chunk_weight](float p) {
+                    progress(base + p * chunk_weight);
+                };
+            }
+            text = whisper_.transcribe(pcm, 16000, chunk_progress);
+        } catch (const std::exception& e) {
+            fprintf(stderr, "[StorageManager] chunk %d of %s failed: %s\n",
+                    chunk.chunk_index, session_id.c_str(), e.what());
         }
-
-        // Transcribe.
-        std::string text = whisper_.transcribe(pcm, 16000, chunk_progress);
         if (!text.empty()) {
             if (!full_transcript.empty()) {
                 full_transcript += " ";
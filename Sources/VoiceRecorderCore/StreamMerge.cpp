@@ -0,0 +1,120 @@
+#include "StreamMerge.hpp"
+
+#include <algorithm>
+#include <cctype>
+
+namespace vr {
+
+namespace {
+
+/// Words `next` may start with before the repeated suffix (a stray
+/// "and" / "so" whisper decodes at a window boundary).
+constexpr size_t kMaxLeadWords = 2;
+
+/// Remove the first `count` words from `segments`, keeping whisper's
+/// leading-space convention on a partially trimmed segment.
+void drop_words(std::vector<TranscriptSegment>& segments, size_t count) {
+    auto it = segments.begin();
+    while (it != segments.end() && count > 0) {
+        const std::vector<std::string> words = split_words(it->text);
+        if (count >= words.size()) {
+            count -= words.size();
+            it = segments.erase(it);
+            continue;
+        }
+        std::string text;
+        for (size_t w = count; w < words.size(); ++w) {
+            text += ' ';
+            text += words[w];
+        }
+        it->text = std::move(text);
+        count = 0;
+    }
+}
+
+} // namespace
+
+std::vector<std::string> split_words(const std::string& text) {
+    std::vector<std::string> words;
+    size_t i = 0;
+    while (i < text.size()) {
+        while (i < text.size() && std::isspace(static_cast<unsigned char>(text[i]))) ++i;
+        const size_t start = i;
+        while (i < text.size() && !std::isspace(static_cast<unsigned char>(text[i]))) ++i;
+        if (i > start) words.emplace_back(text, start, i - start);
+    }
+    return words;
+}
+
+std::string normalize_word(const std::string& word) {
+    std::string out;
+    out.reserve(word.size());
+    for (char c : word) {
+        const auto u = static_cast<unsigned char>(c);
+        if (u >= 0x80 || std::isalnum(u) || c == '\'') {
+            out += static_cast<char>(std::tolower(u));
+        }
+    }
+    return out;
+}
+
+std::string prompt_tail(const std::string& text, size_t max_words) {
+    const std::vector<std::string> words = split_words(text);
+    const size_t first = words.size() > max_words ? words.size() - max_words : 0;
+    std::string out;
+    for (size_t w = first; w < words.size(); ++w) {
+        if (!out.empty()) out += ' ';
+        out += words[w];
+    }
+    return out;
+}
+
+size_t merge_overlap(const std::string& previous_text,
+                     std::vector<TranscriptSegment>& next,
+                     int64_t overlap_end_ms, size_t max_words) {
+    if (next.empty() || max_words == 0) return 0;
+
+    std::vector<std::string> prev = split_words(previous_text);
+    if (prev.size() > max_words) prev.erase(prev.begin(), prev.end() - max_words);
+    for (auto& w : prev) w = normalize_word(w);
+
+    std::vector<std::string> head;
+    for (const auto& seg : next) {
+        for (auto& w : split_words(seg.text)) {
+            if (head.size() == max_words) break;
+            head.push_back(normalize_word(w));
+        }
+        if (head.size() == max_words) break;
+    }
+
+    // Longest suffix of the previous text that `next` starts with, allowing
+    // up to kMaxLeadWords of boundary noise before it (single words only at
+    // the very start).  Ties go to the match with the least lead.
+    size_t best_end = 0;
+    for (size_t k = std::min(prev.size(), head.size()); k > 0 && best_end == 0; --k) {
+        const size_t first = prev.size() - k;
+        const size_t max_lead = k >= 2 ? kMaxLeadWords : 0;
+        for (size_t j = 0; j <= max_lead && j + k <= head.size(); ++j) {
+            size_t m = 0;
+            while (m < k && !prev[first + m].empty() && prev[first + m] == head[j + m]) ++m;
+            if (m == k) {
+                best_end = j + k;
+                break;
+            }
+        }
+    }
+
+    if (best_end > 0) {
+        drop_words(next, best_end);
+        return best_end;
+    }
+
+    size_t dropped = 0;
+    while (!next.empty() && next.front().t1_ms <= overlap_end_ms) {
+        dropped += split_words(next.front().text).size();
+        next.erase(next.begin());
+    }
+    return dropped;
+}
+
+} // namespace vr
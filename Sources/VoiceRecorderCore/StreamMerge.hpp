@@ -0,0 +1,41 @@
+#pragma once
+
+#include "Types.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace vr {
+
+/// Whitespace-separated words of `text`, in order.
+std::vector<std::string> split_words(const std::string& text);
+
+/// `word` lower-cased with punctuation stripped, for comparing words across
+/// decodes ("Hello," == "hello").  Non-ASCII bytes are kept as is.
+std::string normalize_word(const std::string& word);
+
+/// The last `max_words` words of `text`, space-separated.  Handed to the
+/// next stream window as its prompt so whisper continues the sentence
+/// instead of decoding the boundary cold.
+std::string prompt_tail(const std::string& text, size_t max_words);
+
+/// Drop the words at the start of `next` that repeat the end of
+/// `previous_text` because the two windows overlapped.
+///
+/// Looks for the longest suffix of `previous_text` (at most `max_words`
+/// words, case and punctuation ignored) that `next` starts with, and drops
+/// `next` up to the end of it.  The match is anchored at both ends: it
+/// must run to the last word of the previous text and start within the
+/// first two words of `next` (a single-word match only at the very
+/// start), so a phrase repeated later in the new audio is never taken for
+/// the overlap.  With no match, segments ending by `overlap_end_ms` — audio the previous
+/// window already covered — are dropped instead.  Segments emptied by the
+/// merge are removed.
+/// @return  Number of words dropped.
+size_t merge_overlap(const std::string& previous_text,
+                     std::vector<TranscriptSegment>& next,
+                     int64_t overlap_end_ms, size_t max_words);
+
+} // namespace vr
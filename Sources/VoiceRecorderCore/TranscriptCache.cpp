@@ -0,0 +1,316 @@
+#include "TranscriptCache.hpp"
+#include "StreamMerge.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+#include <utility>
+
+namespace vr {
+
+namespace {
+
+/// Bump when the key inputs or the entry layout change, so old entries
+/// simply stop matching.
+constexpr uint8_t kFormatVersion = 2;
+
+inline uint64_t rotl(uint64_t x, int r) { return (x << r) | (x >> (64 - r)); }
+
+inline uint64_t avalanche(uint64_t x) {
+    x ^= x >> 33;
+    x *= 0xFF51AFD7ED558CCDull;
+    x ^= x >> 33;
+    x *= 0xC4CEB9FE1A85EC53ull;
+    x ^= x >> 33;
+    return x;
+}
+
+/// Two independent 64-bit lanes over 8-byte words: fast enough to hash a
+/// chunk's PCM (2.2 MB) in under a millisecond, and wide enough that
+/// a collision between recordings is not a practical concern.  Not
+/// cryptographic — keys are never taken from untrusted input.
+class Hash128 {
+public:
+    void add(const void* data, size_t size) {
+        const auto* p = static_cast<const uint8_t*>(data);
+        size_t i = 0;
+        for (; i + 8 <= size; i += 8) {
+            uint64_t w;
+            std::memcpy(&w, p + i, 8);
+            mix(w);
+        }
+        if (i < size) {
+            uint64_t w = 0;
+            std::memcpy(&w, p + i, size - i);
+            mix(w ^ (static_cast<uint64_t>(size - i) << 56));
+        }
+        length_ += size;
+    }
+
+    template <typename T>
+    void add_value(const T& v) { add(&v, sizeof(v)); }
+
+    void add_string(const std::string& s) {
+        add_value(static_cast<uint64_t>(s.size()));
+        add(s.data(), s.size());
+    }
+
+    std::string hex() const {
+        const uint64_t a = avalanche(a_ ^ length_);
+        const uint64_t b = avalanche(b_ ^ rotl(length_, 32) ^ a);
+        static const char* digits = "0123456789abcdef";
+        std::string out(32, '0');
+        for (int k = 0; k < 16; ++k) {
+            out[15 - k] = digits[(a >> (4 * k)) & 0xF];
+            out[31 - k] = digits[(b >> (4 * k)) & 0xF];
+        }
+        return out;
+    }
+
+private:
+    void mix(uint64_t w) {
+        a_ = rotl(a_ ^ (w * 0x87C37B91114253D5ull), 31) * 0x4CF5AD432745937Full;
+        b_ = rotl(b_ + (w * 0x9E3779B97F4A7C15ull), 27) * 0xD6E8FEB86659FD93ull + a_;
+    }
+
+    uint64_t a_ = 0x6A09E667F3BCC908ull;
+    uint64_t b_ = 0xBB67AE8584CAA73Bull;
+    uint64_t length_ = 0;
+};
+
+// Little-endian entry encoding.
+void put_u32(std::vector<uint8_t>& out, uint32_t v) {
+    for (int i = 0; i < 4; ++i) out.push_back(static_cast<uint8_t>(v >> (8 * i)));
+}
+
+void put_i64(std::vector<uint8_t>& out, int64_t v) {
+    const auto u = static_cast<uint64_t>(v);
+    for (int i = 0; i < 8; ++i) out.push_back(static_cast<uint8_t>(u >> (8 * i)));
+}
+
+/// Bounds-checked reader over an entry.
+struct Reader {
+    const uint8_t* data;
+    size_t         size;
+    size_t         pos = 0;
+
+    bool take(size_t n, uint64_t& v) {
+        if (size - pos < n) return false;
+        v = 0;
+        for (size_t i = 0; i < n; ++i) v |= static_cast<uint64_t>(data[pos + i]) << (8 * i);
+        pos += n;
+        return true;
+    }
+};
+
+} // namespace
+
+// ---------------------------------------------------------------------------
+// Construction
+// ---------------------------------------------------------------------------
+
+TranscriptCache::TranscriptCache(WhisperEngine& engine, Store store)
+    : engine_(engine), store_(std::move(store)) {}
+
+// ---------------------------------------------------------------------------
+// Keys
+// ---------------------------------------------------------------------------
+
+std::string TranscriptCache::key_for(const float* samples, size_t count, int sample_rate,
+                                     const TranscribeOptions& options,
+                                     const std::string& prompt_source) const {
+    if (!samples || count == 0 || sample_rate <= 0) return {};
+
+    // Only the range the engine will see, as transcribe_segments() cuts it.
+    if (options.begin_ms > 0 || options.end_ms > 0) {
+        const auto to_sample = [&](int64_t ms) {
+            return std::min(count, static_cast<size_t>(std::max<int64_t>(0, ms)) *
+                                       static_cast<size_t>(sample_rate) / 1000);
+        };
+        const size_t first = to_sample(options.begin_ms);
+        const size_t last  = options.end_ms > 0 ? to_sample(options.end_ms) : count;
+        samples += first;
+        count = last > first ? last - first : 0;
+        if (count == 0) return {};
+    }
+
+    const double seconds = static_cast<double>(count) / static_cast<double>(sample_rate);
+    const std::string model = engine_.model_fingerprint(options.tier, seconds);
+    if (model.empty()) return {};
+
+    Hash128 h;
+    h.add_value(kFormatVersion);
+    h.add_string(model);
+    h.add_value(static_cast<int32_t>(sample_rate));
+    h.add_value(static_cast<int64_t>(std::max<int64_t>(0, options.begin_ms)));
+    h.add_value(static_cast<uint8_t>(options.beam_search));
+    h.add_value(static_cast<uint8_t>(engine_.vad_enabled()));
+    h.add_value(static_cast<uint8_t>(!prompt_source.empty()));   // prompt chained?
+    h.add_string(prompt_source.empty() ? options.prompt : prompt_source);
+    h.add_value(static_cast<uint64_t>(count));
+    h.add(samples, count * sizeof(float));
+    return h.hex();
+}
+
+std::string TranscriptCache::audio_hash(const float* samples, size_t count) {
+    Hash128 h;
+    h.add_value(kFormatVersion);
+    h.add_value(static_cast<uint64_t>(count));
+    if (samples) h.add(samples, count * sizeof(float));
+    return h.hex();
+}
+
+// ---------------------------------------------------------------------------
+// Transcription
+// ---------------------------------------------------------------------------
+
+std::vector<TranscriptSegment> TranscriptCache::transcribe(const float* samples, size_t count,
+                                                           int sample_rate,
+                                                           const std::string& session_id,
+                                                           ProgressCallback progress,
+                                                           const TranscribeOptions& options,
+                                                           const std::string& prompt_source) {
+    bool hit = false;
+    return lookup_or_run(samples, count, sample_rate, session_id,
+                         std::move(progress), options, prompt_source, hit);
+}
+
+std::vector<TranscriptSegment> TranscriptCache::lookup_or_run(const float* samples, size_t count,
+                                                              int sample_rate,
+                                                              const std::string& session_id,
+                                                              ProgressCallback progress,
+                                                              const TranscribeOptions& options,
+                                                              const std::string& prompt_source,
+                                                              bool& hit) {
+    const std::string key = key_for(samples, count, sample_rate, options, prompt_source);
+
+    std::vector<uint8_t> entry;
+    std::vector<TranscriptSegment> segments;
+    if (!key.empty() && store_.get && store_.get(key, entry) &&
+        unpack_segments(entry.data(), entry.size(), segments)) {
+        hits_.fetch_add(1);
+        hit = true;
+        if (progress) progress(1.0f);
+        return segments;
+    }
+
+    misses_.fetch_add(1);
+    segments = engine_.transcribe_segments(samples, count, sample_rate,
+                                           std::move(progress), options);
+    if (!key.empty() && store_.put) {
+        store_.put(key, session_id, pack_segments(segments));
+    }
+    return segments;
+}
+
+std::vector<TranscriptSegment> TranscriptCache::transcribe_session(
+    const std::string& session_id,
+    const std::vector<ChunkSpan>& spans,
+    const std::function<std::vector<float>(const ChunkSpan&)>& load,
+    ProgressCallback progress,
+    TranscribeOptions options) {
+    options.prompt.clear();
+    options.begin_ms = 0;
+    options.end_ms   = 0;
+
+    size_t cached = 0;
+    std::string prompt_source;   // hash of the chunk the prompt came from
+    std::vector<TranscriptSegment> all;
+    for (size_t i = 0; i < spans.size(); ++i) {
+        const ChunkSpan& span = spans[i];
+        const std::vector<float> pcm = load(span);
+        if (pcm.empty()) {
+            // A silent chunk still has samples; none means it could not be
+            // read, and a transcript without it would be stored as whole.
+            if (span.end_ms > span.begin_ms) {
+                throw std::runtime_error("chunk " + std::to_string(span.chunk_index) +
+                                         " of " + session_id + " could not be read");
+            }
+            continue;
+        }
+
+        ProgressCallback chunk_progress = nullptr;
+        if (progress) {
+            const float n = static_cast<float>(spans.size());
+            chunk_progress = [&progress, i, n](float p) {
+                progress((static_cast<float>(i) + p) / n);
+            };
+        }
+
+        bool hit = false;
+        std::vector<TranscriptSegment> segments = lookup_or_run(
+            pcm.data(), pcm.size(), 16000, session_id, chunk_progress, options,
+            prompt_source, hit);
+        if (hit) ++cached;
+        if (!segments.empty()) {
+            // The next chunk usually continues this one's sentence.
+            options.prompt = prompt_tail(join_segments(segments),
+                                         WhisperEngine::kStreamPromptWords);
+            prompt_source = audio_hash(pcm.data(), pcm.size());
+        }
+        for (TranscriptSegment& seg : segments) {
+            seg.t0_ms += span.begin_ms;
+            seg.t1_ms += span.begin_ms;
+            all.push_back(std::move(seg));
+        }
+    }
+
+    fprintf(stderr, "[TranscriptCache] %s: %zu of %zu chunks from the cache\n",
+            session_id.c_str(), cached, spans.size());
+    return all;
+}
+
+// ---------------------------------------------------------------------------
+// Entry format
+// ---------------------------------------------------------------------------
+
+std::vector<uint8_t> TranscriptCache::pack_segments(const std::vector<TranscriptSegment>& segments) {
+    std::vector<uint8_t> out;
+    size_t text_bytes = 0;
+    for (const TranscriptSegment& seg : segments) text_bytes += seg.text.size();
+    out.reserve(5 + segments.size() * 24 + text_bytes);
+
+    out.push_back(kFormatVersion);
+    put_u32(out, static_cast<uint32_t>(segments.size()));
+    for (const TranscriptSegment& seg : segments) {
+        uint32_t prob;
+        std::memcpy(&prob, &seg.avg_prob, sizeof(prob));
+        put_i64(out, seg.t0_ms);
+        put_i64(out, seg.t1_ms);
+        put_u32(out, prob);
+        put_u32(out, static_cast<uint32_t>(seg.text.size()));
+        out.insert(out.end(), seg.text.begin(), seg.text.end());
+    }
+    return out;
+}
+
+bool TranscriptCache::unpack_segments(const uint8_t* data, size_t size,
+                                      std::vector<TranscriptSegment>& segments) {
+    segments.clear();
+    if (!data || size < 5 || data[0] != kFormatVersion) return false;
+
+    Reader r{data, size, 1};
+    uint64_t count = 0;
+    if (!r.take(4, count)) return false;
+    segments.reserve(static_cast<size_t>(std::min<uint64_t>(count, size / 24)));
+    for (uint64_t i = 0; i < count; ++i) {
+        uint64_t t0 = 0, t1 = 0, prob = 0, length = 0;
+        if (!r.take(8, t0) || !r.take(8, t1) || !r.take(4, prob) || !r.take(4, length) ||
+            size - r.pos < length) {
+            segments.clear();
+            return false;
+        }
+        TranscriptSegment seg;
+        seg.t0_ms = static_cast<int64_t>(t0);
+        seg.t1_ms = static_cast<int64_t>(t1);
+        const auto bits = static_cast<uint32_t>(prob);
+        std::memcpy(&seg.avg_prob, &bits, sizeof(bits));
+        seg.text.assign(reinterpret_cast<const char*>(data + r.pos), static_cast<size_t>(length));
+        r.pos += static_cast<size_t>(length);
+        segments.push_back(std::move(seg));
+    }
+    return r.pos == size;
+}
+
+} // namespace vr
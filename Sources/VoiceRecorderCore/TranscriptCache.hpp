@@ -0,0 +1,121 @@
+#pragma once
+
+#include "WhisperEngine.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace vr {
+
+/// Content-addressed cache of transcription results in front of
+/// WhisperEngine::transcribe_segments().
+///
+/// A result is keyed by what determines it: a 128-bit hash of the PCM
+/// (just the requested range), the model the request routes to (its
+/// fingerprint, so a swapped or re-downloaded model misses), and the
+/// decode parameters that change the output — sampling strategy, prompt,
+/// range offset and whether VAD is on.  Tier and thread count only matter
+/// through the model they select, so they are not part of the key.
+///
+/// A prompt chained from the previous chunk's text is keyed by where it
+/// came from — that chunk's audio hash — not by the text itself, so a
+/// chunk's entry does not depend on how the chunk before it happened to
+/// decode (a pruned entry, another model tier, a resumed recovery).
+///
+/// transcribe_session() runs a session chunk by chunk through it, so a
+/// retry after one chunk failed (or a recovery interrupted half way) runs
+/// whisper only on the chunks that have no entry yet.  Entries are stored
+/// through the Store hooks — DatabaseManager's transcript_cache table in
+/// the app — as the blobs pack_segments() produces.
+class TranscriptCache {
+public:
+    /// Storage hooks, called on whichever thread transcribes.  Either may
+    /// be empty (nothing is cached).
+    struct Store {
+        /// The entry stored under `key` into `entry`; false on a miss.
+        std::function<bool(const std::string& key, std::vector<uint8_t>& entry)> get;
+
+        /// Store `entry` under `key`, owned by `session_id` (may be empty)
+        /// so it goes when that session is deleted.
+        std::function<void(const std::string& key, const std::string& session_id,
+                           const std::vector<uint8_t>& entry)> put;
+    };
+
+    /// `engine` must outlive the cache.
+    TranscriptCache(WhisperEngine& engine, Store store);
+
+    // Non-copyable.
+    TranscriptCache(const TranscriptCache&) = delete;
+    TranscriptCache& operator=(const TranscriptCache&) = delete;
+
+    /// WhisperEngine::transcribe_segments(), answered from the cache when
+    /// an entry exists (progress then jumps to 1) and stored after a run.
+    /// Throws what the engine throws; failures are never cached.
+    ///
+    /// `prompt_source`: when `options.prompt` is chained from an earlier
+    /// chunk's text, the audio_hash() of the chunk it came from (keyed in
+    /// place of the prompt text); empty for a prompt the caller chose.
+    std::vector<TranscriptSegment> transcribe(const float* samples, size_t count,
+                                              int sample_rate,
+                                              const std::string& session_id,
+                                              ProgressCallback progress = nullptr,
+                                              const TranscribeOptions& options = {},
+                                              const std::string& prompt_source = {});
+
+    /// Transcribe a session one chunk at a time through transcribe(), with
+    /// each chunk's text tail as the next one's prompt (as recovery does).
+    /// `load` returns a chunk's 16 kHz mono float32 audio.  Segment times
+    /// are relative to the session; `progress` covers the whole session.
+    /// `options.prompt` and the range are ignored.  Throws if a chunk with
+    /// a non-empty span loads no audio, rather than return a transcript
+    /// missing that span.
+    std::vector<TranscriptSegment> transcribe_session(
+        const std::string& session_id,
+        const std::vector<ChunkSpan>& spans,
+        const std::function<std::vector<float>(const ChunkSpan&)>& load,
+        ProgressCallback progress = nullptr,
+        TranscribeOptions options = {});
+
+    /// Cache key for a request, or empty if no model could serve it.
+    std::string key_for(const float* samples, size_t count, int sample_rate,
+                        const TranscribeOptions& options,
+                        const std::string& prompt_source = {}) const;
+
+    /// Hash of `count` samples alone: the `prompt_source` of the chunk
+    /// after them.
+    static std::string audio_hash(const float* samples, size_t count);
+
+    /// Requests answered from / missing in the cache since construction.
+    uint64_t hits() const { return hits_.load(); }
+    uint64_t misses() const { return misses_.load(); }
+
+    /// Serialized form of an entry (format versioned; chunk_index is not
+    /// kept — the database assigns it).
+    static std::vector<uint8_t> pack_segments(const std::vector<TranscriptSegment>& segments);
+
+    /// Inverse of pack_segments(); false if `size` bytes at `data` are not
+    /// a valid entry of this format version.
+    static bool unpack_segments(const uint8_t* data, size_t size,
+                                std::vector<TranscriptSegment>& segments);
+
+private:
+    /// transcribe(), reporting in `hit` whether the cache answered.
+    std::vector<TranscriptSegment> lookup_or_run(const float* samples, size_t count,
+                                                 int sample_rate,
+                                                 const std::string& session_id,
+                                                 ProgressCallback progress,
+                                                 const TranscribeOptions& options,
+                                                 const std::string& prompt_source,
+                                                 bool& hit);
+
+    WhisperEngine&        engine_;
+    const Store           store_;
+    std::atomic<uint64_t> hits_{0};
+    std::atomic<uint64_t> misses_{0};
+};
+
+} // namespace vr
@@ -0,0 +1,302 @@
+#include "TranscriptionScheduler.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <utility>
+
+#if defined(__APPLE__)
+#include <pthread.h>
+#include <pthread/qos.h>
+#endif
+
+namespace vr {
+
+namespace {
+
+size_t index_of(JobPriority p) { return static_cast<size_t>(p); }
+
+bool is_short_clip(const TranscriptionJob& job) {
+    return job.samples > 0 && job.samples <= TranscriptionScheduler::kShortClipSamples;
+}
+
+/// Run the worker (and the threads whisper spawns from it) at the QoS of
+/// the job it is about to run.
+void apply_qos(JobPriority priority) {
+#if defined(__APPLE__)
+    switch (priority) {
+    case JobPriority::interactive:
+        pthread_set_qos_class_self_np(QOS_CLASS_USER_INTERACTIVE, 0);
+        break;
+    case JobPriority::user_initiated:
+        pthread_set_qos_class_self_np(QOS_CLASS_USER_INITIATED, 0);
+        break;
+    case JobPriority::background:
+        // As refinement and recovery: efficiency cores, behind everything
+        // the user is waiting on.
+        pthread_set_qos_class_self_np(QOS_CLASS_BACKGROUND, 0);
+        break;
+    }
+#else
+    (void)priority;
+#endif
+}
+
+void run_all(std::vector<std::function<void()>>& callbacks) {
+    for (auto& cb : callbacks) {
+        if (cb) cb();
+    }
+    callbacks.clear();
+}
+
+} // namespace
+
+// ---------------------------------------------------------------------------
+// Construction / destruction
+// ---------------------------------------------------------------------------
+
+TranscriptionScheduler::TranscriptionScheduler(size_t n_workers)
+    : n_workers_(std::max<size_t>(1, n_workers)) {
+    workers_.reserve(n_workers_);
+    for (size_t i = 0; i < n_workers_; ++i) {
+        workers_.emplace_back(&TranscriptionScheduler::worker_loop, this);
+    }
+}
+
+TranscriptionScheduler::~TranscriptionScheduler() {
+    std::vector<std::function<void()>> drop;
+    {
+        std::lock_guard<std::mutex> lock(mu_);
+        stopping_ = true;
+        cancel_matching([](const Entry&) { return true; }, drop);
+    }
+    cv_.notify_all();
+    for (std::thread& w : workers_) {
+        if (w.joinable()) w.join();
+    }
+    run_all(drop);
+}
+
+// ---------------------------------------------------------------------------
+// Queue control
+// ---------------------------------------------------------------------------
+
+JobToken TranscriptionScheduler::submit(TranscriptionJob job) {
+    std::vector<std::function<void()>> drop;
+    JobToken token = 0;
+    {
+        std::lock_guard<std::mutex> lock(mu_);
+        if (stopping_) {
+            drop.push_back(std::move(job.cancelled));
+        } else {
+            if (!job.key.empty()) {
+                // Supersede earlier requests for the same key, keeping the
+                // most urgent class any of them asked for.
+                for (const auto& q : queues_) {
+                    for (const EntryPtr& e : q) {
+                        if (e->job.key == job.key) {
+                            job.priority = std::min(job.priority, e->job.priority);
+                        }
+                    }
+                }
+                const std::string key = job.key;
+                cancel_matching([&](const Entry& e) { return e.job.key == key; }, drop);
+            }
+
+            auto entry   = std::make_shared<Entry>();
+            entry->job   = std::move(job);
+            entry->token = token = next_token_++;
+            const JobPriority priority = entry->job.priority;
+            queues_[index_of(priority)].push_back(std::move(entry));
+
+            if (priority != JobPriority::background && busy_workers_ == n_workers_) {
+                preempt_background();
+            }
+        }
+    }
+    cv_.notify_one();
+    run_all(drop);
+    return token;
+}
+
+bool TranscriptionScheduler::cancel(JobToken token) {
+    std::vector<std::function<void()>> drop;
+    size_t matched = 0;
+    {
+        std::lock_guard<std::mutex> lock(mu_);
+        matched = cancel_matching([&](const Entry& e) { return e.token == token; }, drop);
+    }
+    run_all(drop);
+    return matched > 0;
+}
+
+void TranscriptionScheduler::cancel(const std::string& session_id) {
+    if (session_id.empty()) return;
+    std::vector<std::function<void()>> drop;
+    {
+        std::lock_guard<std::mutex> lock(mu_);
+        cancel_matching([&](const Entry& e) { return e.job.session_id == session_id; }, drop);
+    }
+    run_all(drop);
+}
+
+size_t TranscriptionScheduler::pending(JobPriority priority) const {
+    std::lock_guard<std::mutex> lock(mu_);
+    size_t count = queues_[index_of(priority)].size();
+    for (const EntryPtr& e : held_) {
+        if (e->job.priority == priority && !e->cancelled) ++count;
+    }
+    return count;
+}
+
+size_t TranscriptionScheduler::cancel_matching(const std::function<bool(const Entry&)>& match,
+                                               std::vector<std::function<void()>>& drop) {
+    size_t matched = 0;
+    for (auto& q : queues_) {
+        for (auto it = q.begin(); it != q.end();) {
+            if (match(**it)) {
+                (*it)->cancelled = true;
+                drop.push_back(std::move((*it)->job.cancelled));
+                it = q.erase(it);
+                ++matched;
+            } else {
+                ++it;
+            }
+        }
+    }
+    // Held jobs end on their worker: skipped if not started yet, otherwise
+    // aborted mid-inference; the worker runs their callback.
+    for (const EntryPtr& e : held_) {
+        if (!e->cancelled && match(*e)) {
+            e->cancelled = true;
+            e->abort.store(true);
+            ++matched;
+        }
+    }
+    return matched;
+}
+
+void TranscriptionScheduler::preempt_background() {
+    EntryPtr victim;
+    for (const EntryPtr& e : held_) {
+        if (!e->started || e->cancelled || e->preempted ||
+            e->job.priority != JobPriority::background) {
+            continue;
+        }
+        if (!victim || e->started_seq > victim->started_seq) victim = e;
+    }
+    if (victim) {
+        victim->preempted = true;
+        victim->abort.store(true);
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Worker
+// ---------------------------------------------------------------------------
+
+bool TranscriptionScheduler::runnable() const {
+    if (!queues_[index_of(JobPriority::interactive)].empty() ||
+        !queues_[index_of(JobPriority::user_initiated)].empty()) {
+        return true;
+    }
+    return !queues_[index_of(JobPriority::background)].empty() &&
+           background_running_ < background_cap();
+}
+
+std::vector<TranscriptionScheduler::EntryPtr> TranscriptionScheduler::take_batch() {
+    size_t p = 0;
+    while (queues_[p].empty()) ++p;   // runnable() guarantees one
+
+    std::deque<EntryPtr>& q = queues_[p];
+    std::vector<EntryPtr> batch{q.front()};
+    q.pop_front();
+
+    if (p != index_of(JobPriority::interactive) && is_short_clip(batch.front()->job)) {
+        for (auto it = q.begin(); it != q.end() && batch.size() < kMaxBatchJobs;) {
+            if (is_short_clip((*it)->job)) {
+                batch.push_back(*it);
+                it = q.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    }
+
+    held_.insert(held_.end(), batch.begin(), batch.end());
+    return batch;
+}
+
+void TranscriptionScheduler::worker_loop() {
+    std::unique_lock<std::mutex> lock(mu_);
+    for (;;) {
+        cv_.wait(lock, [this] { return stopping_ || runnable(); });
+        if (stopping_) return;
+
+        std::vector<EntryPtr> batch = take_batch();
+        const JobPriority priority = batch.front()->job.priority;
+        ++busy_workers_;
+        if (priority == JobPriority::background) ++background_running_;
+
+        std::vector<std::function<void()>> drop;
+        bool requeued = false;
+        for (size_t i = 0; i < batch.size() && !requeued; ++i) {
+            const EntryPtr& e = batch[i];
+            if (e->cancelled) {
+                drop.push_back(std::move(e->job.cancelled));
+                continue;
+            }
+            e->started     = true;
+            e->started_seq = ++start_seq_;
+            lock.unlock();
+            run_all(drop);
+
+            apply_qos(priority);
+            bool aborted = false;
+            try {
+                if (e->job.run) e->job.run(e->abort);
+            } catch (const TranscriptionAborted&) {
+                aborted = true;
+            } catch (const std::exception& ex) {
+                fprintf(stderr, "[TranscriptionScheduler] job %llu failed: %s\n",
+                        static_cast<unsigned long long>(e->token), ex.what());
+            }
+
+            lock.lock();
+            if (!aborted) continue;
+            if (e->preempted && !e->cancelled && !stopping_) {
+                // Yielded to a more urgent job: back to the head of the
+                // class with the rest of the batch, in order.
+                std::deque<EntryPtr>& q = queues_[index_of(priority)];
+                for (size_t j = batch.size(); j-- > i;) {
+                    if (batch[j]->cancelled) {
+                        drop.push_back(std::move(batch[j]->job.cancelled));
+                        continue;
+                    }
+                    batch[j]->started   = false;
+                    batch[j]->preempted = false;
+                    batch[j]->abort.store(false);   // under mu_, as a cancel sets it
+                    q.push_front(batch[j]);
+                }
+                requeued = true;
+            } else {
+                drop.push_back(std::move(e->job.cancelled));
+            }
+        }
+
+        held_.remove_if([&](const EntryPtr& h) {
+            return std::find(batch.begin(), batch.end(), h) != batch.end();
+        });
+        --busy_workers_;
+        if (priority == JobPriority::background) --background_running_;
+
+        if (!drop.empty()) {
+            lock.unlock();
+            run_all(drop);
+            lock.lock();
+        }
+        // A freed background slot may let another worker start one.
+        if (priority == JobPriority::background) cv_.notify_one();
+    }
+}
+
+} // namespace vr
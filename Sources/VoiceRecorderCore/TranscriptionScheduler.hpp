@@ -0,0 +1,167 @@
+#pragma once
+
+#include "WhisperEngine.hpp"
+
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace vr {
+
+/// Scheduling class of a one-shot transcription, most urgent first.
+enum class JobPriority {
+    interactive,      // the draft of a dictation that just stopped
+    user_initiated,   // a retry or re-transcription the user asked for
+    background,       // bulk work nobody is waiting on
+};
+
+constexpr size_t kJobPriorities = 3;
+
+/// Identifies a submitted job for TranscriptionScheduler::cancel(); 0 is
+/// never issued.
+using JobToken = uint64_t;
+
+/// One unit of work for TranscriptionScheduler.
+struct TranscriptionJob {
+    JobPriority priority = JobPriority::interactive;
+
+    /// Session the job belongs to, for cancel(session_id); may be empty.
+    std::string session_id;
+
+    /// Deduplication key: the session id for a whole-session job, plus the
+    /// range for a partial one.  Submitting a job with the key of one still
+    /// queued or running supersedes it; empty keys are never deduplicated.
+    std::string key;
+
+    /// Audio length in samples, for batching short clips (0 = unknown,
+    /// never batched).
+    size_t samples = 0;
+
+    /// Does the work on a worker thread and delivers its own result.  Pass
+    /// `abort` to the engine (TranscribeOptions::abort) and let
+    /// TranscriptionAborted propagate: the scheduler raises it to cancel
+    /// or preempt the job.  A preempted background job is run again from
+    /// the start later, so run must be repeatable.
+    std::function<void(const std::atomic<bool>& abort)> run;
+
+    /// Called instead of (or after an aborted) `run` when the job was
+    /// cancelled, superseded, or dropped at shutdown — so every submitted
+    /// job ends in exactly one of a finished run or this.  Called on
+    /// whichever thread noticed, never with the scheduler's lock held.
+    std::function<void()> cancelled;
+};
+
+/// Priority scheduler for one-shot transcriptions, in front of the
+/// engine's state pool.
+///
+/// One worker thread per engine state.  Jobs start in priority order (FIFO
+/// within a class), and interactive latency is protected two ways:
+/// background jobs never occupy more than all but one worker, so a fresh
+/// dictation always finds a state free of them; and a non-background job
+/// that finds every worker busy preempts the most recently started
+/// background job, which goes back to the head of its class.
+///
+/// Short clips (at most kShortClipSamples) outside the interactive class
+/// are batched: a worker that starts one also takes up to kMaxBatchJobs - 1
+/// more short clips queued in the same class and runs them back to back,
+/// so a burst of small re-transcriptions holds one state instead of all of
+/// them.  Interactive jobs are never batched; each goes to its own worker.
+///
+/// Refinement and crash recovery keep their own single workers
+/// (RefinementQueue, RecoveryScheduler), which yield to live recording
+/// through their pause().
+class TranscriptionScheduler {
+public:
+    /// Start `n_workers` workers (at least one).
+    explicit TranscriptionScheduler(size_t n_workers = WhisperEngine::kDefaultStateCount);
+
+    /// Cancels everything queued or running, then joins the workers.
+    ~TranscriptionScheduler();
+
+    // Non-copyable.
+    TranscriptionScheduler(const TranscriptionScheduler&) = delete;
+    TranscriptionScheduler& operator=(const TranscriptionScheduler&) = delete;
+
+    /// Queue a job.  A queued job with the same key is dropped (its
+    /// `cancelled` runs before this returns) and the new job takes the
+    /// more urgent of the two priorities; a running one is aborted.
+    JobToken submit(TranscriptionJob job);
+
+    /// Cancel one job: dropped if still queued, aborted if running.  False
+    /// if it already finished.
+    bool cancel(JobToken token);
+
+    /// Cancel every queued or running job of `session_id`.
+    void cancel(const std::string& session_id);
+
+    /// Jobs queued or running in `priority`.
+    size_t pending(JobPriority priority) const;
+
+    size_t worker_count() const { return n_workers_; }
+
+    /// Clips up to 10 s at 16 kHz count as short for batching.
+    static constexpr size_t kShortClipSamples = 10 * 16000;
+
+    /// Upper bound on jobs run back to back by one worker.
+    static constexpr size_t kMaxBatchJobs = 8;
+
+private:
+    struct Entry {
+        TranscriptionJob  job;
+        JobToken          token = 0;
+        std::atomic<bool> abort{false};   // polled by whisper during inference
+        bool              cancelled = false;
+        bool              preempted = false;
+        bool              started = false;
+        uint64_t          started_seq = 0;
+    };
+    using EntryPtr = std::shared_ptr<Entry>;
+
+    void worker_loop();
+
+    /// Whether a worker may start something now.  Caller holds mu_.
+    bool runnable() const;
+
+    /// Dequeue the next job, plus any short clips batched with it.
+    /// Caller holds mu_.
+    std::vector<EntryPtr> take_batch();
+
+    /// Abort the most recently started background job so a more urgent
+    /// one gets its worker.  Caller holds mu_.
+    void preempt_background();
+
+    /// Remove queued jobs matching `match`, moving their `cancelled`
+    /// callbacks to `drop` (to run once mu_ is released), and abort the held
+    /// ones.  Returns the number of jobs matched.  Caller holds mu_.
+    size_t cancel_matching(const std::function<bool(const Entry&)>& match,
+                           std::vector<std::function<void()>>& drop);
+
+    /// Workers background jobs may occupy at once: all but one.
+    size_t background_cap() const { return n_workers_ > 1 ? n_workers_ - 1 : 1; }
+
+    const size_t            n_workers_;
+
+    std::array<std::deque<EntryPtr>, kJobPriorities> queues_;
+    std::list<EntryPtr>     held_;            // taken by a worker (running or batched)
+    size_t                  busy_workers_ = 0;
+    size_t                  background_running_ = 0;
+    JobToken                next_token_ = 1;
+    uint64_t                start_seq_ = 0;
+    bool                    stopping_ = false;
+    mutable std::mutex      mu_;
+    std::condition_variable cv_;
+
+    std::vector<std::thread> workers_;         // declared last: start after state
+};
+
+} // namespace vr
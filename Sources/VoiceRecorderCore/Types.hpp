@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstddef>
 #include <cstdint>
 #include <functional>
 #include <string>
@@ -38,6 +39,40 @@ inline RecordingStatus status_from_string(const std::string& s) {
     return RecordingStatus::failed;
 }
 
+/// Encoding of a stored chunk's audio_blob (chunks.codec column).
+enum class ChunkCodec {
+    pcm_f32,    // raw 16 kHz mono float32 — rows written before the codec column
+    flac_s16,   // 16-bit FLAC, the default for new chunks
+    m4a         // AAC in MP4 from the legacy FFmpeg AudioRecorder
+};
+
+/// Convert codec enum to the string stored in SQLite.
+inline const char* codec_to_string(ChunkCodec c) {
+    switch (c) {
+        case ChunkCodec::pcm_f32:  return "pcm_f32";
+        case ChunkCodec::flac_s16: return "flac_s16";
+        case ChunkCodec::m4a:      return "m4a";
+    }
+    return "pcm_f32";
+}
+
+/// Parse codec string from SQLite back to enum.  NULL / unknown values are
+/// treated as raw float32, which is what every pre-codec row contains.
+inline ChunkCodec codec_from_string(const std::string& s) {
+    if (s == "flac_s16") return ChunkCodec::flac_s16;
+    if (s == "m4a")      return ChunkCodec::m4a;
+    return ChunkCodec::pcm_f32;
+}
+
+/// Which pass produced a session's stored transcript (sessions.transcript_version).
+/// A draft is the quick result pasted right after recording; a refined
+/// transcript replaces it once the background pass has finished.  Rows
+/// written before the column existed read back as `draft`.
+enum class TranscriptVersion {
+    draft   = 1,    // fast model / greedy decoding
+    refined = 2     // accurate model / beam search
+};
+
 // ---------------------------------------------------------------------------
 // Structs
 // ---------------------------------------------------------------------------
@@ -50,14 +85,78 @@ struct RecordingSession {
     RecordingStatus status;
     int64_t         duration_ms;    // Total duration across all chunks
     std::string     transcript;     // Final concatenated transcript
+    TranscriptVersion transcript_version = TranscriptVersion::draft;
+};
+
+/// History-list row: session metadata plus a short transcript preview.
+/// Served from a covering index so listing never loads full transcripts.
+struct SessionSummary {
+    std::string     id;
+    int64_t         created_at;
+    int64_t         completed_at;   // 0 if not yet completed
+    RecordingStatus status;
+    int64_t         duration_ms;
+    std::string     preview;        // First ~120 characters of the transcript
 };
 
+/// One full-text search result, best match first.
+struct SearchHit {
+    SessionSummary  session;        // preview left empty; see snippet
+    double          rank;           // FTS5 bm25(); lower (more negative) is better
+    std::string     snippet;        // Excerpt with matches wrapped in kSnippetOpen/Close
+};
+
+/// Markers bracketing matched terms in SearchHit::snippet (ASCII STX/ETX,
+/// which never occur in transcripts).
+constexpr const char* kSnippetOpen  = "\x02";
+constexpr const char* kSnippetClose = "\x03";
+
 /// A single 35-second audio burst within a session.
 struct AudioChunk {
     std::string             session_id;
     int32_t                 chunk_index;
-    std::vector<uint8_t>    audio_data;     // Raw M4A file bytes
+    std::vector<uint8_t>    audio_data;     // Audio bytes, encoded as `codec`
     int64_t                 duration_ms;
+    std::string             transcript;     // Partial text from streaming (may be empty)
+    ChunkCodec              codec = ChunkCodec::pcm_f32;
+};
+
+/// Where one chunk sits in its session's audio, without the audio itself.
+struct ChunkSpan {
+    int32_t chunk_index = 0;
+    int64_t begin_ms    = 0;     // Sum of the preceding chunks' durations
+    int64_t end_ms      = 0;
+};
+
+/// One whisper segment: a sentence-sized span of text with its timing.
+/// Times are milliseconds from the start of the transcribed audio (the
+/// session, or the chunk window for streaming), mapped back through
+/// resampling and VAD packing, so they index the original recording.
+struct TranscriptSegment {
+    int64_t         t0_ms = 0;
+    int64_t         t1_ms = 0;
+    std::string     text;
+    float           avg_prob = 0.0f;    // Mean probability of its text tokens, 0 – 1
+    int32_t         chunk_index = -1;   // Chunk containing t0; set by the database
+};
+
+/// Concatenate segment texts in order (whisper's segments carry their own
+/// leading spaces), as transcribe() returns them.
+inline std::string join_segments(const std::vector<TranscriptSegment>& segments) {
+    std::string text;
+    for (const auto& s : segments) text += s.text;
+    return text;
+}
+
+/// Borrowed view of one stored chunk's bytes.  Points into SQLite's row
+/// buffer, so it is only valid inside a DatabaseManager::for_each_chunk()
+/// callback — copy what you need to keep.
+struct ChunkView {
+    int32_t         chunk_index;
+    const uint8_t*  data;
+    size_t          size;
+    int64_t         duration_ms;
+    ChunkCodec      codec;
 };
 
 // ---------------------------------------------------------------------------
@@ -73,4 +172,7 @@ using MeteringCallback = std::function<void(float)>;
 /// Fired when a 35-second burst chunk is finalized.
 using BurstCallback = std::function<void(const AudioChunk&)>;
 
+/// Visits stored chunks in chunk_index order.  Return false to stop early.
+using ChunkVisitor = std::function<bool(const ChunkView&)>;
+
 } // namespace vr
@@ -0,0 +1,127 @@
+#include "Vad.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace vr {
+
+// ---------------------------------------------------------------------------
+// detect_speech
+// ---------------------------------------------------------------------------
+
+std::vector<SpeechSegment> detect_speech(const float* samples, size_t count,
+                                         const VadOptions& opts) {
+    std::vector<SpeechSegment> out;
+    if (!samples || count == 0 || opts.sample_rate <= 0) return out;
+
+    const auto ms_to_samples = [&](int ms) {
+        return static_cast<size_t>(std::max(ms, 0)) * static_cast<size_t>(opts.sample_rate) / 1000;
+    };
+    const size_t frame = std::max<size_t>(ms_to_samples(opts.frame_ms), 1);
+    const size_t n_frames = (count + frame - 1) / frame;
+
+    // 1. Per-frame RMS and zero-crossing rate.
+    std::vector<float> rms(n_frames);
+    std::vector<float> zcr(n_frames);
+    for (size_t f = 0; f < n_frames; ++f) {
+        const size_t begin = f * frame;
+        const size_t end   = std::min(begin + frame, count);
+        float energy = 0.0f;
+        size_t crossings = 0;
+        for (size_t i = begin; i < end; ++i) {
+            energy += samples[i] * samples[i];
+            if (i > begin && (samples[i] >= 0.0f) != (samples[i - 1] >= 0.0f)) {
+                ++crossings;
+            }
+        }
+        const size_t len = end - begin;
+        rms[f] = std::sqrt(energy / static_cast<float>(len));
+        zcr[f] = len > 1 ? static_cast<float>(crossings) / static_cast<float>(len - 1) : 0.0f;
+    }
+
+    // 2. Adaptive threshold: the 10th-percentile frame is taken as the
+    //    noise floor (dictation is rarely more than 90% speech).
+    std::vector<float> sorted = rms;
+    const size_t pct = n_frames / 10;
+    std::nth_element(sorted.begin(), sorted.begin() + pct, sorted.end());
+    const float noise_floor = sorted[pct];
+    const float threshold = std::clamp(noise_floor * opts.energy_ratio,
+                                       opts.abs_threshold,
+                                       std::max(opts.abs_threshold, opts.max_threshold));
+
+    // 3. Frame decisions → raw runs of speech frames.
+    struct Run { size_t first, last; };   // frame indices, inclusive
+    std::vector<Run> runs;
+    for (size_t f = 0; f < n_frames; ++f) {
+        const bool speech = rms[f] > threshold ||
+                            (zcr[f] > opts.fricative_zcr && rms[f] > threshold * 0.5f);
+        if (!speech) continue;
+        if (!runs.empty() && runs.back().last + 1 == f) {
+            runs.back().last = f;
+        } else {
+            runs.push_back({f, f});
+        }
+    }
+
+    // 4. Bridge short pauses, then drop bursts too short to be words.
+    const size_t min_silence = std::max<size_t>(ms_to_samples(opts.min_silence_ms) / frame, 1);
+    const size_t min_speech  = ms_to_samples(opts.min_speech_ms) / frame;
+    std::vector<Run> merged;
+    for (const Run& r : runs) {
+        if (!merged.empty() && r.first - merged.back().last <= min_silence) {
+            merged.back().last = r.last;
+        } else {
+            merged.push_back(r);
+        }
+    }
+
+    // 5. Pad, convert to samples, and merge spans the padding made overlap.
+    const size_t pad = ms_to_samples(opts.pad_ms);
+    for (const Run& r : merged) {
+        if (r.last - r.first + 1 < min_speech) continue;
+        SpeechSegment seg;
+        seg.start = r.first * frame > pad ? r.first * frame - pad : 0;
+        seg.end   = std::min((r.last + 1) * frame + pad, count);
+        if (!out.empty() && seg.start <= out.back().end) {
+            out.back().end = seg.end;
+        } else {
+            out.push_back(seg);
+        }
+    }
+    return out;
+}
+
+// ---------------------------------------------------------------------------
+// SpeechTimeline
+// ---------------------------------------------------------------------------
+
+SpeechTimeline::SpeechTimeline(const float* samples,
+                               const std::vector<SpeechSegment>& segments,
+                               size_t gap_samples) {
+    size_t total = 0;
+    for (const auto& seg : segments) total += seg.end - seg.start;
+    packed_.reserve(total + gap_samples * (segments.empty() ? 0 : segments.size() - 1));
+
+    for (const auto& seg : segments) {
+        if (!packed_.empty()) {
+            packed_.insert(packed_.end(), gap_samples, 0.0f);
+        }
+        spans_.push_back({packed_.size(), seg.start, seg.end - seg.start});
+        packed_.insert(packed_.end(), samples + seg.start, samples + seg.end);
+    }
+    speech_ = total;
+}
+
+size_t SpeechTimeline::to_original(size_t packed_offset) const {
+    if (spans_.empty()) return packed_offset;
+
+    // Last span starting at or before the offset.
+    auto it = std::upper_bound(spans_.begin(), spans_.end(), packed_offset,
+                               [](size_t off, const Span& s) { return off < s.packed_start; });
+    if (it == spans_.begin()) return spans_.front().original_start;
+    --it;
+    const size_t into = std::min(packed_offset - it->packed_start, it->length);
+    return it->original_start + into;
+}
+
+} // namespace vr
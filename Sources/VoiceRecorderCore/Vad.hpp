@@ -0,0 +1,74 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+namespace vr {
+
+/// One contiguous span of detected speech, in samples.
+struct SpeechSegment {
+    size_t start = 0;   // first sample
+    size_t end   = 0;   // one past the last sample
+};
+
+/// Tuning for detect_speech().  Defaults suit 16 kHz dictation.
+struct VadOptions {
+    int   sample_rate    = 16000;
+    int   frame_ms       = 20;      // analysis frame
+    int   min_speech_ms  = 200;     // shorter bursts are treated as noise
+    int   min_silence_ms = 600;     // shorter pauses don't split a segment
+    int   pad_ms         = 200;     // context kept either side of speech
+
+    /// A frame is speech when its RMS exceeds noise_floor * this ratio
+    /// (clamped to [abs_threshold, max_threshold]).  The noise floor adapts
+    /// per buffer.
+    float energy_ratio   = 3.0f;
+    float abs_threshold  = 0.004f;  // ~ -48 dBFS; never call quieter audio speech
+    float max_threshold  = 0.02f;   // ~ -34 dBFS; louder is always speech, so
+                                    // pause-free buffers aren't taken for noise
+
+    /// Unvoiced consonants (s, f, t) are quiet but have a high zero-crossing
+    /// rate; frames above this rate need only half the energy threshold.
+    float fricative_zcr  = 0.25f;
+};
+
+/// Energy / zero-crossing voice-activity detector.
+///
+/// Returns padded, merged speech spans in ascending order; empty if the
+/// buffer contains no speech.  One pass over the samples, plus a sort of
+/// the per-frame energies to estimate the noise floor.
+std::vector<SpeechSegment> detect_speech(const float* samples, size_t count,
+                                         const VadOptions& opts = {});
+
+/// Speech spans packed back to back for inference, with a short silence
+/// gap between them, plus the mapping back to the original timeline.
+class SpeechTimeline {
+public:
+    /// Pack `segments` of `samples` (as returned by detect_speech) with
+    /// `gap_samples` of silence between consecutive spans.
+    SpeechTimeline(const float* samples, const std::vector<SpeechSegment>& segments,
+                   size_t gap_samples);
+
+    /// The packed audio to hand to whisper.
+    const std::vector<float>& audio() const { return packed_; }
+
+    /// Map a sample offset in audio() back to the original buffer.  Offsets
+    /// inside a gap map to the end of the preceding span.
+    size_t to_original(size_t packed_offset) const;
+
+    /// Total speech samples kept (excluding gaps).
+    size_t speech_samples() const { return speech_; }
+
+private:
+    struct Span {
+        size_t packed_start;
+        size_t original_start;
+        size_t length;
+    };
+
+    std::vector<float> packed_;
+    std::vector<Span>  spans_;
+    size_t             speech_ = 0;
+};
+
+} // namespace vr
@@ -0,0 +1,159 @@
+#include "WaveformPyramid.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace vr {
+
+namespace {
+
+/// Unquantised bin while the pyramid is built.
+struct Accum {
+    float  min = 0.0f;
+    float  max = 0.0f;
+    double energy = 0.0;   // sum of squares
+    size_t samples = 0;
+};
+
+int16_t quantise(float v) {
+    const float scaled = std::round(std::clamp(v, -1.0f, 1.0f) * 32767.0f);
+    return static_cast<int16_t>(scaled);
+}
+
+WaveformBin to_bin(const Accum& a) {
+    WaveformBin bin;
+    bin.min = quantise(a.min);
+    bin.max = quantise(a.max);
+    bin.rms = a.samples
+                  ? quantise(static_cast<float>(std::sqrt(a.energy / a.samples)))
+                  : 0;
+    return bin;
+}
+
+} // namespace
+
+// ---------------------------------------------------------------------------
+// Building
+// ---------------------------------------------------------------------------
+
+WaveformPyramid build_waveform_pyramid(const float* samples, size_t count,
+                                       int sample_rate) {
+    WaveformPyramid pyramid;
+    if (!samples || count == 0 || sample_rate <= 0) return pyramid;
+
+    // Finest level straight from the samples.
+    const size_t bin_samples =
+        std::max<size_t>(1, static_cast<size_t>(sample_rate) * kWaveformBinMs[0] / 1000);
+    std::vector<Accum> fine((count + bin_samples - 1) / bin_samples);
+    for (size_t b = 0; b < fine.size(); ++b) {
+        const float* x = samples + b * bin_samples;
+        const size_t n = std::min(bin_samples, count - b * bin_samples);
+        float lo = x[0], hi = x[0], energy = 0.0f;
+        for (size_t i = 0; i < n; ++i) {
+            lo = std::min(lo, x[i]);
+            hi = std::max(hi, x[i]);
+            energy += x[i] * x[i];
+        }
+        fine[b] = Accum{lo, hi, energy, n};
+    }
+
+    // Each coarser level merges whole groups of the level below.
+    std::vector<Accum> level = std::move(fine);
+    for (size_t l = 0; l < kWaveformLevels; ++l) {
+        if (l > 0) {
+            const size_t group = static_cast<size_t>(kWaveformBinMs[l] / kWaveformBinMs[l - 1]);
+            std::vector<Accum> coarse((level.size() + group - 1) / group);
+            for (size_t b = 0; b < coarse.size(); ++b) {
+                const size_t end = std::min(level.size(), (b + 1) * group);
+                Accum acc = level[b * group];
+                for (size_t i = b * group + 1; i < end; ++i) {
+                    acc.min = std::min(acc.min, level[i].min);
+                    acc.max = std::max(acc.max, level[i].max);
+                    acc.energy  += level[i].energy;
+                    acc.samples += level[i].samples;
+                }
+                coarse[b] = acc;
+            }
+            level = std::move(coarse);
+        }
+
+        std::vector<WaveformBin>& out = pyramid.levels[l];
+        out.reserve(level.size());
+        for (const Accum& a : level) out.push_back(to_bin(a));
+    }
+    return pyramid;
+}
+
+size_t waveform_level_for(int64_t duration_ms, size_t pixels) {
+    for (size_t l = kWaveformLevels; l-- > 1;) {
+        if (duration_ms / kWaveformBinMs[l] >= static_cast<int64_t>(pixels)) return l;
+    }
+    return 0;
+}
+
+// ---------------------------------------------------------------------------
+// Storage format
+// ---------------------------------------------------------------------------
+
+std::vector<uint8_t> pack_waveform_bins(const std::vector<WaveformBin>& bins) {
+    std::vector<uint8_t> out;
+    out.reserve(bins.size() * kWaveformBinBytes);
+    for (const WaveformBin& bin : bins) {
+        for (int16_t v : {bin.min, bin.max, bin.rms}) {
+            const auto u = static_cast<uint16_t>(v);
+            out.push_back(static_cast<uint8_t>(u & 0xFF));
+            out.push_back(static_cast<uint8_t>(u >> 8));
+        }
+    }
+    return out;
+}
+
+// ---------------------------------------------------------------------------
+// WaveformOverview
+// ---------------------------------------------------------------------------
+
+WaveformOverview::WaveformOverview(int64_t duration_ms, size_t pixels)
+    : duration_ms_(std::max<int64_t>(1, duration_ms)), columns_(pixels) {}
+
+void WaveformOverview::add(int64_t begin_ms, int bin_ms,
+                           const uint8_t* packed, size_t size) {
+    if (columns_.empty() || !packed || bin_ms <= 0) return;
+
+    const size_t count = size / kWaveformBinBytes;
+    for (size_t i = 0; i < count; ++i) {
+        const uint8_t* p = packed + i * kWaveformBinBytes;
+        const auto lo  = static_cast<int16_t>(p[0] | (p[1] << 8));
+        const auto hi  = static_cast<int16_t>(p[2] | (p[3] << 8));
+        const auto rms = static_cast<int16_t>(p[4] | (p[5] << 8));
+
+        const int64_t mid_ms = begin_ms + static_cast<int64_t>(i) * bin_ms + bin_ms / 2;
+        const size_t col = static_cast<size_t>(std::clamp<int64_t>(
+            mid_ms * static_cast<int64_t>(columns_.size()) / duration_ms_,
+            0, static_cast<int64_t>(columns_.size()) - 1));
+
+        Column& c = columns_[col];
+        if (c.bins == 0) {
+            c.min = lo;
+            c.max = hi;
+        } else {
+            c.min = std::min(c.min, lo);
+            c.max = std::max(c.max, hi);
+        }
+        c.energy += static_cast<double>(rms) * rms;
+        ++c.bins;
+    }
+}
+
+std::vector<WaveformBin> WaveformOverview::finish() const {
+    std::vector<WaveformBin> out(columns_.size());
+    for (size_t i = 0; i < columns_.size(); ++i) {
+        const Column& c = columns_[i];
+        if (c.bins == 0) continue;
+        out[i].min = c.min;
+        out[i].max = c.max;
+        out[i].rms = static_cast<int16_t>(std::lround(std::sqrt(c.energy / c.bins)));
+    }
+    return out;
+}
+
+} // namespace vr
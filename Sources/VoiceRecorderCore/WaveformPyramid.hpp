@@ -0,0 +1,76 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace vr {
+
+/// One waveform bin: sample extremes and RMS over its time span, as
+/// 16-bit fixed point (full scale 32767 = 1.0).
+struct WaveformBin {
+    int16_t min = 0;
+    int16_t max = 0;
+    int16_t rms = 0;
+};
+
+/// Bytes per bin once packed for storage (three little-endian int16).
+constexpr size_t kWaveformBinBytes = 6;
+
+/// Resolutions of the overview pyramid, finest first.  Each level's bin is
+/// a whole number of the previous level's bins, so the coarse levels are
+/// built from the fine one without touching the samples again.
+constexpr size_t kWaveformLevels = 3;
+constexpr std::array<int, kWaveformLevels> kWaveformBinMs = {10, 100, 1000};
+
+/// A chunk's waveform at every level of the pyramid.  A 35 s chunk is
+/// 3500 + 350 + 35 bins, about 23 KB packed — and a thumbnail reads only
+/// the coarsest level that still has enough bins, a few hundred bytes.
+struct WaveformPyramid {
+    std::array<std::vector<WaveformBin>, kWaveformLevels> levels;
+
+    bool empty() const { return levels[0].empty(); }
+};
+
+/// Build the pyramid for `count` mono float32 samples at `sample_rate` in
+/// one pass.  The last bin of each level covers whatever is left over.
+WaveformPyramid build_waveform_pyramid(const float* samples, size_t count,
+                                       int sample_rate = 16000);
+
+/// Coarsest level that still has at least `pixels` bins across
+/// `duration_ms`; the finest level if none does.
+size_t waveform_level_for(int64_t duration_ms, size_t pixels);
+
+/// Bins as stored in the waveforms table (kWaveformBinBytes each).
+std::vector<uint8_t> pack_waveform_bins(const std::vector<WaveformBin>& bins);
+
+/// Downsample stored bins to a fixed number of columns for drawing.
+///
+/// Feed it each chunk's packed bins for one level with the chunk's start
+/// time; every bin lands in the column containing its midpoint, taking the
+/// min of mins, max of maxes and the RMS of RMSes.  Columns no bin fell
+/// into stay silent.
+class WaveformOverview {
+public:
+    WaveformOverview(int64_t duration_ms, size_t pixels);
+
+    /// Add one chunk's bins of `bin_ms` each, starting at `begin_ms`.
+    void add(int64_t begin_ms, int bin_ms, const uint8_t* packed, size_t size);
+
+    /// One bin per column.
+    std::vector<WaveformBin> finish() const;
+
+private:
+    struct Column {
+        int16_t min = 0;
+        int16_t max = 0;
+        double  energy = 0.0;   // sum of rms^2
+        int     bins = 0;
+    };
+
+    int64_t             duration_ms_;
+    std::vector<Column> columns_;
+};
+
+} // namespace vr
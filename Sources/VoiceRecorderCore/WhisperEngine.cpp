@@ -1,14 +1,297 @@
 #include "WhisperEngine.hpp"
+#include "CpuTopology.hpp"
+#include "Instrumentation.hpp"
+#include "Resampler.hpp"
+#include "StreamMerge.hpp"
+#include "Vad.hpp"
 
 #include <algorithm>
-#include <cmath>
+#include <cctype>
+#include <chrono>
+#include <condition_variable>
 #include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <numeric>
+#include <optional>
 #include <stdexcept>
 
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
 #include "whisper.h"
 
 namespace vr {
 
+namespace {
+
+/// Pack speech spans only when VAD removes at least this much of the
+/// buffer; below that the extra copy buys no inference time.
+constexpr double kVadMinSavedFraction = 0.1;
+
+/// Silence inserted between packed speech spans (100 ms), so whisper still
+/// sees a pause where one was cut out.
+constexpr size_t kVadGapSamples = 1600;
+
+/// Length of the silent warm-up inference run by preload() (1 s).
+constexpr int kWarmUpSamples = 16000;
+
+/// Per-state allowance in the memory estimate: KV caches and compute
+/// buffers scale roughly with the model, with a floor for tiny models.
+constexpr size_t kMinStateBytes = size_t{32} << 20;
+
+/// Automatic thread count before calibration: the performance cores
+/// (efficiency cores would only slow the slowest worker down).
+int default_threads() {
+    return std::min(WhisperEngine::kMaxAutoThreads, CpuTopology::current().performance_cores);
+}
+
+/// Fastest thread count per model file, optionally persisted as
+/// "<threads>\t<key>" lines.
+struct CalibrationCache {
+    std::mutex                 mu;
+    std::string                path;
+    bool                       loaded = false;
+    std::map<std::string, int> threads;   // cache key -> thread count
+
+    /// Caller holds mu.
+    void load_locked() {
+        if (loaded) return;
+        loaded = true;
+        if (path.empty()) return;
+        std::ifstream in(path);
+        int n = 0;
+        std::string key;
+        while (in >> n && in.get() == '\t' && std::getline(in, key)) {
+            if (n > 0 && !key.empty()) threads[key] = n;
+        }
+    }
+
+    /// Caller holds mu.
+    void save_locked() const {
+        if (path.empty()) return;
+        std::ofstream out(path, std::ios::trunc);
+        for (const auto& entry : threads) {
+            out << entry.second << '\t' << entry.first << '\n';
+        }
+        if (!out) {
+            fprintf(stderr, "[WhisperEngine] could not write calibration cache %s\n", path.c_str());
+        }
+    }
+};
+
+CalibrationCache& calibration_cache() {
+    static CalibrationCache cache;
+    return cache;
+}
+
+/// Warm-up / calibration request: the full encoder plus one decoder step.
+whisper_full_params probe_params(int n_threads) {
+    whisper_full_params params = whisper_full_default_params(WHISPER_SAMPLING_GREEDY);
+    params.print_progress   = false;
+    params.print_timestamps = false;
+    params.no_context       = true;
+    params.single_segment   = true;
+    params.max_tokens       = 1;
+    params.language         = "en";
+    params.n_threads        = n_threads;
+    return params;
+}
+
+int64_t now_ticks() {
+    return std::chrono::steady_clock::now().time_since_epoch().count();
+}
+
+/// Routing preference when the requested tier isn't loaded.
+const std::vector<ModelTier>& tier_preference(ModelTier want) {
+    static const std::vector<ModelTier> fast     = {ModelTier::fast, ModelTier::standard, ModelTier::accurate};
+    static const std::vector<ModelTier> standard = {ModelTier::standard, ModelTier::fast, ModelTier::accurate};
+    static const std::vector<ModelTier> accurate = {ModelTier::accurate, ModelTier::standard, ModelTier::fast};
+    switch (want) {
+        case ModelTier::fast:     return fast;
+        case ModelTier::accurate: return accurate;
+        default:                  return standard;
+    }
+}
+
+const char* tier_name(ModelTier tier) {
+    switch (tier) {
+        case ModelTier::fast:     return "fast";
+        case ModelTier::accurate: return "accurate";
+        default:                  return "standard";
+    }
+}
+
+/// Read-only mapping of a model file, read through a whisper_model_loader.
+/// Mapping instead of fread() means the weights come straight from the
+/// page cache on a relaunch, with no intermediate stdio buffer.
+class MappedFile {
+public:
+    explicit MappedFile(const std::string& path) {
+        const int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) return;
+        struct stat st {};
+        if (::fstat(fd, &st) == 0 && st.st_size > 0) {
+            void* p = ::mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+            if (p != MAP_FAILED) {
+                data_ = static_cast<const uint8_t*>(p);
+                size_ = static_cast<size_t>(st.st_size);
+                // The loader streams through the file once, front to back.
+                ::madvise(p, size_, MADV_SEQUENTIAL);
+                ::madvise(p, size_, MADV_WILLNEED);
+            }
+        }
+        ::close(fd);
+    }
+
+    ~MappedFile() {
+        if (data_) ::munmap(const_cast<uint8_t*>(data_), size_);
+    }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    bool ok() const { return data_ != nullptr; }
+
+    whisper_model_loader loader() {
+        whisper_model_loader l{};
+        l.context = this;
+        l.read = [](void* ctx, void* output, size_t read_size) -> size_t {
+            auto* f = static_cast<MappedFile*>(ctx);
+            const size_t n = std::min(read_size, f->size_ - f->pos_);
+            std::memcpy(output, f->data_ + f->pos_, n);
+            f->pos_ += n;
+            return n;
+        };
+        l.eof = [](void* ctx) -> bool {
+            auto* f = static_cast<MappedFile*>(ctx);
+            return f->pos_ >= f->size_;
+        };
+        l.close = [](void* /*ctx*/) {};   // unmapped by the destructor
+        return l;
+    }
+
+private:
+    const uint8_t* data_ = nullptr;
+    size_t         size_ = 0;
+    size_t         pos_  = 0;
+};
+
+/// Splits one whisper_full call into mel / encoder / decoder time using
+/// the callbacks whisper fires at the phase boundaries: everything before
+/// the first encoder_begin is the spectrogram, encoder_begin opens each
+/// window's encoder pass, and the window's first logits_filter marks the
+/// switch to decoding.
+struct PhaseClock {
+    Stage    phase = Stage::mel;
+    uint64_t mark  = stage_clock_ns();
+
+    void enter(Stage next) {
+        const uint64_t now = stage_clock_ns();
+        record_stage(phase, now - mark);
+        phase = next;
+        mark  = now;
+    }
+
+    void install(whisper_full_params& params) {
+        params.encoder_begin_callback = [](whisper_context*, whisper_state*, void* user_data) {
+            static_cast<PhaseClock*>(user_data)->enter(Stage::encoder);
+            return true;
+        };
+        params.encoder_begin_callback_user_data = this;
+        params.logits_filter_callback = [](whisper_context*, whisper_state*,
+                                           const whisper_token_data*, int, float*,
+                                           void* user_data) {
+            auto* clock = static_cast<PhaseClock*>(user_data);
+            if (clock->phase == Stage::encoder) clock->enter(Stage::decoder);
+        };
+        params.logits_filter_callback_user_data = this;
+    }
+
+    /// Close the phase still open when whisper_full returns.
+    void finish() { enter(phase); }
+};
+
+} // namespace
+
+// ---------------------------------------------------------------------------
+// Model / StateLease
+// ---------------------------------------------------------------------------
+
+struct WhisperEngine::Model {
+    ::whisper_context*              ctx = nullptr;
+    std::vector<::whisper_state*>   states;     // every state owned by the pool
+    std::vector<::whisper_state*>   idle;       // states not currently leased
+    std::mutex                      mu;
+    std::condition_variable         cv;
+
+    ModelTier                       tier = ModelTier::standard;
+    size_t                          bytes = 0;  // approximate resident size
+    std::atomic<int64_t>            last_used{0};   // steady_clock ticks
+    int                             tuned_threads = 0;  // calibrated; 0 = not calibrated
+    std::string                     fingerprint;        // file size + path
+    ::whisper_state*                caption_state = nullptr;   // outside the pool; guarded by caption_mu_
+
+    Model() = default;
+    Model(const Model&) = delete;
+    Model& operator=(const Model&) = delete;
+
+    ~Model() {
+        for (auto* st : states) {
+            whisper_free_state(st);
+        }
+        if (caption_state) {
+            whisper_free_state(caption_state);
+        }
+        if (ctx) {
+            whisper_free(ctx);
+        }
+    }
+
+    /// Block until a state is idle, then take it.  `in_use` receives the
+    /// number of leased states, this one included.
+    ::whisper_state* acquire(int& in_use) {
+        std::unique_lock<std::mutex> lock(mu);
+        cv.wait(lock, [this] { return !idle.empty(); });
+        ::whisper_state* st = idle.back();
+        idle.pop_back();
+        in_use = static_cast<int>(states.size() - idle.size());
+        return st;
+    }
+
+    void release(::whisper_state* st) {
+        {
+            std::lock_guard<std::mutex> lock(mu);
+            idle.push_back(st);
+        }
+        cv.notify_one();
+    }
+};
+
+class WhisperEngine::StateLease {
+public:
+    explicit StateLease(std::shared_ptr<Model> model)
+        : model_(std::move(model)), state_(model_->acquire(concurrent_)) {}
+    ~StateLease() { model_->release(state_); }
+
+    StateLease(const StateLease&) = delete;
+    StateLease& operator=(const StateLease&) = delete;
+
+    const Model&       model() const { return *model_; }
+    ::whisper_context* ctx() const { return model_->ctx; }
+    ::whisper_state*   state() const { return state_; }
+
+    /// Leases held on the pool when this one was taken, itself included.
+    int concurrent() const { return concurrent_; }
+
+private:
+    std::shared_ptr<Model> model_;   // keeps the model alive across a hot swap
+    int                    concurrent_ = 1;
+    ::whisper_state*       state_;
+};
+
 // ---------------------------------------------------------------------------
 // Construction / destruction
 // ---------------------------------------------------------------------------
@@ -16,28 +299,56 @@ namespace vr {
 WhisperEngine::WhisperEngine() = default;
 
 WhisperEngine::~WhisperEngine() {
+    // The preload thread writes model_; let it finish first.
+    wait_for_preload();
     std::lock_guard<std::mutex> lock(mu_);
-    if (ctx_) {
-        whisper_free(ctx_);
-        ctx_ = nullptr;
-    }
+    model_.reset();
 }
 
 WhisperEngine::WhisperEngine(WhisperEngine&& other) noexcept {
+    other.wait_for_preload();
+    std::lock_guard<std::mutex> stream_lock(other.stream_mu_);
     std::lock_guard<std::mutex> lock(other.mu_);
-    ctx_ = other.ctx_;
-    other.ctx_ = nullptr;
+    model_ = std::move(other.model_);
+    registry_ = std::move(other.registry_);
+    memory_budget_ = other.memory_budget_;
+    vad_enabled_ = other.vad_enabled_.load();
+    thread_override_ = other.thread_override_.load();
+    stream_overlap_ms_ = other.stream_overlap_ms_.load();
+    stream_buf_  = std::move(other.stream_buf_);
+    stream_text_ = std::move(other.stream_text_);
+    stream_segments_ = std::move(other.stream_segments_);
+    stream_pos_     = other.stream_pos_;
+    stream_carry_   = other.stream_carry_;
+    stream_overlap_ = other.stream_overlap_;
+    stream_rate_ = other.stream_rate_;
+    streaming_   = other.streaming_;
+    other.streaming_ = false;
 }
 
 WhisperEngine& WhisperEngine::operator=(WhisperEngine&& other) noexcept {
     if (this != &other) {
+        wait_for_preload();
+        other.wait_for_preload();
+        std::lock_guard<std::mutex> slk1(stream_mu_);
+        std::lock_guard<std::mutex> slk2(other.stream_mu_);
         std::lock_guard<std::mutex> lk1(mu_);
         std::lock_guard<std::mutex> lk2(other.mu_);
-        if (ctx_) {
-            whisper_free(ctx_);
-        }
-        ctx_ = other.ctx_;
-        other.ctx_ = nullptr;
+        model_ = std::move(other.model_);
+        registry_ = std::move(other.registry_);
+        memory_budget_ = other.memory_budget_;
+        vad_enabled_ = other.vad_enabled_.load();
+        thread_override_ = other.thread_override_.load();
+        stream_overlap_ms_ = other.stream_overlap_ms_.load();
+        stream_buf_  = std::move(other.stream_buf_);
+        stream_text_ = std::move(other.stream_text_);
+        stream_segments_ = std::move(other.stream_segments_);
+        stream_pos_     = other.stream_pos_;
+        stream_carry_   = other.stream_carry_;
+        stream_overlap_ = other.stream_overlap_;
+        stream_rate_ = other.stream_rate_;
+        streaming_   = other.streaming_;
+        other.streaming_ = false;
     }
     return *this;
 }
@@ -46,31 +357,386 @@ WhisperEngine& WhisperEngine::operator=(WhisperEngine&& other) noexcept {
 // init
 // ---------------------------------------------------------------------------
 
-bool WhisperEngine::init(const std::string& model_path) {
+bool WhisperEngine::init(const std::string& model_path, int n_states) {
+    // Load first, then swap: transcription keeps running on the current
+    // model meanwhile, and in-flight leases keep it alive afterwards.
+    wait_for_preload();
+
+    std::shared_ptr<Model> model = load_model(model_path, n_states, /*warm_up=*/false);
+    if (!model) {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(mu_);
+    model_ = std::move(model);
+    enforce_budget_locked({});
+    return true;
+}
+
+// ---------------------------------------------------------------------------
+// preload
+// ---------------------------------------------------------------------------
+
+std::shared_future<bool> WhisperEngine::preload(const std::string& model_path, int n_states) {
     std::lock_guard<std::mutex> lock(mu_);
 
-    if (ctx_) {
-        whisper_free(ctx_);
-        ctx_ = nullptr;
+    // Loads run one at a time, in call order.
+    std::shared_future<bool> previous = pending_load_;
+    pending_load_ = std::async(std::launch::async, [this, model_path, n_states, previous]() {
+        if (previous.valid()) previous.wait();
+
+        const auto start = std::chrono::steady_clock::now();
+        std::shared_ptr<Model> model = load_model(model_path, n_states, /*warm_up=*/true);
+        const auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - start).count();
+
+        std::lock_guard<std::mutex> lk(mu_);
+        if (!model) {
+            fprintf(stderr, "[WhisperEngine] preload FAILED: %s\n", model_path.c_str());
+            return false;
+        }
+        fprintf(stderr, "[WhisperEngine] preload ready in %lld ms\n", static_cast<long long>(ms));
+        model_ = std::move(model);
+        enforce_budget_locked({});
+        return true;
+    }).share();
+    return pending_load_;
+}
+
+void WhisperEngine::wait_for_preload() const {
+    std::shared_future<bool> pending;
+    {
+        std::lock_guard<std::mutex> lock(mu_);
+        pending = pending_load_;
     }
+    if (pending.valid()) pending.wait();
+}
 
+// ---------------------------------------------------------------------------
+// load_model
+// ---------------------------------------------------------------------------
+
+std::shared_ptr<WhisperEngine::Model> WhisperEngine::load_model(const std::string& model_path,
+                                                                int n_states, bool warm_up,
+                                                                ModelTier tier) {
     struct whisper_context_params cparams = whisper_context_default_params();
     cparams.use_gpu = true;  // Metal on Apple Silicon
 
-    ctx_ = whisper_init_from_file_with_params(model_path.c_str(), cparams);
-    if (!ctx_) {
+    // Load weights without the implicit default state — the pool below
+    // allocates every state explicitly.  Read through an mmap when
+    // possible; fall back to whisper's own file reader.
+    auto model = std::make_shared<Model>();
+    {
+        MappedFile file(model_path);
+        if (file.ok()) {
+            whisper_model_loader loader = file.loader();
+            model->ctx = whisper_init_with_params_no_state(&loader, cparams);
+        } else {
+            model->ctx = whisper_init_from_file_with_params_no_state(model_path.c_str(), cparams);
+        }
+    }
+    if (!model->ctx) {
+        return nullptr;
+    }
+
+    const int count = std::max(1, n_states);
+    for (int i = 0; i < count; ++i) {
+        ::whisper_state* st = whisper_init_state(model->ctx);
+        if (!st) {
+            break;
+        }
+        model->states.push_back(st);
+    }
+    if (model->states.empty()) {
+        fprintf(stderr, "[WhisperEngine] whisper_init_state() failed\n");
+        return nullptr;
+    }
+    if (static_cast<int>(model->states.size()) < count) {
+        fprintf(stderr, "[WhisperEngine] allocated %zu of %d states\n",
+                model->states.size(), count);
+    }
+    model->idle = model->states;
+    model->tier = tier;
+
+    struct stat st {};
+    const size_t file_bytes = ::stat(model_path.c_str(), &st) == 0 ? static_cast<size_t>(st.st_size) : 0;
+    model->bytes = file_bytes + model->states.size() * std::max(file_bytes / 4, kMinStateBytes);
+    const std::string calibration_key = std::to_string(file_bytes) + ":" + model_path;
+    model->fingerprint = calibration_key;
+
+    if (warm_up) {
+        // One second of silence through the full encoder + a single decoder
+        // step compiles the Metal pipelines and touches every weight, so
+        // the user's first request doesn't pay for it.  A failure here only
+        // costs that first request the same latency as before.
+        const std::vector<float> silence(kWarmUpSamples, 0.0f);
+        const auto start = std::chrono::steady_clock::now();
+        const int ret = whisper_full_with_state(model->ctx, model->states.front(),
+                                                probe_params(default_threads()),
+                                                silence.data(), kWarmUpSamples);
+        const auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - start).count();
+        fprintf(stderr, "[WhisperEngine] warm-up %s in %lld ms\n",
+                ret == 0 ? "done" : "FAILED", static_cast<long long>(ms));
+
+        // With the pipelines warm, pick this model's thread count.
+        if (ret == 0) {
+            model->tuned_threads = calibrate_threads(*model, calibration_key);
+        }
+    } else {
+        // No time for a benchmark on the synchronous path; reuse a result
+        // from an earlier (pre)load if there is one.
+        CalibrationCache& cache = calibration_cache();
+        std::lock_guard<std::mutex> lock(cache.mu);
+        cache.load_locked();
+        auto it = cache.threads.find(calibration_key);
+        if (it != cache.threads.end()) model->tuned_threads = it->second;
+    }
+
+    return model;
+}
+
+// ---------------------------------------------------------------------------
+// Threading
+// ---------------------------------------------------------------------------
+
+int WhisperEngine::calibrate_threads(Model& model, const std::string& cache_key) {
+    CalibrationCache& cache = calibration_cache();
+    {
+        std::lock_guard<std::mutex> lock(cache.mu);
+        cache.load_locked();
+        auto it = cache.threads.find(cache_key);
+        if (it != cache.threads.end()) return it->second;
+    }
+
+    // Candidates around the performance-core count: all of them, all
+    // physical cores, and two smaller counts (memory bandwidth, not ALUs,
+    // often limits the larger models).
+    const CpuTopology& cpu = CpuTopology::current();
+    const int p = default_threads();
+    std::vector<int> candidates = {
+        p, std::min(cpu.performance_cores + cpu.efficiency_cores, kMaxAutoThreads),
+        p - 2, p / 2,
+    };
+    candidates.erase(std::remove_if(candidates.begin(), candidates.end(),
+                                    [&](int n) { return n < 1 || n > cpu.logical_cores; }),
+                     candidates.end());
+    std::sort(candidates.begin(), candidates.end());
+    candidates.erase(std::unique(candidates.begin(), candidates.end()), candidates.end());
+
+    const std::vector<float> silence(kWarmUpSamples, 0.0f);
+    int best = p;
+    auto best_time = std::chrono::steady_clock::duration::max();
+    for (int n : candidates) {
+        const auto start = std::chrono::steady_clock::now();
+        const int ret = whisper_full_with_state(model.ctx, model.states.front(),
+                                                probe_params(n), silence.data(), kWarmUpSamples);
+        const auto elapsed = std::chrono::steady_clock::now() - start;
+        if (ret != 0) continue;
+        fprintf(stderr, "[WhisperEngine] calibrate: %d threads in %lld ms\n", n,
+                static_cast<long long>(
+                    std::chrono::duration_cast<std::chrono::milliseconds>(elapsed).count()));
+        if (elapsed < best_time) {
+            best_time = elapsed;
+            best = n;
+        }
+    }
+    fprintf(stderr, "[WhisperEngine] calibrated to %d threads (%dP + %dE cores)\n",
+            best, cpu.performance_cores, cpu.efficiency_cores);
+
+    std::lock_guard<std::mutex> lock(cache.mu);
+    cache.threads[cache_key] = best;
+    cache.save_locked();
+    return best;
+}
+
+int WhisperEngine::threads_for(const Model& model, int concurrent) const {
+    const int forced = thread_override_.load();
+    if (forced > 0) return forced;
+    const int base = model.tuned_threads > 0 ? model.tuned_threads : default_threads();
+    return std::max(1, base / std::max(1, concurrent));
+}
+
+void WhisperEngine::set_thread_count(int n_threads) {
+    thread_override_.store(std::max(0, n_threads));
+}
+
+int WhisperEngine::thread_count() const {
+    std::lock_guard<std::mutex> lock(mu_);
+    if (model_) return threads_for(*model_, 1);
+    const int forced = thread_override_.load();
+    return forced > 0 ? forced : default_threads();
+}
+
+bool WhisperEngine::thread_count_overridden() const {
+    return thread_override_.load() > 0;
+}
+
+void WhisperEngine::set_calibration_cache_path(const std::string& path) {
+    CalibrationCache& cache = calibration_cache();
+    std::lock_guard<std::mutex> lock(cache.mu);
+    cache.path   = path;
+    cache.loaded = false;
+}
+
+// ---------------------------------------------------------------------------
+// Model registry
+// ---------------------------------------------------------------------------
+
+bool WhisperEngine::add_model(const std::string& id, const std::string& model_path,
+                              ModelTier tier, int n_states) {
+    std::shared_ptr<Model> model = load_model(model_path, n_states, /*warm_up=*/true, tier);
+    if (!model) {
+        fprintf(stderr, "[WhisperEngine] add_model(%s) FAILED: %s\n", id.c_str(), model_path.c_str());
         return false;
     }
+    model->last_used.store(now_ticks());
+
+    std::lock_guard<std::mutex> lock(mu_);
+    registry_[id] = std::move(model);
+    fprintf(stderr, "[WhisperEngine] registered %s (%s tier)\n", id.c_str(), tier_name(tier));
+    enforce_budget_locked(id);
     return true;
 }
 
+bool WhisperEngine::remove_model(const std::string& id) {
+    std::lock_guard<std::mutex> lock(mu_);
+    return registry_.erase(id) > 0;
+}
+
+bool WhisperEngine::set_default_model(const std::string& id) {
+    std::lock_guard<std::mutex> lock(mu_);
+    auto it = registry_.find(id);
+    if (it == registry_.end()) return false;
+    model_ = it->second;
+    enforce_budget_locked(id);
+    return true;
+}
+
+std::vector<std::string> WhisperEngine::model_ids() const {
+    std::lock_guard<std::mutex> lock(mu_);
+    std::vector<std::string> ids;
+    ids.reserve(registry_.size());
+    for (const auto& [id, model] : registry_) ids.push_back(id);
+    return ids;
+}
+
+void WhisperEngine::set_memory_budget(size_t bytes) {
+    std::lock_guard<std::mutex> lock(mu_);
+    memory_budget_ = bytes;
+    enforce_budget_locked({});
+}
+
+size_t WhisperEngine::memory_budget() const {
+    std::lock_guard<std::mutex> lock(mu_);
+    return memory_budget_;
+}
+
+size_t WhisperEngine::memory_in_use() const {
+    std::lock_guard<std::mutex> lock(mu_);
+    return memory_in_use_locked();
+}
+
+size_t WhisperEngine::memory_in_use_locked() const {
+    size_t total = 0;
+    bool default_registered = false;
+    for (const auto& [id, model] : registry_) {
+        total += model->bytes;
+        default_registered |= (model == model_);
+    }
+    if (model_ && !default_registered) total += model_->bytes;
+    return total;
+}
+
+void WhisperEngine::enforce_budget_locked(const std::string& keep) {
+    while (memory_in_use_locked() > memory_budget_) {
+        auto victim = registry_.end();
+        for (auto it = registry_.begin(); it != registry_.end(); ++it) {
+            if (it->first == keep || it->second == model_) continue;
+            if (victim == registry_.end() ||
+                it->second->last_used.load() < victim->second->last_used.load()) {
+                victim = it;
+            }
+        }
+        if (victim == registry_.end()) {
+            fprintf(stderr, "[WhisperEngine] %zu MB loaded exceeds the %zu MB budget\n",
+                    memory_in_use_locked() >> 20, memory_budget_ >> 20);
+            return;
+        }
+        fprintf(stderr, "[WhisperEngine] evicting %s to stay within the memory budget\n",
+                victim->first.c_str());
+        registry_.erase(victim);   // freed once its in-flight leases end
+    }
+}
+
+std::shared_ptr<WhisperEngine::Model> WhisperEngine::route(std::optional<ModelTier> tier,
+                                                           double seconds) const {
+    const ModelTier want = tier ? *tier
+                                : (seconds <= kShortClipSec ? ModelTier::fast : ModelTier::standard);
+    {
+        std::lock_guard<std::mutex> lock(mu_);
+        for (ModelTier t : tier_preference(want)) {
+            // The default model wins ties, then the most recently used.
+            if (model_ && model_->tier == t) return model_;
+            std::shared_ptr<Model> best;
+            for (const auto& [id, model] : registry_) {
+                if (model->tier == t &&
+                    (!best || model->last_used.load() > best->last_used.load())) {
+                    best = model;
+                }
+            }
+            if (best) return best;
+        }
+    }
+    return current_model();   // nothing loaded: wait for a pending preload
+}
+
 // ---------------------------------------------------------------------------
-// is_loaded
+// is_loaded / state_count
 // ---------------------------------------------------------------------------
 
 bool WhisperEngine::is_loaded() const {
     std::lock_guard<std::mutex> lock(mu_);
-    return ctx_ != nullptr;
+    return model_ != nullptr || !registry_.empty();
+}
+
+bool WhisperEngine::is_loading() const {
+    std::lock_guard<std::mutex> lock(mu_);
+    return pending_load_.valid() &&
+           pending_load_.wait_for(std::chrono::seconds(0)) != std::future_status::ready;
+}
+
+int WhisperEngine::state_count() const {
+    std::lock_guard<std::mutex> lock(mu_);
+    return model_ ? static_cast<int>(model_->states.size()) : 0;
+}
+
+std::string WhisperEngine::model_fingerprint(std::optional<ModelTier> tier, double seconds) const {
+    const std::shared_ptr<Model> model = route(tier, seconds);
+    return model ? model->fingerprint : std::string();
+}
+
+void WhisperEngine::set_vad_enabled(bool enabled) {
+    vad_enabled_.store(enabled);
+}
+
+bool WhisperEngine::vad_enabled() const {
+    return vad_enabled_.load();
+}
+
+std::shared_ptr<WhisperEngine::Model> WhisperEngine::current_model() const {
+    std::shared_future<bool> pending;
+    {
+        std::lock_guard<std::mutex> lock(mu_);
+        if (model_ || !pending_load_.valid()) return model_;
+        pending = pending_load_;
+    }
+
+    // Nothing loaded yet, but a preload is on its way: wait for it rather
+    // than failing the request.
+    pending.wait();
+    std::lock_guard<std::mutex> lock(mu_);
+    return model_;
 }
 
 // ---------------------------------------------------------------------------
@@ -79,32 +745,109 @@ bool WhisperEngine::is_loaded() const {
 
 std::string WhisperEngine::transcribe(const std::vector<float>& audio_data,
                                       int sample_rate,
-                                      ProgressCallback progress) {
-    std::lock_guard<std::mutex> lock(mu_);
+                                      ProgressCallback progress,
+                                      const TranscribeOptions& options) {
+    return transcribe(audio_data.data(), audio_data.size(), sample_rate,
+                      std::move(progress), options);
+}
+
+std::string WhisperEngine::transcribe(const float* samples, size_t count,
+                                      int sample_rate,
+                                      ProgressCallback progress,
+                                      const TranscribeOptions& options) {
+    return join_segments(transcribe_segments(samples, count, sample_rate,
+                                             std::move(progress), options));
+}
 
-    if (!ctx_) {
+std::vector<TranscriptSegment> WhisperEngine::transcribe_segments(
+    const float* samples, size_t count, int sample_rate,
+    ProgressCallback progress, const TranscribeOptions& options) {
+    // Cut out the requested range, in source samples.
+    if (sample_rate > 0 && (options.begin_ms > 0 || options.end_ms > 0)) {
+        const auto to_sample = [&](int64_t ms) {
+            return std::min(count, static_cast<size_t>(std::max<int64_t>(0, ms)) *
+                                       static_cast<size_t>(sample_rate) / 1000);
+        };
+        const size_t first = to_sample(options.begin_ms);
+        const size_t last  = options.end_ms > 0 ? to_sample(options.end_ms) : count;
+        samples += first;
+        count = last > first ? last - first : 0;
+    }
+    const int64_t offset_ms = std::max<int64_t>(0, options.begin_ms);
+
+    // Route on the clip's length before any work is done on it.
+    const double clip_sec = sample_rate > 0
+        ? static_cast<double>(count) / static_cast<double>(sample_rate) : 0.0;
+    std::shared_ptr<Model> model = route(options.tier, clip_sec);
+    if (!model) {
         throw std::runtime_error("Whisper model not loaded");
     }
+    model->last_used.store(now_ticks());
 
-    // 1. Resample to 16 kHz if necessary.
-    std::vector<float> pcm16k;
+    // 1. Resample to 16 kHz if necessary.  16 kHz input (the recording
+    //    format) is read in place.
+    std::vector<float> resampled;
+    const float* pcm16k = samples;
+    size_t n_samples = count;
     if (sample_rate != 16000) {
-        pcm16k = resample_to_16k(audio_data, sample_rate);
-    } else {
-        pcm16k = audio_data;
+        if (auto resampler = Resampler::get(sample_rate, 16000)) {
+            resampler->process(samples, count, resampled);
+        }
+        pcm16k = resampled.data();
+        n_samples = resampled.size();
     }
 
-    if (pcm16k.empty()) {
+    if (!pcm16k || n_samples == 0) {
         throw std::runtime_error("Audio data is empty after resampling");
     }
 
+    // 2. Voice-activity detection: drop silence before it reaches the model.
+    //    Long pauses cost encoder windows and invite hallucinated text.
+    //    `timeline` maps packed offsets back to the original audio.
+    std::optional<SpeechTimeline> timeline;
+    if (vad_enabled()) {
+        const std::vector<SpeechSegment> speech = detect_speech(pcm16k, n_samples);
+        const size_t speech_samples = std::accumulate(
+            speech.begin(), speech.end(), size_t{0},
+            [](size_t sum, const SpeechSegment& s) { return sum + (s.end - s.start); });
+
+        fprintf(stderr, "[WhisperEngine] VAD: %.2fs of %.2fs is speech (%zu segments)\n",
+                static_cast<float>(speech_samples) / 16000.0f,
+                static_cast<float>(n_samples) / 16000.0f, speech.size());
+
+        if (speech.empty()) {
+            if (progress) progress(1.0f);
+            return {};
+        }
+        if (static_cast<double>(speech_samples) <
+            static_cast<double>(n_samples) * (1.0 - kVadMinSavedFraction)) {
+            timeline.emplace(pcm16k, speech, kVadGapSamples);
+            pcm16k    = timeline->audio().data();
+            n_samples = timeline->audio().size();
+        }
+    }
+
     // Configure whisper parameters
-    whisper_full_params params = whisper_full_default_params(WHISPER_SAMPLING_GREEDY);
+    whisper_full_params params = whisper_full_default_params(
+        options.beam_search ? WHISPER_SAMPLING_BEAM_SEARCH : WHISPER_SAMPLING_GREEDY);
     params.print_progress   = false;
     params.print_timestamps = false;
     params.single_segment   = false;
     params.language         = "en";
-    params.n_threads        = 4;
+    if (!options.prompt.empty()) {
+        params.initial_prompt = options.prompt.c_str();
+    }
+    if (options.beam_search) {
+        params.beam_search.beam_size = kBeamSize;
+    }
+    if (options.abort) {
+        params.abort_callback = [](void* user_data) {
+            return static_cast<const std::atomic<bool>*>(user_data)->load(
+                std::memory_order_relaxed);
+        };
+        params.abort_callback_user_data =
+            const_cast<std::atomic<bool>*>(options.abort);
+    }
 
     // Wire up progress callback
     struct CallbackCtx { ProgressCallback cb; };
@@ -120,68 +863,340 @@ std::string WhisperEngine::transcribe(const std::vector<float>& audio_data,
     };
     params.progress_callback_user_data = &cb_ctx;
 
+    // Counted from here, so a caption yields while this waits for a state.
+    struct ActiveRequest {
+        std::atomic<int>& n;
+        explicit ActiveRequest(std::atomic<int>& count) : n(count) { n.fetch_add(1); }
+        ~ActiveRequest() { n.fetch_sub(1); }
+    } active(active_requests_);
+
+    // Lease a state (blocks while every state is busy).  The thread count
+    // depends on how many other requests hold one of its siblings.
+    StateLease lease(std::move(model));
+    params.n_threads = options.n_threads > 0
+        ? options.n_threads : threads_for(lease.model(), lease.concurrent());
+
     // Diagnostic logging
-    float duration_sec = static_cast<float>(pcm16k.size()) / 16000.0f;
-    fprintf(stderr, "[WhisperEngine] transcribe: %zu samples, %.2fs duration, sampleRate=%d\n",
-            pcm16k.size(), duration_sec, sample_rate);
+    float duration_sec = static_cast<float>(n_samples) / 16000.0f;
+    fprintf(stderr, "[WhisperEngine] transcribe: %zu samples, %.2fs duration, sampleRate=%d, %s model, %s, %d threads\n",
+            n_samples, duration_sec, sample_rate, tier_name(lease.model().tier),
+            options.beam_search ? "beam search" : "greedy", params.n_threads);
 
-    // Run inference
-    int ret = whisper_full(ctx_, params, pcm16k.data(),
-                           static_cast<int>(pcm16k.size()));
+    int ret;
+    {
+        StageSpan span(Stage::transcribe);
+        PhaseClock phases;
+        phases.install(params);
+        ret = whisper_full_with_state(lease.ctx(), lease.state(), params,
+                                      pcm16k, static_cast<int>(n_samples));
+        phases.finish();
+    }
+    if (options.abort && options.abort->load()) {
+        fprintf(stderr, "[WhisperEngine] transcribe aborted\n");
+        throw TranscriptionAborted();
+    }
     if (ret != 0) {
         fprintf(stderr, "[WhisperEngine] whisper_full() FAILED with code %d\n", ret);
         throw std::runtime_error("whisper_full() returned error code " + std::to_string(ret));
     }
 
-    // Collect segments
-    std::string result;
-    int n_segments = whisper_full_n_segments(ctx_);
+    // Collect segments.  whisper's times are centiseconds into the buffer
+    // it saw; map them back through VAD packing to the original audio.
+    const auto to_ms = [&](int64_t t_cs) -> int64_t {
+        size_t sample = static_cast<size_t>(std::max<int64_t>(0, t_cs)) * 160;
+        if (timeline) sample = timeline->to_original(std::min(sample, n_samples));
+        return offset_ms + static_cast<int64_t>(sample / 16);
+    };
+    const whisper_token eot = whisper_token_eot(lease.ctx());
+
+    std::vector<TranscriptSegment> segments;
+    size_t text_length = 0;
+    const int n_segments = whisper_full_n_segments_from_state(lease.state());
+    segments.reserve(static_cast<size_t>(std::max(0, n_segments)));
     for (int i = 0; i < n_segments; ++i) {
-        const char* text = whisper_full_get_segment_text(ctx_, i);
-        if (text) {
-            result += text;
+        const char* text = whisper_full_get_segment_text_from_state(lease.state(), i);
+        if (!text) continue;
+
+        TranscriptSegment seg;
+        seg.text  = text;
+        seg.t0_ms = to_ms(whisper_full_get_segment_t0_from_state(lease.state(), i));
+        seg.t1_ms = std::max(seg.t0_ms,
+                             to_ms(whisper_full_get_segment_t1_from_state(lease.state(), i)));
+
+        // Mean probability over text tokens; timestamps and other special
+        // tokens (ids from EOT up) say nothing about the words.
+        float p_sum = 0.0f;
+        int   p_n   = 0;
+        const int n_tokens = whisper_full_n_tokens_from_state(lease.state(), i);
+        for (int j = 0; j < n_tokens; ++j) {
+            if (whisper_full_get_token_id_from_state(lease.state(), i, j) >= eot) continue;
+            p_sum += whisper_full_get_token_p_from_state(lease.state(), i, j);
+            ++p_n;
         }
+        seg.avg_prob = p_n > 0 ? p_sum / static_cast<float>(p_n) : 0.0f;
+
+        text_length += seg.text.size();
+        segments.push_back(std::move(seg));
     }
 
     // Diagnostic: log segment count and result preview
     fprintf(stderr, "[WhisperEngine] transcribe done: %d segments, result length=%zu",
-            n_segments, result.size());
-    if (!result.empty()) {
-        std::string preview = result.substr(0, 20);
-        fprintf(stderr, ", preview=\"%s%s\"", preview.c_str(), result.size() > 20 ? "..." : "");
+            n_segments, text_length);
+    if (!segments.empty()) {
+        std::string preview = segments.front().text.substr(0, 20);
+        fprintf(stderr, ", preview=\"%s%s\"", preview.c_str(), text_length > 20 ? "..." : "");
     }
     fprintf(stderr, "\n");
 
-    return result;
+    return segments;
+}
+
+// ---------------------------------------------------------------------------
+// Streaming  (begin_stream / feed / finish)
+// ---------------------------------------------------------------------------
+
+void WhisperEngine::begin_stream(int sample_rate) {
+    std::lock_guard<std::mutex> lock(stream_mu_);
+    stream_buf_.clear();
+    stream_text_.clear();
+    stream_segments_.clear();
+    stream_rate_    = sample_rate > 0 ? sample_rate : 16000;
+    stream_pos_     = 0;
+    stream_carry_   = 0;
+    stream_overlap_ = static_cast<size_t>(stream_overlap_ms_.load()) *
+                      static_cast<size_t>(stream_rate_) / 1000;
+    streaming_      = true;
+}
+
+std::string WhisperEngine::feed(const float* samples, size_t count,
+                                ProgressCallback progress) {
+    std::lock_guard<std::mutex> lock(stream_mu_);
+
+    if (!streaming_) {
+        throw std::runtime_error("feed() called without begin_stream()");
+    }
+    if (samples && count > 0) {
+        stream_buf_.insert(stream_buf_.end(), samples, samples + count);
+    }
+
+    const size_t step = static_cast<size_t>(kStreamWindowSec) *
+                        static_cast<size_t>(stream_rate_);
+    std::string produced;
+
+    while (stream_buf_.size() >= stream_carry_ + step) {
+        // The window is the overlap carried from the previous one plus a
+        // full step of new audio.
+        const size_t window = stream_carry_ + step;
+
+        // A failed window is dropped instead of wedging the stream.  The
+        // audio is still in SQLite, so a retry can recover it.
+        std::vector<TranscriptSegment> segments;
+        try {
+            segments = transcribe_segments(stream_buf_.data(), window, stream_rate_,
+                                           progress, stream_options());
+        } catch (...) {
+            advance_stream(window, false);
+            throw;
+        }
+        const std::string text = append_segments(std::move(segments));
+        advance_stream(window, true);
+        append_text(produced, text);
+        append_text(stream_text_, text);
+    }
+
+    return produced;
+}
+
+std::string WhisperEngine::finish(ProgressCallback progress) {
+    std::lock_guard<std::mutex> lock(stream_mu_);
+
+    if (!streaming_) {
+        throw std::runtime_error("finish() called without begin_stream()");
+    }
+    streaming_ = false;
+
+    // Only the overlap left means every sample has been transcribed.
+    if (stream_buf_.size() > stream_carry_) {
+        std::vector<TranscriptSegment> segments = transcribe_segments(
+            stream_buf_.data(), stream_buf_.size(), stream_rate_, progress, stream_options());
+        append_text(stream_text_, append_segments(std::move(segments)));
+    } else if (progress) {
+        progress(1.0f);
+    }
+    stream_buf_.clear();
+    stream_carry_ = 0;
+
+    std::string full;
+    full.swap(stream_text_);
+    return full;
+}
+
+void WhisperEngine::cancel_stream() {
+    std::lock_guard<std::mutex> lock(stream_mu_);
+    stream_buf_.clear();
+    stream_text_.clear();
+    stream_segments_.clear();
+    stream_pos_   = 0;
+    stream_carry_ = 0;
+    streaming_    = false;
+}
+
+std::vector<TranscriptSegment> WhisperEngine::stream_segments() const {
+    std::lock_guard<std::mutex> lock(stream_mu_);
+    return stream_segments_;
+}
+
+void WhisperEngine::set_stream_overlap_ms(int ms) {
+    stream_overlap_ms_.store(std::clamp(ms, 0, kMaxStreamOverlapMs));
+}
+
+int WhisperEngine::stream_overlap_ms() const {
+    return stream_overlap_ms_.load();
+}
+
+TranscribeOptions WhisperEngine::stream_options() const {
+    TranscribeOptions options;
+    options.prompt = prompt_tail(stream_text_, kStreamPromptWords);
+    return options;
+}
+
+void WhisperEngine::advance_stream(size_t n, bool keep_overlap) {
+    n = std::min(n, stream_buf_.size());
+    const size_t keep = keep_overlap ? std::min(stream_overlap_, n) : 0;
+    stream_buf_.erase(stream_buf_.begin(), stream_buf_.begin() + (n - keep));
+    stream_pos_  += n - keep;
+    stream_carry_ = keep;
+}
+
+std::string WhisperEngine::append_segments(std::vector<TranscriptSegment> segments) {
+    // Window-relative times → stream-relative.
+    const auto to_ms = [this](size_t sample) {
+        return static_cast<int64_t>(sample * 1000 / static_cast<size_t>(stream_rate_));
+    };
+    const int64_t offset = to_ms(stream_pos_);
+    for (auto& seg : segments) {
+        seg.t0_ms += offset;
+        seg.t1_ms += offset;
+    }
+
+    // The window opened with audio the previous one already transcribed.
+    // Allow for a brisk ~4 words per second of overlap, plus slack for a
+    // word the boundary split in two.
+    if (stream_carry_ > 0) {
+        const int64_t overlap_ms = to_ms(stream_carry_);
+        const size_t max_words = 2 + static_cast<size_t>(overlap_ms) * 4 / 1000;
+        const size_t dropped = merge_overlap(stream_text_, segments,
+                                             offset + overlap_ms, max_words);
+        if (dropped > 0) {
+            fprintf(stderr, "[WhisperEngine] stream overlap: dropped %zu repeated words\n",
+                    dropped);
+        }
+    }
+
+    std::string text = join_segments(segments);
+    stream_segments_.insert(stream_segments_.end(),
+                            std::make_move_iterator(segments.begin()),
+                            std::make_move_iterator(segments.end()));
+    return text;
+}
+
+bool WhisperEngine::is_streaming() const {
+    std::lock_guard<std::mutex> lock(stream_mu_);
+    return streaming_;
+}
+
+void WhisperEngine::append_text(std::string& out, const std::string& text) {
+    if (text.empty()) return;
+    // whisper's segments usually carry their own leading space.
+    if (!out.empty() && !std::isspace(static_cast<unsigned char>(out.back())) &&
+        !std::isspace(static_cast<unsigned char>(text.front()))) {
+        out += " ";
+    }
+    out += text;
 }
 
 // ---------------------------------------------------------------------------
-// resample_to_16k  (simple linear interpolation — good enough for speech)
+// Live captions
 // ---------------------------------------------------------------------------
 
-std::vector<float> WhisperEngine::resample_to_16k(const std::vector<float>& input,
-                                                   int in_rate) const {
-    if (input.empty() || in_rate <= 0) {
-        return {};
+std::string WhisperEngine::caption(const float* samples, size_t count, int n_threads,
+                                   const std::atomic<bool>* abort) {
+    if (!samples || count == 0) return {};
+
+    std::lock_guard<std::mutex> caption_lock(caption_mu_);
+    std::shared_ptr<Model> model = route(ModelTier::fast, static_cast<double>(count) / 16000.0);
+    if (!model) {
+        throw std::runtime_error("Whisper model not loaded");
+    }
+    model->last_used.store(now_ticks());   // keep the fast model off the eviction list
+    if (!model->caption_state) {
+        model->caption_state = whisper_init_state(model->ctx);
+        if (!model->caption_state) {
+            throw std::runtime_error("Could not allocate the caption state");
+        }
     }
 
-    constexpr int kTargetRate = 16000;
-    const double ratio = static_cast<double>(kTargetRate) / static_cast<double>(in_rate);
-    const size_t out_len = static_cast<size_t>(
-        std::ceil(static_cast<double>(input.size()) * ratio));
+    whisper_full_params params = whisper_full_default_params(WHISPER_SAMPLING_GREEDY);
+    params.print_progress   = false;
+    params.print_timestamps = false;
+    params.no_context       = true;
+    params.no_timestamps    = true;
+    params.single_segment   = true;
+    params.max_tokens       = kCaptionMaxTokens;
+    params.language         = "en";
+    params.n_threads        = std::max(1, n_threads);
+    // The encoder normally runs over a full 30 s window; 50 positions per
+    // second of audio (plus a little slack) cover the caption window at a
+    // fraction of the cost.
+    params.audio_ctx = std::min(1500, static_cast<int>(count / 320) + 32);
 
-    std::vector<float> output(out_len);
+    struct AbortCtx {
+        const std::atomic<bool>* abort;
+        const std::atomic<int>*  active;
+    };
+    AbortCtx abort_ctx{abort, &active_requests_};
+    params.abort_callback = [](void* user_data) {
+        const auto* c = static_cast<const AbortCtx*>(user_data);
+        return (c->abort && c->abort->load(std::memory_order_relaxed)) ||
+               c->active->load(std::memory_order_relaxed) > 0;
+    };
+    params.abort_callback_user_data = &abort_ctx;
 
-    for (size_t i = 0; i < out_len; ++i) {
-        double src_idx = static_cast<double>(i) / ratio;
-        size_t idx0 = static_cast<size_t>(src_idx);
-        size_t idx1 = std::min(idx0 + 1, input.size() - 1);
-        double frac = src_idx - static_cast<double>(idx0);
-        output[i] = static_cast<float>(
-            input[idx0] * (1.0 - frac) + input[idx1] * frac);
+    const int ret = whisper_full_with_state(model->ctx, model->caption_state, params,
+                                            samples, static_cast<int>(count));
+    if ((abort && abort->load()) || (ret != 0 && active_requests_.load() > 0)) {
+        throw TranscriptionAborted();
     }
+    if (ret != 0) {
+        throw std::runtime_error("whisper_full() returned error code " + std::to_string(ret));
+    }
+
+    std::vector<TranscriptSegment> segments;
+    const int n_segments = whisper_full_n_segments_from_state(model->caption_state);
+    for (int i = 0; i < n_segments; ++i) {
+        const char* text = whisper_full_get_segment_text_from_state(model->caption_state, i);
+        if (!text) continue;
+        TranscriptSegment seg;
+        seg.text = text;
+        segments.push_back(std::move(seg));
+    }
+    return join_segments(segments);
+}
 
-    return output;
+void WhisperEngine::release_caption_states() {
+    std::lock_guard<std::mutex> caption_lock(caption_mu_);
+    std::vector<std::shared_ptr<Model>> models;
+    {
+        std::lock_guard<std::mutex> lock(mu_);
+        if (model_) models.push_back(model_);
+        for (const auto& entry : registry_) models.push_back(entry.second);
+    }
+    for (const auto& model : models) {
+        if (model->caption_state) {
+            whisper_free_state(model->caption_state);
+            model->caption_state = nullptr;
+        }
+    }
 }
 
 } // namespace vr
@@ -1,18 +1,79 @@
 #pragma once
 
 #include "Types.hpp"
+#include <atomic>
+#include <future>
+#include <map>
 #include <memory>
 #include <mutex>
+#include <optional>
+#include <stdexcept>
 #include <string>
 #include <vector>
 
 // Forward-declare in global namespace to match whisper.h
 struct whisper_context;
+struct whisper_state;
 
 namespace vr {
 
+/// Speed / accuracy class of a loaded model, used to route requests
+/// (e.g. tiny/base.en = fast, base.en = standard, small/medium = accurate).
+enum class ModelTier { fast, standard, accurate };
+
+/// Per-request decoding choices for WhisperEngine::transcribe().
+struct TranscribeOptions {
+    /// Model tier to use; nullopt routes automatically (clips up to
+    /// kShortClipSec go to the fast tier).
+    std::optional<ModelTier> tier;
+
+    /// Beam search (kBeamSize beams) instead of greedy decoding: slower,
+    /// but fewer dropped and misheard words.  Used by the refinement pass.
+    bool beam_search = false;
+
+    /// Transcribe only [begin_ms, end_ms) of the input (end_ms <= 0: to the
+    /// end), e.g. to redo low-confidence segments.  Segment times stay
+    /// relative to the start of the full input.
+    int64_t begin_ms = 0;
+    int64_t end_ms   = 0;
+
+    /// Text that precedes this audio (e.g. the end of the previous stream
+    /// window), passed to whisper as its initial prompt so decoding picks
+    /// up mid-sentence instead of starting cold.
+    std::string prompt;
+
+    /// CPU threads for this request; 0 applies the engine's threading
+    /// policy (see set_thread_count()).
+    int n_threads = 0;
+
+    /// Polled during inference; once it reads true the request stops and
+    /// transcribe() throws TranscriptionAborted.  Lets background work get
+    /// out of the way of a live recording.
+    const std::atomic<bool>* abort = nullptr;
+};
+
+/// Thrown by transcribe() when TranscribeOptions::abort was raised.
+struct TranscriptionAborted : std::runtime_error {
+    TranscriptionAborted() : std::runtime_error("Transcription aborted") {}
+};
+
 /// Thin wrapper around whisper.cpp's C API.
 /// Loads a ggml model once, then transcribes PCM audio buffers on demand.
+///
+/// The loaded weights (one whisper_context) are shared by a small pool of
+/// preallocated whisper_state objects.  Each transcribe() call leases a
+/// state for the duration of whisper_full_with_state(), so up to
+/// state_count() requests run in parallel; further callers wait for a
+/// state to be returned.  The engine mutex only guards the model handles.
+/// CPU threads are divided among the requests sharing a pool, so a live
+/// stream overlapping a recovery job doesn't oversubscribe the cores.
+///
+/// Besides the default model (init() / preload()), further models can be
+/// registered by id with a tier.  transcribe() routes each request to a
+/// tier — short clips to a fast model, explicit requests to an accurate
+/// one — falling back to whatever is loaded.  Swapping any model is
+/// atomic: new requests see the new one, in-flight requests finish on the
+/// old one, which is freed when its last lease ends.
 class WhisperEngine {
 public:
     WhisperEngine();
@@ -24,29 +85,290 @@ public:
     WhisperEngine(WhisperEngine&&) noexcept;
     WhisperEngine& operator=(WhisperEngine&&) noexcept;
 
-    /// Load the ggml model file (e.g. "ggml-base.en.bin").
-    /// Returns true on success.  Thread-safe.
-    bool init(const std::string& model_path);
+    /// Default number of decoder states preallocated per model.  Each state
+    /// owns its own KV cache and compute buffers (tens of MB for base.en).
+    static constexpr int kDefaultStateCount = 2;
+
+    /// Load the ggml model file (e.g. "ggml-base.en.bin") as the default
+    /// (standard-tier) model and preallocate `n_states` inference states.
+    /// Returns true on success.  Thread-safe: the previous model keeps
+    /// serving until the new one is ready (and stays loaded if the load
+    /// fails); requests already in flight finish on it.
+    bool init(const std::string& model_path, int n_states = kDefaultStateCount);
+
+    /// Load a model on a background thread and warm it up with a short
+    /// silent inference, so Metal pipelines and compute buffers are ready
+    /// before the first real request.  Weights are read from an mmap of the
+    /// file, so a relaunch is served from the page cache.  Until the load
+    /// completes, requests keep using the previous model — or, if none is
+    /// loaded, wait for this one.  The future yields init()'s result.
+    std::shared_future<bool> preload(const std::string& model_path,
+                                     int n_states = kDefaultStateCount);
 
     /// Transcribe raw PCM float32 audio.
     /// @param audio_data  Interleaved float32 samples (mono).
     /// @param sample_rate Source sample rate (will be resampled to 16 kHz internally).
     /// @param progress    Optional callback fired with progress 0.0-1.0.
+    /// @param options     Tier routing and decoding strategy.
     /// @return  Transcribed text, or empty string on failure.
     std::string transcribe(const std::vector<float>& audio_data,
                            int sample_rate,
-                           ProgressCallback progress = nullptr);
+                           ProgressCallback progress = nullptr,
+                           const TranscribeOptions& options = {});
+
+    /// Same as above over a borrowed buffer (e.g. NSData bytes).  16 kHz
+    /// input is passed to whisper in place without copying.
+    std::string transcribe(const float* samples, size_t count,
+                           int sample_rate,
+                           ProgressCallback progress = nullptr,
+                           const TranscribeOptions& options = {});
+
+    /// Transcribe into timed segments (see TranscriptSegment) instead of a
+    /// single string.  transcribe() is join_segments() of this.  Audio with
+    /// no detected speech yields no segments.
+    std::vector<TranscriptSegment> transcribe_segments(const float* samples, size_t count,
+                                                       int sample_rate,
+                                                       ProgressCallback progress = nullptr,
+                                                       const TranscribeOptions& options = {});
 
     /// Whether a model has been successfully loaded.
     bool is_loaded() const;
 
+    /// Whether a preload() is still in progress.
+    bool is_loading() const;
+
+    /// Number of inference states in the current model's pool (0 if none).
+    int state_count() const;
+
+    /// Identity of the model a request for `seconds` of audio on `tier`
+    /// would run on (file size and path), e.g. to key cached results.
+    /// Waits for a pending preload like transcribe(); empty if no model is
+    /// available.
+    std::string model_fingerprint(std::optional<ModelTier> tier, double seconds) const;
+
+    // ---- Model registry ----
+
+    /// Load `model_path` and register it as `id` in `tier`, replacing any
+    /// model already registered under that id.  Registered models beyond
+    /// the memory budget are evicted least-recently-used first.  Blocks
+    /// while loading (and warming up); returns false if the load fails.
+    bool add_model(const std::string& id, const std::string& model_path,
+                   ModelTier tier, int n_states = kDefaultStateCount);
+
+    /// Unregister `id`.  In-flight requests on it finish normally.
+    bool remove_model(const std::string& id);
+
+    /// Make the registered model `id` the default, atomically.
+    bool set_default_model(const std::string& id);
+
+    /// Ids of the registered models (not including the init()/preload()
+    /// default unless it was made default from the registry).
+    std::vector<std::string> model_ids() const;
+
+    /// Approximate resident size budget for all loaded models, in bytes.
+    void set_memory_budget(size_t bytes);
+    size_t memory_budget() const;
+
+    /// Approximate resident size of every loaded model, in bytes.
+    size_t memory_in_use() const;
+
+    /// Default memory budget (2 GiB: e.g. tiny + base + small with states).
+    static constexpr size_t kDefaultMemoryBudget = size_t{2} << 30;
+
+    /// Clips up to this long are routed to the fast tier automatically.
+    static constexpr double kShortClipSec = 20.0;
+
+    /// Beams used when TranscribeOptions::beam_search is set.
+    static constexpr int kBeamSize = 5;
+
+    // ---- Threading ----
+
+    /// CPU threads per request.  0 (the default) is automatic: each model's
+    /// calibrated count, or the performance-core count, split evenly across
+    /// the requests running concurrently on its state pool.  A positive
+    /// value is used as is for every request.
+    void set_thread_count(int n_threads);
+
+    /// Threads the next request on the default model would get if it ran
+    /// alone: the override, else that model's automatic count.
+    int thread_count() const;
+
+    /// Whether set_thread_count() has an override in effect.
+    bool thread_count_overridden() const;
+
+    /// File that persists calibration results across launches, keyed by
+    /// model path and size.  Without one, results live for the process only.
+    /// Set it before loading models.
+    static void set_calibration_cache_path(const std::string& path);
+
+    /// Upper bound on the automatic thread count; whisper's CPU kernels
+    /// stop scaling well beyond this.
+    static constexpr int kMaxAutoThreads = 8;
+
+    /// Voice-activity detection before inference (on by default).  Only the
+    /// detected speech spans are passed to whisper, packed back to back;
+    /// audio with no speech returns an empty transcript without running
+    /// the model at all.
+    void set_vad_enabled(bool enabled);
+    bool vad_enabled() const;
+
+    // ---- Streaming ----
+
+    /// Begin an incremental transcription stream.  Audio handed to feed()
+    /// is transcribed window-by-window while recording continues, so
+    /// finish() only has to process whatever is still buffered.
+    /// Discards any stream that was already in progress.
+    void begin_stream(int sample_rate = 16000);
+
+    /// Append mono float32 samples to the current stream.  Every complete
+    /// window (kStreamWindowSec of audio) is transcribed before returning.
+    /// @return  Text of the windows completed by this call (may be empty).
+    std::string feed(const float* samples, size_t count,
+                     ProgressCallback progress = nullptr);
+
+    /// Transcribe any audio still buffered and close the stream.
+    /// @return  Full transcript of everything fed since begin_stream().
+    std::string finish(ProgressCallback progress = nullptr);
+
+    /// Drop the current stream without transcribing the buffered tail.
+    void cancel_stream();
+
+    /// Segments of the current stream, or of the last one finish()ed, with
+    /// times relative to begin_stream().  Cleared by begin_stream() and
+    /// cancel_stream().
+    std::vector<TranscriptSegment> stream_segments() const;
+
+    /// Whether begin_stream() has been called without a matching finish().
+    bool is_streaming() const;
+
+    /// Audio from the end of each stream window that is transcribed again
+    /// at the start of the next, so a word cut by the boundary is heard
+    /// whole once; the repeated words are merged away (merge_overlap()).
+    /// 0 disables overlap.  Clamped to kMaxStreamOverlapMs; takes effect at
+    /// the next begin_stream().
+    void set_stream_overlap_ms(int ms);
+    int stream_overlap_ms() const;
+
+    /// Stream window length — matches the 35-second storage chunks so each
+    /// persisted chunk is transcribed as soon as it arrives.  Each window
+    /// covers this much new audio plus the overlap.
+    static constexpr int kStreamWindowSec = 35;
+
+    /// One second of overlap per 35 s window: under 3% extra inference.
+    static constexpr int kDefaultStreamOverlapMs = 1000;
+    static constexpr int kMaxStreamOverlapMs     = 5000;
+
+    /// Words of the transcript so far carried into each window's prompt.
+    static constexpr size_t kStreamPromptWords = 32;
+
+    // ---- Live captions ----
+
+    /// Decode `count` samples of 16 kHz audio — the last few seconds of a
+    /// recording in progress — into a caption.  Runs on the fast tier
+    /// (falling back like transcribe()) on a state reserved for captions,
+    /// outside the pool, so a caption never holds a state a transcription
+    /// is waiting for.  Greedy, no context, one segment of at most
+    /// kCaptionMaxTokens tokens, with the encoder cut to the window's
+    /// length; no VAD.  A caption yields to transcriptions: it stops as
+    /// soon as one starts (or `abort` reads true) and throws
+    /// TranscriptionAborted.  Captions run one at a time.
+    std::string caption(const float* samples, size_t count, int n_threads,
+                        const std::atomic<bool>* abort = nullptr);
+
+    /// Free the caption states (e.g. when the recording ends).  The next
+    /// caption() allocates one again.
+    void release_caption_states();
+
+    /// Transcription requests running or waiting for a state right now
+    /// (one-shot calls and stream windows; captions are not counted).
+    int active_requests() const { return active_requests_.load(); }
+
+    /// Token budget per caption: several seconds of speech.
+    static constexpr int kCaptionMaxTokens = 48;
+
 private:
-    /// Resample from `in_rate` to 16 kHz (whisper's native rate).
-    std::vector<float> resample_to_16k(const std::vector<float>& input,
-                                       int in_rate) const;
+    /// A loaded model: the shared whisper_context plus its state pool.
+    /// Defined in the .cpp so whisper.h stays out of this header.
+    struct Model;
+
+    /// RAII lease of one whisper_state from a Model's pool.
+    class StateLease;
+
+    /// Snapshot of the current model.  If none is loaded but a preload is
+    /// in progress, waits for it.  nullptr if no model is available.
+    std::shared_ptr<Model> current_model() const;
+
+    /// Read the weights and allocate `n_states` states; optionally run the
+    /// warm-up inference.  nullptr on failure.
+    static std::shared_ptr<Model> load_model(const std::string& model_path,
+                                             int n_states, bool warm_up,
+                                             ModelTier tier = ModelTier::standard);
+
+    /// Time a short inference at a few thread counts and return the
+    /// fastest.  Results are cached under `cache_key` (model path + size),
+    /// so this runs once per model file.
+    static int calibrate_threads(Model& model, const std::string& cache_key);
+
+    /// Threads for one request on `model` with `concurrent` requests
+    /// (including it) using its state pool.
+    int threads_for(const Model& model, int concurrent) const;
+
+    /// Pick the model for a request of `seconds` of audio.  Falls back
+    /// across tiers to whatever is loaded; waits for a pending preload if
+    /// nothing is.  nullptr if no model is available.
+    std::shared_ptr<Model> route(std::optional<ModelTier> tier, double seconds) const;
+
+    /// Evict least-recently-used registry entries (never `keep` or the
+    /// default) until memory_in_use() fits the budget.  Caller holds mu_.
+    void enforce_budget_locked(const std::string& keep);
 
-    ::whisper_context* ctx_ = nullptr;   // opaque whisper.h handle
+    size_t memory_in_use_locked() const;
+
+    /// Block until any preload() in progress has finished.
+    void wait_for_preload() const;
+
+    /// Join a window's text onto the accumulated stream transcript.
+    static void append_text(std::string& out, const std::string& text);
+
+    /// Shift the current window's segments to stream time, merge away
+    /// words repeated from the overlap, keep them, and return their text.
+    /// Caller holds stream_mu_.
+    std::string append_segments(std::vector<TranscriptSegment> segments);
+
+    /// Options for the next stream window: the transcript tail as prompt.
+    /// Caller holds stream_mu_.
+    TranscribeOptions stream_options() const;
+
+    /// Drop the first `n` buffered samples, keeping the overlap for the
+    /// next window unless `keep_overlap` is false.  Caller holds stream_mu_.
+    void advance_stream(size_t n, bool keep_overlap);
+
+    std::shared_ptr<Model>  model_;      // default model; guarded by mu_
+    std::map<std::string, std::shared_ptr<Model>> registry_;   // guarded by mu_
+    size_t                  memory_budget_ = kDefaultMemoryBudget;   // guarded by mu_
+    std::shared_future<bool> pending_load_;   // last preload(); guarded by mu_
     mutable std::mutex      mu_;
+    std::atomic<bool>       vad_enabled_{true};
+    std::atomic<int>        thread_override_{0};   // 0 = automatic
+    std::atomic<int>        stream_overlap_ms_{kDefaultStreamOverlapMs};
+    std::atomic<int>        active_requests_{0};
+
+    /// Held for a whole caption(); guards every Model's caption state.
+    /// Lock order is caption_mu_ then mu_.
+    std::mutex              caption_mu_;
+
+    // Streaming state — guarded by stream_mu_.  Lock order is stream_mu_
+    // then mu_ (feed/finish call transcribe() while holding stream_mu_ so
+    // windows are processed strictly in arrival order).
+    std::vector<float>      stream_buf_;
+    std::string             stream_text_;
+    std::vector<TranscriptSegment> stream_segments_;
+    size_t                  stream_pos_     = 0;   // stream sample at stream_buf_[0]
+    size_t                  stream_carry_   = 0;   // leading samples already transcribed
+    size_t                  stream_overlap_ = 0;   // samples re-run per window
+    int                     stream_rate_ = 16000;
+    bool                    streaming_   = false;
+    mutable std::mutex      stream_mu_;
 };
 
 } // namespace vr
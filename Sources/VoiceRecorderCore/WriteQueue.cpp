@@ -0,0 +1,188 @@
+#include "WriteQueue.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <utility>
+
+namespace vr {
+
+// ---------------------------------------------------------------------------
+// Construction / destruction
+// ---------------------------------------------------------------------------
+
+WriteQueue::WriteQueue(DatabaseManager& db)
+    : db_(db), writer_(&WriteQueue::writer_loop, this) {}
+
+WriteQueue::~WriteQueue() {
+    {
+        std::lock_guard<std::mutex> lock(mu_);
+        stopping_ = true;
+    }
+    cv_.notify_all();
+    if (writer_.joinable()) writer_.join();
+}
+
+// ---------------------------------------------------------------------------
+// Enqueue
+// ---------------------------------------------------------------------------
+
+void WriteQueue::add_chunk(const std::string& session_id,
+                           int chunk_index,
+                           std::vector<uint8_t> pcm,
+                           int64_t duration_ms) {
+    WriteOp op;
+    op.kind        = WriteOp::Kind::add_chunk;
+    op.session_id  = session_id;
+    op.chunk_index = chunk_index;
+    op.data        = std::move(pcm);
+    op.duration_ms = duration_ms;
+    enqueue(std::move(op), /*needs_encode=*/true);
+}
+
+void WriteQueue::update_chunk_transcript(const std::string& session_id,
+                                         int chunk_index,
+                                         std::string transcript) {
+    WriteOp op;
+    op.kind        = WriteOp::Kind::chunk_transcript;
+    op.session_id  = session_id;
+    op.chunk_index = chunk_index;
+    op.text        = std::move(transcript);
+    enqueue(std::move(op), false);
+}
+
+void WriteQueue::update_duration(const std::string& session_id, int64_t duration_ms) {
+    WriteOp op;
+    op.kind        = WriteOp::Kind::duration;
+    op.session_id  = session_id;
+    op.duration_ms = duration_ms;
+    enqueue(std::move(op), false);
+}
+
+void WriteQueue::update_status(const std::string& session_id, RecordingStatus status) {
+    WriteOp op;
+    op.kind       = WriteOp::Kind::status;
+    op.session_id = session_id;
+    op.status     = status;
+    enqueue(std::move(op), false);
+}
+
+void WriteQueue::enqueue(WriteOp op, bool needs_encode) {
+    {
+        std::lock_guard<std::mutex> lock(mu_);
+        Entry e;
+        e.seq          = next_seq_++;
+        e.needs_encode = needs_encode;
+        last_seq_[op.session_id] = e.seq;
+        e.op           = std::move(op);
+        queue_.push_back(std::move(e));
+    }
+    cv_.notify_one();
+}
+
+// ---------------------------------------------------------------------------
+// flush_and_wait / pending
+// ---------------------------------------------------------------------------
+
+bool WriteQueue::flush_and_wait(const std::string& session_id) {
+    std::unique_lock<std::mutex> lock(mu_);
+
+    auto it = last_seq_.find(session_id);
+    if (it != last_seq_.end()) {
+        const uint64_t target = it->second;
+
+        // Cut the group-commit window short: someone is waiting.
+        ++flush_waiters_;
+        cv_.notify_one();
+        done_cv_.wait(lock, [&] { return done_seq_ >= target; });
+        --flush_waiters_;
+
+        // Forget the session unless newer writes arrived meanwhile.
+        it = last_seq_.find(session_id);
+        if (it != last_seq_.end() && it->second <= done_seq_) {
+            last_seq_.erase(it);
+        }
+    }
+
+    return failed_.erase(session_id) == 0;
+}
+
+size_t WriteQueue::pending() const {
+    std::lock_guard<std::mutex> lock(mu_);
+    return queue_.size() + in_flight_;
+}
+
+// ---------------------------------------------------------------------------
+// Writer thread
+// ---------------------------------------------------------------------------
+
+void WriteQueue::writer_loop() {
+    for (;;) {
+        std::vector<Entry> batch;
+        {
+            std::unique_lock<std::mutex> lock(mu_);
+            cv_.wait(lock, [this] { return stopping_ || !queue_.empty(); });
+            if (queue_.empty()) {
+                return;   // stopping and fully drained
+            }
+
+            // Group commit: give related writes (a chunk and its metadata)
+            // a moment to arrive so they share one transaction.
+            cv_.wait_for(lock, kGroupCommitWindow, [this] {
+                return stopping_ || flush_waiters_ > 0 || queue_.size() >= kMaxBatchOps;
+            });
+
+            const size_t n = std::min(queue_.size(), kMaxBatchOps);
+            batch.reserve(n);
+            for (size_t i = 0; i < n; ++i) {
+                batch.push_back(std::move(queue_.front()));
+                queue_.pop_front();
+            }
+            in_flight_ = batch.size();
+        }
+
+        commit(batch);
+
+        {
+            std::lock_guard<std::mutex> lock(mu_);
+            done_seq_  = batch.back().seq;
+            in_flight_ = 0;
+        }
+        done_cv_.notify_all();
+    }
+}
+
+void WriteQueue::commit(std::vector<Entry>& batch) {
+    // Encode chunks here, outside any database lock.
+    std::vector<WriteOp> ops;
+    ops.reserve(batch.size());
+    for (auto& e : batch) {
+        if (e.needs_encode) {
+            const WriteOp& raw = e.op;
+            ops.push_back(db_.encode_chunk(raw.session_id, raw.chunk_index,
+                                           raw.data.data(), raw.data.size(),
+                                           raw.duration_ms));
+        } else {
+            ops.push_back(std::move(e.op));
+        }
+    }
+
+    if (db_.apply_batch(ops)) return;
+
+    // The batch rolled back as a whole; retry op by op so only the
+    // failing writes are lost and their sessions reported.
+    std::unordered_set<std::string> failed;
+    for (const auto& op : ops) {
+        if (!db_.apply_batch({op})) {
+            fprintf(stderr, "[WriteQueue] write failed for session %s (chunk %d)\n",
+                    op.session_id.c_str(), op.chunk_index);
+            failed.insert(op.session_id);
+        }
+    }
+
+    if (!failed.empty()) {
+        std::lock_guard<std::mutex> lock(mu_);
+        failed_.insert(failed.begin(), failed.end());
+    }
+}
+
+} // namespace vr
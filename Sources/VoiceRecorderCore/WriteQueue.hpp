@@ -0,0 +1,103 @@
+#pragma once
+
+#include "DatabaseManager.hpp"
+#include "Types.hpp"
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace vr {
+
+/// Write-behind queue for recording-time writes.
+///
+/// Callers (the main thread) enqueue chunk inserts and metadata updates and
+/// return immediately; a dedicated writer thread encodes chunks and commits
+/// whatever has accumulated as one transaction (group commit).  Writes are
+/// applied in enqueue order.  flush_and_wait() is the barrier that keeps
+/// "store before transcribe": once it returns, every write queued earlier
+/// for that session is committed and visible to readers.
+class WriteQueue {
+public:
+    /// `db` must be open and must outlive the queue.
+    explicit WriteQueue(DatabaseManager& db);
+
+    /// Commits everything still queued, then joins the writer thread.
+    ~WriteQueue();
+
+    // Non-copyable.
+    WriteQueue(const WriteQueue&) = delete;
+    WriteQueue& operator=(const WriteQueue&) = delete;
+
+    /// Queue a chunk of raw 16 kHz mono float32 PCM.  Encoding with the
+    /// database's storage codec happens on the writer thread.
+    void add_chunk(const std::string& session_id,
+                   int chunk_index,
+                   std::vector<uint8_t> pcm,
+                   int64_t duration_ms);
+
+    /// Queue a per-chunk partial transcript (streaming transcription).
+    void update_chunk_transcript(const std::string& session_id,
+                                 int chunk_index,
+                                 std::string transcript);
+
+    /// Queue a session duration update.
+    void update_duration(const std::string& session_id, int64_t duration_ms);
+
+    /// Queue a session status update.
+    void update_status(const std::string& session_id, RecordingStatus status);
+
+    /// Block until every write queued so far for `session_id` has been
+    /// committed.  Returns false if any of them failed since the previous
+    /// flush of this session.
+    bool flush_and_wait(const std::string& session_id);
+
+    /// Number of writes queued but not yet committed.
+    size_t pending() const;
+
+    /// How long the writer waits for more writes to join a batch, unless a
+    /// flush is waiting.
+    static constexpr std::chrono::milliseconds kGroupCommitWindow{50};
+
+    /// Upper bound on writes per transaction.
+    static constexpr size_t kMaxBatchOps = 64;
+
+private:
+    struct Entry {
+        WriteOp  op;
+        bool     needs_encode = false;   // add_chunk with raw PCM in op.data
+        uint64_t seq = 0;
+    };
+
+    void enqueue(WriteOp op, bool needs_encode);
+    void writer_loop();
+
+    /// Encode and commit one batch; falls back to one transaction per op
+    /// if the batch fails, so a single bad write can't drop the others.
+    void commit(std::vector<Entry>& batch);
+
+    DatabaseManager&                          db_;
+
+    mutable std::mutex                        mu_;
+    std::condition_variable                   cv_;        // writer wake-up
+    std::condition_variable                   done_cv_;   // flush waiters
+    std::deque<Entry>                         queue_;
+    std::unordered_map<std::string, uint64_t> last_seq_;  // newest queued seq per session
+    std::unordered_set<std::string>           failed_;    // sessions with a failed write
+    uint64_t                                  next_seq_ = 1;
+    uint64_t                                  done_seq_ = 0;
+    size_t                                    in_flight_ = 0;
+    int                                       flush_waiters_ = 0;
+    bool                                      stopping_ = false;
+
+    std::thread                               writer_;    // declared last: starts after state
+};
+
+} // namespace vr